@@ -21,6 +21,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -301,6 +302,8 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
+	PROFILE_ZONE_ON("Mixer", Common::Profiler::kTrackAudio);
+
 	Common::StackLock lock(_mutex);
 
 	int16 *buf = (int16 *)samples;
@@ -388,7 +388,7 @@ void OpenGLSdlGraphicsManager::updateScreen() {
 	}
 
 #if defined(USE_IMGUI) && SDL_VERSION_ATLEAST(2, 0, 0)
-	if (_imGuiCallbacks.render) {
+	if (_imGuiCallbacks.render || _profilerOverlayVisible) {
 		_forceRedraw = true;
 	}
 #endif
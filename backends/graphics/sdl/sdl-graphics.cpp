@@ -26,7 +26,9 @@
 #include "backends/keymapper/action.h"
 #include "backends/keymapper/keymap.h"
 #include "common/config-manager.h"
+#include "common/file.h"
 #include "common/fs.h"
+#include "common/profiler.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "graphics/scaler/aspect.h"
@@ -56,6 +58,10 @@
 #endif
 #endif
 
+#if defined(USE_IMGUI) && SDL_VERSION_ATLEAST(2, 0, 0)
+#include "backends/imgui/components/imgui_profiler.h"
+#endif
+
 
 static void getMouseState(int *x, int *y) {
 #if SDL_VERSION_ATLEAST(3, 0, 0)
@@ -460,6 +466,14 @@ bool SdlGraphicsManager::notifyEvent(const Common::Event &event) {
 		saveScreenshot();
 		return true;
 
+	case kActionToggleProfiler:
+		toggleProfiler();
+		return true;
+
+	case kActionSaveProfilerTrace:
+		saveProfilerTrace();
+		return true;
+
 	default:
 		return false;
 	}
@@ -482,6 +496,64 @@ void SdlGraphicsManager::toggleFullScreen() {
 #endif
 }
 
+void SdlGraphicsManager::toggleProfiler() {
+	Common::Profiler &profiler = Common::Profiler::instance();
+
+#if defined(USE_IMGUI) && SDL_VERSION_ATLEAST(2, 0, 0)
+	if (_imGuiReady) {
+		// Only record while the overlay is shown, the frames are kept for saving a trace afterwards
+		_profilerOverlayVisible = !_profilerOverlayVisible;
+		profiler.setEnabled(_profilerOverlayVisible);
+		return;
+	}
+#endif
+
+	profiler.setEnabled(!Common::Profiler::isEnabled());
+#ifdef USE_OSD
+	if (Common::Profiler::isEnabled())
+		displayMessageOnOSD(_("Profiler started"));
+	else
+		displayMessageOnOSD(_("Profiler stopped"));
+#endif
+}
+
+void SdlGraphicsManager::saveProfilerTrace() {
+	Common::Profiler &profiler = Common::Profiler::instance();
+	if (profiler.getFrameCount() == 0) {
+		warning("No profiler frames recorded, start the profiler first");
+		return;
+	}
+
+	// Traces go next to the screenshots
+	Common::Path tracesPath;
+	OSystem_SDL *sdl_g_system = dynamic_cast<OSystem_SDL*>(g_system);
+	if (sdl_g_system)
+		tracesPath = sdl_g_system->getScreenshotsPath();
+
+	Common::String currentTarget = ConfMan.getActiveDomainName();
+	Common::String filename;
+	for (int n = 0;; n++) {
+		filename = Common::String::format("scummvm%s%s-trace-%05d.json", currentTarget.empty() ? "" : "-",
+		                                  currentTarget.c_str(), n);
+
+		Common::FSNode file = Common::FSNode(tracesPath.appendComponent(filename));
+		if (!file.exists()) {
+			break;
+		}
+	}
+
+	Common::DumpFile file;
+	if (!file.open(Common::FSNode(tracesPath.appendComponent(filename))) || !profiler.writeChromeTrace(file)) {
+		warning("Could not save profiler trace '%s'", filename.c_str());
+		return;
+	}
+
+	debug("Saved profiler trace '%s' with %u frames", filename.c_str(), profiler.getFrameCount());
+#ifdef USE_OSD
+	displayMessageOnOSD(Common::U32String::format(_("Saved profiler trace '%s'"), filename.c_str()));
+#endif
+}
+
 Common::Keymap *SdlGraphicsManager::getKeymap() {
 	using namespace Common;
 
@@ -511,6 +583,16 @@ Common::Keymap *SdlGraphicsManager::getKeymap() {
 	act->setCustomBackendActionEvent(kActionSaveScreenshot);
 	keymap->addAction(act);
 
+	act = new Action("PROF", _("Toggle profiler"));
+	act->addDefaultInputMapping("C+A+p");
+	act->setCustomBackendActionEvent(kActionToggleProfiler);
+	keymap->addAction(act);
+
+	act = new Action("PRTR", _("Save profiler trace"));
+	act->addDefaultInputMapping("C+A+t");
+	act->setCustomBackendActionEvent(kActionSaveProfilerTrace);
+	keymap->addAction(act);
+
 	if (hasFeature(OSystem::kFeatureAspectRatioCorrection)) {
 		act = new Action("ASPT", _("Toggle aspect ratio correction"));
 		act->addDefaultInputMapping("C+A+a");
@@ -683,7 +765,7 @@ void SdlGraphicsManager::initImGui(SDL_Renderer *renderer, void *glContext) {
 }
 
 void SdlGraphicsManager::renderImGui() {
-	if (!_imGuiReady || !_imGuiCallbacks.render) {
+	if (!_imGuiReady || (!_imGuiCallbacks.render && !_profilerOverlayVisible)) {
 		return;
 	}
 
@@ -716,7 +798,21 @@ void SdlGraphicsManager::renderImGui() {
 #endif
 
 	ImGui::NewFrame();
-	_imGuiCallbacks.render();
+	if (_imGuiCallbacks.render) {
+		_imGuiCallbacks.render();
+	}
+	if (_profilerOverlayVisible) {
+		if (!_profilerOverlay) {
+			_profilerOverlay = new ImGuiEx::ImGuiProfiler();
+		}
+		if (_profilerOverlay->draw("Profiler", &_profilerOverlayVisible)) {
+			saveProfilerTrace();
+		}
+		// Closed with its close button
+		if (!_profilerOverlayVisible) {
+			Common::Profiler::instance().setEnabled(false);
+		}
+	}
 	ImGui::Render();
 #ifdef USE_IMGUI_SDLRENDERER3
 	if (_imGuiSDLRenderer) {
@@ -753,6 +849,9 @@ void SdlGraphicsManager::destroyImGui() {
 	_imGuiInited = false;
 	_imGuiReady = false;
 
+	delete _profilerOverlay;
+	_profilerOverlay = nullptr;
+
 #ifdef USE_IMGUI_SDLRENDERER3
 	if (_imGuiSDLRenderer) {
 		ImGui_ImplSDLRenderer3_Shutdown();
@@ -30,6 +30,12 @@
 
 class SdlEventSource;
 
+#if defined(USE_IMGUI)
+namespace ImGuiEx {
+class ImGuiProfiler;
+}
+#endif
+
 #define USE_OSD	1
 
 /**
@@ -150,7 +156,9 @@ protected:
 		kActionIncreaseScaleFactor,
 		kActionDecreaseScaleFactor,
 		kActionNextScaleFilter,
-		kActionPreviousScaleFilter
+		kActionPreviousScaleFilter,
+		kActionToggleProfiler,
+		kActionSaveProfilerTrace
 	};
 
 	/** Obtain the user configured fullscreen resolution, or default to the desktop resolution */
@@ -220,6 +228,8 @@ protected:
 
 private:
 	void toggleFullScreen();
+	void toggleProfiler();
+	void saveProfilerTrace();
 
 #if defined(USE_IMGUI) && SDL_VERSION_ATLEAST(2, 0, 0)
 public:
@@ -230,6 +240,8 @@ protected:
 	bool _imGuiReady = false;
 	bool _imGuiInited = false;
 	SDL_Renderer *_imGuiSDLRenderer = nullptr;
+	bool _profilerOverlayVisible = false;
+	ImGuiEx::ImGuiProfiler *_profilerOverlay = nullptr;
 
 	void initImGui(SDL_Renderer *renderer, void *glContext);
 	void renderImGui();
@@ -1407,7 +1407,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		_forceRedraw = true;
 
 #if defined(USE_IMGUI) && (defined(USE_IMGUI_SDLRENDERER2) || defined(USE_IMGUI_SDLRENDERER3))
-	if (_imGuiCallbacks.render) {
+	if (_imGuiCallbacks.render || _profilerOverlayVisible) {
 		_forceRedraw = true;
 	}
 #endif
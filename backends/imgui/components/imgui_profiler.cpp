@@ -0,0 +1,207 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/profiler.h"
+#include "common/str.h"
+#include "common/util.h"
+
+#include "backends/imgui/components/imgui_profiler.h"
+
+namespace ImGuiEx {
+
+namespace {
+
+struct ZoneOrder {
+	const Common::Array<Common::Profiler::Zone> &_zones;
+
+	ZoneOrder(const Common::Array<Common::Profiler::Zone> &zones) : _zones(zones) {}
+
+	bool operator()(uint a, uint b) const {
+		const Common::Profiler::Zone &za = _zones[a];
+		const Common::Profiler::Zone &zb = _zones[b];
+		if (za.track != zb.track)
+			return za.track < zb.track;
+		if (za.start != zb.start)
+			return za.start < zb.start;
+		return za.depth < zb.depth;
+	}
+};
+
+struct ZoneTotal {
+	const char *name;
+	uint16 track;
+	uint32 calls;
+	uint64 total;
+	uint32 longest;
+};
+
+const char *const kTrackNames[Common::Profiler::kTrackCount] = { "Engine", "Audio" };
+
+} // End of anonymous namespace
+
+ImGuiProfiler::ImGuiProfiler() : _follow(true), _selectedFrame(0) {
+}
+
+bool ImGuiProfiler::draw(const char *title, bool *p_open) {
+	if (!*p_open)
+		return false;
+
+	ImGui::SetNextWindowSize(ImVec2(480, 560), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin(title, p_open)) {
+		ImGui::End();
+		return false;
+	}
+
+	Common::Profiler &profiler = Common::Profiler::instance();
+	bool saveTrace = false;
+
+	bool recording = Common::Profiler::isEnabled();
+	if (ImGui::Checkbox("Record", &recording))
+		profiler.setEnabled(recording);
+	ImGui::SameLine();
+	ImGui::Checkbox("Follow", &_follow);
+	ImGui::SetItemTooltip("Show the most recent frame");
+	ImGui::SameLine();
+	if (ImGui::Button("Save trace"))
+		saveTrace = true;
+	ImGui::SetItemTooltip("Save the recorded frames in the Chrome trace format");
+
+	const uint count = profiler.getFrameCount();
+	if (count == 0) {
+		ImGui::TextUnformatted("No frames recorded");
+		ImGui::End();
+		return saveTrace;
+	}
+
+	// Frame times, oldest first
+	float times[Common::Profiler::kFrameCount];
+	float total = 0.0f, longest = 0.0f;
+	for (uint i = 0; i < count; i++) {
+		times[i] = profiler.getFrame(count - 1 - i).duration / 1000.0f;
+		total += times[i];
+		longest = MAX(longest, times[i]);
+	}
+
+	ImGui::Text("Frame time: %.2f ms average, %.2f ms max", total / count, longest);
+	ImGui::PlotHistogram("##frames", times, count, 0, nullptr, 0.0f, MAX(longest, 1000.0f / 60.0f), ImVec2(-1, 80));
+	if (ImGui::IsItemHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
+		const float pos = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+		const uint index = CLIP<int>((int)(pos * count), 0, count - 1);
+		_selectedFrame = profiler.getFrame(count - 1 - index).number;
+		_follow = false;
+	}
+
+	uint age = 0;
+	if (!_follow) {
+		while (age < count && profiler.getFrame(age).number != _selectedFrame)
+			age++;
+		// The frame was dropped from the ring
+		if (age == count) {
+			age = 0;
+			_follow = true;
+		}
+	}
+	const Common::Profiler::Frame &frame = profiler.getFrame(age);
+
+	if (ImGui::CollapsingHeader(Common::String::format("Frame %u: %.2f ms###frame", frame.number, frame.duration / 1000.0f).c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
+		Common::Array<uint> order;
+		for (uint i = 0; i < frame.zones.size(); i++)
+			order.push_back(i);
+		Common::sort(order.begin(), order.end(), ZoneOrder(frame.zones));
+
+		if (ImGui::BeginTable("zones", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+			ImGui::TableSetupColumn("Zone");
+			ImGui::TableSetupColumn("ms");
+			ImGui::TableSetupColumn("%");
+			ImGui::TableHeadersRow();
+
+			int track = -1;
+			for (uint i = 0; i < order.size(); i++) {
+				const Common::Profiler::Zone &zone = frame.zones[order[i]];
+				ImGui::TableNextRow();
+				if (zone.track != track) {
+					track = zone.track;
+					ImGui::TableNextColumn();
+					ImGui::TextDisabled("%s", kTrackNames[track]);
+					ImGui::TableNextRow();
+				}
+				ImGui::TableNextColumn();
+				ImGui::Text("%*s%s", zone.depth * 2, "", zone.name);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.duration / 1000.0f);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f", frame.duration ? zone.duration * 100.0f / frame.duration : 0.0f);
+			}
+			ImGui::EndTable();
+		}
+
+		for (uint i = 0; i < frame.counters.size(); i++)
+			ImGui::Text("%s: %lld", frame.counters[i].name, (long long)frame.counters[i].value);
+	}
+
+	if (ImGui::CollapsingHeader("All frames")) {
+		Common::Array<ZoneTotal> totals;
+		for (uint f = 0; f < count; f++) {
+			const Common::Profiler::Frame &fr = profiler.getFrame(f);
+			for (uint i = 0; i < fr.zones.size(); i++) {
+				const Common::Profiler::Zone &zone = fr.zones[i];
+				uint t = 0;
+				while (t < totals.size() && (totals[t].track != zone.track || strcmp(totals[t].name, zone.name)))
+					t++;
+				if (t == totals.size()) {
+					ZoneTotal zoneTotal = { zone.name, zone.track, 0, 0, 0 };
+					totals.push_back(zoneTotal);
+				}
+				totals[t].calls++;
+				totals[t].total += zone.duration;
+				totals[t].longest = MAX(totals[t].longest, zone.duration);
+			}
+		}
+
+		if (ImGui::BeginTable("totals", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+			ImGui::TableSetupColumn("Zone");
+			ImGui::TableSetupColumn("ms/frame");
+			ImGui::TableSetupColumn("max ms");
+			ImGui::TableSetupColumn("calls/frame");
+			ImGui::TableHeadersRow();
+
+			for (uint t = 0; t < totals.size(); t++) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text("%s (%s)", totals[t].name, kTrackNames[totals[t].track]);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", totals[t].total / 1000.0f / count);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", totals[t].longest / 1000.0f);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f", (float)totals[t].calls / count);
+			}
+			ImGui::EndTable();
+		}
+	}
+
+	ImGui::End();
+	return saveTrace;
+}
+
+} // namespace ImGuiEx
@@ -26,6 +26,7 @@
 #include "backends/mixer/mixer.h"
 #include "gui/EventRecorder.h"
 
+#include "common/profiler.h"
 #include "common/timer.h"
 #include "graphics/pixelformat.h"
 
@@ -195,11 +196,18 @@ void ModularGraphicsBackend::updateScreen() {
 	g_eventRec.preDrawOverlayGui();
 #endif
 
-	_graphicsManager->updateScreen();
+	{
+		PROFILE_ZONE("updateScreen");
+		_graphicsManager->updateScreen();
+	}
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.postDrawOverlayGui();
 #endif
+
+	// The screen update closes the frame
+	if (Common::Profiler::isEnabled())
+		Common::Profiler::instance().endFrame();
 }
 
 void ModularGraphicsBackend::presentBuffer() {
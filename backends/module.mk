@@ -198,6 +198,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mixer/null/null-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	tasks/sdl/sdl-task-scheduler.o \
 	timer/sdl/sdl-timer.o
 
 ifndef USE_SDL3
@@ -263,6 +264,11 @@ MODULE_OBJS += \
 	taskbar/unity/unity-taskbar.o \
 	dialogs/gtk/gtk-dialogs.o
 
+ifdef HAS_PTHREADS
+MODULE_OBJS += \
+	tasks/pthread/pthread-task-scheduler.o
+endif
+
 ifdef USE_SPEECH_DISPATCHER
 ifdef USE_TTS
 MODULE_OBJS += \
@@ -505,6 +511,7 @@ MODULE_OBJS += \
 	imgui/imgui_widgets.o \
 	imgui/imgui_utils.o \
 	imgui/components/imgui_logger.o \
+	imgui/components/imgui_profiler.o \
 	imgui/misc/freetype/imgui_freetype.o
 endif
 
@@ -68,6 +68,9 @@
 #include "backends/mutex/pthread/pthread-mutex.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
+#ifdef HAS_PTHREADS
+#include "backends/tasks/pthread/pthread-task-scheduler.h"
+#endif
 
 #include "backends/keymapper/keymapper.h"
 #include "backends/keymapper/keymapper-defaults.h"
@@ -580,6 +583,9 @@ void OSystem_Android::initBackend() {
 
 	_eventManager = new DefaultEventManager(this);
 	_audiocdManager = new DefaultAudioCDManager();
+#ifdef HAS_PTHREADS
+	_taskScheduler = createPthreadTaskScheduler();
+#endif
 
 	BaseBackend::initBackend();
 }
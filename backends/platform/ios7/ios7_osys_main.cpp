@@ -51,6 +51,9 @@
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#ifdef HAS_PTHREADS
+#include "backends/tasks/pthread/pthread-task-scheduler.h"
+#endif
 #include "backends/fs/chroot/chroot-fs-factory.h"
 #include "backends/fs/posix/posix-fs.h"
 #include "audio/mixer.h"
@@ -167,6 +170,10 @@ void OSystem_iOS7::initBackend() {
 
 	setTimerCallback(&OSystem_iOS7::timerHandler, 10);
 
+#ifdef HAS_PTHREADS
+	_taskScheduler = createPthreadTaskScheduler();
+#endif
+
 	ConfMan.registerDefault("iconspath", Common::Path("/"));
 
 	EventsBaseBackend::initBackend();
@@ -51,7 +51,9 @@ typedef void (*sighandler_t)(int);
 #include "backends/mutex/null/null-mutex.h"
 #include "base/main.h"
 
-#ifndef NULL_DRIVER_USE_FOR_TEST
+#ifdef NULL_DRIVER_USE_FOR_TEST
+#include "common/task-scheduler.h"
+#else
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
@@ -86,6 +88,7 @@ public:
 
 	virtual Common::MutexInternal *createMutex();
 	virtual uint32 getMillis(bool skipRecord = false);
+	virtual uint64 getMicros();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
 
@@ -95,6 +98,13 @@ public:
 
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority);
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	void setTaskScheduler(Common::TaskScheduler *taskScheduler) {
+		delete _taskScheduler;
+		_taskScheduler = taskScheduler;
+	}
+#endif
+
 private:
 #ifdef POSIX
 	timeval _startTime;
@@ -205,6 +215,18 @@ uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #endif
 }
 
+uint64 OSystem_NULL::getMicros() {
+#ifdef POSIX
+	timeval curTime;
+
+	gettimeofday(&curTime, 0);
+
+	return (uint64)(curTime.tv_sec - _startTime.tv_sec) * 1000000 + (curTime.tv_usec - _startTime.tv_usec);
+#else
+	return (uint64)getMillis(true) * 1000;
+#endif
+}
+
 void OSystem_NULL::delayMillis(uint msecs) {
 #ifdef POSIX
 	usleep(msecs * 1000);
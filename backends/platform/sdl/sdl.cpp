@@ -46,6 +46,7 @@
 #include "backends/events/default/default-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/tasks/sdl/sdl-task-scheduler.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #ifdef USE_OPENGL
@@ -125,6 +126,8 @@ OSystem_SDL::~OSystem_SDL() {
 	// destructors would also take care of this for us. However, various
 	// of our managers must be deleted *before* we call SDL_Quit().
 	// Hence, we perform the destruction on our own.
+	delete _taskScheduler;
+	_taskScheduler = nullptr;
 	delete _savefileManager;
 	_savefileManager = nullptr;
 	if (_graphicsManager) {
@@ -377,6 +380,9 @@ void OSystem_SDL::initBackend() {
 
 	_audiocdManager = createAudioCDManager();
 
+	if (_taskScheduler == nullptr)
+		_taskScheduler = createSdlTaskScheduler();
+
 	// Setup a custom program icon.
 	_window->setupIcon();
 
@@ -850,6 +856,19 @@ uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	return millis;
 }
 
+uint64 OSystem_SDL::getMicros() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	return SDL_GetTicksNS() / 1000;
+#elif SDL_VERSION_ATLEAST(2, 0, 0)
+	// Split the conversion, the counter times a million would overflow
+	const uint64 counter = SDL_GetPerformanceCounter();
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+	return (counter / frequency) * 1000000 + (counter % frequency) * 1000000 / frequency;
+#else
+	return (uint64)SDL_GetTicks() * 1000;
+#endif
+}
+
 void OSystem_SDL::delayMillis(uint msecs) {
 #ifdef ENABLE_EVENTRECORDER
 	if (!g_eventRec.processDelayMillis())
@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "backends/tasks/pthread/pthread-task-scheduler.h"
+#include "common/array.h"
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * pthreads task scheduler implementation
+ */
+class PthreadTaskScheduler final : public Common::TaskScheduler {
+public:
+	PthreadTaskScheduler(uint workerCount);
+	~PthreadTaskScheduler() override;
+
+	uint getWorkerCount() const override { return _threads.size(); }
+
+protected:
+	void lock() override { pthread_mutex_lock(&_mutex); }
+	void unlock() override { pthread_mutex_unlock(&_mutex); }
+	void waitForSignal() override { pthread_cond_wait(&_cond, &_mutex); }
+	void signalAll() override { pthread_cond_broadcast(&_cond); }
+
+private:
+	static void *workerMain(void *data);
+
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	Common::Array<pthread_t> _threads;
+};
+
+PthreadTaskScheduler::PthreadTaskScheduler(uint workerCount) {
+	pthread_mutex_init(&_mutex, nullptr);
+	pthread_cond_init(&_cond, nullptr);
+
+	_threads.reserve(workerCount);
+	for (uint i = 0; i < workerCount; i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, nullptr, workerMain, this) != 0) {
+			warning("pthread_create() failed, using %u worker threads", _threads.size());
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+PthreadTaskScheduler::~PthreadTaskScheduler() {
+	stopWorkers();
+	for (uint i = 0; i < _threads.size(); i++)
+		pthread_join(_threads[i], nullptr);
+
+	pthread_cond_destroy(&_cond);
+	pthread_mutex_destroy(&_mutex);
+}
+
+void *PthreadTaskScheduler::workerMain(void *data) {
+	((PthreadTaskScheduler *)data)->runWorker();
+	return nullptr;
+}
+
+Common::TaskScheduler *createPthreadTaskScheduler(uint workerCount) {
+	if (workerCount == 0) {
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		if (cores > 1)
+			workerCount = cores - 1;
+	}
+
+	return new PthreadTaskScheduler(workerCount);
+}
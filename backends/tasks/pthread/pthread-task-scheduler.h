@@ -0,0 +1,35 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKENDS_TASKS_PTHREAD_H
+#define BACKENDS_TASKS_PTHREAD_H
+
+#include "common/task-scheduler.h"
+
+/**
+ * Create a task scheduler backed by a pool of pthreads.
+ *
+ * @param workerCount  Number of worker threads to start. If 0, one worker
+ *                     is started for every CPU core besides the calling one.
+ */
+Common::TaskScheduler *createPthreadTaskScheduler(uint workerCount = 0);
+
+#endif
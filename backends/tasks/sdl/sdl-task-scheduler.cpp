@@ -0,0 +1,130 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/tasks/sdl/sdl-task-scheduler.h"
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/array.h"
+#include "common/textconsole.h"
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+
+/**
+ * SDL task scheduler implementation
+ */
+class SdlTaskScheduler final : public Common::TaskScheduler {
+public:
+	SdlTaskScheduler(uint workerCount);
+	~SdlTaskScheduler() override;
+
+	uint getWorkerCount() const override { return _threads.size(); }
+
+protected:
+	void lock() override { SDL_LockMutex(_mutex); }
+	void unlock() override { SDL_UnlockMutex(_mutex); }
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	void waitForSignal() override { SDL_WaitCondition(_cond, _mutex); }
+	void signalAll() override { SDL_BroadcastCondition(_cond); }
+#else
+	void waitForSignal() override { SDL_CondWait(_cond, _mutex); }
+	void signalAll() override { SDL_CondBroadcast(_cond); }
+#endif
+
+private:
+	static int SDLCALL workerMain(void *data);
+
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_Mutex *_mutex;
+	SDL_Condition *_cond;
+#else
+	SDL_mutex *_mutex;
+	SDL_cond *_cond;
+#endif
+	Common::Array<SDL_Thread *> _threads;
+};
+
+SdlTaskScheduler::SdlTaskScheduler(uint workerCount) {
+	_mutex = SDL_CreateMutex();
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	_cond = SDL_CreateCondition();
+#else
+	_cond = SDL_CreateCond();
+#endif
+	if (!_mutex || !_cond)
+		return;
+
+	_threads.reserve(workerCount);
+	for (uint i = 0; i < workerCount; i++) {
+		SDL_Thread *thread = SDL_CreateThread(workerMain, "ScummVM task worker", this);
+		if (!thread) {
+			warning("SDL_CreateThread() failed, using %u worker threads", _threads.size());
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+SdlTaskScheduler::~SdlTaskScheduler() {
+	if (!_threads.empty()) {
+		stopWorkers();
+		for (uint i = 0; i < _threads.size(); i++)
+			SDL_WaitThread(_threads[i], nullptr);
+	}
+
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_DestroyCondition(_cond);
+#else
+	SDL_DestroyCond(_cond);
+#endif
+	SDL_DestroyMutex(_mutex);
+}
+
+int SDLCALL SdlTaskScheduler::workerMain(void *data) {
+	((SdlTaskScheduler *)data)->runWorker();
+	return 0;
+}
+
+Common::TaskScheduler *createSdlTaskScheduler() {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	int cores = SDL_GetNumLogicalCPUCores();
+#else
+	int cores = SDL_GetCPUCount();
+#endif
+	if (cores <= 1)
+		return new Common::TaskScheduler();
+
+	return new SdlTaskScheduler(cores - 1);
+}
+
+#else
+
+// SDL 1.2 has threads, but no portable way to query the number of cores.
+// Keep running tasks synchronously there.
+Common::TaskScheduler *createSdlTaskScheduler() {
+	return new Common::TaskScheduler();
+}
+
+#endif
+
+#endif
@@ -75,6 +75,8 @@ void ConfigManager::copyFrom(ConfigManager &source) {
 	_activeDomainName = source._activeDomainName;
 	_activeDomain = &_gameDomains[_activeDomainName];
 	_filename = source._filename;
+	_domainCache.clear();
+	_hasFlushed = false;
 }
 
 
@@ -83,6 +85,7 @@ bool ConfigManager::loadDefaultConfigFile(const Path &fallbackFilename) {
 	assert(g_system);
 	SeekableReadStream *stream = g_system->createConfigReadStream();
 	_filename.clear(); // clear the filename to indicate that we are using the default config file
+	_hasFlushed = false;
 
 	bool loadResult = false;
 	// ... load it, if available ...
@@ -105,6 +108,7 @@ bool ConfigManager::loadDefaultConfigFile(const Path &fallbackFilename) {
 
 bool ConfigManager::loadConfigFile(const Path &filename, const Path &fallbackFilename) {
 	_filename = filename;
+	_hasFlushed = false;
 
 	FSNode node(filename);
 	File cfg_file;
@@ -128,6 +132,9 @@ bool ConfigManager::loadFallbackConfigFile(const Path &filename) {
 
 	debug("Using initial configuration file: %s", filename.toString(Common::Path::kNativeSeparator).c_str());
 	loadFromStream(fallbackFile);
+
+	// This is not the file flushToDisk() writes to
+	_hasFlushed = false;
 	return true;
 }
 
@@ -189,41 +196,67 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 	_cloudDomain.clear();
 #endif
 
+	_domainCache.clear();
+	_lastFlushed.clear();
+	_hasFlushed = false;
+
+	// Read the whole file at once and parse it in place, so that lines
+	// do not have to be copied into strings of their own
+	int64 size = stream.size() - stream.pos();
+	if (size < 0 || stream.err())
+		return false;
+
+	Array<char> buffer;
+	buffer.resize((uint)size + 1);
+	size = stream.read(buffer.data(), (uint32)size);
+	buffer[(uint)size] = '\0';
+
+	const char *pos = buffer.data();
+	const char *const bufferEnd = pos + size;
+
+	// Skip UTF-8 byte-order mark if added by a text editor.
+	if (size >= 3 && memcmp(pos, UTF8_BOM, 3) == 0)
+		pos += 3;
+
 	// TODO: Detect if a domain occurs multiple times (or likewise, if
 	// a key occurs multiple times inside one domain).
 
-	while (!stream.eos() && !stream.err()) {
+	while (pos < bufferEnd) {
 		lineno++;
 
-		// Read a line
-		String line = stream.readLine();
+		// Find the end of the line. CR, LF and CR/LF are all accepted.
+		const char *line = pos;
+		const char *lineEnd = line;
+		while (lineEnd < bufferEnd && *lineEnd != '\n' && *lineEnd != '\r')
+			lineEnd++;
 
-		// Skip UTF-8 byte-order mark if added by a text editor.
-		if (lineno == 1 && memcmp(line.c_str(), UTF8_BOM, 3) == 0) {
-			line.erase(0, 3);
-		}
+		pos = lineEnd;
+		if (pos < bufferEnd && *pos == '\r')
+			pos++;
+		if (pos < bufferEnd && *pos == '\n')
+			pos++;
 
-		if (line.size() == 0) {
+		if (line == lineEnd) {
 			// Do nothing
 		} else if (line[0] == '#') {
 			// Accumulate comments here. Once we encounter either the start
 			// of a new domain, or a key-value-pair, we associate the value
 			// of the 'comment' variable with that entity.
-			comment += line;
+			comment += String(line, lineEnd);
 			comment += "\n";
 		} else if (line[0] == '[') {
 			// It's a new domain which begins here.
 			// Determine where the previously accumulated domain goes, if we accumulated anything.
 			addDomain(domainName, domain);
 			domain.clear();
-			const char *p = line.c_str() + 1;
+			const char *p = line + 1;
 			// Get the domain name, and check whether it's valid (that
 			// is, verify that it only consists of alphanumerics,
 			// dashes and underscores).
-			while (*p && (isAlnum(*p) || *p == '-' || *p == '_'))
+			while (p < lineEnd && (isAlnum(*p) || *p == '-' || *p == '_'))
 				p++;
 
-			if (*p == '\0') {
+			if (p == lineEnd) {
 				warning("Config file buggy: missing ] in line %d", lineno);
 				return false;
 			} else if (*p != ']') {
@@ -231,7 +264,7 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 				return false;
 			}
 
-			domainName = String(line.c_str() + 1, p);
+			domainName = String(line + 1, p);
 
 			domain.setDomainComment(comment);
 			comment.clear();
@@ -240,12 +273,12 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			// This line should be a line with a 'key=value' pair, or an empty one.
 
 			// Skip leading whitespaces
-			const char *t = line.c_str();
-			while (isSpace(*t))
+			const char *t = line;
+			while (t < lineEnd && isSpace(*t))
 				t++;
 
 			// Skip empty lines / lines with only whitespace
-			if (*t == 0)
+			if (t == lineEnd)
 				continue;
 
 			// If no domain has been set, this config file is invalid!
@@ -255,36 +288,64 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			}
 
 			// Split string at '=' into 'key' and 'value'. First, find the "=" delimeter.
-			const char *p = strchr(t, '=');
-			if (!p) {
-				warning("Config file buggy: Junk found in line %d: '%s'", lineno, t);
+			const char *p = t;
+			while (p < lineEnd && *p != '=')
+				p++;
+
+			if (p == lineEnd) {
+				warning("Config file buggy: Junk found in line %d: '%s'", lineno, String(t, lineEnd).c_str());
 				return false;
 			}
 
-			// Extract the key/value pair
-			String key(t, p);
-			String value(p + 1);
+			// Trim off spaces and extract the key/value pair
+			const char *keyEnd = p;
+			while (keyEnd > t && isSpace(keyEnd[-1]))
+				keyEnd--;
+
+			const char *value = p + 1;
+			const char *valueEnd = lineEnd;
+			while (value < valueEnd && isSpace(*value))
+				value++;
+			while (valueEnd > value && isSpace(valueEnd[-1]))
+				valueEnd--;
 
-			// Trim of spaces
-			key.trim();
-			value.trim();
+			String key(t, keyEnd);
 
 			// Finally, store the key/value pair in the active domain
-			domain.setVal(key, value);
+			domain.setVal(key, String(value, valueEnd));
 
-			// Store comment
-			domain.setKVComment(key, comment);
+			// Store comment. Most keys have none, so only keep track of
+			// actual comments, and of keys whose comment has to be reset.
+			if (!comment.empty() || domain.hasKVComment(key))
+				domain.setKVComment(key, comment);
 			comment.clear();
 		}
 	}
 
 	addDomain(domainName, domain); // Add the last domain found
 
+	// Flushing the config unchanged would write the same text again
+	_lastFlushed = String(buffer.data(), size);
+	_hasFlushed = true;
+
 	return true;
 }
 
 void ConfigManager::flushToDisk() {
 #ifndef __DC__
+	if (_flushBatchDepth > 0) {
+		_flushPending = true;
+		return;
+	}
+
+	String config;
+	writeConfig(config);
+
+	// Many callers flush after every change they make, whether or not
+	// anything was actually modified. Skip the write if nothing was.
+	if (_hasFlushed && config == _lastFlushed)
+		return;
+
 	WriteStream *stream;
 
 	if (_filename.empty()) {
@@ -306,42 +367,86 @@ void ConfigManager::flushToDisk() {
 		stream = dump;
 	}
 
+	// The streams write to a temporary file, which replaces the config
+	// file once it is closed, so a partly written file is never seen
+	stream->write(config.c_str(), config.size());
+	stream->finalize();
+
+	if (!stream->err()) {
+		_lastFlushed = config;
+		_hasFlushed = true;
+	}
+
+	delete stream;
+
+#endif // !__DC__
+}
+
+void ConfigManager::beginFlushBatch() {
+	_flushBatchDepth++;
+}
+
+void ConfigManager::endFlushBatch() {
+	assert(_flushBatchDepth > 0);
+	if (--_flushBatchDepth == 0 && _flushPending) {
+		_flushPending = false;
+		flushToDisk();
+	}
+}
+
+void ConfigManager::writeConfig(String &out) {
 	// Write the application domain
-	writeDomain(*stream, kApplicationDomain, _appDomain);
+	appendDomain(out, kApplicationDomain, _appDomain);
 
 	// Write the keymapper domain
-	writeDomain(*stream, kKeymapperDomain, _keymapperDomain);
+	appendDomain(out, kKeymapperDomain, _keymapperDomain);
 #ifdef USE_CLOUD
 	// Write the cloud domain
-	writeDomain(*stream, kCloudDomain, _cloudDomain);
+	appendDomain(out, kCloudDomain, _cloudDomain);
 #endif
 
 	// Write the miscellaneous domains next
 	for (const auto &misc : _miscDomains) {
-		writeDomain(*stream, misc._key, misc._value);
+		appendDomain(out, misc._key, misc._value);
 	}
 
 	// First write the domains in _domainSaveOrder, in that order.
 	// Note: It's possible for _domainSaveOrder to list domains which
 	// are not present anymore, so we validate each name.
+	HashMap<String, bool> ordered;
 	for (const auto &domain : _domainSaveOrder) {
+		ordered[domain] = true;
 		if (_gameDomains.contains(domain)) {
-			writeDomain(*stream, domain, _gameDomains[domain]);
+			appendDomain(out, domain, _gameDomains[domain]);
 		}
 	}
 
 	// Now write the domains which haven't been written yet
 	for (auto &domain : _gameDomains) {
-		if (find(_domainSaveOrder.begin(), _domainSaveOrder.end(), domain._key) == _domainSaveOrder.end())
-			writeDomain(*stream, domain._key, domain._value);
+		if (!ordered.contains(domain._key))
+			appendDomain(out, domain._key, domain._value);
 	}
 
-	delete stream;
+	// Forget about domains which were removed or renamed
+	if (_domainCache.size() > 2 * (_gameDomains.size() + _miscDomains.size()) + 16)
+		_domainCache.clear();
+}
 
-#endif // !__DC__
+void ConfigManager::appendDomain(String &out, const String &name, const Domain &domain) {
+	// A fresh cache entry has revision 0 and no text, which is also
+	// what any domain that was never modified serializes to
+	CachedDomain &cached = _domainCache.getOrCreateVal(name);
+
+	if (cached.revision != domain.getRevision()) {
+		cached.text.clear();
+		writeDomain(cached.text, name, domain);
+		cached.revision = domain.getRevision();
+	}
+
+	out += cached.text;
 }
 
-void ConfigManager::writeDomain(WriteStream &stream, const String &name, const Domain &domain) {
+void ConfigManager::writeDomain(String &out, const String &name, const Domain &domain) {
 	if (domain.empty())
 		return; // Don't bother writing empty domains.
 
@@ -351,35 +456,29 @@ void ConfigManager::writeDomain(WriteStream &stream, const String &name, const D
 	if (domain.contains("id_came_from_command_line"))
 		return;
 
-	String comment;
-
 	// Write domain comment (if any)
-	comment = domain.getDomainComment();
-	if (!comment.empty())
-		stream.writeString(comment);
+	out += domain.getDomainComment();
 
 	// Write domain start
-	stream.writeByte('[');
-	stream.writeString(name);
-	stream.writeByte(']');
-	stream.writeByte('\n');
+	out += '[';
+	out += name;
+	out += "]\n";
 
 	// Write all key/value pairs in this domain, including comments
 	for (const auto &x : domain) {
 		if (!x._value.empty()) {
 			// Write comment (if any)
-			if (domain.hasKVComment(x._key)) {
-				comment = domain.getKVComment(x._key);
-				stream.writeString(comment);
-			}
+			if (domain.hasKVComment(x._key))
+				out += domain.getKVComment(x._key);
+
 			// Write the key/value pair
-			stream.writeString(x._key);
-			stream.writeByte('=');
-			stream.writeString(x._value);
-			stream.writeByte('\n');
+			out += x._key;
+			out += '=';
+			out += x._value;
+			out += '\n';
 		}
 	}
-	stream.writeByte('\n');
+	out += '\n';
 }
 
 
@@ -805,7 +904,10 @@ bool ConfigManager::isKeyTemporary(const String &key) const {
 
 #pragma mark -
 
+uint32 ConfigManager::Domain::_lastRevision = 0;
+
 void ConfigManager::Domain::setDomainComment(const String &comment) {
+	touch();
 	_domainComment = comment;
 }
 const String &ConfigManager::Domain::getDomainComment() const {
@@ -813,6 +915,7 @@ const String &ConfigManager::Domain::getDomainComment() const {
 }
 
 void ConfigManager::Domain::setKVComment(const String &key, const String &comment) {
+	touch();
 	_keyValueComments[key] = comment;
 }
 const String &ConfigManager::Domain::getKVComment(const String &key) const {
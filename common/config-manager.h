@@ -29,6 +29,8 @@
 #include "common/str.h"
 #include "common/hash-str.h"
 
+class ConfigManagerTestSuite;
+
 namespace Common {
 
 /**
@@ -61,6 +63,10 @@ public:
 		StringMap _entries;
 		StringMap _keyValueComments;
 		String _domainComment;
+		uint32 _revision = 0;
+
+		static uint32 _lastRevision;
+		void touch() { _revision = ++_lastRevision; }
 
 	public:
 		typedef StringMap::const_iterator const_iterator;
@@ -79,10 +85,10 @@ public:
 		 */
 		const String &operator[](const String &key) const { return _entries[key]; }
 
-		void           setVal(const String &key, const String &value) { _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
+		void           setVal(const String &key, const String &value) { touch(); _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
 
-		String &getOrCreateVal(const String &key) { return _entries.getOrCreateVal(key); }
-		String        &getVal(const String &key) { return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
+		String &getOrCreateVal(const String &key) { touch(); return _entries.getOrCreateVal(key); }
+		String        &getVal(const String &key) { touch(); return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
 		const String  &getVal(const String &key) const { return _entries.getVal(key); } /*!< @overload */
 		 /**
 		  * Retrieve the value of @p key if it exists and leave the referenced variable unchanged if the key does not exist.
@@ -92,9 +98,9 @@ public:
 		const String &getValOrDefault(const String &key) const { return _entries.getValOrDefault(key); }
 		bool tryGetVal(const String &key, String &out) const { return _entries.tryGetVal(key, out); }
 
-		void           clear() { _entries.clear(); } /*!< Clear all configuration entries in the domain. */
+		void           clear() { touch(); _entries.clear(); } /*!< Clear all configuration entries in the domain. */
 
-		void           erase(const String &key) { _entries.erase(key); } /*!< Remove a key from the domain. */
+		void           erase(const String &key) { touch(); _entries.erase(key); } /*!< Remove a key from the domain. */
 
 		void           setDomainComment(const String &comment); /*!< Add a @p comment for this configuration domain. */
 		const String  &getDomainComment() const; /*!< Retrieve the comment of this configuration domain. */
@@ -102,6 +108,12 @@ public:
 		void           setKVComment(const String &key, const String &comment); /*!< Add a key-value @p comment to a @p key. */
 		const String  &getKVComment(const String &key) const; /*!< Retrieve the key-value comment of a @p key. */
 		bool           hasKVComment(const String &key) const; /*!< Check whether a @p key has a key-value comment. */
+
+		/**
+		 * Return a number that changes whenever the domain is modified.
+		 * Copies of a domain share its revision until either is modified.
+		 */
+		uint32         getRevision() const { return _revision; }
 	};
 
 	/** A hash map of existing configuration domains. */
@@ -200,7 +212,19 @@ public:
 	void                     registerDefault(const String &key, bool value); /*!< @overload */
 	void                     registerDefault(const String &key, const Path &value); /*!< @overload */
 
-	void                     flushToDisk(); /*!< Flush configuration to disk. */
+	/**
+	 * Flush configuration to disk. The file is only written if the
+	 * configuration changed since it was last loaded or flushed.
+	 */
+	void                     flushToDisk();
+
+	/**
+	 * Defer flushToDisk() until the matching endFlushBatch(). Batches can
+	 * be nested; the file is written once when the outermost batch ends,
+	 * and only if a flush was requested in between.
+	 */
+	void                     beginFlushBatch();
+	void                     endFlushBatch(); /*!< End a batch started with beginFlushBatch(). */
 
 	void                     setActiveDomain(const String &domName); /*!< Set the given domain as active. */
 	Domain                  *getActiveDomain() { return _activeDomain; } /*!< Get the active domain. */
@@ -231,12 +255,15 @@ public:
 	/** @} */
 private:
 	friend class Singleton<SingletonBaseType>;
+	friend class ::ConfigManagerTestSuite;
 	ConfigManager();
 
 	bool			loadFallbackConfigFile(const Path &filename);
 	bool			loadFromStream(SeekableReadStream &stream);
 	void			addDomain(const String &domainName, const Domain &domain);
-	void			writeDomain(WriteStream &stream, const String &name, const Domain &domain);
+	void			writeConfig(String &out);
+	void			appendDomain(String &out, const String &name, const Domain &domain);
+	void			writeDomain(String &out, const String &name, const Domain &domain);
 	void			renameDomain(const String &oldName, const String &newName, DomainMap &map);
 
 	Domain			_transientDomain;
@@ -259,6 +286,21 @@ private:
 	Domain *		_activeDomain;
 
 	Path			_filename;
+
+	// Serialized domains, reused by flushToDisk() while their revision
+	// is unchanged
+	struct CachedDomain {
+		uint32 revision = 0;
+		String text;
+	};
+	HashMap<String, CachedDomain> _domainCache;
+
+	// Text of the config file as last loaded or flushed, valid if
+	// _hasFlushed is set
+	String			_lastFlushed;
+	bool			_hasFlushed = false;
+	int				_flushBatchDepth = 0;
+	bool			_flushPending = false;
 };
 
 /** @} */
@@ -24,6 +24,7 @@
 #include "common/debug.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/memorypool.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -70,6 +71,61 @@ static void displayCoroStats() {
 } // End of anonymous namespace
 #endif
 
+namespace {
+
+/**
+ * Pools for the coroutine contexts, one for every multiple of
+ * kContextGranularity bytes up to kNumContextPools times that.
+ */
+class CoroContextPool {
+public:
+	enum {
+		kContextGranularity = 16,
+		kNumContextPools = 16
+	};
+
+	CoroContextPool() {
+		for (int i = 0; i < kNumContextPools; i++)
+			_pools[i] = new MemoryPool((i + 1) * kContextGranularity);
+	}
+
+	~CoroContextPool() {
+		for (int i = 0; i < kNumContextPools; i++)
+			delete _pools[i];
+	}
+
+	void *allocate(size_t size) {
+		const size_t pool = (size - 1) / kContextGranularity;
+		if (pool >= kNumContextPools)
+			return ::operator new(size);
+		return _pools[pool]->allocChunk();
+	}
+
+	void release(void *ptr, size_t size) {
+		const size_t pool = (size - 1) / kContextGranularity;
+		if (pool >= kNumContextPools)
+			::operator delete(ptr);
+		else
+			_pools[pool]->freeChunk(ptr);
+	}
+
+private:
+	MemoryPool *_pools[kNumContextPools];
+};
+
+static CoroContextPool s_contextPool;
+
+} // End of anonymous namespace
+
+void *CoroBaseContext::operator new(size_t size) {
+	return s_contextPool.allocate(size);
+}
+
+void CoroBaseContext::operator delete(void *ptr, size_t size) {
+	if (ptr)
+		s_contextPool.release(ptr, size);
+}
+
 CoroBaseContext::CoroBaseContext(const char *func)
 	: _line(0), _sleep(0), _subctx(nullptr) {
 #ifdef COROUTINE_DEBUG
@@ -106,6 +162,11 @@ CoroutineScheduler::CoroutineScheduler() {
 	pRCfunction = nullptr;
 	pidCounter = 0;
 
+	_wheelTime = 1;
+	_tick = 0;
+	_readyPos = 0;
+	_revisitCurrent = false;
+
 	active = new PROCESS;
 	active->pPrevious = nullptr;
 	active->pNext = nullptr;
@@ -163,6 +224,13 @@ void CoroutineScheduler::reset() {
 
 	// no active processes
 	pCurrent = active->pNext = nullptr;
+	active->order = 0;
+
+	// no sleeping or waiting processes
+	Common::fill(&_wheel[0], &_wheel[kWheelOverflow + 1], (PROCESS *)nullptr);
+	_ready.clear();
+	_readyPos = 0;
+	_revisitCurrent = false;
 
 	// place first process on free list
 	pFreeProcesses = processList;
@@ -216,33 +284,65 @@ void CoroutineScheduler::checkStack() {
 #endif
 
 void CoroutineScheduler::schedule() {
-	// start dispatching active process list
-	PROCESS *pNext;
-	PROCESS *pProc = active->pNext;
-	while (pProc != nullptr) {
-		pNext = pProc->pNext;
-
-		if (--pProc->sleepTime <= 0) {
-			// process is ready for dispatch, activate it
-			pCurrent = pProc;
-			pProc->coroAddr(pProc->state, pProc->param);
-
-			if (!pProc->state || pProc->state->_sleep <= 0) {
-				// Coroutine finished
-				pCurrent = pCurrent->pPrevious;
-				killProcess(pProc);
-			} else {
-				pProc->sleepTime = pProc->state->_sleep;
-			}
+	_tick = _wheelTime++;
+
+	// Move processes which are sleeping long enough to reach the current
+	// cycle down the wheel, starting with the highest level
+	if ((_tick & ((1 << (kWheelBits * kWheelLevels)) - 1)) == 0)
+		cascadeTimers(kWheelOverflow);
+	for (int level = kWheelLevels - 1; level > 0; level--) {
+		if ((_tick & ((1 << (kWheelBits * level)) - 1)) == 0)
+			cascadeTimers(level * kWheelSlots + ((_tick >> (kWheelBits * level)) & (kWheelSlots - 1)));
+	}
 
-			// pCurrent may have been changed
-			pNext = pCurrent->pNext;
-			pCurrent = nullptr;
+	// Collect the processes due in this cycle, in the order of the active list
+	assert(_ready.empty());
+	PROCESS *pDue = _wheel[_tick & (kWheelSlots - 1)];
+	_wheel[_tick & (kWheelSlots - 1)] = nullptr;
+	for (; pDue != nullptr; pDue = pDue->pWheelNext) {
+		pDue->wheelSlot = -1;
+		pDue->ready = true;
+		_ready.push_back(pDue);
+	}
+	Common::sort(_ready.begin(), _ready.end(), [](const PROCESS *a, const PROCESS *b) {
+		return a->order < b->order;
+	});
+
+	// start dispatching the due processes
+	for (_readyPos = 0; _readyPos < _ready.size(); ) {
+		PROCESS *pProc = _ready[_readyPos++];
+		if (!pProc)
+			continue;
+
+		// process is ready for dispatch, activate it
+		pProc->ready = false;
+		pCurrent = pProc;
+		_revisitCurrent = false;
+
+		// getMicros() is not recorded by the event recorder, unlike getMillis()
+		const uint64 startTime = g_system->getMicros();
+		pProc->coroAddr(pProc->state, pProc->param);
+		pProc->runTime += g_system->getMicros() - startTime;
+		pProc->runCount++;
+
+		if (!pProc->state || pProc->state->_sleep <= 0) {
+			// Coroutine finished
+			pCurrent = pCurrent->pPrevious;
+			killProcess(pProc);
+		} else {
+			pProc->wakeTick = _tick + pProc->state->_sleep;
+			if (_revisitCurrent)
+				revisit(pProc);
+			else
+				insertTimer(pProc);
 		}
 
-		pProc = pNext;
+		pCurrent = nullptr;
 	}
 
+	_ready.clear();
+	_readyPos = 0;
+
 	// Disable any events that were pulsed
 	for (auto &event : _events) {
 		if (event->pulsing) {
@@ -251,19 +351,146 @@ void CoroutineScheduler::schedule() {
 	}
 }
 
+void CoroutineScheduler::insertTimer(PROCESS *pProc) {
+	assert(pProc->wheelSlot == -1 && !pProc->ready);
+
+	const uint32 delta = pProc->wakeTick - _wheelTime;
+	assert((int32)delta >= 0);
+
+	int slot = kWheelOverflow;
+	for (int level = 0; level < kWheelLevels; level++) {
+		if (delta < (1U << (kWheelBits * (level + 1)))) {
+			slot = level * kWheelSlots + ((pProc->wakeTick >> (kWheelBits * level)) & (kWheelSlots - 1));
+			break;
+		}
+	}
+
+	pProc->wheelSlot = slot;
+	pProc->pWheelPrevious = nullptr;
+	pProc->pWheelNext = _wheel[slot];
+	if (_wheel[slot])
+		_wheel[slot]->pWheelPrevious = pProc;
+	_wheel[slot] = pProc;
+}
+
+void CoroutineScheduler::removeTimer(PROCESS *pProc) {
+	if (pProc->wheelSlot == -1)
+		return;
+
+	if (pProc->pWheelPrevious)
+		pProc->pWheelPrevious->pWheelNext = pProc->pWheelNext;
+	else
+		_wheel[pProc->wheelSlot] = pProc->pWheelNext;
+	if (pProc->pWheelNext)
+		pProc->pWheelNext->pWheelPrevious = pProc->pWheelPrevious;
+
+	pProc->wheelSlot = -1;
+	pProc->pWheelNext = pProc->pWheelPrevious = nullptr;
+}
+
+void CoroutineScheduler::cascadeTimers(int slot) {
+	// _wheelTime already points to the next cycle, reinsert relative to the current one
+	const uint32 wheelTime = _wheelTime;
+	_wheelTime = _tick;
+
+	PROCESS *pProc = _wheel[slot];
+	_wheel[slot] = nullptr;
+	while (pProc != nullptr) {
+		PROCESS *pNext = pProc->pWheelNext;
+		pProc->wheelSlot = -1;
+		insertTimer(pProc);
+		pProc = pNext;
+	}
+
+	_wheelTime = wheelTime;
+}
+
+void CoroutineScheduler::addReady(PROCESS *pProc) {
+	assert(pProc->wheelSlot == -1 && !pProc->ready);
+
+	// Processes which have not been run yet are sorted by their order
+	uint pos = _ready.size();
+	while (pos > _readyPos && (!_ready[pos - 1] || _ready[pos - 1]->order > pProc->order))
+		pos--;
+	_ready.insert_at(pos, pProc);
+	pProc->ready = true;
+}
+
+void CoroutineScheduler::removeReady(PROCESS *pProc) {
+	if (!pProc->ready)
+		return;
+
+	for (uint i = _readyPos; i < _ready.size(); i++) {
+		if (_ready[i] == pProc)
+			_ready[i] = nullptr;
+	}
+	pProc->ready = false;
+}
+
+void CoroutineScheduler::revisit(PROCESS *pProc) {
+	// The dispatcher visits this process a second time in this cycle, which
+	// counts as another cycle of its sleep
+	removeTimer(pProc);
+	if ((int32)(pProc->wakeTick - (_tick + 1)) <= 0) {
+		pProc->wakeTick = _tick;
+		addReady(pProc);
+	} else {
+		pProc->wakeTick--;
+		insertTimer(pProc);
+	}
+}
+
+void CoroutineScheduler::assignOrder(PROCESS *pProc) {
+	const uint32 kOrderGap = 1 << 16;
+
+	const uint32 prevOrder = pProc->pPrevious->order;
+	if (pProc->pNext == nullptr) {
+		if (prevOrder <= 0xFFFFFFFF - kOrderGap) {
+			pProc->order = prevOrder + kOrderGap;
+			return;
+		}
+	} else if (pProc->pNext->order - prevOrder >= 2) {
+		pProc->order = prevOrder + (pProc->pNext->order - prevOrder) / 2;
+		return;
+	}
+
+	renumber();
+}
+
+void CoroutineScheduler::renumber() {
+	// This keeps the relative order, so the ready list stays sorted
+	uint32 order = 0;
+	for (PROCESS *pProc = active->pNext; pProc != nullptr; pProc = pProc->pNext) {
+		order += 1 << 16;
+		pProc->order = order;
+	}
+}
+
+void CoroutineScheduler::unlinkProcess(PROCESS *pProc) {
+	pProc->pPrevious->pNext = pProc->pNext;
+	if (pProc->pNext)
+		pProc->pNext->pPrevious = pProc->pPrevious;
+}
+
 void CoroutineScheduler::rescheduleAll() {
 	assert(pCurrent);
 
+	// The dispatcher starts over after the current process, so all processes
+	// which have already been visited in this cycle are visited again
+	for (PROCESS *pProc = active->pNext; pProc != nullptr; pProc = pProc->pNext) {
+		if (pProc != pCurrent && pProc->order < pCurrent->order)
+			revisit(pProc);
+	}
+
 	// Unlink current process
-	pCurrent->pPrevious->pNext = pCurrent->pNext;
-	if (pCurrent->pNext)
-		pCurrent->pNext->pPrevious = pCurrent->pPrevious;
+	unlinkProcess(pCurrent);
 
 	// Add process to the start of the active list
 	pCurrent->pNext = active->pNext;
 	active->pNext->pPrevious = pCurrent;
 	active->pNext = pCurrent;
 	pCurrent->pPrevious = active;
+	assignOrder(pCurrent);
 }
 
 void CoroutineScheduler::reschedule(PPROCESS pReSchedProc) {
@@ -274,33 +501,37 @@ void CoroutineScheduler::reschedule(PPROCESS pReSchedProc) {
 	if (!pReSchedProc)
 		pReSchedProc = pCurrent;
 
-	PPROCESS pEnd;
-
-	// Find the last process in the list.
-	// But if the target process is down the list from here, do nothing
-	for (pEnd = pCurrent; pEnd->pNext != nullptr; pEnd = pEnd->pNext) {
-		if (pEnd->pNext == pReSchedProc)
-			return;
-	}
-
-	assert(pEnd->pNext == nullptr);
+	// If the target process is down the list from here, do nothing
+	if (pReSchedProc != pCurrent && pReSchedProc->order > pCurrent->order)
+		return;
 
 	// Could be in the middle of a KillProc()!
 	// Dying process was last and this process was penultimate
 	if (pReSchedProc->pNext == nullptr)
 		return;
 
+	// Find the last process in the list.
+	PPROCESS pEnd;
+	for (pEnd = pCurrent; pEnd->pNext != nullptr; pEnd = pEnd->pNext)
+		;
+
 	// If we're moving the current process, move it back by one, so that the next
 	// schedule() iteration moves to the now next one
-	if (pCurrent == pReSchedProc)
+	const bool visited = pReSchedProc != pCurrent;
+	if (pCurrent == pReSchedProc) {
 		pCurrent = pCurrent->pPrevious;
+		_revisitCurrent = true;
+	}
 
 	// Unlink the process, and add it at the end
-	pReSchedProc->pPrevious->pNext = pReSchedProc->pNext;
-	pReSchedProc->pNext->pPrevious = pReSchedProc->pPrevious;
+	unlinkProcess(pReSchedProc);
 	pEnd->pNext = pReSchedProc;
 	pReSchedProc->pPrevious = pEnd;
 	pReSchedProc->pNext = nullptr;
+	assignOrder(pReSchedProc);
+
+	if (visited)
+		revisit(pReSchedProc);
 }
 
 void CoroutineScheduler::giveWay(PPROCESS pReSchedProc) {
@@ -322,18 +553,30 @@ void CoroutineScheduler::giveWay(PPROCESS pReSchedProc) {
 		;
 	assert(pEnd->pNext == nullptr);
 
+	// A process which has already been visited in this cycle is visited again
+	const bool visited = pReSchedProc != pCurrent && pReSchedProc->order < pCurrent->order;
 
 	// If we're moving the current process, move it back by one, so that the next
 	// schedule() iteration moves to the now next one
-	if (pCurrent == pReSchedProc)
+	if (pCurrent == pReSchedProc) {
 		pCurrent = pCurrent->pPrevious;
+		_revisitCurrent = true;
+	}
 
 	// Unlink the process, and add it at the end
-	pReSchedProc->pPrevious->pNext = pReSchedProc->pNext;
-	pReSchedProc->pNext->pPrevious = pReSchedProc->pPrevious;
+	unlinkProcess(pReSchedProc);
 	pEnd->pNext = pReSchedProc;
 	pReSchedProc->pPrevious = pEnd;
 	pReSchedProc->pNext = nullptr;
+	assignOrder(pReSchedProc);
+
+	if (visited) {
+		revisit(pReSchedProc);
+	} else if (pReSchedProc->ready) {
+		// Keep the ready list sorted
+		removeReady(pReSchedProc);
+		addReady(pReSchedProc);
+	}
 }
 
 void CoroutineScheduler::waitForSingleObject(CORO_PARAM, int pid, uint32 duration, bool *expired) {
@@ -521,6 +764,7 @@ PROCESS *CoroutineScheduler::createProcess(uint32 pid, CORO_ADDR coroAddr, const
 		active->pNext = pProc;
 
 	}
+	assignOrder(pProc);
 
 	// set coroutine entry point
 	pProc->coroAddr = coroAddr;
@@ -528,8 +772,21 @@ PROCESS *CoroutineScheduler::createProcess(uint32 pid, CORO_ADDR coroAddr, const
 	// clear coroutine state
 	pProc->state = nullptr;
 
-	// wake process up as soon as possible
-	pProc->sleepTime = 1;
+	// clear statistics
+	pProc->runCount = 0;
+	pProc->runTime = 0;
+
+	// wake process up as soon as possible, which is in the current cycle
+	// when it has been created by another process
+	pProc->wheelSlot = -1;
+	pProc->ready = false;
+	if (pCurrent != nullptr) {
+		pProc->wakeTick = _tick;
+		addReady(pProc);
+	} else {
+		pProc->wakeTick = _wheelTime;
+		insertTimer(pProc);
+	}
 
 	// set new process id
 	pProc->pid = pid;
@@ -575,10 +832,11 @@ void CoroutineScheduler::killProcess(PROCESS *pKillProc) {
 	delete pKillProc->state;
 	pKillProc->state = nullptr;
 
+	removeTimer(pKillProc);
+	removeReady(pKillProc);
+
 	// Take the process out of the active chain list
-	pKillProc->pPrevious->pNext = pKillProc->pNext;
-	if (pKillProc->pNext)
-		pKillProc->pNext->pPrevious = pKillProc->pPrevious;
+	unlinkProcess(pKillProc);
 
 	// link first free process after pProc
 	pKillProc->pNext = pFreeProcesses;
@@ -604,6 +862,28 @@ int CoroutineScheduler::getCurrentPID() const {
 	return pProc->pid;
 }
 
+const PROCESS *CoroutineScheduler::getNextProcess(const PROCESS *pProc) const {
+	return pProc ? pProc->pNext : active->pNext;
+}
+
+uint32 CoroutineScheduler::getSleepTime(const PROCESS *pProc) const {
+	if (pProc->ready)
+		return 0;
+
+	// Outside of schedule(), the next cycle is the first one
+	const uint32 tick = pCurrent ? _tick : _wheelTime - 1;
+	return (int32)(pProc->wakeTick - tick) > 0 ? pProc->wakeTick - tick : 0;
+}
+
+String CoroutineScheduler::listProcesses() const {
+	String result = "  PID      Sleep     Runs  Time (ms)\n";
+	for (const PROCESS *pProc = getNextProcess(); pProc; pProc = getNextProcess(pProc)) {
+		result += String::format("%5u  %9u  %7u  %9.3f\n", pProc->pid, getSleepTime(pProc),
+		                         pProc->runCount, pProc->runTime / 1000.0);
+	}
+	return result;
+}
+
 int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 	int numKilled = 0;
 	PROCESS *pProc, *pPrev; // process list pointers
@@ -624,6 +904,9 @@ int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 				delete pProc->state;
 				pProc->state = nullptr;
 
+				removeTimer(pProc);
+				removeReady(pProc);
+
 				// make prev point to next to unlink pProc
 				pPrev->pNext = pProc->pNext;
 				if (pProc->pNext)
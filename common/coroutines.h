@@ -24,8 +24,10 @@
 
 #include "common/scummsys.h"
 #include "common/util.h"    // for SCUMMVM_CURRENT_FUNCTION
+#include "common/array.h"
 #include "common/list.h"
 #include "common/singleton.h"
+#include "common/str.h"
 
 namespace Common {
 
@@ -67,6 +69,13 @@ struct CoroBaseContext {
 	 * Destructor for coroutine context.
 	 */
 	virtual ~CoroBaseContext();
+
+	/**
+	 * Contexts are created and destroyed at every coroutine invocation,
+	 * so small ones are allocated from pools instead of the heap.
+	 */
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
 };
 
 typedef CoroBaseContext *CoroContext;
@@ -304,7 +313,16 @@ struct PROCESS {
 	CoroContext state;      ///< State of the coroutine.
 	CORO_ADDR  coroAddr;    ///< Entry point of the coroutine.
 
-	int sleepTime;      ///< Number of scheduler cycles to sleep.
+	uint32 wakeTick;    ///< Scheduler cycle in which the process runs next.
+	uint32 order;       ///< Sort key of the process, increasing along the active list.
+	PROCESS *pWheelNext;        ///< Next process in the same timer wheel slot.
+	PROCESS *pWheelPrevious;    ///< Previous process in the same timer wheel slot.
+	int wheelSlot;      ///< Timer wheel slot holding the process, or -1.
+	bool ready;         ///< Whether the process is queued to run in the current cycle.
+
+	uint32 runCount;    ///< Number of times the process has been run.
+	uint64 runTime;     ///< Total time spent running the process, in microseconds.
+
 	uint32 pid;         ///< Process ID.
 	uint32 pidWaiting[CORO_MAX_PID_WAITING];    ///< Process ID(s) that the process is currently waiting on.
 #ifndef NO_CXX11_ALIGNAS
@@ -361,6 +379,36 @@ private:
 	/** Auto-incrementing process ID. */
 	int pidCounter;
 
+	/**
+	 * Sleeping processes are kept in a hierarchical timer wheel, so that a
+	 * scheduler cycle only visits the processes that are due. The first
+	 * level has one slot per cycle, every further level covers the whole
+	 * previous one per slot. Processes sleeping even longer are kept in
+	 * an overflow slot.
+	 */
+	enum {
+		kWheelBits = 6,
+		kWheelSlots = 1 << kWheelBits,
+		kWheelLevels = 3,
+		kWheelOverflow = kWheelLevels * kWheelSlots
+	};
+	PROCESS *_wheel[kWheelOverflow + 1];
+
+	/** Cycle which is run by the next call to schedule(). */
+	uint32 _wheelTime;
+
+	/** Cycle currently being run. */
+	uint32 _tick;
+
+	/** Processes to run in the current cycle, sorted by their order. */
+	Common::Array<PROCESS *> _ready;
+
+	/** Position of the next process to run in _ready. */
+	uint _readyPos;
+
+	/** Whether the current process has been moved, and is visited again in this cycle. */
+	bool _revisitCurrent;
+
 	/** Event list. */
 	Common::List<EVENT *> _events;
 
@@ -384,6 +432,16 @@ private:
 
 	PROCESS *getProcess(uint32 pid);
 	EVENT *getEvent(uint32 pid);
+
+	void insertTimer(PROCESS *pProc);
+	void removeTimer(PROCESS *pProc);
+	void cascadeTimers(int slot);
+	void addReady(PROCESS *pProc);
+	void removeReady(PROCESS *pProc);
+	void revisit(PROCESS *pProc);
+	void assignOrder(PROCESS *pProc);
+	void renumber();
+	void unlinkProcess(PROCESS *pProc);
 public:
 	/**
 	 * Kill all processes and place them on the free list.
@@ -494,6 +552,25 @@ public:
 	 */
 	int getCurrentPID() const;
 
+	/**
+	 * Iterate over the active processes, in the order they are run.
+	 *
+	 * @param pProc         The previous process, or nullptr to get the first one.
+	 * @return      The next process, or nullptr when there are no more.
+	 */
+	const PROCESS *getNextProcess(const PROCESS *pProc = nullptr) const;
+
+	/**
+	 * Return the number of scheduler cycles until the given process runs again.
+	 */
+	uint32 getSleepTime(const PROCESS *pProc) const;
+
+	/**
+	 * Return a table of the active processes, in the order they are run,
+	 * with their sleep time and counters. Meant for debugger consoles.
+	 */
+	String listProcesses() const;
+
 	/**
 	 * Kill any process matching the specified PID. The current
 	 * process cannot be killed.
@@ -26,6 +26,7 @@ MODULE_OBJS := \
 	osd_message_queue.o \
 	path.o \
 	platform.o \
+	profiler.o \
 	punycode.o \
 	random.o \
 	rational.o \
@@ -38,6 +39,7 @@ MODULE_OBJS := \
 	str-enc.o \
 	encodings/singlebyte.o \
 	system.o \
+	task-scheduler.o \
 	textconsole.o \
 	text-to-speech.o \
 	tokenizer.o \
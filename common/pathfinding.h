@@ -0,0 +1,506 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_PATHFINDING_H
+#define COMMON_PATHFINDING_H
+
+#include "common/scummsys.h"
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/rect.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_pathfinding Path finding
+ * @ingroup common
+ *
+ * @brief A* over graphs and grids, and jump point search over grids.
+ *
+ * The searches keep their per-node state between queries. A generation
+ * counter tells which nodes were touched by the current query, so nothing
+ * has to be cleared or allocated when the same finder is used again on a
+ * map of the same size.
+ * @{
+ */
+
+/**
+ * State of the nodes of a search, with the open set as a binary heap.
+ */
+template<typename Cost>
+class SearchArena {
+public:
+	SearchArena() : _generation(0), _expanded(0) {}
+
+	/** Starts a new query over nodes 0 to size - 1. */
+	void reset(uint32 size) {
+		if (_nodes.size() < size)
+			_nodes.resize(size);
+		_heap.clear();
+		_expanded = 0;
+
+		if (++_generation == 0) {
+			for (uint32 i = 0; i < _nodes.size(); i++)
+				_nodes[i].generation = 0;
+			_generation = 1;
+		}
+	}
+
+	/**
+	 * Adds a node to the open set, or lowers its cost if it is already open.
+	 * Does nothing if the node was already reached with a lower cost.
+	 */
+	void open(uint32 node, uint32 parent, Cost g, Cost h) {
+		Node &n = _nodes[node];
+		if (n.generation == _generation) {
+			if (g >= n.g)
+				return;
+			n.g = g;
+			n.f = g + h;
+			n.parent = parent;
+			if (n.heapIndex == kClosed) {
+				// Only happens with an inconsistent heuristic
+				n.heapIndex = _heap.size();
+				_heap.push_back(node);
+			}
+			siftUp(n.heapIndex);
+			return;
+		}
+
+		n.generation = _generation;
+		n.g = g;
+		n.f = g + h;
+		n.parent = parent;
+		n.heapIndex = _heap.size();
+		_heap.push_back(node);
+		siftUp(n.heapIndex);
+	}
+
+	bool empty() const { return _heap.empty(); }
+
+	/** Removes the open node with the lowest estimated total cost, and closes it. */
+	uint32 pop() {
+		const uint32 node = _heap[0];
+		_nodes[node].heapIndex = kClosed;
+		const uint32 last = _heap.back();
+		_heap.pop_back();
+		if (!_heap.empty()) {
+			place(0, last);
+			siftDown(0);
+		}
+		_expanded++;
+		return node;
+	}
+
+	bool isReached(uint32 node) const { return _nodes[node].generation == _generation; }
+	bool isClosed(uint32 node) const { return isReached(node) && _nodes[node].heapIndex == kClosed; }
+
+	/** Cost from the start to a reached node. */
+	Cost getCost(uint32 node) const { return _nodes[node].g; }
+	/** Node a reached node was reached from. The start is its own parent. */
+	uint32 getParent(uint32 node) const { return _nodes[node].parent; }
+
+	/** Nodes expanded by the current query. */
+	uint32 getExpanded() const { return _expanded; }
+
+private:
+	static const int32 kClosed = -1;
+
+	struct Node {
+		uint32 generation;
+		uint32 parent;
+		int32 heapIndex;
+		Cost g, f;
+	};
+
+	Array<Node> _nodes;
+	Array<uint32> _heap;
+	uint32 _generation;
+	uint32 _expanded;
+
+	void place(uint32 pos, uint32 node) {
+		_heap[pos] = node;
+		_nodes[node].heapIndex = pos;
+	}
+
+	void siftUp(uint32 pos) {
+		const uint32 node = _heap[pos];
+		const Cost f = _nodes[node].f;
+		while (pos > 0) {
+			const uint32 parent = (pos - 1) / 2;
+			if (_nodes[_heap[parent]].f <= f)
+				break;
+			place(pos, _heap[parent]);
+			pos = parent;
+		}
+		place(pos, node);
+	}
+
+	void siftDown(uint32 pos) {
+		const uint32 node = _heap[pos];
+		const Cost f = _nodes[node].f;
+		const uint32 size = _heap.size();
+		while (2 * pos + 1 < size) {
+			uint32 child = 2 * pos + 1;
+			if (child + 1 < size && _nodes[_heap[child + 1]].f < _nodes[_heap[child]].f)
+				child++;
+			if (f <= _nodes[_heap[child]].f)
+				break;
+			place(pos, _heap[child]);
+			pos = child;
+		}
+		place(pos, node);
+	}
+};
+
+/**
+ * A* search over a graph.
+ *
+ * The graph type must provide:
+ * - uint32 size() const: the number of nodes.
+ * - Cost estimate(uint32 from, uint32 to) const: a lower bound of the cost
+ *   between two nodes. Returning 0 turns the search into Dijkstra's.
+ * - template<class Visitor> void visitNeighbors(uint32 node, Visitor &visit) const:
+ *   calls visit(neighbor, cost) for every edge leaving node.
+ */
+template<typename Cost>
+class PathFinder {
+public:
+	PathFinder() : _pathCost(0) {}
+
+	/**
+	 * Finds the cheapest path between two nodes. On success, path holds the
+	 * nodes from start to goal, both included.
+	 */
+	template<class Graph>
+	bool findPath(const Graph &graph, uint32 start, uint32 goal, Array<uint32> &path) {
+		path.clear();
+		_arena.reset(graph.size());
+		_arena.open(start, start, 0, graph.estimate(start, goal));
+
+		while (!_arena.empty()) {
+			const uint32 node = _arena.pop();
+			if (node == goal) {
+				_pathCost = _arena.getCost(goal);
+				tracePath(start, goal, path);
+				return true;
+			}
+
+			const Cost g = _arena.getCost(node);
+			auto visit = [&](uint32 neighbor, Cost cost) {
+				if (!_arena.isClosed(neighbor))
+					_arena.open(neighbor, node, g + cost, graph.estimate(neighbor, goal));
+			};
+			graph.visitNeighbors(node, visit);
+		}
+
+		return false;
+	}
+
+	/** Cost of the last path found. */
+	Cost getPathCost() const { return _pathCost; }
+	/** Nodes expanded by the last query, to compare searches. */
+	uint32 getExpanded() const { return _arena.getExpanded(); }
+
+protected:
+	SearchArena<Cost> _arena;
+	Cost _pathCost;
+
+	void tracePath(uint32 start, uint32 goal, Array<uint32> &path) const {
+		for (uint32 node = goal; node != start; node = _arena.getParent(node))
+			path.push_back(node);
+		path.push_back(start);
+		for (uint32 i = 0, j = path.size() - 1; i < j; i++, j--)
+			SWAP(path[i], path[j]);
+	}
+};
+
+/**
+ * Path finding over a grid of walkable cells.
+ *
+ * Moves go to the 8 neighboring cells. Straight moves cost 1 and diagonal
+ * moves cost sqrt(2). A diagonal move is only allowed when both cells it
+ * passes between are walkable, so paths never cut corners.
+ *
+ * The map type must provide int getWidth() const, int getHeight() const and
+ * bool isWalkable(int x, int y) const. isWalkable() is only called with
+ * coordinates inside the map.
+ */
+class GridPathFinder : public PathFinder<float> {
+public:
+	enum Method {
+		kAStar,           ///< Plain A*, the path holds every cell
+		kJumpPointSearch  ///< Jump point search, the path only holds the turning points
+	};
+
+	/**
+	 * Finds the shortest path between two cells. Consecutive points of the
+	 * path are always on a straight or diagonal line.
+	 */
+	template<class Map>
+	bool findPath(const Map &map, const Point &start, const Point &goal, Array<Point> &path, Method method = kJumpPointSearch) {
+		path.clear();
+		if (!isOpen(map, start.x, start.y) || !isOpen(map, goal.x, goal.y))
+			return false;
+
+		const int width = map.getWidth();
+		const uint32 startNode = start.y * width + start.x;
+		const uint32 goalNode = goal.y * width + goal.x;
+
+		Array<uint32> &nodes = _nodePath;
+		bool found;
+		if (method == kAStar) {
+			GridGraph<Map> graph(map);
+			found = PathFinder<float>::findPath(graph, startNode, goalNode, nodes);
+		} else {
+			found = jumpPointSearch(map, startNode, goalNode, nodes);
+		}
+
+		if (!found)
+			return false;
+
+		path.reserve(nodes.size());
+		for (uint32 i = 0; i < nodes.size(); i++)
+			path.push_back(Point(nodes[i] % width, nodes[i] / width));
+		return true;
+	}
+
+	/** Lower bound of the cost between two cells. */
+	static float octileDistance(int x1, int y1, int x2, int y2) {
+		const int dx = ABS(x1 - x2);
+		const int dy = ABS(y1 - y2);
+		return (dx > dy) ? (dx - dy) + dy * kDiagonalCost : (dy - dx) + dx * kDiagonalCost;
+	}
+
+private:
+	static constexpr float kDiagonalCost = 1.41421356f;
+
+	Array<uint32> _nodePath;
+
+	template<class Map>
+	static bool isOpen(const Map &map, int x, int y) {
+		return x >= 0 && y >= 0 && x < map.getWidth() && y < map.getHeight() && map.isWalkable(x, y);
+	}
+
+	template<class Map>
+	class GridGraph {
+	public:
+		GridGraph(const Map &map) : _map(map), _width(map.getWidth()) {}
+
+		uint32 size() const { return _width * _map.getHeight(); }
+
+		float estimate(uint32 from, uint32 to) const {
+			return octileDistance(from % _width, from / _width, to % _width, to / _width);
+		}
+
+		template<class Visitor>
+		void visitNeighbors(uint32 node, Visitor &visit) const {
+			const int x = node % _width;
+			const int y = node / _width;
+			const bool left = isOpen(_map, x - 1, y);
+			const bool right = isOpen(_map, x + 1, y);
+			const bool up = isOpen(_map, x, y - 1);
+			const bool down = isOpen(_map, x, y + 1);
+
+			if (left)
+				visit(node - 1, 1.0f);
+			if (right)
+				visit(node + 1, 1.0f);
+			if (up)
+				visit(node - _width, 1.0f);
+			if (down)
+				visit(node + _width, 1.0f);
+			if (left && up && _map.isWalkable(x - 1, y - 1))
+				visit(node - _width - 1, kDiagonalCost);
+			if (right && up && _map.isWalkable(x + 1, y - 1))
+				visit(node - _width + 1, kDiagonalCost);
+			if (left && down && _map.isWalkable(x - 1, y + 1))
+				visit(node + _width - 1, kDiagonalCost);
+			if (right && down && _map.isWalkable(x + 1, y + 1))
+				visit(node + _width + 1, kDiagonalCost);
+		}
+
+	private:
+		const Map &_map;
+		const int _width;
+	};
+
+	/**
+	 * Follows a straight line from (x, y) until a cell with a forced
+	 * neighbor, the goal, or a wall. Returns false if a wall is hit first.
+	 */
+	template<class Map>
+	static bool jumpStraight(const Map &map, int &x, int &y, int dx, int dy, const Point &goal) {
+		for (;;) {
+			if (!isOpen(map, x, y))
+				return false;
+			if (x == goal.x && y == goal.y)
+				return true;
+
+			if (dx != 0) {
+				if ((isOpen(map, x, y - 1) && !isOpen(map, x - dx, y - 1)) ||
+				    (isOpen(map, x, y + 1) && !isOpen(map, x - dx, y + 1)))
+					return true;
+			} else {
+				if ((isOpen(map, x - 1, y) && !isOpen(map, x - 1, y - dy)) ||
+				    (isOpen(map, x + 1, y) && !isOpen(map, x + 1, y - dy)))
+					return true;
+			}
+
+			x += dx;
+			y += dy;
+		}
+	}
+
+	/**
+	 * Follows a diagonal from (x, y) until a cell from which a straight
+	 * jump finds a jump point, or the goal. The cell the jump starts from
+	 * must have been reached by a valid diagonal move.
+	 */
+	template<class Map>
+	static bool jumpDiagonal(const Map &map, int &x, int &y, int dx, int dy, const Point &goal) {
+		for (;;) {
+			if (!isOpen(map, x, y))
+				return false;
+			if (x == goal.x && y == goal.y)
+				return true;
+
+			int jx = x + dx, jy = y;
+			if (jumpStraight(map, jx, jy, dx, 0, goal))
+				return true;
+			jx = x;
+			jy = y + dy;
+			if (jumpStraight(map, jx, jy, 0, dy, goal))
+				return true;
+
+			if (!isOpen(map, x + dx, y) || !isOpen(map, x, y + dy))
+				return false;
+			x += dx;
+			y += dy;
+		}
+	}
+
+	template<class Map>
+	void jumpFrom(const Map &map, uint32 node, int x, int y, int dx, int dy, const Point &goal) {
+		int jx = x + dx, jy = y + dy;
+		const bool found = (dx != 0 && dy != 0) ? jumpDiagonal(map, jx, jy, dx, dy, goal) : jumpStraight(map, jx, jy, dx, dy, goal);
+		if (!found)
+			return;
+
+		const uint32 jumpNode = jy * map.getWidth() + jx;
+		if (_arena.isClosed(jumpNode))
+			return;
+		const float g = _arena.getCost(node) + octileDistance(x, y, jx, jy);
+		_arena.open(jumpNode, node, g, octileDistance(jx, jy, goal.x, goal.y));
+	}
+
+	template<class Map>
+	bool jumpPointSearch(const Map &map, uint32 start, uint32 goal, Array<uint32> &path) {
+		const int width = map.getWidth();
+		const Point goalPoint(goal % width, goal / width);
+
+		path.clear();
+		_arena.reset(width * map.getHeight());
+		_arena.open(start, start, 0, octileDistance(start % width, start / width, goalPoint.x, goalPoint.y));
+
+		while (!_arena.empty()) {
+			const uint32 node = _arena.pop();
+			if (node == goal) {
+				_pathCost = _arena.getCost(goal);
+				tracePath(start, goal, path);
+				return true;
+			}
+
+			const int x = node % width;
+			const int y = node / width;
+
+			if (node == start) {
+				for (int dy = -1; dy <= 1; dy++) {
+					for (int dx = -1; dx <= 1; dx++) {
+						if ((dx == 0 && dy == 0) || !isOpen(map, x + dx, y + dy))
+							continue;
+						if (dx != 0 && dy != 0 && (!isOpen(map, x + dx, y) || !isOpen(map, x, y + dy)))
+							continue;
+						jumpFrom(map, node, x, y, dx, dy, goalPoint);
+					}
+				}
+				continue;
+			}
+
+			// Only the directions that can't be reached more cheaply without going through this node
+			const uint32 parent = _arena.getParent(node);
+			const int px = parent % width;
+			const int py = parent / width;
+			const int dx = (x > px) - (x < px);
+			const int dy = (y > py) - (y < py);
+
+			if (dx != 0 && dy != 0) {
+				const bool vertical = isOpen(map, x, y + dy);
+				const bool horizontal = isOpen(map, x + dx, y);
+				if (vertical)
+					jumpFrom(map, node, x, y, 0, dy, goalPoint);
+				if (horizontal)
+					jumpFrom(map, node, x, y, dx, 0, goalPoint);
+				if (vertical && horizontal)
+					jumpFrom(map, node, x, y, dx, dy, goalPoint);
+			} else if (dx != 0) {
+				const bool next = isOpen(map, x + dx, y);
+				const bool above = isOpen(map, x, y - 1);
+				const bool below = isOpen(map, x, y + 1);
+				if (next) {
+					jumpFrom(map, node, x, y, dx, 0, goalPoint);
+					if (above)
+						jumpFrom(map, node, x, y, dx, -1, goalPoint);
+					if (below)
+						jumpFrom(map, node, x, y, dx, 1, goalPoint);
+				}
+				if (above)
+					jumpFrom(map, node, x, y, 0, -1, goalPoint);
+				if (below)
+					jumpFrom(map, node, x, y, 0, 1, goalPoint);
+			} else {
+				const bool next = isOpen(map, x, y + dy);
+				const bool left = isOpen(map, x - 1, y);
+				const bool right = isOpen(map, x + 1, y);
+				if (next) {
+					jumpFrom(map, node, x, y, 0, dy, goalPoint);
+					if (left)
+						jumpFrom(map, node, x, y, -1, dy, goalPoint);
+					if (right)
+						jumpFrom(map, node, x, y, 1, dy, goalPoint);
+				}
+				if (left)
+					jumpFrom(map, node, x, y, -1, 0, goalPoint);
+				if (right)
+					jumpFrom(map, node, x, y, 1, 0, goalPoint);
+			}
+		}
+
+		return false;
+	}
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
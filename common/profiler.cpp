@@ -0,0 +1,164 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/profiler.h"
+#include "common/str.h"
+#include "common/stream.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(Profiler);
+
+bool Profiler::_enabled = false;
+
+Profiler::Profiler() : _currentFrame(0), _completeFrames(0), _frameNumber(0) {
+	// One more frame than kept, for the one being recorded
+	_frames.resize(kFrameCount + 1);
+	for (int i = 0; i < kTrackCount; i++)
+		_depth[i] = 0;
+}
+
+void Profiler::setEnabled(bool enabled) {
+	StackLock lock(_mutex);
+
+	if (enabled && !_enabled) {
+		_completeFrames = 0;
+		startFrame(g_system->getMicros());
+	}
+	_enabled = enabled;
+}
+
+void Profiler::startFrame(uint64 now) {
+	Frame &frame = _frames[_currentFrame];
+	frame.number = _frameNumber++;
+	frame.start = now;
+	frame.duration = 0;
+	// Keep the storage, it is needed again for every frame
+	frame.zones.resize(0);
+	frame.counters.resize(0);
+}
+
+void Profiler::endFrame() {
+	if (!_enabled)
+		return;
+
+	StackLock lock(_mutex);
+
+	const uint64 now = g_system->getMicros();
+	_frames[_currentFrame].duration = now - _frames[_currentFrame].start;
+
+	_currentFrame = (_currentFrame + 1) % _frames.size();
+	if (_completeFrames < kFrameCount)
+		_completeFrames++;
+	startFrame(now);
+}
+
+const Profiler::Frame &Profiler::getFrame(uint age) const {
+	assert(age < _completeFrames);
+	return _frames[(_currentFrame + _frames.size() - 1 - age) % _frames.size()];
+}
+
+void Profiler::leaveZone(const char *name, uint64 start, uint16 depth, Track track) {
+	const uint64 now = g_system->getMicros();
+	_depth[track] = depth;
+	if (!_enabled)
+		return;
+
+	Zone zone;
+	zone.name = name;
+	zone.start = start;
+	zone.duration = now - start;
+	zone.depth = depth;
+	zone.track = track;
+
+	StackLock lock(_mutex);
+	_frames[_currentFrame].zones.push_back(zone);
+}
+
+void Profiler::addToCounter(const char *name, int64 value) {
+	StackLock lock(_mutex);
+
+	Array<Counter> &counters = _frames[_currentFrame].counters;
+	for (uint i = 0; i < counters.size(); i++) {
+		// The same literal may have several addresses when it is used in several files
+		if (counters[i].name == name || !strcmp(counters[i].name, name)) {
+			counters[i].value += value;
+			return;
+		}
+	}
+
+	Counter counter;
+	counter.name = name;
+	counter.value = value;
+	counters.push_back(counter);
+}
+
+static String escapeJSON(const char *s) {
+	String result;
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\')
+			result += '\\';
+		if ((byte)*s < 0x20)
+			result += String::format("\\u%04x", (byte)*s);
+		else
+			result += *s;
+	}
+	return result;
+}
+
+bool Profiler::writeChromeTrace(WriteStream &stream) const {
+	static const char *const trackNames[kTrackCount] = { "Engine", "Audio" };
+
+	stream.writeString("{\"traceEvents\":[\n");
+	stream.writeString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Frames\"}}");
+	for (int track = 0; track < kTrackCount; track++)
+		stream.writeString(String::format(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", track + 1, trackNames[track]));
+
+	if (_completeFrames > 0) {
+		// Times are relative to the oldest frame, the trace viewers don't need the absolute values
+		const uint64 base = getFrame(_completeFrames - 1).start;
+
+		for (uint age = _completeFrames; age-- > 0;) {
+			const Frame &frame = getFrame(age);
+			stream.writeString(String::format(",\n{\"name\":\"Frame %u\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":0}",
+			                                  frame.number, (unsigned long long)(frame.start - base), frame.duration));
+
+			for (uint i = 0; i < frame.zones.size(); i++) {
+				const Zone &zone = frame.zones[i];
+				// Zones of the audio thread may have started before the oldest frame
+				const uint64 start = (zone.start > base) ? zone.start - base : 0;
+				stream.writeString(String::format(",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":%d}",
+				                                  escapeJSON(zone.name).c_str(), (unsigned long long)start, zone.duration, zone.track + 1));
+			}
+
+			for (uint i = 0; i < frame.counters.size(); i++) {
+				const Counter &counter = frame.counters[i];
+				stream.writeString(String::format(",\n{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%llu,\"pid\":1,\"args\":{\"value\":%lld}}",
+				                                  escapeJSON(counter.name).c_str(), (unsigned long long)(frame.start - base), (long long)counter.value));
+			}
+		}
+	}
+
+	stream.writeString("\n],\"displayTimeUnit\":\"ms\"}\n");
+	return !stream.err();
+}
+
+} // End of namespace Common
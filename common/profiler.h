@@ -0,0 +1,180 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_PROFILER_H
+#define COMMON_PROFILER_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_profiler Profiler
+ * @ingroup common
+ *
+ * @brief Records where the time of each frame goes.
+ * @{
+ */
+
+class WriteStream;
+
+/**
+ * Collects timed zones and counters, grouped by frame.
+ *
+ * Zones are marked with PROFILE_ZONE(), which times the rest of the
+ * enclosing block. Zones nest, and each thread records its own zones on a
+ * separate track. Counters are added up over a frame with PROFILE_COUNT().
+ *
+ * The backend ends a frame on each updateScreen() call. The last
+ * kFrameCount frames are kept, so they can be inspected or written out as
+ * a trace afterwards.
+ *
+ * Nothing is recorded, and the macros only test a flag, while the profiler
+ * is disabled.
+ */
+class Profiler : public Singleton<Profiler> {
+public:
+	/** Threads that record zones. */
+	enum Track {
+		kTrackMain,  ///< The engine thread
+		kTrackAudio, ///< The mixer callback
+		kTrackCount
+	};
+
+	enum {
+		kFrameCount = 240
+	};
+
+	struct Zone {
+		const char *name;
+		uint64 start;    ///< Microseconds, as returned by OSystem::getMicros()
+		uint32 duration; ///< Microseconds
+		uint16 depth;    ///< Number of zones the zone is nested in
+		uint16 track;
+	};
+
+	struct Counter {
+		const char *name;
+		int64 value;
+	};
+
+	struct Frame {
+		uint32 number;
+		uint64 start;
+		uint32 duration;
+		Array<Zone> zones;       ///< Ordered by end time, so nested zones come before the zone around them
+		Array<Counter> counters;
+	};
+
+	static bool isEnabled() { return _enabled; }
+
+	/** Starts or stops recording. Starting again drops the frames recorded before. */
+	void setEnabled(bool enabled);
+
+	/** Closes the current frame. Called by the backend after each screen update. */
+	void endFrame();
+
+	/** Number of complete frames kept. */
+	uint getFrameCount() const { return _completeFrames; }
+
+	/** A complete frame. 0 is the most recent one. */
+	const Frame &getFrame(uint age) const;
+
+	/** Called by ProfilerZone, use PROFILE_ZONE() instead. */
+	uint16 enterZone(Track track) { return _depth[track]++; }
+	void leaveZone(const char *name, uint64 start, uint16 depth, Track track);
+
+	/** Adds value to a counter of the current frame. Use PROFILE_COUNT() instead. */
+	void addToCounter(const char *name, int64 value);
+
+	/**
+	 * Writes the complete frames in the Trace Event format, which can be
+	 * loaded by the Chrome tracing tools and Perfetto.
+	 */
+	bool writeChromeTrace(WriteStream &stream) const;
+
+private:
+	friend class Singleton<Profiler>;
+	Profiler();
+
+	static bool _enabled;
+
+	Mutex _mutex;
+	Array<Frame> _frames;
+	uint _currentFrame;
+	uint _completeFrames;
+	uint32 _frameNumber;
+	uint16 _depth[kTrackCount];
+
+	void startFrame(uint64 now);
+};
+
+/**
+ * Times the rest of the block it is declared in.
+ */
+class ProfilerZone {
+public:
+	ProfilerZone(const char *name, Profiler::Track track = Profiler::kTrackMain) : _active(Profiler::isEnabled()) {
+		if (_active) {
+			_name = name;
+			_track = track;
+			_depth = Profiler::instance().enterZone(track);
+			_start = g_system->getMicros();
+		}
+	}
+
+	~ProfilerZone() {
+		if (_active)
+			Profiler::instance().leaveZone(_name, _start, _depth, _track);
+	}
+
+private:
+	bool _active;
+	const char *_name;
+	Profiler::Track _track;
+	uint16 _depth;
+	uint64 _start;
+};
+
+#define PROFILER_CONCAT2(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT2(a, b)
+
+/** Times the rest of the enclosing block. name must be a string literal. */
+#define PROFILE_ZONE(name) Common::ProfilerZone PROFILER_CONCAT(profilerZone, __LINE__)(name)
+
+/** Same as PROFILE_ZONE(), for code running on another thread than the engine. */
+#define PROFILE_ZONE_ON(name, track) Common::ProfilerZone PROFILER_CONCAT(profilerZone, __LINE__)(name, track)
+
+/** Adds value to a counter of the current frame. name must be a string literal. */
+#define PROFILE_COUNT(name, value) \
+	do { \
+		if (Common::Profiler::isEnabled()) \
+			Common::Profiler::instance().addToCounter(name, value); \
+	} while (0)
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
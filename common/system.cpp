@@ -28,6 +28,7 @@
 #include "common/savefile.h"
 #include "common/str.h"
 #include "common/taskbar.h"
+#include "common/task-scheduler.h"
 #include "common/updates.h"
 #include "common/dialogs.h"
 #include "common/rotationmode.h"
@@ -47,6 +48,7 @@ OSystem::OSystem() {
 	_eventManager = nullptr;
 	_timerManager = nullptr;
 	_savefileManager = nullptr;
+	_taskScheduler = nullptr;
 #if defined(USE_TASKBAR)
 	_taskbarManager = nullptr;
 #endif
@@ -63,6 +65,11 @@ OSystem::OSystem() {
 }
 
 OSystem::~OSystem() {
+	// Delete the task scheduler first, so its worker threads are joined
+	// before anything they might use goes away
+	delete _taskScheduler;
+	_taskScheduler = nullptr;
+
 	delete _audiocdManager;
 	_audiocdManager = nullptr;
 
@@ -112,6 +119,9 @@ void OSystem::initBackend() {
 	if (!_savefileManager)
 		error("Backend failed to instantiate savefile manager");
 
+	if (!_taskScheduler)
+		_taskScheduler = new Common::TaskScheduler();
+
 	// TODO: We currently don't check _fsFactory because not all ports
 	// set it.
 // 	if (!_fsFactory)
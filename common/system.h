@@ -59,6 +59,7 @@ struct Rect;
 class SaveFileManager;
 class SearchSet;
 class String;
+class TaskScheduler;
 #if defined(USE_TASKBAR)
 class TaskbarManager;
 #endif
@@ -219,6 +220,15 @@ protected:
 	 */
 	Common::SaveFileManager *_savefileManager;
 
+	/**
+	 * No default value is provided for _taskScheduler by OSystem.
+	 * However, OSystem::initBackend() does set a default value, which runs
+	 * all tasks synchronously, if none has been set before.
+	 *
+	 * @note _taskScheduler is deleted by the OSystem destructor.
+	 */
+	Common::TaskScheduler *_taskScheduler;
+
 #if defined(USE_TASKBAR)
 	/**
 	 * No default value is provided for _taskbarManager by OSystem.
@@ -1549,6 +1559,15 @@ public:
 	 */
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get the number of microseconds since an arbitrary point in time.
+	 *
+	 * This is meant for measuring short durations, and is never recorded
+	 * by the event recorder. Backends without a precise timer fall back to
+	 * getMillis().
+	 */
+	virtual uint64 getMicros() { return (uint64)getMillis(true) * 1000; }
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1567,6 +1586,15 @@ public:
 	 */
 	virtual Common::TimerManager *getTimerManager();
 
+	/**
+	 * Return the task scheduler singleton.
+	 *
+	 * For more information, see @ref TaskScheduler.
+	 */
+	inline Common::TaskScheduler *getTaskScheduler() {
+		return _taskScheduler;
+	}
+
 	/**
 	 * Return the event manager singleton.
 	 *
@@ -0,0 +1,259 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/task-scheduler.h"
+#include "common/array.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+/**
+ * Shared state of a submitted task. All fields are protected by the
+ * scheduler lock.
+ */
+struct TaskState {
+	Task *task;
+	DisposeAfterUse::Flag disposeAfterUse;
+	uint refCount;
+	bool done;
+};
+
+TaskFuture::TaskFuture(TaskScheduler *scheduler, TaskState *state) : _scheduler(scheduler), _state(state) {
+}
+
+TaskFuture::TaskFuture(const TaskFuture &other) : _scheduler(other._scheduler), _state(other._state) {
+	if (_state)
+		_scheduler->retain(_state);
+}
+
+TaskFuture::~TaskFuture() {
+	if (_state)
+		_scheduler->release(_state);
+}
+
+TaskFuture &TaskFuture::operator=(const TaskFuture &other) {
+	if (other._state)
+		other._scheduler->retain(other._state);
+	if (_state)
+		_scheduler->release(_state);
+
+	_scheduler = other._scheduler;
+	_state = other._state;
+	return *this;
+}
+
+bool TaskFuture::isDone() const {
+	return !_state || _scheduler->isDone(_state);
+}
+
+void TaskFuture::wait() const {
+	if (_state)
+		_scheduler->wait(_state);
+}
+
+
+#pragma mark -
+
+
+TaskScheduler::TaskScheduler() : _stopping(false) {
+}
+
+TaskScheduler::~TaskScheduler() {
+	// Backends stop and join their workers before we get here, and those
+	// drain the queue. Anything left was never picked up by a thread.
+	while (!_queue.empty()) {
+		TaskState *state = _queue.pop();
+		runTask(state);
+		state->done = true;
+		releaseLocked(state);
+	}
+}
+
+TaskFuture TaskScheduler::submit(Task *task, DisposeAfterUse::Flag disposeAfterUse) {
+	assert(task);
+
+	TaskState *state = new TaskState();
+	state->task = task;
+	state->disposeAfterUse = disposeAfterUse;
+	state->refCount = 1;
+	state->done = false;
+
+	if (getWorkerCount() == 0) {
+		runTask(state);
+		state->done = true;
+		return TaskFuture(this, state);
+	}
+
+	lock();
+	// One reference for the queue, one for the returned future
+	state->refCount++;
+	_queue.push(state);
+	signalAll();
+	unlock();
+
+	return TaskFuture(this, state);
+}
+
+void TaskScheduler::runWorker() {
+	lock();
+	for (;;) {
+		while (_queue.empty() && !_stopping)
+			waitForSignal();
+
+		if (_queue.empty())
+			break;
+
+		runNextLocked();
+	}
+	unlock();
+}
+
+void TaskScheduler::stopWorkers() {
+	lock();
+	_stopping = true;
+	signalAll();
+	unlock();
+}
+
+void TaskScheduler::runNextLocked() {
+	TaskState *state = _queue.pop();
+
+	unlock();
+	runTask(state);
+	lock();
+
+	state->done = true;
+	releaseLocked(state);
+	signalAll();
+}
+
+void TaskScheduler::runTask(TaskState *state) {
+	state->task->run();
+
+	if (state->disposeAfterUse == DisposeAfterUse::YES)
+		delete state->task;
+	state->task = nullptr;
+}
+
+void TaskScheduler::retain(TaskState *state) {
+	lock();
+	state->refCount++;
+	unlock();
+}
+
+void TaskScheduler::release(TaskState *state) {
+	lock();
+	releaseLocked(state);
+	unlock();
+}
+
+void TaskScheduler::releaseLocked(TaskState *state) {
+	assert(state->refCount > 0);
+	if (--state->refCount == 0)
+		delete state;
+}
+
+bool TaskScheduler::isDone(TaskState *state) {
+	lock();
+	bool done = state->done;
+	unlock();
+	return done;
+}
+
+void TaskScheduler::wait(TaskState *state) {
+	lock();
+	while (!state->done) {
+		// Help out instead of idling. This also keeps nested waits from
+		// deadlocking when every worker is blocked inside a task.
+		if (!_queue.empty())
+			runNextLocked();
+		else
+			waitForSignal();
+	}
+	unlock();
+}
+
+class TaskScheduler::ParallelForChunk : public Task {
+public:
+	ParallelForChunk() : _body(nullptr), _first(0), _last(0) {}
+
+	void set(ParallelForBody *body, uint first, uint last) {
+		_body = body;
+		_first = first;
+		_last = last;
+	}
+
+	void run() override {
+		_body->run(_first, _last);
+	}
+
+private:
+	ParallelForBody *_body;
+	uint _first, _last;
+};
+
+void TaskScheduler::runParallelFor(uint begin, uint end, uint grainSize, ParallelForBody &body) {
+	if (begin >= end)
+		return;
+
+	const uint count = end - begin;
+	if (grainSize < 1)
+		grainSize = 1;
+
+	uint chunks = MIN<uint>((count + grainSize - 1) / grainSize, getWorkerCount() + 1);
+	if (chunks <= 1) {
+		body.run(begin, end);
+		return;
+	}
+
+	const uint step = count / chunks;
+	uint extra = count % chunks;
+
+	Array<ParallelForChunk> tasks;
+	Array<TaskFuture> futures;
+	tasks.resize(chunks - 1);
+	futures.reserve(chunks - 1);
+
+	// The first chunk is left for the calling thread
+	uint first = begin;
+	uint last = first + step + (extra ? 1 : 0);
+	if (extra)
+		extra--;
+	const uint callerLast = last;
+
+	for (uint i = 0; i < chunks - 1; i++) {
+		first = last;
+		last = first + step + (extra ? 1 : 0);
+		if (extra)
+			extra--;
+
+		tasks[i].set(&body, first, last);
+		futures.push_back(submit(&tasks[i], DisposeAfterUse::NO));
+	}
+	assert(last == end);
+
+	body.run(begin, callerLast);
+
+	for (uint i = 0; i < futures.size(); i++)
+		futures[i].wait();
+}
+
+} // End of namespace Common
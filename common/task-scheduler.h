@@ -0,0 +1,209 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_TASK_SCHEDULER_H
+#define COMMON_TASK_SCHEDULER_H
+
+#include "common/scummsys.h"
+#include "common/queue.h"
+#include "common/types.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_task_scheduler Task scheduler
+ * @ingroup common
+ *
+ * @brief API for running CPU heavy work on other cores.
+ *
+ * The task scheduler is obtained through OSystem::getTaskScheduler().
+ * Backends that can spawn threads provide a scheduler with a pool of
+ * worker threads. On all other ports, the default scheduler runs every
+ * task synchronously on the calling thread, so code using it does not
+ * need a separate single-threaded path.
+ *
+ * Tasks may run concurrently with the rest of ScummVM. They should only
+ * work on data they own, and must not call into OSystem, engines or
+ * other code that is not safe to use from several threads at once.
+ * @{
+ */
+
+/**
+ * A unit of work that can be run by a TaskScheduler.
+ */
+class Task {
+public:
+	virtual ~Task() {}
+
+	/** Do the work. Called exactly once, possibly on a worker thread. */
+	virtual void run() = 0;
+};
+
+class TaskScheduler;
+struct TaskState;
+
+/**
+ * Handle to a task submitted to a TaskScheduler.
+ *
+ * Futures can be freely copied; the task state stays alive as long as
+ * any future refers to it. Futures must not outlive their scheduler.
+ */
+class TaskFuture {
+public:
+	TaskFuture() : _scheduler(nullptr), _state(nullptr) {}
+	TaskFuture(const TaskFuture &other);
+	~TaskFuture();
+
+	TaskFuture &operator=(const TaskFuture &other);
+
+	/** Return true if this future refers to a submitted task. */
+	bool isValid() const { return _state != nullptr; }
+
+	/** Return true if the task has finished running. */
+	bool isDone() const;
+
+	/**
+	 * Block until the task has finished running.
+	 *
+	 * While waiting, the calling thread helps running queued tasks, so
+	 * it is safe to wait from within another task.
+	 */
+	void wait() const;
+
+private:
+	friend class TaskScheduler;
+
+	TaskFuture(TaskScheduler *scheduler, TaskState *state);
+
+	TaskScheduler *_scheduler;
+	TaskState *_state;
+};
+
+/**
+ * Runs tasks on worker threads, or synchronously if the backend has none.
+ *
+ * This base class implements the queue and all bookkeeping. Backends only
+ * override the locking primitives and start threads which call runWorker().
+ */
+class TaskScheduler {
+public:
+	TaskScheduler();
+	virtual ~TaskScheduler();
+
+	/**
+	 * Return the number of worker threads. If this is 0, every task is run
+	 * synchronously by submit().
+	 */
+	virtual uint getWorkerCount() const { return 0; }
+
+	/**
+	 * Queue a task for execution.
+	 *
+	 * @param task             The task to run.
+	 * @param disposeAfterUse  Whether to delete the task once it has run. If
+	 *                         set, the task is deleted on the thread that ran it.
+	 * @return A future to wait on the task.
+	 */
+	TaskFuture submit(Task *task, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
+	/**
+	 * Call func(first, last) on disjoint sub-ranges covering [begin, end),
+	 * spread over the worker threads and the calling thread. Returns once
+	 * all sub-ranges have been processed.
+	 *
+	 * @param begin      First index of the range.
+	 * @param end        One past the last index of the range.
+	 * @param grainSize  Minimum number of indices per sub-range.
+	 * @param func       Callable taking (uint first, uint last).
+	 */
+	template<class F>
+	void parallelFor(uint begin, uint end, uint grainSize, F func) {
+		ParallelForFunc<F> body(func);
+		runParallelFor(begin, end, grainSize, body);
+	}
+
+protected:
+	/** Acquire the lock protecting the scheduler state. */
+	virtual void lock() {}
+	/** Release the lock protecting the scheduler state. */
+	virtual void unlock() {}
+	/**
+	 * Release the lock, sleep until signalAll() is called, and reacquire
+	 * the lock before returning. Only called with the lock held.
+	 */
+	virtual void waitForSignal() {}
+	/** Wake up all threads sleeping in waitForSignal(). */
+	virtual void signalAll() {}
+
+	/**
+	 * Run queued tasks until stopWorkers() is called and the queue is
+	 * empty. This is the body of every worker thread.
+	 */
+	void runWorker();
+
+	/**
+	 * Make all worker threads return from runWorker() once the queue is
+	 * drained. Backends must call this, and join their threads, in their
+	 * destructor.
+	 */
+	void stopWorkers();
+
+private:
+	friend class TaskFuture;
+
+	class ParallelForBody {
+	public:
+		virtual ~ParallelForBody() {}
+		virtual void run(uint first, uint last) = 0;
+	};
+
+	template<class F>
+	class ParallelForFunc : public ParallelForBody {
+	public:
+		ParallelForFunc(F &func) : _func(func) {}
+		void run(uint first, uint last) override { _func(first, last); }
+	private:
+		F &_func;
+	};
+
+	class ParallelForChunk;
+
+	void runParallelFor(uint begin, uint end, uint grainSize, ParallelForBody &body);
+
+	void retain(TaskState *state);
+	void release(TaskState *state);
+	void releaseLocked(TaskState *state);
+	bool isDone(TaskState *state);
+	void wait(TaskState *state);
+
+	/** Pop and run one queued task. Called with the lock held. */
+	void runNextLocked();
+	static void runTask(TaskState *state);
+
+	Queue<TaskState *> _queue;
+	bool _stopping;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
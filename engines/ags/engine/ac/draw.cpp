@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/profiler.h"
 #include "common/std/algorithm.h"
 #include "ags/lib/aastr-0.1.1/aastr.h"
 #include "ags/shared/core/platform.h"
@@ -2241,21 +2242,27 @@ void render_graphics(IDriverDependantBitmap *extraBitmap, int extraX, int extraY
 	if ((_G(in_new_room) > 0) && (_GP(game).color_depth > 1))
 		return;
 
-	// TODO: find out if it's okay to move shake to update function
-	update_shakescreen();
-
-	construct_game_scene(false);
-	set_our_eip(5);
-	// TODO: extraBitmap is a hack, used to place an additional gui element
-	// on top of the screen. Normally this should be a part of the game UI stage.
-	if (extraBitmap != nullptr) {
-		_G(gfxDriver)->BeginSpriteBatch(_GP(play).GetMainViewport(), _GP(play).GetGlobalTransform(_G(drawstate).FullFrameRedraw),
-										(GraphicFlip)_GP(play).screen_flipped);
-		invalidate_sprite(extraX, extraY, extraBitmap, false);
-		_G(gfxDriver)->DrawSprite(extraX, extraY, extraBitmap);
-		_G(gfxDriver)->EndSpriteBatch();
+	// The screen update in render_to_screen() ends the profiler frame, so
+	// the zone is closed before it
+	{
+		PROFILE_ZONE("AGS render");
+
+		// TODO: find out if it's okay to move shake to update function
+		update_shakescreen();
+
+		construct_game_scene(false);
+		set_our_eip(5);
+		// TODO: extraBitmap is a hack, used to place an additional gui element
+		// on top of the screen. Normally this should be a part of the game UI stage.
+		if (extraBitmap != nullptr) {
+			_G(gfxDriver)->BeginSpriteBatch(_GP(play).GetMainViewport(), _GP(play).GetGlobalTransform(_G(drawstate).FullFrameRedraw),
+											(GraphicFlip)_GP(play).screen_flipped);
+			invalidate_sprite(extraX, extraY, extraBitmap, false);
+			_G(gfxDriver)->DrawSprite(extraX, extraY, extraBitmap);
+			_G(gfxDriver)->EndSpriteBatch();
+		}
+		construct_game_screen_overlay(true);
 	}
-	construct_game_screen_overlay(true);
 	render_to_screen();
 
 	if (!SHOULD_QUIT && !_GP(play).screen_is_faded_out) {
@@ -21,6 +21,7 @@
 
 #include "ags/engine/gfx/gfxfilter_scummvm_renderer.h"
 #include "ags/engine/gfx/ali_3d_scummvm.h"
+#include "common/profiler.h"
 #include "common/std/algorithm.h"
 #include "ags/engine/ac/sys_events.h"
 #include "ags/engine/gfx/gfxfilter_scummvm_renderer.h"
@@ -632,7 +633,10 @@ void ScummVMRendererGraphicsDriver::Present(int xoff, int yoff, Shared::GraphicF
 }
 
 void ScummVMRendererGraphicsDriver::Render(int xoff, int yoff, GraphicFlip flip) {
-	RenderToBackBuffer();
+	{
+		PROFILE_ZONE("AGS draw sprites");
+		RenderToBackBuffer();
+	}
 	Present(xoff, yoff, flip);
 }
 
@@ -23,6 +23,7 @@
 // Game loop
 //
 
+#include "common/profiler.h"
 #include "common/std/limits.h"
 #include "ags/engine/ac/button.h"
 #include "ags/shared/ac/common.h"
@@ -108,6 +109,8 @@ static void game_loop_check_problems_at_start() {
 
 // Runs rep-exec
 static void game_loop_do_early_script_update() {
+	PROFILE_ZONE("AGS scripts");
+
 	if (_G(in_new_room) == 0) {
 		// Run the room and game script repeatedly_execute
 		run_function_on_non_blocking_thread(&_GP(repExecAlways));
@@ -118,6 +121,8 @@ static void game_loop_do_early_script_update() {
 
 // Runs late-rep-exec
 static void game_loop_do_late_script_update() {
+	PROFILE_ZONE("AGS late scripts");
+
 	if (_G(in_new_room) == 0) {
 		// Run the room and game script late_repeatedly_execute
 		run_function_on_non_blocking_thread(&_GP(lateRepExecAlways));
@@ -593,6 +598,8 @@ static void game_loop_check_controls(bool checkControls) {
 }
 
 static void game_loop_do_update() {
+	PROFILE_ZONE("AGS game update");
+
 	if (_G(debug_flags) & DBG_NOUPDATE);
 	else if (_G(game_paused) == 0) update_stuff();
 }
@@ -782,7 +789,6 @@ void set_loop_counter(unsigned int new_counter) {
 }
 
 void UpdateGameOnce(bool checkControls, IDriverDependantBitmap *extraBitmap, int extraX, int extraY) {
-
 	int res;
 
 	sys_evt_process_pending();
@@ -860,8 +866,9 @@ void UpdateGameOnce(bool checkControls, IDriverDependantBitmap *extraBitmap, int
 	update_audio_system_on_game_loop();
 
 	// Only render if we are not skipping a cutscene
-	if (!_GP(play).fast_forward)
+	if (!_GP(play).fast_forward) {
 		render_graphics(extraBitmap, extraX, extraY);
+	}
 
 	set_our_eip(6);
 
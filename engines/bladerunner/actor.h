@@ -180,6 +180,7 @@ public:
 	int getWalkbox() const { return _walkboxId; }
 
 	bool isRetired() const { return _isRetired; }
+	bool isInvisible() const { return _isInvisible; }
 	bool isTarget() const { return _isTarget; }
 	void setTarget(bool targetable);
 	bool isImmuneToObstacles() const { return _isImmuneToObstacles; }
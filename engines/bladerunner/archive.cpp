@@ -47,6 +47,7 @@ bool MIXArchive::open(const Common::Path &filename) {
 		return false;
 	}
 
+	_path  = filename;
 	_isTLK = filename.baseName().hasSuffix(".TLK");
 
 	_entryCount = _fd.readUint16LE();
@@ -140,7 +141,7 @@ uint32 MIXArchive::indexForHash(int32 hash) const {
 	return _entryCount;
 }
 
-Common::SeekableReadStream *MIXArchive::createReadStreamForMember(const Common::Path &name) {
+bool MIXArchive::findMember(const Common::Path &name, uint32 &start, uint32 &end) const {
 	int32 hash;
 
 	if (_isTLK) {
@@ -152,13 +153,36 @@ Common::SeekableReadStream *MIXArchive::createReadStreamForMember(const Common::
 	uint32 i = indexForHash(hash);
 
 	if (i == _entryCount) {
-		return nullptr;
+		return false;
 	}
 
-	uint32 start = _entries[i].offset + 6 + 12 * _entryCount;
-	uint32 end   = _entries[i].length + start;
+	start = _entries[i].offset + 6 + 12 * _entryCount;
+	end   = _entries[i].length + start;
+	return true;
+}
+
+Common::SeekableReadStream *MIXArchive::createReadStreamForMember(const Common::Path &name) {
+	uint32 start, end;
+	if (!findMember(name, start, end)) {
+		return nullptr;
+	}
 
 	return new Common::SafeSeekableSubReadStream(&_fd, start, end, DisposeAfterUse::NO);
 }
 
+Common::SeekableReadStream *MIXArchive::createIndependentReadStreamForMember(const Common::Path &name) {
+	uint32 start, end;
+	if (!findMember(name, start, end)) {
+		return nullptr;
+	}
+
+	Common::File *fd = new Common::File();
+	if (!fd->open(_path)) {
+		delete fd;
+		return nullptr;
+	}
+
+	return new Common::SafeSeekableSubReadStream(fd, start, end, DisposeAfterUse::YES);
+}
+
 } // End of namespace BladeRunner
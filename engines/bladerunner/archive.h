@@ -43,8 +43,11 @@ public:
 	Common::String getName() const { return _fd.getName(); }
 
 	Common::SeekableReadStream *createReadStreamForMember(const Common::Path &name);
+	// Opens the archive again for the returned stream, so it doesn't share its file handle
+	Common::SeekableReadStream *createIndependentReadStreamForMember(const Common::Path &name);
 
 private:
+	Common::Path _path;
 	Common::File _fd;
 	bool _isTLK;
 
@@ -60,6 +63,7 @@ private:
 	Common::Array<ArchiveEntry> _entries;
 
 	uint32 indexForHash(int32 hash) const;
+	bool findMember(const Common::Path &name, uint32 &start, uint32 &end) const;
 };
 
 
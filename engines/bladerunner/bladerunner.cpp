@@ -133,6 +133,7 @@ BladeRunnerEngine::BladeRunnerEngine(OSystem *syst, const ADGameDescription *des
 	_cutContent                   = Common::String(desc->gameId).contains("bladerunner-final");
 	_enhancedEdition              = Common::String(desc->gameId).contains("bladerunner-ee");
 	_validBootParam               = false;
+	_vqaPrefetchDepth             = 8;
 
 	_playerLosesControlCounter = 0;
 	_extraCPos = 0;
@@ -2550,6 +2551,38 @@ Common::SeekableReadStream *BladeRunnerEngine::getResourceStream(const Common::S
 	return nullptr;
 }
 
+// Like getResourceStream(), but the stream gets its own file handle, so that it
+// can be read from another thread while the other resources are being used
+Common::SeekableReadStream *BladeRunnerEngine::getIndependentResourceStream(const Common::String &name) {
+	Common::Path path(name);
+	if (Common::File::exists(path)) {
+		Common::File *directFile = new Common::File();
+		if (directFile->open(path)) {
+			return directFile;
+		}
+		delete directFile;
+		return nullptr;
+	}
+
+	// The members of the enhanced edition archive can't be opened separately
+	if (_enhancedEdition) {
+		return nullptr;
+	}
+
+	for (int i = 0; i != kArchiveCount; ++i) {
+		if (!_archives[i].isOpen()) {
+			continue;
+		}
+
+		Common::SeekableReadStream *stream = _archives[i].createIndependentReadStreamForMember(path);
+		if (stream) {
+			return stream;
+		}
+	}
+
+	return nullptr;
+}
+
 bool BladeRunnerEngine::playerHasControl() {
 	return _playerLosesControlCounter == 0;
 }
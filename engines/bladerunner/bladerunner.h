@@ -245,6 +245,7 @@ public:
 	bool _cutContent;
 	bool _enhancedEdition;
 	bool _validBootParam;
+	int  _vqaPrefetchDepth; // Number of VQA frames read ahead on a worker thread, 0 to disable
 
 	int _walkSoundId;
 	int _walkSoundVolume;
@@ -428,6 +429,7 @@ public:
 	void setSubtitlesEnabled(bool newVal);
 
 	Common::SeekableReadStream *getResourceStream(const Common::String &name);
+	Common::SeekableReadStream *getIndependentResourceStream(const Common::String &name);
 
 	bool playerHasControl();
 	void playerLosesControl();
@@ -45,12 +45,14 @@
 #include "bladerunner/settings.h"
 #include "bladerunner/set.h"
 #include "bladerunner/set_effects.h"
+#include "bladerunner/slice_renderer.h"
 #include "bladerunner/text_resource.h"
 #include "bladerunner/time.h"
 #include "bladerunner/vector.h"
 #include "bladerunner/view.h"
 #include "bladerunner/vqa_decoder.h"
 #include "bladerunner/vqa_player.h"
+#include "bladerunner/vqa_prefetcher.h"
 #include "bladerunner/waypoints.h"
 #include "bladerunner/zbuffer.h"
 #include "bladerunner/chapters.h"
@@ -150,6 +152,8 @@ Debugger::Debugger(BladeRunnerEngine *vm) : GUI::Debugger() {
 #else
 	registerCmd("effect", WRAP_METHOD(Debugger, cmdEffect));
 #endif // BLADERUNNER_ORIGINAL_BUGS
+	registerCmd("benchactors", WRAP_METHOD(Debugger, cmdBenchActors));
+	registerCmd("vqaprefetch", WRAP_METHOD(Debugger, cmdVqaPrefetch));
 }
 
 Debugger::~Debugger() {
@@ -3331,4 +3335,106 @@ bool Debugger::cmdCheatReport(int argc, const char** argv) {
 	return true;
 }
 
+/**
+* Redraw the actors of the current set a number of times, once on a single
+* thread and once split into bands of lines, and show the time spent in each case.
+*/
+bool Debugger::cmdBenchActors(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Time the drawing of the actors in the current set.\n");
+		debugPrintf("Usage: %s [<frames>]\n", argv[0]);
+		return true;
+	}
+
+	int frameCount = argc == 2 ? atoi(argv[1]) : 100;
+	if (frameCount <= 0) {
+		debugPrintf("Invalid number of frames %i\n", frameCount);
+		return true;
+	}
+
+	int setId = _vm->_scene->getSetId();
+	int actorCount = 0;
+	for (int i = 0, end = _vm->_gameInfo->getActorCount(); i != end; ++i) {
+		if (_vm->_actors[i]->getSetId() == setId && !_vm->_actors[i]->isInvisible()) {
+			++actorCount;
+		}
+	}
+
+	if (actorCount == 0) {
+		debugPrintf("There are no visible actors in the current set\n");
+		return true;
+	}
+
+	bool useBands = _vm->_sliceRenderer->getUseBands();
+	uint32 drawTime[2] = { 0, 0 };
+
+	_vm->_sliceRenderer->setView(_vm->_view);
+	for (int pass = 0; pass < 2; ++pass) {
+		_vm->_sliceRenderer->setUseBands(pass == 1);
+		for (int frame = 0; frame < frameCount; ++frame) {
+			blit(_vm->_surfaceBack, _vm->_surfaceFront);
+
+			uint32 startTime = g_system->getMillis();
+			for (int i = 0, end = _vm->_gameInfo->getActorCount(); i != end; ++i) {
+				Actor *actor = _vm->_actors[i];
+				if (actor->getSetId() == setId && !actor->isInvisible()) {
+					Common::Rect screenRect;
+					if (actor->draw(&screenRect)) {
+						_vm->_zbuffer->mark(screenRect);
+					}
+				}
+			}
+			drawTime[pass] += g_system->getMillis() - startTime;
+
+			_vm->_zbuffer->clean();
+		}
+	}
+	_vm->_sliceRenderer->setUseBands(useBands);
+
+	debugPrintf("%d frames of %d actors: single thread %u ms, bands %u ms\n", frameCount, actorCount, drawTime[0], drawTime[1]);
+	return true;
+}
+
+/**
+* Show the statistics of the frames read ahead for the background of the
+* current scene, or set how many frames are read ahead for the videos opened from now on.
+*/
+bool Debugger::cmdVqaPrefetch(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Show the VQA prefetch statistics of the current scene, or set the prefetch depth (0 disables it).\n");
+		debugPrintf("Usage: %s [<depth>]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		int depth = atoi(argv[1]);
+		if (depth < 0) {
+			debugPrintf("Invalid depth %i\n", depth);
+			return true;
+		}
+		_vm->_vqaPrefetchDepth = depth;
+		debugPrintf("Prefetch depth set to %d, it will be used for the next videos\n", depth);
+		return true;
+	}
+
+	debugPrintf("Prefetch depth: %d\n", _vm->_vqaPrefetchDepth);
+
+	if (_vm->_scene == nullptr || _vm->_scene->_vqaPlayer == nullptr) {
+		debugPrintf("No scene video\n");
+		return true;
+	}
+
+	const VQAPrefetcher *prefetcher = _vm->_scene->_vqaPlayer->_decoder.getPrefetcher();
+	if (prefetcher == nullptr) {
+		debugPrintf("The scene video %s is not prefetched\n", _vm->_scene->_vqaPlayer->_name.c_str());
+		return true;
+	}
+
+	const VQAPrefetcher::Stats &stats = prefetcher->getStats();
+	debugPrintf("%s, %d frames ahead%s:\n", _vm->_scene->_vqaPlayer->_name.c_str(), prefetcher->getDepth(), prefetcher->isDecoding() ? ", decoded on the worker" : "");
+	debugPrintf("  %u frames ready, %u waited for, %u not prefetched\n", stats.hits, stats.waits, stats.misses);
+	debugPrintf("  %u bytes read ahead, %u ms spent waiting\n", stats.bytesRead, stats.waitTime);
+	return true;
+}
+
 } // End of namespace BladeRunner
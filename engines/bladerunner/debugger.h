@@ -143,6 +143,8 @@ public:
 #endif // BLADERUNNER_ORIGINAL_BUGS
 	bool cmdList(int argc, const char **argv);
 	bool cmdVk(int argc, const char **argv);
+	bool cmdBenchActors(int argc, const char **argv);
+	bool cmdVqaPrefetch(int argc, const char **argv);
 
 	Common::String getDifficultyDescription(int difficultyValue);
 	Common::String getAmmoTypeDescription(int ammoType); 
@@ -279,6 +279,7 @@ MODULE_OBJS = \
 	view.o \
 	vqa_decoder.o \
 	vqa_player.o \
+	vqa_prefetcher.o \
 	waypoints.o \
 	zbuffer.o
 
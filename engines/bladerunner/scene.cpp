@@ -117,6 +117,7 @@ bool Scene::open(int setId, int sceneId, bool isLoadingGame) {
 	}
 
 	_vqaPlayer = new VQAPlayer(_vm, &_vm->_surfaceBack, vqaName);
+	_vqaPlayer->decodeAhead(_vm->_zbuffer);
 
 	if (!_vm->_sceneScript->open(sceneName)) {
 		return false;
@@ -29,6 +29,8 @@
 
 #include "common/memstream.h"
 #include "common/rect.h"
+#include "common/system.h"
+#include "common/task-scheduler.h"
 #include "common/util.h"
 
 namespace BladeRunner {
@@ -58,8 +60,7 @@ SliceRenderer::SliceRenderer(BladeRunnerEngine *vm) {
 	_frameSliceCount   = 0;
 	_startSlice        = 0.0f;
 	_endSlice          = 0.0f;
-	_m13               = 0;
-	_m23               = 0;
+	_useBands          = true;
 
 	_shadowPolygonDefault[ 0] = Vector3( 16.0f,  96.0f, 0.0f);
 	_shadowPolygonDefault[ 1] = Vector3( 16.0f, 160.0f, 0.0f);
@@ -411,20 +412,10 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 		&setEffectsColorCoeficient,
 		&setEffectColor);
 
-	_lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
-	_lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
-	_lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
-
-	_setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
-	_setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
-	_setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
-
 	setupLookupTable(_m12lookup, sliceLineIterator._sliceMatrix(0, 1));
 	setupLookupTable(_m11lookup, sliceLineIterator._sliceMatrix(0, 0));
-	_m13 = sliceLineIterator._sliceMatrix(0, 2);
 	setupLookupTable(_m21lookup, sliceLineIterator._sliceMatrix(1, 0));
 	setupLookupTable(_m22lookup, sliceLineIterator._sliceMatrix(1, 1));
-	_m23 = sliceLineIterator._sliceMatrix(1, 2);
 
 	if (_animationsShadowEnabled[_animation]) {
 		float coeficientShadow;
@@ -440,13 +431,14 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 		drawShadowInWorld(transparency, surface, zbuffer);
 	}
 
-	int frameY = sliceLineIterator._startY;
+	// The lights and set effects are evaluated incrementally from one line to the
+	// next, so the colors of all lines are computed first and the lines are
+	// drawn afterwards, possibly in parallel.
+	_lines.resize(0);
 
-	uint16 *zBufferLinePtr = zbuffer + BladeRunnerEngine::kOriginalGameWidth * frameY;
+	int frameY = sliceLineIterator._startY;
 
 	while (sliceLineIterator._currentY <= sliceLineIterator._endY) {
-		_m13 = sliceLineIterator._sliceMatrix(0, 2);
-		_m23 = sliceLineIterator._sliceMatrix(1, 2);
 		sliceLine = sliceLineIterator.line();
 
 		sliceRendererLights.calculateColorSlice(Vector3(_position.x, _position.y, _position.z + _frameBottomZ + sliceLine * _frameSliceHeight));
@@ -459,21 +451,41 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 				&setEffectColor);
 		}
 
-		_lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
-		_lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
-		_lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
+		if (frameY >= 0 && frameY < surface.h) {
+			Line line;
+			line.y     = frameY;
+			line.slice = (int)sliceLine;
+			line.m13   = sliceLineIterator._sliceMatrix(0, 2);
+			line.m23   = sliceLineIterator._sliceMatrix(1, 2);
 
-		_setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
-		_setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
-		_setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
+			line.lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
+			line.lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
+			line.lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
 
-		if (frameY >= 0 && frameY < surface.h) {
-			drawSlice((int)sliceLine, true, frameY, surface, zBufferLinePtr);
+			line.setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
+			line.setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
+			line.setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
+
+			_lines.push_back(line);
 		}
 
 		sliceLineIterator.advance();
 		++frameY;
-		zBufferLinePtr += BladeRunnerEngine::kOriginalGameWidth;
+	}
+
+	// Every line is a different row of the surface and the z-buffer, so bands of lines can be drawn independently
+	if (_useBands && _lines.size() > (uint)kBandHeight) {
+		g_system->getTaskScheduler()->parallelFor(0, _lines.size(), kBandHeight, [&](uint first, uint last) {
+			drawLines(surface, zbuffer, first, last);
+		});
+	} else {
+		drawLines(surface, zbuffer, 0, _lines.size());
+	}
+}
+
+void SliceRenderer::drawLines(Graphics::Surface &surface, uint16 *zbuffer, uint first, uint last) const {
+	for (uint i = first; i < last; ++i) {
+		drawSlice(_lines[i], true, surface, zbuffer + BladeRunnerEngine::kOriginalGameWidth * _lines[i].y);
 	}
 }
 
@@ -514,10 +526,12 @@ void SliceRenderer::drawOnScreen(int animationId, int animationFrame, int screen
 
 	setupLookupTable(_m11lookup, m(0, 0));
 	setupLookupTable(_m12lookup, m(0, 1));
-	_m13 = m(0, 2);
 	setupLookupTable(_m21lookup, m(1, 0));
 	setupLookupTable(_m22lookup, m(1, 1));
-	_m23 = m(1, 2);
+
+	Line line;
+	line.m13 = m(0, 2);
+	line.m23 = m(1, 2);
 
 	int frameY = screenY + (size / 2.0f * frameHeight);
 	int currentY = frameY;
@@ -530,14 +544,19 @@ void SliceRenderer::drawOnScreen(int animationId, int animationFrame, int screen
 	while (currentSlice < _frameSliceCount) {
 		if (currentY >= 0 && currentY < surface.h) {
 			memset(lineZbuffer, 0xFF, BladeRunnerEngine::kOriginalGameWidth * 2);
-			drawSlice(currentSlice, false, currentY, surface, lineZbuffer);
+			line.y = currentY;
+			line.slice = (int)currentSlice;
+			drawSlice(line, false, surface, lineZbuffer);
 			currentSlice += sliceStep;
 			--currentY;
 		}
 	}
 }
 
-void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface &surface, uint16 *zbufferLine) {
+void SliceRenderer::drawSlice(const Line &line, bool advanced, Graphics::Surface &surface, uint16 *zbufferLine) const {
+	const int slice = line.slice;
+	const int y = line.y;
+
 	if (slice < 0 || (uint32)slice >= _frameSliceCount) {
 		return;
 	}
@@ -561,15 +580,15 @@ void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface
 			continue;
 
 		uint32 lastVertex = vertexCount - 1;
-		int lastVertexX = MAX((_m11lookup[p[3 * lastVertex]] + _m12lookup[p[3 * lastVertex + 1]] + _m13) / 65536, 0);
+		int lastVertexX = MAX((_m11lookup[p[3 * lastVertex]] + _m12lookup[p[3 * lastVertex + 1]] + line.m13) / 65536, 0);
 
 		int previousVertexX = lastVertexX;
 
 		while (vertexCount--) {
-			int vertexX = CLIP<int32>((_m11lookup[p[0]] + _m12lookup[p[1]] + _m13) / 65536, 0, BladeRunnerEngine::kOriginalGameWidth);
+			int vertexX = CLIP<int32>((_m11lookup[p[0]] + _m12lookup[p[1]] + line.m13) / 65536, 0, BladeRunnerEngine::kOriginalGameWidth);
 
 			if (vertexX > previousVertexX) {
-				int vertexZ = (_m21lookup[p[0]] + _m22lookup[p[1]] + _m23) / 64;
+				int vertexZ = (_m21lookup[p[0]] + _m22lookup[p[1]] + line.m23) / 64;
 
 				if (vertexZ >= 0 && vertexZ < 65536) {
 					uint32 outColor = palette.value[p[2]];
@@ -578,9 +597,9 @@ void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface
 						_screenEffects->getColor(&aescColor, vertexX, y, vertexZ);
 
 						Color256 color = palette.color[p[2]];
-						color.r = ((int)(_setEffectColor.r + _lightsColor.r * color.r) / 65536) + aescColor.r;
-						color.g = ((int)(_setEffectColor.g + _lightsColor.g * color.g) / 65536) + aescColor.g;
-						color.b = ((int)(_setEffectColor.b + _lightsColor.b * color.b) / 65536) + aescColor.b;
+						color.r = ((int)(line.setEffectColor.r + line.lightsColor.r * color.r) / 65536) + aescColor.r;
+						color.g = ((int)(line.setEffectColor.g + line.lightsColor.g * color.g) / 65536) + aescColor.g;
+						color.b = ((int)(line.setEffectColor.b + line.lightsColor.b * color.b) / 65536) + aescColor.b;
 						// We need to convert from 5 bits per channel (r,g,b) to 8 bits
 						outColor = _pixelFormat.RGBToColor(Color::get8BitColorFrom5Bit(color.r), Color::get8BitColorFrom5Bit(color.g), Color::get8BitColorFrom5Bit(color.b));
 					}
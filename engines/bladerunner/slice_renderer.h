@@ -27,6 +27,7 @@
 #include "bladerunner/view.h"
 #include "bladerunner/matrix.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 #include "graphics/surface.h"
@@ -43,6 +44,21 @@ class Lights;
 class SetEffects;
 
 class SliceRenderer {
+	/**
+	 * Everything needed to draw one screen line of a frame in the world,
+	 * computed before any of the lines is drawn
+	 */
+	struct Line {
+		int   y;
+		int   slice;
+		int   m13;
+		int   m23;
+		Color lightsColor;
+		Color setEffectColor;
+	};
+
+	static const int kBandHeight = 16;
+
 	BladeRunnerEngine *_vm;
 
 	int       _animation;
@@ -75,19 +91,17 @@ class SliceRenderer {
 
 	int _m11lookup[256];
 	int _m12lookup[256];
-	int _m13;
 	int _m21lookup[256];
 	int _m22lookup[256];
-	int _m23;
+
+	Common::Array<Line> _lines;
+	bool _useBands;
 
 	bool _animationsShadowEnabled[997];
 
 	Vector3 _shadowPolygonDefault[12];
 	Vector3 _shadowPolygonCurrent[12];
 
-	Color _setEffectColor;
-	Color _lightsColor;
-
 	Graphics::PixelFormat _pixelFormat;
 
 public:
@@ -108,12 +122,22 @@ public:
 
 	void disableShadows(int *animationsIdsList, int listSize);
 
+	/**
+	 * Sets whether the lines of frames drawn in the world are split into
+	 * bands of kBandHeight lines which are drawn concurrently. The result is
+	 * the same, as every band only touches its own lines of the surface and
+	 * the z-buffer.
+	 */
+	void setUseBands(bool useBands) { _useBands = useBands; }
+	bool getUseBands() const { return _useBands; }
+
 private:
 	void calculateBoundingRect();
 	Matrix3x2 calculateFacingRotationMatrix();
 	void loadFrame(int animation, int frame);
 
-	void drawSlice(int slice, bool advanced, int y, Graphics::Surface &surface, uint16 *zbufferLine);
+	void drawLines(Graphics::Surface &surface, uint16 *zbuffer, uint first, uint last) const;
+	void drawSlice(const Line &line, bool advanced, Graphics::Surface &surface, uint16 *zbufferLine) const;
 	void drawShadowInWorld(int transparency, Graphics::Surface &surface, uint16 *zbuffer);
 	void drawShadowPolygon(int transparency, Graphics::Surface &surface, uint16 *zbuffer);
 };
@@ -28,6 +28,7 @@
 #include "bladerunner/lights.h"
 #include "bladerunner/screen_effects.h"
 #include "bladerunner/view.h"
+#include "bladerunner/vqa_prefetcher.h"
 #include "bladerunner/zbuffer.h"
 
 #include "audio/decoders/raw.h"
@@ -112,6 +113,8 @@ VQADecoder::VQADecoder() {
 	_frameInfo           = nullptr;
 	_videoTrack          = nullptr;
 	_audioTrack          = nullptr;
+	_prefetcher          = nullptr;
+	_frameDecodedAhead   = false;
 	_maxVIEWChunkSize    = 0;
 	_maxZBUFChunkSize    = 0;
 	_maxAESCChunkSize    = 0;
@@ -152,6 +155,10 @@ VQADecoder::~VQADecoder() {
 }
 
 void VQADecoder::close() {
+	delete _prefetcher;
+	_prefetcher = nullptr;
+	_frameDecodedAhead = false;
+
 	for (uint i = _codebooks.size(); i != 0; --i) {
 		delete[] _codebooks[i - 1].data;
 	}
@@ -231,10 +238,18 @@ void VQADecoder::overrideOffsetXY(uint16 offX, uint16 offY) {
 
 void VQADecoder::decodeVideoFrame(Graphics::Surface *surface, int frame, bool forceDraw) {
 	_decodingFrame = frame;
+	if (_frameDecodedAhead) {
+		_prefetcher->copyFrame(surface);
+		return;
+	}
 	_videoTrack->decodeVideoFrame(surface, forceDraw);
 }
 
 void VQADecoder::decodeZBuffer(ZBuffer *zbuffer) {
+	if (_frameDecodedAhead) {
+		_prefetcher->copyZBuffer(zbuffer);
+		return;
+	}
 	_videoTrack->decodeZBuffer(zbuffer);
 }
 
@@ -254,34 +269,34 @@ void VQADecoder::decodeLights(Lights *lights) {
 	_videoTrack->decodeLights(lights);
 }
 
-void VQADecoder::readPacket(uint readFlags) {
+void VQADecoder::readPacket(Common::SeekableReadStream *s, uint readFlags) {
 	IFFChunkHeader chd;
 
-	if (remain(_s) < 8) {
-		warning("VQADecoder::readPacket(): remain: %d", remain(_s));
-		assert(remain(_s) < 8);
+	if (remain(s) < 8) {
+		warning("VQADecoder::readPacket(): remain: %d", remain(s));
+		assert(remain(s) < 8);
 	}
 
 	do {
-		if (!readIFFChunkHeader(_s, &chd)) {
+		if (!readIFFChunkHeader(s, &chd)) {
 			error("VQADecoder::readPacket(): Error reading chunk header");
 		}
 
 		bool rc = false;
 		// Video track
 		switch (chd.id) {
-		case kAESC: rc = ((readFlags & kVQAReadCustom) == 0) ? _s->skip(roundup(chd.size)) : _videoTrack->readAESC(_s, chd.size); break;
-		case kLITE: rc = ((readFlags & kVQAReadCustom) == 0) ? _s->skip(roundup(chd.size)) : _videoTrack->readLITE(_s, chd.size); break;
-		case kVIEW: rc = ((readFlags & kVQAReadCustom) == 0) ? _s->skip(roundup(chd.size)) : _videoTrack->readVIEW(_s, chd.size); break;
-		case kVQFL: rc = ((readFlags & kVQAReadVideo ) == 0) ? _s->skip(roundup(chd.size)) : _videoTrack->readVQFL(_s, chd.size, readFlags); break;
-		case kVQFR: rc = ((readFlags & kVQAReadVideo ) == 0) ? _s->skip(roundup(chd.size)) : _videoTrack->readVQFR(_s, chd.size, readFlags); break;
-		case kZBUF: rc = ((readFlags & kVQAReadCustom) == 0) ? _s->skip(roundup(chd.size)) : _videoTrack->readZBUF(_s, chd.size); break;
+		case kAESC: rc = ((readFlags & kVQAReadCustom) == 0) ? s->skip(roundup(chd.size)) : _videoTrack->readAESC(s, chd.size); break;
+		case kLITE: rc = ((readFlags & kVQAReadCustom) == 0) ? s->skip(roundup(chd.size)) : _videoTrack->readLITE(s, chd.size); break;
+		case kVIEW: rc = ((readFlags & kVQAReadCustom) == 0) ? s->skip(roundup(chd.size)) : _videoTrack->readVIEW(s, chd.size); break;
+		case kVQFL: rc = ((readFlags & kVQAReadVideo ) == 0) ? s->skip(roundup(chd.size)) : _videoTrack->readVQFL(s, chd.size, readFlags); break;
+		case kVQFR: rc = ((readFlags & kVQAReadVideo ) == 0) ? s->skip(roundup(chd.size)) : _videoTrack->readVQFR(s, chd.size, readFlags); break;
+		case kZBUF: rc = ((readFlags & kVQAReadCustom) == 0) ? s->skip(roundup(chd.size)) : _videoTrack->readZBUF(s, chd.size); break;
 		// Sound track
-		case kSN2J: rc = ((readFlags & kVQAReadAudio) == 0) ? _s->skip(roundup(chd.size)) : _audioTrack->readSN2J(_s, chd.size); break;
-		case kSND2: rc = ((readFlags & kVQAReadAudio) == 0) ? _s->skip(roundup(chd.size)) : _audioTrack->readSND2(_s, chd.size); break;
+		case kSN2J: rc = ((readFlags & kVQAReadAudio) == 0) ? s->skip(roundup(chd.size)) : _audioTrack->readSN2J(s, chd.size); break;
+		case kSND2: rc = ((readFlags & kVQAReadAudio) == 0) ? s->skip(roundup(chd.size)) : _audioTrack->readSND2(s, chd.size); break;
 		default:
 			rc = false;
-			_s->skip(roundup(chd.size));
+			s->skip(roundup(chd.size));
 		}
 
 		if (!rc) {
@@ -296,11 +311,75 @@ void VQADecoder::readFrame(int frame, uint readFlags) {
 		error("VQADecoder::readFrame(): frame %d out of bounds, frame count is %d", frame, numFrames());
 	}
 
+	_readingFrame = frame;
+
+	// Only sequential video reads are prefetched, audio is read further ahead and codebooks from earlier frames
+	if (_prefetcher && readFlags == kVQAReadVideo) {
+		_frameDecodedAhead = false;
+		Common::SeekableReadStream *packet = _prefetcher->takeFrame(frame);
+		if (packet) {
+			// The picture and the z-buffer are then taken from the prefetcher, only the rest is left to read
+			_frameDecodedAhead = _prefetcher->isDecoding();
+			readPacket(packet, _frameDecodedAhead ? (uint)kVQAReadCustom : readFlags);
+			delete packet;
+			return;
+		}
+	}
+
 	uint32 frameOffset = 2 * (_frameInfo[frame] & 0x0FFFFFFF);
 	_s->seek(frameOffset);
 
+	readPacket(_s, readFlags);
+}
+
+void VQADecoder::readFrame(int frame, Common::SeekableReadStream *packet, uint readFlags) {
 	_readingFrame = frame;
-	readPacket(readFlags);
+	readPacket(packet, readFlags);
+}
+
+void VQADecoder::startPrefetch(Common::SeekableReadStream *s, int depth, const Graphics::Surface *surface, const ZBuffer *zbuffer) {
+	delete _prefetcher;
+	_prefetcher = nullptr;
+
+	if (!_frameInfo) {
+		delete s;
+		return;
+	}
+
+	Common::Array<uint32> frameOffsets(numFrames() + 1);
+	for (int i = 0; i < numFrames(); ++i) {
+		frameOffsets[i] = 2 * (_frameInfo[i] & 0x0FFFFFFF);
+	}
+	frameOffsets[numFrames()] = s->size();
+
+	// The worker decodes with its own decoder, as it is a few frames ahead of this one
+	VQADecoder *decoder = nullptr;
+	if (surface && zbuffer && !_oldV2VQA) {
+		decoder = new VQADecoder();
+		if (s->seek(0) && decoder->loadStream(s)) {
+			decoder->overrideOffsetXY(offsetX(), offsetY());
+		} else {
+			delete decoder;
+			decoder = nullptr;
+		}
+	}
+
+	_prefetcher = new VQAPrefetcher(s, frameOffsets, depth);
+	if (decoder) {
+		_prefetcher->decodeAhead(decoder, surface, zbuffer);
+	}
+}
+
+void VQADecoder::setPrefetchLoop(int frameEnd, int next) {
+	if (_prefetcher) {
+		_prefetcher->setLoop(frameEnd, next);
+	}
+}
+
+void VQADecoder::prefetchFrom(int frame) {
+	if (_prefetcher && frame >= 0 && frame < numFrames()) {
+		_prefetcher->start(frame);
+	}
 }
 
 bool VQADecoder::readVQHD(Common::SeekableReadStream *s, uint32 size) {
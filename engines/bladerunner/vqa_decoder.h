@@ -41,6 +41,7 @@ namespace BladeRunner {
 class Lights;
 class ScreenEffects;
 class View;
+class VQAPrefetcher;
 class ZBuffer;
 
 enum VQADecoderSkipFlags {
@@ -67,6 +68,21 @@ public:
 	void close();
 
 	void readFrame(int frame, uint readFlags = kVQAReadAll);
+	void readFrame(int frame, Common::SeekableReadStream *packet, uint readFlags);
+
+	/**
+	 * Reads the video of the frames following the ones asked for from
+	 * readFrame() ahead on a worker thread. The decoder takes ownership of
+	 * the stream, which must be another stream of the same VQA that doesn't
+	 * share a file handle with any other stream.
+	 *
+	 * If surface and zbuffer are set, the worker also decodes the frames,
+	 * going on from what they show. Only for players that show every frame.
+	 */
+	void startPrefetch(Common::SeekableReadStream *s, int depth, const Graphics::Surface *surface = nullptr, const ZBuffer *zbuffer = nullptr);
+	void setPrefetchLoop(int frameEnd, int next);
+	void prefetchFrom(int frame);
+	const VQAPrefetcher *getPrefetcher() const { return _prefetcher; }
 
 	void                        decodeVideoFrame(Graphics::Surface *surface, int frame, bool forceDraw = false);
 	void                        decodeZBuffer(ZBuffer *zbuffer);
@@ -183,8 +199,10 @@ public:
 
 	VQAVideoTrack *_videoTrack;
 	VQAAudioTrack *_audioTrack;
+	VQAPrefetcher *_prefetcher;
+	bool           _frameDecodedAhead; // The video of the frame read last was decoded by the prefetcher
 
-	void readPacket(uint readFlags);
+	void readPacket(Common::SeekableReadStream *s, uint readFlags);
 
 	bool readVQHD(Common::SeekableReadStream *s, uint32 size);
 	bool readMSCI(Common::SeekableReadStream *s, uint32 size);
@@ -32,6 +32,7 @@
 #include "audio/decoders/raw.h"
 
 #include "common/system.h"
+#include "common/task-scheduler.h"
 
 namespace BladeRunner {
 
@@ -82,6 +83,13 @@ bool VQAPlayer::open() {
 	}
 #endif
 
+	if (_vm->_vqaPrefetchDepth > 0 && g_system->getTaskScheduler()->getWorkerCount() > 0) {
+		Common::SeekableReadStream *prefetchStream = _vm->getIndependentResourceStream(_name);
+		if (prefetchStream) {
+			_decoder.startPrefetch(prefetchStream, _vm->_vqaPrefetchDepth, _decodeAheadZBuffer ? _surface : nullptr, _decodeAheadZBuffer);
+		}
+	}
+
 	_hasAudio = _decoder.hasAudio();
 	if (_hasAudio) {
 		_audioStream = Audio::makeQueuingAudioStream(_decoder.frequency(), false);
@@ -105,6 +113,8 @@ bool VQAPlayer::open() {
 		_frameNext = 0;
 		// TODO? Removed as redundant
 //		setBeginAndEndFrame(0, _frameEnd, 0, kLoopSetModeJustStart, nullptr, nullptr);
+		setPrefetchLoop();
+		_decoder.prefetchFrom(_frameNext);
 	}
 
 	return true;
@@ -278,6 +288,7 @@ int VQAPlayer::update(bool forceDraw, bool advanceFrame, bool useTime, Graphics:
 
 	} else if (advanceFrame) {
 		_frame = _frameNext;
+		setPrefetchLoop();
 		_decoder.readFrame(_frameNext, kVQAReadVideo);
 		_decoder.decodeVideoFrame(customSurface != nullptr ? customSurface : _surface, _frameNext);
 
@@ -457,6 +468,8 @@ bool VQAPlayer::setBeginAndEndFrame(int begin, int end, int repeatsCount, int lo
 bool VQAPlayer::seekToFrame(int frame) {
 	_frameNext = frame;
 	_frameNextTime = 60 * _vm->_time->currentSystem();
+	setPrefetchLoop();
+	_decoder.prefetchFrom(frame);
 	return true;
 }
 
@@ -497,6 +510,11 @@ int VQAPlayer::getQueuedAudioFrames() const {
 	return _audioStream->numQueuedStreams();
 }
 
+void VQAPlayer::setPrefetchLoop() {
+	// Once the current loop ends, playback goes on from _frameBeginNext, unless this was the last repetition
+	_decoder.setPrefetchLoop(_frameEnd, (_repeatsCount != 0 || _frameEndQueued != -1) ? _frameBeginNext : -1);
+}
+
 // Adds another audio "frame" to the queue of the audio stream
 void VQAPlayer::queueAudioFrame(Audio::AudioStream *audioStream) {
 	if (audioStream == nullptr) {
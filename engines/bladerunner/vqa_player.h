@@ -89,6 +89,8 @@ class VQAPlayer {
 	bool   _specialPS15GlitchFix;
 	bool   _specialUG18DoNotRepeatLastLoop;
 
+	ZBuffer *_decodeAheadZBuffer;
+
 	void (*_callbackLoopEnded)(void *, int frame, int loopId);
 	void  *_callbackData;
 
@@ -117,6 +119,7 @@ public:
 		  _audioStarted(false),
 		  _specialPS15GlitchFix(false),
 		  _specialUG18DoNotRepeatLastLoop(false),
+		  _decodeAheadZBuffer(nullptr),
 		  _callbackLoopEnded(nullptr),
 		  _callbackData(nullptr) { }
 
@@ -127,6 +130,13 @@ public:
 	bool open();
 	void close();
 
+	/**
+	 * Lets the prefetching also decode the video and the z-buffer of the
+	 * upcoming frames, for the scene background that shows every frame in
+	 * order. zbuffer is the one passed to updateZBuffer(). Use before open().
+	 */
+	void decodeAhead(ZBuffer *zbuffer) { _decodeAheadZBuffer = zbuffer; }
+
 	bool loadVQPTable(const Common::String& vqpResName);
 
 	int  update(bool forceDraw = false, bool advanceFrame = true, bool useTime = true, Graphics::Surface *customSurface = nullptr);
@@ -152,6 +162,7 @@ public:
 
 private:
 	void queueAudioFrame(Audio::AudioStream *audioStream);
+	void setPrefetchLoop();
 };
 
 } // End of namespace BladeRunner
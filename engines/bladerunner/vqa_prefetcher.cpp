@@ -0,0 +1,294 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "bladerunner/vqa_prefetcher.h"
+
+#include "bladerunner/bladerunner.h"
+#include "bladerunner/vqa_decoder.h"
+#include "bladerunner/zbuffer.h"
+
+#include "common/memstream.h"
+#include "common/system.h"
+
+namespace BladeRunner {
+
+VQAPrefetcher::VQAPrefetcher(Common::SeekableReadStream *s, const Common::Array<uint32> &frameOffsets, int depth) {
+	_s            = s;
+	_frameOffsets = frameOffsets;
+	// One more slot for the frame that was last taken
+	_slots.resize(MAX(depth, 1) + 1);
+
+	_head        = 0;
+	_ready       = 0;
+	_inFlight    = 0;
+	_holdingHead = false;
+
+	// Nothing is read before start(), as the player may start playing from any loop
+	_nextFetch = -1;
+	_loopEnd   = -1;
+	_loopNext  = -1;
+
+	_stats.hits      = 0;
+	_stats.waits     = 0;
+	_stats.misses    = 0;
+	_stats.bytesRead = 0;
+	_stats.waitTime  = 0;
+	_batchBytesRead  = 0;
+
+	_decoder       = nullptr;
+	_zbuffer       = nullptr;
+	_targetSurface = nullptr;
+	_targetZBuffer = nullptr;
+}
+
+VQAPrefetcher::~VQAPrefetcher() {
+	if (_batch.isValid()) {
+		_batch.wait();
+	}
+	delete _decoder;
+	delete _zbuffer;
+	_surface.free();
+	delete _s;
+}
+
+void VQAPrefetcher::decodeAhead(VQADecoder *decoder, const Graphics::Surface *surface, const ZBuffer *zbuffer) {
+	_decoder       = decoder;
+	_targetSurface = surface;
+	_targetZBuffer = zbuffer;
+
+	_surface.create(surface->w, surface->h, surface->format);
+	_zbuffer = new ZBuffer();
+	_zbuffer->init(BladeRunnerEngine::kOriginalGameWidth, BladeRunnerEngine::kOriginalGameHeight);
+}
+
+void VQAPrefetcher::setLoop(int frameEnd, int next) {
+	_loopEnd  = frameEnd;
+	_loopNext = next;
+}
+
+int VQAPrefetcher::nextFrame(int frame) const {
+	if (frame == _loopEnd) {
+		return _loopNext;
+	}
+	if (frame + 1 < (int)_frameOffsets.size() - 1) {
+		return frame + 1;
+	}
+	return -1;
+}
+
+void VQAPrefetcher::readSlot(Slot &slot) {
+	uint32 start = _frameOffsets[slot.frame];
+	uint32 end   = _frameOffsets[slot.frame + 1];
+
+	slot.valid = false;
+	if (end <= start) {
+		return;
+	}
+
+	slot.data.resize(end - start);
+	if (!_s->seek(start) || _s->read(slot.data.data(), end - start) != end - start) {
+		return;
+	}
+
+	slot.valid = true;
+	_batchBytesRead += end - start;
+}
+
+void VQAPrefetcher::decodeSlot(Slot &slot) {
+	if (!slot.valid) {
+		return;
+	}
+
+	Common::MemoryReadStream packet(slot.data.data(), slot.data.size());
+	_decoder->readFrame(slot.frame, &packet, kVQAReadVideo);
+	_decoder->decodeVideoFrame(&_surface, slot.frame);
+	_decoder->decodeZBuffer(_zbuffer);
+
+	slot.pixels.resize(_surface.pitch * _surface.h);
+	memcpy(slot.pixels.data(), _surface.getPixels(), slot.pixels.size());
+	slot.zbuffer.resize(BladeRunnerEngine::kOriginalGameWidth * BladeRunnerEngine::kOriginalGameHeight);
+	memcpy(slot.zbuffer.data(), _zbuffer->getDecodedData(), slot.zbuffer.size() * sizeof(uint16));
+}
+
+void VQAPrefetcher::syncDecoder() {
+	_surface.copyRectToSurface(*_targetSurface, 0, 0, Common::Rect(_surface.w, _surface.h));
+	_zbuffer->setData(_targetZBuffer->getDecodedData());
+}
+
+void VQAPrefetcher::BatchTask::run() {
+	for (uint i = 0; i != _count; ++i) {
+		Slot &slot = _prefetcher->_slots[(_firstSlot + i) % _prefetcher->_slots.size()];
+		_prefetcher->readSlot(slot);
+		if (_prefetcher->_decoder) {
+			_prefetcher->decodeSlot(slot);
+		}
+	}
+}
+
+void VQAPrefetcher::waitForBatch() {
+	if (!_batch.isValid()) {
+		return;
+	}
+
+	uint32 startTime = g_system->getMillis();
+	_batch.wait();
+	_stats.waitTime += g_system->getMillis() - startTime;
+
+	collectBatch();
+}
+
+void VQAPrefetcher::collectBatch() {
+	if (!_batch.isValid() || !_batch.isDone()) {
+		return;
+	}
+
+	_ready += _inFlight;
+	_inFlight = 0;
+	_stats.bytesRead += _batchBytesRead;
+	_batchBytesRead = 0;
+	_batch = Common::TaskFuture();
+}
+
+void VQAPrefetcher::refill() {
+	if (_batch.isValid() || _nextFetch < 0) {
+		return;
+	}
+
+	// The slot before _head must be left alone while the stream over it may still be read
+	uint freeSlots = _slots.size() - _ready - (_holdingHead ? 1 : 0);
+	uint firstSlot = (_head + _ready) % _slots.size();
+	uint count = 0;
+
+	while (count < freeSlots && _nextFetch >= 0) {
+		_slots[(firstSlot + count) % _slots.size()].frame = _nextFetch;
+		_nextFetch = nextFrame(_nextFetch);
+		++count;
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	_inFlight = count;
+	_batch = g_system->getTaskScheduler()->submit(new BatchTask(this, firstSlot, count));
+}
+
+void VQAPrefetcher::start(int frame) {
+	// The oldest slot that wasn't taken is the first of the ready or the in flight ones
+	if (_ready + _inFlight != 0 && _slots[_head].frame == frame) {
+		return;
+	}
+
+	waitForBatch();
+	_ready = 0;
+	if (_decoder) {
+		syncDecoder();
+	}
+	_nextFetch = frame;
+	refill();
+}
+
+VQAPrefetcher::Slot *VQAPrefetcher::takeReady(int frame) {
+	for (uint i = 0; i != _ready; ++i) {
+		Slot &slot = _slots[(_head + i) % _slots.size()];
+		if (slot.frame != frame) {
+			continue;
+		}
+
+		// Frames before this one were skipped by the player, drop them
+		_head = (_head + i + 1) % _slots.size();
+		_ready -= i + 1;
+		_holdingHead = true;
+		refill();
+		return &slot;
+	}
+	return nullptr;
+}
+
+bool VQAPrefetcher::isInBatch(int frame) const {
+	// The frame numbers of the batch are set before it is submitted and never changed by the worker
+	for (uint i = 0; i != _inFlight; ++i) {
+		if (_slots[(_head + _ready + i) % _slots.size()].frame == frame) {
+			return true;
+		}
+	}
+	return false;
+}
+
+Common::SeekableReadStream *VQAPrefetcher::takeFrame(int frame) {
+	_holdingHead = false;
+	collectBatch();
+
+	bool waited = false;
+	Slot *slot = takeReady(frame);
+	if (!slot && isInBatch(frame)) {
+		waitForBatch();
+		waited = true;
+		slot = takeReady(frame);
+	}
+
+	if (!slot) {
+		// The player jumped somewhere unexpected
+		++_stats.misses;
+		waitForBatch();
+		_ready = 0;
+		if (!_decoder) {
+			// Start over after this frame, which is read directly
+			_nextFetch = nextFrame(frame);
+			refill();
+			return nullptr;
+		}
+
+		// The frames have to be decoded in order, so start over from this one and wait for it
+		syncDecoder();
+		_nextFetch = frame;
+		refill();
+		waitForBatch();
+		slot = takeReady(frame);
+	} else if (!slot->valid) {
+		++_stats.misses;
+	} else if (waited) {
+		++_stats.waits;
+	} else {
+		++_stats.hits;
+	}
+
+	if (!slot || !slot->valid) {
+		return nullptr;
+	}
+	return new Common::MemoryReadStream(slot->data.data(), slot->data.size());
+}
+
+const VQAPrefetcher::Slot &VQAPrefetcher::takenSlot() const {
+	assert(_holdingHead);
+	return _slots[(_head + _slots.size() - 1) % _slots.size()];
+}
+
+void VQAPrefetcher::copyFrame(Graphics::Surface *surface) const {
+	const Slot &slot = takenSlot();
+	surface->copyRectToSurface(slot.pixels.data(), _surface.pitch, 0, 0, _surface.w, _surface.h);
+}
+
+void VQAPrefetcher::copyZBuffer(ZBuffer *zbuffer) const {
+	zbuffer->setData(takenSlot().zbuffer.data());
+}
+
+} // End of namespace BladeRunner
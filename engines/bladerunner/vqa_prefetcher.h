@@ -0,0 +1,162 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BLADERUNNER_VQA_PREFETCHER_H
+#define BLADERUNNER_VQA_PREFETCHER_H
+
+#include "common/array.h"
+#include "common/stream.h"
+#include "common/task-scheduler.h"
+
+#include "graphics/surface.h"
+
+namespace BladeRunner {
+
+class VQADecoder;
+class ZBuffer;
+
+/**
+ * Reads the packets of the upcoming frames of a VQA on a worker thread, so
+ * the game loop doesn't have to wait for them to be loaded from the archive.
+ * With decodeAhead(), the worker also decodes the picture and the z-buffer
+ * of each frame.
+ *
+ * The packets are kept in a ring of buffers. Frames are fetched in playback
+ * order, following the loop set with setLoop(), in batches that refill the
+ * free part of the ring. The buffers of a batch are only touched by the
+ * worker until the batch is done, the other buffers only by the game thread.
+ */
+class VQAPrefetcher {
+public:
+	struct Stats {
+		uint32 hits;      ///< Frames taken from the ring
+		uint32 waits;     ///< Frames that were still being read and had to be waited for
+		uint32 misses;    ///< Frames that weren't prefetched and had to be read directly
+		uint32 bytesRead; ///< Bytes read by the worker
+		uint32 waitTime;  ///< Milliseconds spent waiting for the worker
+	};
+
+	/**
+	 * @param s             Stream of the VQA, used only by the worker. Must not
+	 *                      share a file handle with any other stream.
+	 * @param frameOffsets  Offset of the packet of each frame, followed by the size of the stream.
+	 * @param depth         Number of frames to read ahead.
+	 */
+	VQAPrefetcher(Common::SeekableReadStream *s, const Common::Array<uint32> &frameOffsets, int depth);
+	~VQAPrefetcher();
+
+	/**
+	 * Decodes the frames on the worker too, with a decoder of the same VQA
+	 * owned by the prefetcher. As the pictures and the z-buffers are only
+	 * updated by each frame, they are decoded in order into a copy of the
+	 * given ones, which is taken again whenever the player jumps elsewhere.
+	 * Use only before start() and for players that show every frame.
+	 */
+	void decodeAhead(VQADecoder *decoder, const Graphics::Surface *surface, const ZBuffer *zbuffer);
+
+	/**
+	 * Sets which frame follows frameEnd. Use -1 as next to stop prefetching at frameEnd.
+	 */
+	void setLoop(int frameEnd, int next);
+
+	/**
+	 * Starts prefetching from a frame, unless that is already the next one.
+	 */
+	void start(int frame);
+
+	/**
+	 * Returns a stream over the packet of a frame, or nullptr if the frame
+	 * wasn't prefetched. The stream must be deleted by the caller before the
+	 * next call.
+	 */
+	Common::SeekableReadStream *takeFrame(int frame);
+
+	/**
+	 * Copies the picture or the z-buffer decoded for the frame last taken.
+	 */
+	void copyFrame(Graphics::Surface *surface) const;
+	void copyZBuffer(ZBuffer *zbuffer) const;
+
+	bool isDecoding() const { return _decoder != nullptr; }
+	const Stats &getStats() const { return _stats; }
+	int getDepth() const { return _slots.size() - 1; }
+
+private:
+	struct Slot {
+		int                   frame;
+		bool                  valid;
+		Common::Array<byte>   data;
+		Common::Array<byte>   pixels;
+		Common::Array<uint16> zbuffer;
+	};
+
+	class BatchTask : public Common::Task {
+	public:
+		BatchTask(VQAPrefetcher *prefetcher, uint firstSlot, uint count) : _prefetcher(prefetcher), _firstSlot(firstSlot), _count(count) {}
+		void run() override;
+
+	private:
+		VQAPrefetcher *_prefetcher;
+		uint           _firstSlot;
+		uint           _count;
+	};
+
+	Common::SeekableReadStream *_s;
+	Common::Array<uint32>       _frameOffsets;
+	Common::Array<Slot>         _slots;
+
+	uint _head;      // Oldest slot of the ring
+	uint _ready;     // Number of slots read, starting at _head
+	uint _inFlight;  // Number of slots being read by the worker, after the ready ones
+	bool _holdingHead; // The frame at _head was taken and its stream may still be in use
+
+	int _nextFetch;  // Next frame to read, -1 when done
+	int _loopEnd;
+	int _loopNext;
+
+	Common::TaskFuture _batch;
+	Stats              _stats;
+	uint32             _batchBytesRead;
+
+	// Only used by the worker while a batch is running
+	VQADecoder        *_decoder;
+	Graphics::Surface  _surface;
+	ZBuffer           *_zbuffer;
+
+	// What the player shows, the decoding starts over from it
+	const Graphics::Surface *_targetSurface;
+	const ZBuffer           *_targetZBuffer;
+
+	int   nextFrame(int frame) const;
+	void  readSlot(Slot &slot);
+	void  decodeSlot(Slot &slot);
+	void  syncDecoder();
+	void  waitForBatch();
+	void  collectBatch();
+	void  refill();
+	Slot *takeReady(int frame);
+	bool  isInBatch(int frame) const;
+	const Slot &takenSlot() const;
+};
+
+} // End of namespace BladeRunner
+
+#endif
@@ -174,10 +174,27 @@ bool ZBuffer::decodeData(const uint8 *data, int size) {
 	return true;
 }
 
+// Replaces the whole z-buffer, like a complete one from decodeData()
+bool ZBuffer::setData(const uint16 *data) {
+	if (_disabled) {
+		return false;
+	}
+
+	resetUpdates();
+	memcpy(_zbuf1, data, 2 * _width * _height);
+	memcpy(_zbuf2, data, 2 * _width * _height);
+	return true;
+}
+
 uint16 *ZBuffer::getData() const {
 	return _zbuf2;
 }
 
+// The z-buffer as decoded, without what was drawn into the marked rects
+const uint16 *ZBuffer::getDecodedData() const {
+	return _zbuf1;
+}
+
 #if !BLADERUNNER_ORIGINAL_BUGS
 void ZBuffer::setDataZbufExplicit(int x, int y, uint16 overidingVal) {
 	assert(x >= 0 && x < _width);
@@ -63,8 +63,10 @@ public:
 
 	void init(int width, int height);
 	bool decodeData(const uint8 *data, int size);
+	bool setData(const uint16 *data);
 
 	uint16 *getData() const;
+	const uint16 *getDecodedData() const;
 	uint16 getZValue(int x, int y) const;
 
 #if !BLADERUNNER_ORIGINAL_BUGS
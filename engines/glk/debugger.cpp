@@ -22,14 +22,126 @@
 #include "glk/debugger.h"
 #include "glk/glk.h"
 #include "glk/raw_decoder.h"
+#include "glk/window_text_buffer.h"
+#include "common/debug.h"
+#include "common/events.h"
 #include "common/file.h"
+#include "common/str-array.h"
+#include "common/system.h"
 #include "graphics/managed_surface.h"
 #include "image/png.h"
 
 namespace Glk {
 
-Debugger::Debugger() : GUI::Debugger() {
+/**
+ * Types the commands of a transcript, each one once the game asks for a line
+ * of input, and times how long the game takes to ask for the next one. Only
+ * one key is handed out per dispatch, so every key typed before has been
+ * handled when deciding on the next one.
+ */
+class TurnReplayer : public Common::EventSource {
+private:
+	Common::StringArray _commands;
+	uint _index;            ///< Next command to type
+	uint _pos;              ///< Next character of the command being typed
+	bool _typing;           ///< A command is being typed
+	bool _inTurn;           ///< A command was entered and the game is running the turn
+	bool _keySent;          ///< A key was handed out in the current dispatch
+	bool _done;
+	uint32 _turnStart;
+	uint32 _totalTime;
+	uint32 _slowestTime;
+
+	static void pressKey(Common::Event &event, Common::KeyCode keycode, uint16 ascii) {
+		event.type = Common::EVENT_KEYDOWN;
+		event.kbd = Common::KeyState(keycode, ascii);
+	}
+
+	void typeKey(Common::Event &event) {
+		const Common::String &command = _commands[_index - 1];
+		if (_pos < command.size()) {
+			pressKey(event, Common::KEYCODE_INVALID, (byte)command[_pos++]);
+			return;
+		}
+
+		// The return key is handled before the events are polled again,
+		// so the turn starts now
+		pressKey(event, Common::KEYCODE_RETURN, Common::ASCII_RETURN);
+		_typing = false;
+		_inTurn = true;
+		_turnStart = g_system->getMillis();
+	}
+
+public:
+	TurnReplayer(const Common::StringArray &commands) : _commands(commands), _index(0), _pos(0),
+		_typing(false), _inTurn(false), _keySent(false), _done(false), _turnStart(0), _totalTime(0),
+		_slowestTime(0) {}
+
+	bool allowMapping() const override { return false; }
+
+	bool pollEvent(Common::Event &event) override {
+		if (_keySent || _done) {
+			_keySent = false;
+			return false;
+		}
+
+		if (_typing) {
+			typeKey(event);
+			_keySent = true;
+			return true;
+		}
+
+		Windows &windows = *g_vm->_windows;
+		bool lineRequest = false, charRequest = false;
+		for (Windows::iterator i = windows.begin(); i != windows.end(); ++i) {
+			lineRequest |= (*i)->_lineRequest || (*i)->_lineRequestUni;
+			charRequest |= (*i)->_charRequest || (*i)->_charRequestUni;
+		}
+
+		if (Windows::_moreFocus || (!lineRequest && charRequest)) {
+			// Get past "more" and "press a key" prompts
+			pressKey(event, Common::KEYCODE_SPACE, ' ');
+			_keySent = true;
+			return true;
+		}
+
+		if (!lineRequest)
+			return false;
+
+		if (_inTurn) {
+			uint32 turnTime = g_system->getMillis() - _turnStart;
+			_totalTime += turnTime;
+			_slowestTime = MAX(_slowestTime, turnTime);
+			_inTurn = false;
+		}
+
+		if (_index == _commands.size()) {
+			debug("Replayed %u turns in %u ms, %u ms per turn, slowest %u ms", _index,
+				_totalTime, _totalTime / MAX(_index, 1U), _slowestTime);
+			_done = true;
+			return false;
+		}
+
+		_index++;
+		_pos = 0;
+		_typing = true;
+		typeKey(event);
+		_keySent = true;
+		return true;
+	}
+};
+
+Debugger::Debugger() : GUI::Debugger(), _turnReplayer(nullptr) {
 	registerCmd("dumppic", WRAP_METHOD(Debugger, cmdDumpPic));
+	registerCmd("benchreflow", WRAP_METHOD(Debugger, cmdBenchReflow));
+	registerCmd("benchturns", WRAP_METHOD(Debugger, cmdBenchTurns));
+}
+
+Debugger::~Debugger() {
+	if (_turnReplayer) {
+		g_system->getEventManager()->getEventDispatcher()->unregisterSource(_turnReplayer);
+		delete _turnReplayer;
+	}
 }
 
 int Debugger::strToInt(const char *s) {
@@ -99,6 +211,70 @@ bool Debugger::cmdDumpPic(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdBenchReflow(int argc, const char **argv) {
+	if (argc > 3) {
+		debugPrintf("Format: benchreflow [resize count] [paragraphs to add]\n");
+		return true;
+	}
+
+	// Use the focused window if it's a text buffer, otherwise the first one
+	TextBufferWindow *win = dynamic_cast<TextBufferWindow *>(g_vm->_windows->getFocusWindow());
+	for (Windows::iterator i = g_vm->_windows->begin(); !win && i != g_vm->_windows->end(); ++i)
+		win = dynamic_cast<TextBufferWindow *>(*i);
+
+	if (!win) {
+		debugPrintf("No text buffer window\n");
+		return true;
+	}
+
+	int count = argc > 1 ? strToInt(argv[1]) : 10;
+	int fill = argc > 2 ? strToInt(argv[2]) : 0;
+	uint32 fullTime, lazyTime;
+	win->benchmarkReflow(count, fill, fullTime, lazyTime);
+
+	debugPrintf("%d resizes: full reflow %u ms, lazy reflow %u ms\n", count * 2, fullTime, lazyTime);
+	return true;
+}
+
+bool Debugger::cmdBenchTurns(int argc, const char **argv) {
+	if (argc != 2) {
+		debugPrintf("Format: benchturns <file with one command per line>\n");
+		return true;
+	}
+
+	Common::File f;
+	if (!f.open(Common::Path(argv[1]))) {
+		debugPrintf("Could not open %s\n", argv[1]);
+		return true;
+	}
+
+	Common::StringArray commands;
+	while (!f.eos() && !f.err()) {
+		Common::String line = f.readLine();
+		line.trim();
+		if (!line.empty())
+			commands.push_back(line);
+	}
+
+	if (commands.empty()) {
+		debugPrintf("No commands in %s\n", argv[1]);
+		return true;
+	}
+
+	// The commands are typed as key events, so the game's input loop runs
+	// exactly as with a player at the keyboard
+	Common::EventDispatcher *dispatcher = g_system->getEventManager()->getEventDispatcher();
+	if (_turnReplayer) {
+		dispatcher->unregisterSource(_turnReplayer);
+		delete _turnReplayer;
+	}
+	_turnReplayer = new TurnReplayer(commands);
+	dispatcher->registerSource(_turnReplayer, false);
+
+	debugPrintf("Replaying %u commands, the timings are logged when done\n", commands.size());
+	return cmdExit(0, nullptr);
+}
+
 void Debugger::saveRawPicture(const RawDecoder &rd, Common::WriteStream &ws) {
 #ifdef USE_PNG
 	const Graphics::Surface *surface = rd.getSurface();
@@ -30,8 +30,11 @@
 namespace Glk {
 
 class GlkEngine;
+class TurnReplayer;
 
 class Debugger : public GUI::Debugger {
+private:
+	TurnReplayer *_turnReplayer;
 private:
 	/**
 	 * Saves a decoded raw image to a PNG file
@@ -42,6 +45,16 @@ private:
 	 * Dump a picture
 	 */
 	bool cmdDumpPic(int argc, const char **argv);
+
+	/**
+	 * Time the rewrapping of a text buffer window when resizing it
+	 */
+	bool cmdBenchReflow(int argc, const char **argv);
+
+	/**
+	 * Replay the commands of a transcript file and time each turn
+	 */
+	bool cmdBenchTurns(int argc, const char **argv);
 protected:
 	/**
 	 * Convert a numeric string to an integer
@@ -49,6 +62,7 @@ protected:
 	int strToInt(const char *s);
 public:
 	Debugger();
+	~Debugger() override;
 };
 
 } // End of namespace Glk
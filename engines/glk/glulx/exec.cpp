@@ -24,11 +24,24 @@
 namespace Glk {
 namespace Glulx {
 
+/* GCC and Clang can jump through a table of label addresses, which is
+   cheaper than the range checks and the two-level switch below. Each case
+   is also given a label for this. Other compilers use the switches. */
+#if defined(__GNUC__) && !defined(GLULX_EXTEND_OPCODES)
+#define GLULX_THREADED_DISPATCH
+#define OPCODE(op) case op: label_##op
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#else
+#define OPCODE(op) case op
+#endif
+
 void Glulx::execute_loop() {
 	bool done_executing = false;
 	int ix;
 	uint opcode;
 	const operandlist_t *oplist;
+	instcache_t *cached;
 	oparg_t inst[MAX_OPERANDS];
 	uint value, addr, val0, val1;
 	int vals0, vals1;
@@ -38,6 +51,134 @@ void Glulx::execute_loop() {
 	gfloat32 valf, valf1, valf2;
 #endif /* FLOAT_SUPPORT */
 
+#ifdef GLULX_THREADED_DISPATCH
+	/* Label addresses are only known inside this function, so the table is
+	   filled on the first call. */
+	static const void *dispatch[0x200];
+	if (!dispatch[op_nop]) {
+		for (ix = 0; ix < 0x200; ix++)
+			dispatch[ix] = &&op_unknown;
+		dispatch[op_nop] = &&label_op_nop;
+		dispatch[op_add] = &&label_op_add;
+		dispatch[op_sub] = &&label_op_sub;
+		dispatch[op_mul] = &&label_op_mul;
+		dispatch[op_div] = &&label_op_div;
+		dispatch[op_mod] = &&label_op_mod;
+		dispatch[op_neg] = &&label_op_neg;
+		dispatch[op_bitand] = &&label_op_bitand;
+		dispatch[op_bitor] = &&label_op_bitor;
+		dispatch[op_bitxor] = &&label_op_bitxor;
+		dispatch[op_bitnot] = &&label_op_bitnot;
+		dispatch[op_shiftl] = &&label_op_shiftl;
+		dispatch[op_ushiftr] = &&label_op_ushiftr;
+		dispatch[op_sshiftr] = &&label_op_sshiftr;
+		dispatch[op_jump] = &&label_op_jump;
+		dispatch[op_jz] = &&label_op_jz;
+		dispatch[op_jnz] = &&label_op_jnz;
+		dispatch[op_jeq] = &&label_op_jeq;
+		dispatch[op_jne] = &&label_op_jne;
+		dispatch[op_jlt] = &&label_op_jlt;
+		dispatch[op_jgt] = &&label_op_jgt;
+		dispatch[op_jle] = &&label_op_jle;
+		dispatch[op_jge] = &&label_op_jge;
+		dispatch[op_jltu] = &&label_op_jltu;
+		dispatch[op_jgtu] = &&label_op_jgtu;
+		dispatch[op_jleu] = &&label_op_jleu;
+		dispatch[op_jgeu] = &&label_op_jgeu;
+		dispatch[op_call] = &&label_op_call;
+		dispatch[op_return] = &&label_op_return;
+		dispatch[op_tailcall] = &&label_op_tailcall;
+		dispatch[op_catch] = &&label_op_catch;
+		dispatch[op_throw] = &&label_op_throw;
+		dispatch[op_copy] = &&label_op_copy;
+		dispatch[op_copys] = &&label_op_copys;
+		dispatch[op_copyb] = &&label_op_copyb;
+		dispatch[op_sexs] = &&label_op_sexs;
+		dispatch[op_sexb] = &&label_op_sexb;
+		dispatch[op_aload] = &&label_op_aload;
+		dispatch[op_aloads] = &&label_op_aloads;
+		dispatch[op_aloadb] = &&label_op_aloadb;
+		dispatch[op_aloadbit] = &&label_op_aloadbit;
+		dispatch[op_astore] = &&label_op_astore;
+		dispatch[op_astores] = &&label_op_astores;
+		dispatch[op_astoreb] = &&label_op_astoreb;
+		dispatch[op_astorebit] = &&label_op_astorebit;
+		dispatch[op_stkcount] = &&label_op_stkcount;
+		dispatch[op_stkpeek] = &&label_op_stkpeek;
+		dispatch[op_stkswap] = &&label_op_stkswap;
+		dispatch[op_stkcopy] = &&label_op_stkcopy;
+		dispatch[op_stkroll] = &&label_op_stkroll;
+		dispatch[op_streamchar] = &&label_op_streamchar;
+		dispatch[op_streamunichar] = &&label_op_streamunichar;
+		dispatch[op_streamnum] = &&label_op_streamnum;
+		dispatch[op_streamstr] = &&label_op_streamstr;
+		dispatch[op_gestalt] = &&label_op_gestalt;
+		dispatch[op_debugtrap] = &&label_op_debugtrap;
+		dispatch[op_jumpabs] = &&label_op_jumpabs;
+		dispatch[op_callf] = &&label_op_callf;
+		dispatch[op_callfi] = &&label_op_callfi;
+		dispatch[op_callfii] = &&label_op_callfii;
+		dispatch[op_callfiii] = &&label_op_callfiii;
+		dispatch[op_getmemsize] = &&label_op_getmemsize;
+		dispatch[op_setmemsize] = &&label_op_setmemsize;
+		dispatch[op_getstringtbl] = &&label_op_getstringtbl;
+		dispatch[op_setstringtbl] = &&label_op_setstringtbl;
+		dispatch[op_getiosys] = &&label_op_getiosys;
+		dispatch[op_setiosys] = &&label_op_setiosys;
+		dispatch[op_glk] = &&label_op_glk;
+		dispatch[op_random] = &&label_op_random;
+		dispatch[op_setrandom] = &&label_op_setrandom;
+		dispatch[op_verify] = &&label_op_verify;
+		dispatch[op_restart] = &&label_op_restart;
+		dispatch[op_protect] = &&label_op_protect;
+		dispatch[op_saveundo] = &&label_op_saveundo;
+		dispatch[op_restoreundo] = &&label_op_restoreundo;
+		dispatch[op_quit] = &&label_op_quit;
+		dispatch[op_linearsearch] = &&label_op_linearsearch;
+		dispatch[op_binarysearch] = &&label_op_binarysearch;
+		dispatch[op_linkedsearch] = &&label_op_linkedsearch;
+		dispatch[op_malloc] = &&label_op_malloc;
+		dispatch[op_mfree] = &&label_op_mfree;
+		dispatch[op_accelfunc] = &&label_op_accelfunc;
+		dispatch[op_accelparam] = &&label_op_accelparam;
+		dispatch[op_save] = &&label_op_save;
+		dispatch[op_restore] = &&label_op_restore;
+		dispatch[op_mzero] = &&label_op_mzero;
+		dispatch[op_mcopy] = &&label_op_mcopy;
+#ifdef FLOAT_SUPPORT
+		dispatch[op_numtof] = &&label_op_numtof;
+		dispatch[op_ftonumz] = &&label_op_ftonumz;
+		dispatch[op_ftonumn] = &&label_op_ftonumn;
+		dispatch[op_fadd] = &&label_op_fadd;
+		dispatch[op_fsub] = &&label_op_fsub;
+		dispatch[op_fmul] = &&label_op_fmul;
+		dispatch[op_fdiv] = &&label_op_fdiv;
+		dispatch[op_fmod] = &&label_op_fmod;
+		dispatch[op_floor] = &&label_op_floor;
+		dispatch[op_ceil] = &&label_op_ceil;
+		dispatch[op_sqrt] = &&label_op_sqrt;
+		dispatch[op_log] = &&label_op_log;
+		dispatch[op_exp] = &&label_op_exp;
+		dispatch[op_pow] = &&label_op_pow;
+		dispatch[op_sin] = &&label_op_sin;
+		dispatch[op_cos] = &&label_op_cos;
+		dispatch[op_tan] = &&label_op_tan;
+		dispatch[op_asin] = &&label_op_asin;
+		dispatch[op_acos] = &&label_op_acos;
+		dispatch[op_atan] = &&label_op_atan;
+		dispatch[op_atan2] = &&label_op_atan2;
+		dispatch[op_jisinf] = &&label_op_jisinf;
+		dispatch[op_jisnan] = &&label_op_jisnan;
+		dispatch[op_jfeq] = &&label_op_jfeq;
+		dispatch[op_jfne] = &&label_op_jfne;
+		dispatch[op_jflt] = &&label_op_jflt;
+		dispatch[op_jfgt] = &&label_op_jfgt;
+		dispatch[op_jfle] = &&label_op_jfle;
+		dispatch[op_jfge] = &&label_op_jfge;
+#endif /* FLOAT_SUPPORT */
+	}
+#endif /* GLULX_THREADED_DISPATCH */
+
 	while (!done_executing && !g_vm->shouldQuit()) {
 
 		profile_tick();
@@ -48,69 +189,97 @@ void Glulx::execute_loop() {
 		/* Stash the current opcode's address, in case the interpreter needs to serialize the VM state out-of-band. */
 		prevpc = pc;
 
-		/* Fetch the opcode number. */
-		opcode = Mem1(pc);
-		pc++;
-		if (opcode & 0x80) {
-			/* More than one-byte opcode. */
-			if (opcode & 0x40) {
-				/* Four-byte opcode */
-				opcode &= 0x3F;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
+		cached = &instcache[pc & (INSTCACHE_SIZE - 1)];
+		if (cached->pc == pc) {
+			/* The instruction was decoded before; only the operand values
+			   have to be loaded. */
+			opcode = cached->opcode;
+			fetch_operands(inst, cached);
+			pc = cached->nextpc;
+		} else {
+			/* Fetch the opcode number. */
+			opcode = Mem1(pc);
+			pc++;
+			if (opcode & 0x80) {
+				/* More than one-byte opcode. */
+				if (opcode & 0x40) {
+					/* Four-byte opcode */
+					opcode &= 0x3F;
+					opcode = (opcode << 8) | Mem1(pc);
+					pc++;
+					opcode = (opcode << 8) | Mem1(pc);
+					pc++;
+					opcode = (opcode << 8) | Mem1(pc);
+					pc++;
+				} else {
+					/* Two-byte opcode */
+					opcode &= 0x7F;
+					opcode = (opcode << 8) | Mem1(pc);
+					pc++;
+				}
+			}
+
+			/* Now we have an opcode number. */
+
+			/* Fetch the structure that describes how the operands for this
+			   opcode are arranged. This is a pointer to an immutable,
+			   static object. */
+			if (opcode < 0x80)
+				oplist = fast_operandlist[opcode];
+			else
+				oplist = lookup_operandlist(opcode);
+
+			if (!oplist)
+				fatal_error_i("Encountered unknown opcode.", opcode);
+
+			/* Based on the oplist structure, load the actual operand values
+			   into inst. This moves the PC up to the end of the instruction.
+			   Instructions that lie entirely in ROM can't change, so their
+			   decoded operand modes are kept in the cache for next time. */
+			cached->pc = 0;
+			if (pc < ramstart && decode_operands(cached, oplist, pc) && cached->nextpc <= ramstart) {
+				cached->pc = prevpc;
+				cached->opcode = opcode;
+				cached->oplist = oplist;
+				fetch_operands(inst, cached);
+				pc = cached->nextpc;
 			} else {
-				/* Two-byte opcode */
-				opcode &= 0x7F;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
+				parse_operands(inst, oplist);
 			}
 		}
 
-		/* Now we have an opcode number. */
-
-		/* Fetch the structure that describes how the operands for this
-		   opcode are arranged. This is a pointer to an immutable,
-		   static object. */
-		if (opcode < 0x80)
-			oplist = fast_operandlist[opcode];
-		else
-			oplist = lookup_operandlist(opcode);
-
-		if (!oplist)
-			fatal_error_i("Encountered unknown opcode.", opcode);
-
-		/* Based on the oplist structure, load the actual operand values
-		   into inst. This moves the PC up to the end of the instruction. */
-		parse_operands(inst, oplist);
-
 		/* Perform the opcode. This switch statement is split in two, based
 		   on some paranoid suspicions about the ability of compilers to
-		   optimize large-range switches. Ignore that. */
+		   optimize large-range switches. Ignore that.
+		   Where the compiler supports it, the switches are skipped and the
+		   table of case labels is used instead. */
+
+#ifdef GLULX_THREADED_DISPATCH
+		if (opcode < 0x200)
+			goto *dispatch[opcode];
+		goto op_unknown;
+#endif /* GLULX_THREADED_DISPATCH */
 
 		if (opcode < 0x80) {
 
 			switch (opcode) {
 
-			case op_nop:
+			OPCODE(op_nop):
 				break;
 
-			case op_add:
+			OPCODE(op_add):
 				value = inst[0].value + inst[1].value;
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_sub:
+			OPCODE(op_sub):
 				value = inst[0].value - inst[1].value;
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_mul:
+			OPCODE(op_mul):
 				value = inst[0].value * inst[1].value;
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_div:
+			OPCODE(op_div):
 				vals0 = inst[0].value;
 				vals1 = inst[1].value;
 				if (vals1 == 0)
@@ -140,7 +309,7 @@ void Glulx::execute_loop() {
 				}
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_mod:
+			OPCODE(op_mod):
 				vals0 = inst[0].value;
 				vals1 = inst[1].value;
 				if (vals1 == 0)
@@ -159,30 +328,30 @@ void Glulx::execute_loop() {
 				}
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_neg:
+			OPCODE(op_neg):
 				vals0 = inst[0].value;
 				value = (-vals0);
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
 
-			case op_bitand:
+			OPCODE(op_bitand):
 				value = (inst[0].value & inst[1].value);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_bitor:
+			OPCODE(op_bitor):
 				value = (inst[0].value | inst[1].value);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_bitxor:
+			OPCODE(op_bitxor):
 				value = (inst[0].value ^ inst[1].value);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_bitnot:
+			OPCODE(op_bitnot):
 				value = ~(inst[0].value);
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
 
-			case op_shiftl:
+			OPCODE(op_shiftl):
 				vals0 = inst[1].value;
 				if (vals0 < 0 || vals0 >= 32)
 					value = 0;
@@ -190,7 +359,7 @@ void Glulx::execute_loop() {
 					value = ((uint)(inst[0].value) << (uint)vals0);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_ushiftr:
+			OPCODE(op_ushiftr):
 				vals0 = inst[1].value;
 				if (vals0 < 0 || vals0 >= 32)
 					value = 0;
@@ -198,7 +367,7 @@ void Glulx::execute_loop() {
 					value = ((uint)(inst[0].value) >> (uint)vals0);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_sshiftr:
+			OPCODE(op_sshiftr):
 				vals0 = inst[1].value;
 				if (vals0 < 0 || vals0 >= 32) {
 					if (inst[0].value & 0x80000000)
@@ -214,7 +383,7 @@ void Glulx::execute_loop() {
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
 
-			case op_jump:
+			OPCODE(op_jump):
 				value = inst[0].value;
 				/* fall through to PerformJump label. */
 
@@ -235,31 +404,31 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				break;
 
-			case op_jz:
+			OPCODE(op_jz):
 				if (inst[0].value == 0) {
 					value = inst[1].value;
 					goto PerformJump;
 				}
 				break;
-			case op_jnz:
+			OPCODE(op_jnz):
 				if (inst[0].value != 0) {
 					value = inst[1].value;
 					goto PerformJump;
 				}
 				break;
-			case op_jeq:
+			OPCODE(op_jeq):
 				if (inst[0].value == inst[1].value) {
 					value = inst[2].value;
 					goto PerformJump;
 				}
 				break;
-			case op_jne:
+			OPCODE(op_jne):
 				if (inst[0].value != inst[1].value) {
 					value = inst[2].value;
 					goto PerformJump;
 				}
 				break;
-			case op_jlt:
+			OPCODE(op_jlt):
 				vals0 = inst[0].value;
 				vals1 = inst[1].value;
 				if (vals0 < vals1) {
@@ -267,7 +436,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jgt:
+			OPCODE(op_jgt):
 				vals0 = inst[0].value;
 				vals1 = inst[1].value;
 				if (vals0 > vals1) {
@@ -275,7 +444,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jle:
+			OPCODE(op_jle):
 				vals0 = inst[0].value;
 				vals1 = inst[1].value;
 				if (vals0 <= vals1) {
@@ -283,7 +452,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jge:
+			OPCODE(op_jge):
 				vals0 = inst[0].value;
 				vals1 = inst[1].value;
 				if (vals0 >= vals1) {
@@ -291,7 +460,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jltu:
+			OPCODE(op_jltu):
 				val0 = inst[0].value;
 				val1 = inst[1].value;
 				if (val0 < val1) {
@@ -299,7 +468,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jgtu:
+			OPCODE(op_jgtu):
 				val0 = inst[0].value;
 				val1 = inst[1].value;
 				if (val0 > val1) {
@@ -307,7 +476,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jleu:
+			OPCODE(op_jleu):
 				val0 = inst[0].value;
 				val1 = inst[1].value;
 				if (val0 <= val1) {
@@ -315,7 +484,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jgeu:
+			OPCODE(op_jgeu):
 				val0 = inst[0].value;
 				val1 = inst[1].value;
 				if (val0 >= val1) {
@@ -324,13 +493,13 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				break;
 
-			case op_call:
+			OPCODE(op_call):
 				value = inst[1].value;
 				arglist = pop_arguments(value, 0);
 				push_callstub(inst[2].desttype, inst[2].value);
 				enter_function(inst[0].value, value, arglist);
 				break;
-			case op_return:
+			OPCODE(op_return):
 				leave_function();
 				if (stackptr == 0) {
 					done_executing = true;
@@ -338,28 +507,28 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				pop_callstub(inst[0].value);
 				break;
-			case op_tailcall:
+			OPCODE(op_tailcall):
 				value = inst[1].value;
 				arglist = pop_arguments(value, 0);
 				leave_function();
 				enter_function(inst[0].value, value, arglist);
 				break;
 
-			case op_catch:
+			OPCODE(op_catch):
 				push_callstub(inst[0].desttype, inst[0].value);
 				value = inst[1].value;
 				val0 = stackptr;
 				store_operand(inst[0].desttype, inst[0].value, val0);
 				goto PerformJump;
 				break;
-			case op_throw:
+			OPCODE(op_throw):
 				profile_fail("throw");
 				value = inst[0].value;
 				stackptr = inst[1].value;
 				pop_callstub(value);
 				break;
 
-			case op_copy:
+			OPCODE(op_copy):
 				value = inst[0].value;
 #ifdef TOLERATE_SUPERGLUS_BUG
 				if (inst[1].desttype == 1 && inst[1].value == 0)
@@ -367,16 +536,16 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 #endif /* TOLERATE_SUPERGLUS_BUG */
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_copys:
+			OPCODE(op_copys):
 				value = inst[0].value;
 				store_operand_s(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_copyb:
+			OPCODE(op_copyb):
 				value = inst[0].value;
 				store_operand_b(inst[1].desttype, inst[1].value, value);
 				break;
 
-			case op_sexs:
+			OPCODE(op_sexs):
 				val0 = inst[0].value;
 				if (val0 & 0x8000)
 					val0 |= 0xFFFF0000;
@@ -384,7 +553,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					val0 &= 0x0000FFFF;
 				store_operand(inst[1].desttype, inst[1].value, val0);
 				break;
-			case op_sexb:
+			OPCODE(op_sexb):
 				val0 = inst[0].value;
 				if (val0 & 0x80)
 					val0 |= 0xFFFFFF00;
@@ -393,25 +562,25 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				store_operand(inst[1].desttype, inst[1].value, val0);
 				break;
 
-			case op_aload:
+			OPCODE(op_aload):
 				value = inst[0].value;
 				value += 4 * inst[1].value;
 				val0 = Mem4(value);
 				store_operand(inst[2].desttype, inst[2].value, val0);
 				break;
-			case op_aloads:
+			OPCODE(op_aloads):
 				value = inst[0].value;
 				value += 2 * inst[1].value;
 				val0 = Mem2(value);
 				store_operand(inst[2].desttype, inst[2].value, val0);
 				break;
-			case op_aloadb:
+			OPCODE(op_aloadb):
 				value = inst[0].value;
 				value += inst[1].value;
 				val0 = Mem1(value);
 				store_operand(inst[2].desttype, inst[2].value, val0);
 				break;
-			case op_aloadbit:
+			OPCODE(op_aloadbit):
 				value = inst[0].value;
 				vals0 = inst[1].value;
 				val1 = (vals0 & 7);
@@ -426,25 +595,25 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				store_operand(inst[2].desttype, inst[2].value, val0);
 				break;
 
-			case op_astore:
+			OPCODE(op_astore):
 				value = inst[0].value;
 				value += 4 * inst[1].value;
 				val0 = inst[2].value;
 				MemW4(value, val0);
 				break;
-			case op_astores:
+			OPCODE(op_astores):
 				value = inst[0].value;
 				value += 2 * inst[1].value;
 				val0 = inst[2].value;
 				MemW2(value, val0);
 				break;
-			case op_astoreb:
+			OPCODE(op_astoreb):
 				value = inst[0].value;
 				value += inst[1].value;
 				val0 = inst[2].value;
 				MemW1(value, val0);
 				break;
-			case op_astorebit:
+			OPCODE(op_astorebit):
 				value = inst[0].value;
 				vals0 = inst[1].value;
 				val1 = (vals0 & 7);
@@ -460,18 +629,18 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				MemW1(value, val0);
 				break;
 
-			case op_stkcount:
+			OPCODE(op_stkcount):
 				value = (stackptr - valstackbase) / 4;
 				store_operand(inst[0].desttype, inst[0].value, value);
 				break;
-			case op_stkpeek:
+			OPCODE(op_stkpeek):
 				vals0 = inst[0].value * 4;
 				if (vals0 < 0 || vals0 >= (int)(stackptr - valstackbase))
 					fatal_error("Stkpeek outside current stack range.");
 				value = Stk4(stackptr - (vals0 + 4));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_stkswap:
+			OPCODE(op_stkswap):
 				if (stackptr < valstackbase + 8) {
 					fatal_error("Stack underflow in stkswap.");
 				}
@@ -480,7 +649,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				StkW4(stackptr - 4, val1);
 				StkW4(stackptr - 8, val0);
 				break;
-			case op_stkcopy:
+			OPCODE(op_stkcopy):
 				vals0 = inst[0].value;
 				if (vals0 < 0)
 					fatal_error("Negative operand in stkcopy.");
@@ -497,7 +666,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				stackptr += vals0 * 4;
 				break;
-			case op_stkroll:
+			OPCODE(op_stkroll):
 				vals0 = inst[0].value;
 				vals1 = inst[1].value;
 				if (vals0 < 0)
@@ -530,43 +699,46 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				break;
 
-			case op_streamchar:
+			OPCODE(op_streamchar):
 				profile_in(0xE0000001, stackptr, false);
 				value = inst[0].value & 0xFF;
 				(this->*stream_char_handler)(value);
 				profile_out(stackptr);
 				break;
-			case op_streamunichar:
+			OPCODE(op_streamunichar):
 				profile_in(0xE0000002, stackptr, false);
 				value = inst[0].value;
 				(this->*stream_unichar_handler)(value);
 				profile_out(stackptr);
 				break;
-			case op_streamnum:
+			OPCODE(op_streamnum):
 				profile_in(0xE0000003, stackptr, false);
 				vals0 = inst[0].value;
 				stream_num(vals0, false, 0);
 				profile_out(stackptr);
 				break;
-			case op_streamstr:
+			OPCODE(op_streamstr):
 				profile_in(0xE0000004, stackptr, false);
 				stream_string(inst[0].value, 0, 0);
 				profile_out(stackptr);
 				break;
 
 			default:
+#ifdef GLULX_THREADED_DISPATCH
+			op_unknown:
+#endif
 				fatal_error_i("Executed unknown opcode.", opcode);
 			}
 		} else {
 
 			switch (opcode) {
 
-			case op_gestalt:
+			OPCODE(op_gestalt):
 				value = do_gestalt(inst[0].value, inst[1].value);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
 
-			case op_debugtrap:
+			OPCODE(op_debugtrap):
 #ifdef VM_DEBUGGER
 				/* We block and handle debug commands, but only if the
 				   library has invoked debug features. (Meaning, has
@@ -579,26 +751,26 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				fatal_error_i("user debugtrap encountered.", inst[0].value);
 				break;
 
-			case op_jumpabs:
+			OPCODE(op_jumpabs):
 				pc = inst[0].value;
 				break;
 
-			case op_callf:
+			OPCODE(op_callf):
 				push_callstub(inst[1].desttype, inst[1].value);
 				enter_function(inst[0].value, 0, arglistfix);
 				break;
-			case op_callfi:
+			OPCODE(op_callfi):
 				arglistfix[0] = inst[1].value;
 				push_callstub(inst[2].desttype, inst[2].value);
 				enter_function(inst[0].value, 1, arglistfix);
 				break;
-			case op_callfii:
+			OPCODE(op_callfii):
 				arglistfix[0] = inst[1].value;
 				arglistfix[1] = inst[2].value;
 				push_callstub(inst[3].desttype, inst[3].value);
 				enter_function(inst[0].value, 2, arglistfix);
 				break;
-			case op_callfiii:
+			OPCODE(op_callfiii):
 				arglistfix[0] = inst[1].value;
 				arglistfix[1] = inst[2].value;
 				arglistfix[2] = inst[3].value;
@@ -606,32 +778,32 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				enter_function(inst[0].value, 3, arglistfix);
 				break;
 
-			case op_getmemsize:
+			OPCODE(op_getmemsize):
 				store_operand(inst[0].desttype, inst[0].value, endmem);
 				break;
-			case op_setmemsize:
+			OPCODE(op_setmemsize):
 				value = change_memsize(inst[0].value, false);
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
 
-			case op_getstringtbl:
+			OPCODE(op_getstringtbl):
 				value = stream_get_table();
 				store_operand(inst[0].desttype, inst[0].value, value);
 				break;
-			case op_setstringtbl:
+			OPCODE(op_setstringtbl):
 				stream_set_table(inst[0].value);
 				break;
 
-			case op_getiosys:
+			OPCODE(op_getiosys):
 				stream_get_iosys(&val0, &val1);
 				store_operand(inst[0].desttype, inst[0].value, val0);
 				store_operand(inst[1].desttype, inst[1].value, val1);
 				break;
-			case op_setiosys:
+			OPCODE(op_setiosys):
 				stream_set_iosys(inst[0].value, inst[1].value);
 				break;
 
-			case op_glk:
+			OPCODE(op_glk):
 				profile_in(0xF0000000 + inst[0].value, stackptr, false);
 				value = inst[1].value;
 				arglist = pop_arguments(value, 0);
@@ -644,7 +816,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				profile_out(stackptr);
 				break;
 
-			case op_random:
+			OPCODE(op_random):
 				vals0 = inst[0].value;
 				if (vals0 == 0)
 					value = glulx_random();
@@ -654,21 +826,21 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					value = -(int)(glulx_random() % (uint)(-vals0));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_setrandom:
+			OPCODE(op_setrandom):
 				glulx_setrandom(inst[0].value);
 				break;
 
-			case op_verify:
+			OPCODE(op_verify):
 				value = perform_verify();
 				store_operand(inst[0].desttype, inst[0].value, value);
 				break;
 
-			case op_restart:
+			OPCODE(op_restart):
 				profile_fail("restart");
 				vm_restart();
 				break;
 
-			case op_protect:
+			OPCODE(op_protect):
 				val0 = inst[0].value;
 				val1 = val0 + inst[1].value;
 				if (val0 == val1) {
@@ -679,7 +851,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				protectend = val1;
 				break;
 
-			case op_save: {
+			OPCODE(op_save): {
 				push_callstub(inst[1].desttype, inst[1].value);
 				strid_t saveStream = find_stream_by_id(inst[0].value);
 				value = writeGameData(*saveStream).getCode() == Common::kNoError ? 0 : 1;
@@ -687,7 +859,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				break;
 			}
 
-			case op_restore: {
+			OPCODE(op_restore): {
 				strid_t stream = find_stream_by_id(inst[0].value);
 				value = readSaveData(*stream).getCode() == Common::kNoError ? 0 : 1;
 
@@ -704,13 +876,13 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				break;
 			}
 
-			case op_saveundo:
+			OPCODE(op_saveundo):
 				push_callstub(inst[0].desttype, inst[0].value);
 				value = perform_saveundo();
 				pop_callstub(value);
 				break;
 
-			case op_restoreundo:
+			OPCODE(op_restoreundo):
 				value = perform_restoreundo();
 				if (value == 0) {
 					/* We've succeeded, and the stack now contains the callstub
@@ -724,27 +896,27 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				break;
 
-			case op_quit:
+			OPCODE(op_quit):
 				done_executing = true;
 				break;
 
-			case op_linearsearch:
+			OPCODE(op_linearsearch):
 				value = linear_search(inst[0].value, inst[1].value, inst[2].value,
 				                      inst[3].value, inst[4].value, inst[5].value, inst[6].value);
 				store_operand(inst[7].desttype, inst[7].value, value);
 				break;
-			case op_binarysearch:
+			OPCODE(op_binarysearch):
 				value = binary_search(inst[0].value, inst[1].value, inst[2].value,
 				                      inst[3].value, inst[4].value, inst[5].value, inst[6].value);
 				store_operand(inst[7].desttype, inst[7].value, value);
 				break;
-			case op_linkedsearch:
+			OPCODE(op_linkedsearch):
 				value = linked_search(inst[0].value, inst[1].value, inst[2].value,
 				                      inst[3].value, inst[4].value, inst[5].value);
 				store_operand(inst[6].desttype, inst[6].value, value);
 				break;
 
-			case op_mzero: {
+			OPCODE(op_mzero): {
 				uint lx;
 				uint count = inst[0].value;
 				addr = inst[1].value;
@@ -753,7 +925,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 			}
 			break;
-			case op_mcopy: {
+			OPCODE(op_mcopy): {
 				uint lx;
 				uint count = inst[0].value;
 				uint addrsrc = inst[1].value;
@@ -773,29 +945,29 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 			}
 			break;
-			case op_malloc:
+			OPCODE(op_malloc):
 				value = heap_alloc(inst[0].value);
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_mfree:
+			OPCODE(op_mfree):
 				heap_free(inst[0].value);
 				break;
 
-			case op_accelfunc:
+			OPCODE(op_accelfunc):
 				accel_set_func(inst[0].value, inst[1].value);
 				break;
-			case op_accelparam:
+			OPCODE(op_accelparam):
 				accel_set_param(inst[0].value, inst[1].value);
 				break;
 
 #ifdef FLOAT_SUPPORT
 
-			case op_numtof:
+			OPCODE(op_numtof):
 				vals0 = inst[0].value;
 				value = encode_float((gfloat32)vals0);
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_ftonumz:
+			OPCODE(op_ftonumz):
 				valf = decode_float(inst[0].value);
 				if (!signbit(valf)) {
 					if (isnan(valf) || isinf(valf) || (valf > 2147483647.0))
@@ -810,7 +982,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				store_operand(inst[1].desttype, inst[1].value, vals0);
 				break;
-			case op_ftonumn:
+			OPCODE(op_ftonumn):
 				valf = decode_float(inst[0].value);
 				if (!signbit(valf)) {
 					if (isnan(valf) || isinf(valf) || (valf > 2147483647.0))
@@ -826,32 +998,32 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				store_operand(inst[1].desttype, inst[1].value, vals0);
 				break;
 
-			case op_fadd:
+			OPCODE(op_fadd):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				value = encode_float(valf1 + valf2);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_fsub:
+			OPCODE(op_fsub):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				value = encode_float(valf1 - valf2);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_fmul:
+			OPCODE(op_fmul):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				value = encode_float(valf1 * valf2);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
-			case op_fdiv:
+			OPCODE(op_fdiv):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				value = encode_float(valf1 / valf2);
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
 
-			case op_fmod:
+			OPCODE(op_fmod):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				valf = fmodf(valf1, valf2);
@@ -867,12 +1039,12 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				store_operand(inst[3].desttype, inst[3].value, val1);
 				break;
 
-			case op_floor:
+			OPCODE(op_floor):
 				valf = decode_float(inst[0].value);
 				value = encode_float(floorf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_ceil:
+			OPCODE(op_ceil):
 				valf = decode_float(inst[0].value);
 				value = encode_float(ceilf(valf));
 				if (value == 0x0 || value == 0x80000000) {
@@ -884,66 +1056,66 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
 
-			case op_sqrt:
+			OPCODE(op_sqrt):
 				valf = decode_float(inst[0].value);
 				value = encode_float(sqrtf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_log:
+			OPCODE(op_log):
 				valf = decode_float(inst[0].value);
 				value = encode_float(logf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_exp:
+			OPCODE(op_exp):
 				valf = decode_float(inst[0].value);
 				value = encode_float(expf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_pow:
+			OPCODE(op_pow):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				value = encode_float(glulx_powf(valf1, valf2));
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
 
-			case op_sin:
+			OPCODE(op_sin):
 				valf = decode_float(inst[0].value);
 				value = encode_float(sinf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_cos:
+			OPCODE(op_cos):
 				valf = decode_float(inst[0].value);
 				value = encode_float(cosf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_tan:
+			OPCODE(op_tan):
 				valf = decode_float(inst[0].value);
 				value = encode_float(tanf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_asin:
+			OPCODE(op_asin):
 				valf = decode_float(inst[0].value);
 				value = encode_float(asinf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_acos:
+			OPCODE(op_acos):
 				valf = decode_float(inst[0].value);
 				value = encode_float(acosf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_atan:
+			OPCODE(op_atan):
 				valf = decode_float(inst[0].value);
 				value = encode_float(atanf(valf));
 				store_operand(inst[1].desttype, inst[1].value, value);
 				break;
-			case op_atan2:
+			OPCODE(op_atan2):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				value = encode_float(atan2f(valf1, valf2));
 				store_operand(inst[2].desttype, inst[2].value, value);
 				break;
 
-			case op_jisinf:
+			OPCODE(op_jisinf):
 				/* Infinity is well-defined, so we don't bother to convert to
 				   float. */
 				val0 = inst[0].value;
@@ -952,7 +1124,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jisnan:
+			OPCODE(op_jisnan):
 				/* NaN is well-defined, so we don't bother to convert to
 				   float. */
 				val0 = inst[0].value;
@@ -962,7 +1134,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				break;
 
-			case op_jfeq:
+			OPCODE(op_jfeq):
 				if ((inst[2].value & 0x7F800000) == 0x7F800000 && (inst[2].value & 0x007FFFFF) != 0) {
 					/* The delta is NaN, which can never match. */
 					val0 = 0;
@@ -981,7 +1153,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jfne:
+			OPCODE(op_jfne):
 				if ((inst[2].value & 0x7F800000) == 0x7F800000 && (inst[2].value & 0x007FFFFF) != 0) {
 					/* The delta is NaN, which can never match. */
 					val0 = 0;
@@ -1001,7 +1173,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 				}
 				break;
 
-			case op_jflt:
+			OPCODE(op_jflt):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				if (valf1 < valf2) {
@@ -1009,7 +1181,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jfgt:
+			OPCODE(op_jfgt):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				if (valf1 > valf2) {
@@ -1017,7 +1189,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jfle:
+			OPCODE(op_jfle):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				if (valf1 <= valf2) {
@@ -1025,7 +1197,7 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 					goto PerformJump;
 				}
 				break;
-			case op_jfge:
+			OPCODE(op_jfge):
 				valf1 = decode_float(inst[0].value);
 				valf2 = decode_float(inst[1].value);
 				if (valf1 >= valf2) {
@@ -1051,5 +1223,9 @@ PerformJump: /* goto label for successful jumping... ironic, no? */
 #endif /* VM_DEBUGGER */
 }
 
+#ifdef GLULX_THREADED_DISPATCH
+#pragma GCC diagnostic pop
+#endif
+
 } // End of namespace Glulx
 } // End of namespace Glk
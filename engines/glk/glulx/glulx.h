@@ -145,6 +145,12 @@ private:
 	 */
 	const operandlist_t *fast_operandlist[0x80];
 
+	/**
+	 * Decoded instructions, indexed by their address modulo INSTCACHE_SIZE. Only instructions
+	 * in ROM are cached, so writes to memory never make an entry stale.
+	 */
+	instcache_t *instcache;
+
 	/**@}*/
 
 	/**
@@ -551,6 +557,24 @@ public:
 	*/
 	void parse_operands(oparg_t *opargs, const operandlist_t *oplist);
 
+	/**
+	 * Decode the addressing modes and operand bytes of an instruction, starting at the given
+	 * address of its mode bytes, into a cache entry. Returns false if an addressing mode is
+	 * invalid, in which case parse_operands() has to be used to report it.
+	 */
+	bool decode_operands(instcache_t *entry, const operandlist_t *oplist, uint modeaddr);
+
+	/**
+	 * Load the operand values of a decoded instruction into args, like parse_operands().
+	 * This doesn't move the PC.
+	 */
+	void fetch_operands(oparg_t *args, const instcache_t *entry);
+
+	/**
+	 * Forget all the decoded instructions.
+	 */
+	void clear_instcache();
+
 	/**
 	 * Store a result value, according to the desttype and destaddress given. This is usually used to store
 	 * the result of an opcode, but it's also used by any code that pulls a call-stub off the stack.
@@ -351,6 +351,36 @@ typedef oparg_struct oparg_t;
 
 #define MAX_OPERANDS (8)
 
+/**
+ * How the value of a decoded operand is obtained.
+ */
+enum opkind {
+	opkind_Const = 0,   ///< Load a constant
+	opkind_Pop = 1,     ///< Load a value popped off the stack
+	opkind_Mem = 2,     ///< Load from main memory
+	opkind_Local = 3,   ///< Load from the locals
+	opkind_Store = 4    ///< Store; opkind_Store + desttype
+};
+
+/**
+ * An instruction with its operand addressing modes already decoded, as kept in the
+ * instruction cache.
+ */
+struct instcache_struct {
+	uint pc;                        ///< Address of the instruction, or 0 if the entry is unused
+	uint nextpc;                    ///< Address of the following instruction
+	uint opcode;
+	const operandlist_t *oplist;
+	byte kinds[MAX_OPERANDS];       ///< opkind of each operand
+	uint values[MAX_OPERANDS];      ///< Constant, address or locals offset of each operand
+};
+typedef instcache_struct instcache_t;
+
+/**
+ * Number of entries of the instruction cache. This must be a power of two.
+ */
+#define INSTCACHE_SIZE (0x4000)
+
 typedef uint(Glulx::*acceleration_func)(uint argc, uint *argv);
 
 struct accelentry_struct {
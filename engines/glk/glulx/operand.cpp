@@ -66,6 +66,18 @@ static const operandlist_t list_LLSS = { 4, 4, &array_LLSS[0] };
 void Glulx::init_operands() {
 	for (int ix = 0; ix < 0x80; ix++)
 		fast_operandlist[ix] = lookup_operandlist(ix);
+
+	if (!instcache) {
+		instcache = (instcache_t *)glulx_malloc(INSTCACHE_SIZE * sizeof(instcache_t));
+		if (!instcache)
+			fatal_error("Unable to allocate instruction cache.");
+	}
+	clear_instcache();
+}
+
+void Glulx::clear_instcache() {
+	for (int ix = 0; ix < INSTCACHE_SIZE; ix++)
+		instcache[ix].pc = 0;
 }
 
 const operandlist_t *Glulx::lookup_operandlist(uint opcode) {
@@ -516,6 +528,154 @@ WrLocalsAddr:
 	}
 }
 
+bool Glulx::decode_operands(instcache_t *entry, const operandlist_t *oplist, uint modeaddr) {
+	int numops = oplist->num_ops;
+	uint addr = modeaddr + (numops + 1) / 2;
+	int modeval = 0;
+
+	for (int ix = 0; ix < numops; ix++) {
+		int mode;
+		uint value;
+		int kind;
+
+		if ((ix & 1) == 0) {
+			modeval = Mem1(modeaddr);
+			mode = (modeval & 0x0F);
+		} else {
+			mode = ((modeval >> 4) & 0x0F);
+			modeaddr++;
+		}
+
+		/* Fetch the constant, address or locals offset that follows the mode bytes. */
+		switch (mode) {
+		case 0: /* constant zero, or discard value */
+		case 8: /* pop off stack, or push on stack */
+			value = 0;
+			break;
+		case 1: /* one-byte constant */
+			value = (int)(signed char)(Mem1(addr));
+			addr++;
+			break;
+		case 2: /* two-byte constant */
+			value = (int)(signed char)(Mem1(addr));
+			value = (value << 8) | (uint)(Mem1(addr + 1));
+			addr += 2;
+			break;
+		case 3: /* four-byte constant */
+		case 7: /* main memory, four-byte address */
+		case 11: /* locals, four-byte address */
+			value = Mem4(addr);
+			addr += 4;
+			break;
+		case 15: /* main memory RAM, four-byte address */
+			value = Mem4(addr) + ramstart;
+			addr += 4;
+			break;
+		case 6: /* main memory, two-byte address */
+		case 10: /* locals, two-byte address */
+			value = (uint)Mem2(addr);
+			addr += 2;
+			break;
+		case 14: /* main memory RAM, two-byte address */
+			value = (uint)Mem2(addr) + ramstart;
+			addr += 2;
+			break;
+		case 5: /* main memory, one-byte address */
+		case 9: /* locals, one-byte address */
+			value = (uint)(Mem1(addr));
+			addr++;
+			break;
+		case 13: /* main memory RAM, one-byte address */
+			value = (uint)(Mem1(addr)) + ramstart;
+			addr++;
+			break;
+		default:
+			return false;
+		}
+
+		if (oplist->formlist[ix] == modeform_Load) {
+			if (mode == 8)
+				kind = opkind_Pop;
+			else if (mode <= 3)
+				kind = opkind_Const;
+			else if (mode >= 9 && mode <= 11)
+				kind = opkind_Local;
+			else
+				kind = opkind_Mem;
+		} else {
+			if (mode >= 1 && mode <= 3)
+				return false;
+			else if (mode == 0)
+				kind = opkind_Store + 0;
+			else if (mode == 8)
+				kind = opkind_Store + 3;
+			else if (mode >= 9 && mode <= 11)
+				kind = opkind_Store + 2;
+			else
+				kind = opkind_Store + 1;
+		}
+
+		entry->kinds[ix] = kind;
+		entry->values[ix] = value;
+	}
+
+	entry->nextpc = addr;
+	return true;
+}
+
+void Glulx::fetch_operands(oparg_t *args, const instcache_t *entry) {
+	int numops = entry->oplist->num_ops;
+	int argsize = entry->oplist->arg_size;
+
+	for (int ix = 0; ix < numops; ix++, args++) {
+		uint addr = entry->values[ix];
+
+		switch (entry->kinds[ix]) {
+		case opkind_Const:
+			args->desttype = 0;
+			args->value = addr;
+			break;
+
+		case opkind_Pop:
+			if (stackptr < valstackbase + 4) {
+				fatal_error("Stack underflow in operand.");
+			}
+			stackptr -= 4;
+			args->desttype = 0;
+			args->value = Stk4(stackptr);
+			break;
+
+		case opkind_Mem:
+			args->desttype = 0;
+			if (argsize == 4) {
+				args->value = Mem4(addr);
+			} else if (argsize == 2) {
+				args->value = Mem2(addr);
+			} else {
+				args->value = Mem1(addr);
+			}
+			break;
+
+		case opkind_Local:
+			addr += localsbase;
+			args->desttype = 0;
+			if (argsize == 4) {
+				args->value = Stk4(addr);
+			} else if (argsize == 2) {
+				args->value = Stk2(addr);
+			} else {
+				args->value = Stk1(addr);
+			}
+			break;
+
+		default:
+			args->desttype = entry->kinds[ix] - opkind_Store;
+			args->value = addr;
+			break;
+		}
+	}
+}
+
 void Glulx::store_operand(uint desttype, uint destaddr, uint storeval) {
 	switch (desttype) {
 
@@ -114,6 +114,10 @@ void Glulx::finalize_vm() {
 		glulx_free(stack);
 		stack = nullptr;
 	}
+	if (instcache) {
+		glulx_free(instcache);
+		instcache = nullptr;
+	}
 
 	final_serial();
 }
@@ -40,7 +40,7 @@ TextBufferWindow::TextBufferWindow(Windows *windows, uint rock) : TextWindow(win
 		_lastSeen(0), _scrollPos(0), _scrollMax(0), _scrollBack(SCROLLBACK), _width(-1), _height(-1),
 		_inBuf(nullptr), _lineTerminators(nullptr), _echoLineInput(true), _ladjw(0), _radjw(0),
 		_ladjn(0), _radjn(0), _numChars(0), _chars(nullptr), _attrs(nullptr), _spaced(0), _dashed(0),
-		_copyBuf(nullptr), _copyPos(0) {
+		_copyBuf(nullptr), _copyPos(0), _lazyReflow(true), _reflowing(false) {
 	_type = wintype_TextBuffer;
 	_history.resize(HISTORYLEN);
 
@@ -73,6 +73,8 @@ TextBufferWindow::~TextBufferWindow() {
 		if (_lines[i]._rPic)
 			_lines[i]._rPic->decrement();
 	}
+
+	_unwrapped.clear();
 }
 
 void TextBufferWindow::rearrange(const Rect &box) {
@@ -90,7 +92,8 @@ void TextBufferWindow::rearrange(const Rect &box) {
 
 	if (newwid != _width) {
 		_width = newwid;
-		reflow();
+		// wrap the visible rows and a page of history, the rest is wrapped when scrolling back
+		reflow(_lazyReflow ? newhgt * 2 : -1);
 	}
 
 	if (newhgt != _height) {
@@ -119,121 +122,175 @@ void TextBufferWindow::rearrange(const Rect &box) {
 	}
 }
 
-void TextBufferWindow::reflow() {
+void TextBufferWindow::reflow(int minRows) {
 	int inputbyte = -1;
 	Attributes curattr, oldattr;
-	int i, k, p, s;
-	int x;
+	int i, k;
 
 	if (_height < 4 || _width < 20)
 		return;
 
 	_lines[0]._len = _numChars;
 
-	// allocate temp buffers
-	Attributes *attrbuf = new Attributes[SCROLLBACK * TBLINELEN];
-	uint32 *charbuf = new uint32[SCROLLBACK * TBLINELEN];
-	int *alignbuf = new int[SCROLLBACK];
-	Picture **pictbuf = new Picture *[SCROLLBACK];
-	uint *hyperbuf = new uint[SCROLLBACK];
-	int *offsetbuf = new int[SCROLLBACK];
-
-	if (!attrbuf || !charbuf || !alignbuf || !pictbuf || !hyperbuf || !offsetbuf) {
-		delete[] attrbuf;
-		delete[] charbuf;
-		delete[] alignbuf;
-		delete[] pictbuf;
-		delete[] hyperbuf;
-		delete[] offsetbuf;
-		return;
-	}
-
-	// copy text to temp buffers
+	// copy text to a temp buffer, starting with the part that isn't wrapped yet
+	FlowText text;
+	text._chars.swap(_unwrapped._chars);
+	text._attrs.swap(_unwrapped._attrs);
+	text._pictures.swap(_unwrapped._pictures);
 
 	oldattr = _attr;
 	curattr.clear();
+	if (!text._attrs.empty())
+		curattr = text._attrs.back();
 
-	x = 0;
-	p = 0;
-	s = _scrollMax < SCROLLBACK ? _scrollMax : SCROLLBACK - 1;
-
-	for (k = s; k >= 0; k--) {
+	for (k = MIN(_scrollMax, _scrollBack - 1); k >= 0; k--) {
 		if (k == 0 && _lineRequest)
-			inputbyte = p + _inFence;
+			inputbyte = text._chars.size() + _inFence;
 
 		if (_lines[k]._lPic) {
-			offsetbuf[x] = p;
-			alignbuf[x] = imagealign_MarginLeft;
-			pictbuf[x] = _lines[k]._lPic;
-
-			if (pictbuf[x]) pictbuf[x]->increment();
-			hyperbuf[x] = _lines[k]._lHyper;
-			x++;
+			FlowPicture pic = { text._chars.size(), imagealign_MarginLeft, _lines[k]._lPic, _lines[k]._lHyper };
+			pic._pic->increment();
+			text._pictures.push_back(pic);
 		}
 
 		if (_lines[k]._rPic) {
-			offsetbuf[x] = p;
-			alignbuf[x] = imagealign_MarginRight;
-			pictbuf[x] = _lines[k]._rPic;
-			if (pictbuf[x]) pictbuf[x]->increment();
-			hyperbuf[x] = _lines[k]._rHyper;
-			x++;
+			FlowPicture pic = { text._chars.size(), imagealign_MarginRight, _lines[k]._rPic, _lines[k]._rHyper };
+			pic._pic->increment();
+			text._pictures.push_back(pic);
 		}
 
 		for (i = 0; i < _lines[k]._len; i++) {
-			attrbuf[p] = curattr = _lines[k]._attrs[i];
-			charbuf[p] = _lines[k]._chars[i];
-			p++;
+			text._attrs.push_back(curattr = _lines[k]._attrs[i]);
+			text._chars.push_back(_lines[k]._chars[i]);
 		}
 
 		if (_lines[k]._newLine) {
-			attrbuf[p] = curattr;
-			charbuf[p] = '\n';
-			p++;
+			text._attrs.push_back(curattr);
+			text._chars.push_back('\n');
+		}
+	}
+
+	// and dump text back, only the newest paragraphs if possible
+	uint start = 0;
+	if (minRows < 0) {
+		flowText(text, 0, inputbyte);
+	} else {
+		for (int rows = minRows;; rows *= 2) {
+			start = findFlowStart(text, rows);
+			flowText(text, start, inputbyte);
+			if (start == 0 || _scrollMax + 1 >= minRows)
+				break;
+
+			// Too few rows, the window will be cleared again, along with the pictures it now owns
+			for (uint p = 0; p < text._pictures.size(); p++) {
+				if (text._pictures[p]._offset >= start)
+					text._pictures[p]._pic->increment();
+			}
+		}
+	}
+
+	// the older paragraphs stay unwrapped
+	text._chars.resize(start);
+	text._attrs.resize(start);
+	for (uint p = 0; p < text._pictures.size(); p++) {
+		if (text._pictures[p]._offset >= start) {
+			text._pictures.resize(p);
+			break;
 		}
 	}
+	_unwrapped._chars.swap(text._chars);
+	_unwrapped._attrs.swap(text._attrs);
+	_unwrapped._pictures.swap(text._pictures);
+
+	_attr = oldattr;
 
-	offsetbuf[x] = -1;
+	touchScroll();
+}
 
+void TextBufferWindow::flowText(const FlowText &text, uint start, int inputbyte) {
 	// clear window
 	clear();
+	_reflowing = true;
 
-	// and dump text back
-	x = 0;
-	for (i = 0; i < p; i++) {
-		if (i == inputbyte)
+	uint p = 0;
+	while (p < text._pictures.size() && text._pictures[p]._offset < start)
+		p++;
+
+	for (uint i = start; i < text._chars.size(); i++) {
+		if ((int)i == inputbyte)
 			break;
-		_attr = attrbuf[i];
+		_attr = text._attrs[i];
 
-		if (offsetbuf[x] == i) {
-			putPicture(pictbuf[x], alignbuf[x], hyperbuf[x]);
-			x++;
-		}
+		for (; p < text._pictures.size() && text._pictures[p]._offset == i; p++)
+			putPicture(text._pictures[p]._pic, text._pictures[p]._align, text._pictures[p]._hyper);
 
-		putCharUni(charbuf[i]);
+		putCharUni(text._chars[i]);
 	}
 
+	_reflowing = false;
+
 	// terribly sorry about this...
 	_lastSeen = 0;
 	_scrollPos = 0;
 
 	if (inputbyte != -1) {
 		_inFence = _numChars;
-		putTextUni(charbuf + inputbyte, p - inputbyte, _numChars, 0);
+		putTextUni(text._chars.data() + inputbyte, text._chars.size() - inputbyte, _numChars, 0);
 		_inCurs = _numChars;
 	}
+}
 
-	// free temp buffers
-	delete[] attrbuf;
-	delete[] charbuf;
-	delete[] alignbuf;
-	delete[] pictbuf;
-	delete[] hyperbuf;
-	delete[] offsetbuf;
+uint TextBufferWindow::findFlowStart(const FlowText &text, int rows) const {
+	// Guess the rows of each paragraph from its length, one character per cell
+	uint end = text._chars.size();
+	int estimate = 0;
+
+	for (uint i = end; i > 0; i--) {
+		if (text._chars[i - 1] == '\n') {
+			estimate += (end - i) / _width + 1;
+			if (estimate >= rows)
+				return i;
+			end = i - 1;
+		}
+	}
 
-	_attr = oldattr;
+	return 0;
+}
 
-	touchScroll();
+void TextBufferWindow::wrapScrollback(int minRows) {
+	int scrollPos = _scrollPos;
+	int lastSeen = _lastSeen;
+
+	reflow(minRows);
+
+	_scrollPos = scrollPos;
+	_lastSeen = lastSeen;
+}
+
+void TextBufferWindow::benchmarkReflow(int count, int fill, uint32 &fullTime, uint32 &lazyTime) {
+	static const char *const PARAGRAPH = "You are standing in an open field west of a white house, with a boarded "
+		"front door. There is a small mailbox here. The grass is damp and a narrow path winds north "
+		"through the trees, towards the forest, where birds sing in the warm afternoon light.";
+
+	for (int i = 0; i < fill; i++) {
+		Common::String str = Common::String::format("%d. %s", i + 1, PARAGRAPH);
+		for (uint j = 0; j < str.size(); j++)
+			putCharUni((byte)str[j]);
+		putCharUni('\n');
+	}
+
+	Rect box(_bbox.left, _bbox.top - _yAdj, _bbox.right, _bbox.bottom);
+	Rect narrowBox(box.left, box.top, box.left + box.width() * 3 / 4, box.bottom);
+
+	for (int pass = 0; pass < 2; pass++) {
+		_lazyReflow = pass == 1;
+		uint32 startTime = g_system->getMillis();
+		for (int i = 0; i < count; i++) {
+			rearrange(narrowBox);
+			rearrange(box);
+		}
+		(_lazyReflow ? lazyTime : fullTime) = g_system->getMillis() - startTime;
+	}
 }
 
 void TextBufferWindow::touchScroll() {
@@ -389,7 +446,9 @@ void TextBufferWindow::putCharUni(uint32 ch) {
 	int linelen;
 	uint color;
 
-	gli_tts_speak(&ch, 1);
+	// text being wrapped again has already been spoken
+	if (!_reflowing)
+		gli_tts_speak(&ch, 1);
 
 	pw = (_bbox.right - _bbox.left - g_conf->_tMarginX * 2 - g_conf->_scrollWidth) * GLI_SUBPIX;
 	pw = pw - 2 * SLOP - _radjw - _ladjw;
@@ -542,6 +601,8 @@ void TextBufferWindow::clear() {
 
 	_numChars = 0;
 
+	_unwrapped.clear();
+
 	for (i = 0; i < _scrollBack; i++) {
 		_lines[i]._len = 0;
 
@@ -1215,6 +1276,10 @@ int TextBufferWindow::acceptScroll(uint arg) {
 		break;
 	}
 
+	// wrap more of the scrollback before reaching the end of the wrapped rows
+	if (!_unwrapped._chars.empty() && _scrollPos + _height * 2 > _scrollMax)
+		wrapScrollback(MAX(_scrollPos + _height * 3, (_scrollMax + 1) * 2));
+
 	if (_scrollPos > _scrollMax - _height + 1)
 		_scrollPos = _scrollMax - _height + 1;
 	if (_scrollPos < 0)
@@ -1549,11 +1614,13 @@ void TextBufferWindow::scrollOneLine(bool forced) {
 	_lines[0]._len = _numChars;
 	_lines[0]._newLine = forced;
 
-	for (int i = _scrollBack - 1; i > 0; i--) {
-		memcpy(&_lines[i], &_lines[i - 1], sizeof(TextBufferRow));
-		if (i < _height)
-			touch(i);
-	}
+	// the oldest row is always empty, as the scrollback grows before getting full
+	_lines.rotate();
+	_chars = _lines[0]._chars;
+	_attrs = _lines[0]._attrs;
+
+	for (int i = 1; i < _height && i < _scrollBack; i++)
+		touch(i);
 
 	if (_radjn)
 		_radjn--;
@@ -1644,6 +1711,33 @@ void TextBufferWindow::flowBreak() {
 
 /*--------------------------------------------------------------------------*/
 
+void TextBufferWindow::TextBufferRows::resize(uint newSize) {
+	if (_first) {
+		// put the rows back in order before adding or removing the oldest ones
+		Common::Array<TextBufferRow> rows;
+		rows.reserve(MAX<uint>(newSize, _rows.size()));
+		for (uint i = 0; i < _rows.size(); i++)
+			rows.push_back((*this)[i]);
+		_rows.swap(rows);
+		_first = 0;
+	}
+
+	_rows.resize(newSize);
+}
+
+/*--------------------------------------------------------------------------*/
+
+void TextBufferWindow::FlowText::clear() {
+	for (uint i = 0; i < _pictures.size(); i++)
+		_pictures[i]._pic->decrement();
+
+	_chars.clear();
+	_attrs.clear();
+	_pictures.clear();
+}
+
+/*--------------------------------------------------------------------------*/
+
 TextBufferWindow::TextBufferRow::TextBufferRow() : _len(0), _newLine(0), _dirty(false),
 	_repaint(false), _lPic(nullptr), _rPic(nullptr), _lHyper(0), _rHyper(0),
 	_lm(0), _rm(0) {
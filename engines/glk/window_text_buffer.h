@@ -52,11 +52,87 @@ class TextBufferWindow : public TextWindow, Speech {
 		 */
 		TextBufferRow();
 	};
-	typedef Common::Array<TextBufferRow> TextBufferRows;
+
+	/**
+	 * Rows of the window, newest first. They are kept in a ring, so that
+	 * scrolling in a new line doesn't have to move every row of the scrollback
+	 */
+	class TextBufferRows {
+	private:
+		Common::Array<TextBufferRow> _rows;
+		uint _first;	///< Index in _rows of the newest row
+	public:
+		TextBufferRows() : _first(0) {}
+
+		uint size() const { return _rows.size(); }
+
+		TextBufferRow &operator[](uint idx) { return _rows[(_first + idx) % _rows.size()]; }
+		const TextBufferRow &operator[](uint idx) const { return _rows[(_first + idx) % _rows.size()]; }
+
+		/**
+		 * Change the number of rows, keeping their order
+		 */
+		void resize(uint newSize);
+
+		/**
+		 * Turn the oldest row into the newest one, moving all the others one row back
+		 */
+		void rotate() { _first = (_first + _rows.size() - 1) % _rows.size(); }
+	};
+
+	/**
+	 * Picture placed at a given position of a run of text
+	 */
+	struct FlowPicture {
+		uint _offset;
+		uint _align;
+		Picture *_pic;
+		uint _hyper;
+	};
+
+	/**
+	 * Text of the scrollback laid out as logical paragraphs, separated by '\n'
+	 */
+	struct FlowText {
+		Common::Array<uint32> _chars;
+		Common::Array<Attributes> _attrs;
+		Common::Array<FlowPicture> _pictures;
+
+		void clear();
+	};
 private:
 	PropFontInfo &_font;
+
+	/**
+	 * Oldest part of the scrollback, which isn't wrapped to the current width.
+	 * When the window width changes, only the newest paragraphs are wrapped
+	 * again; the older ones are moved here, and wrapped on demand when
+	 * scrolling back to them.
+	 */
+	FlowText _unwrapped;
+	bool _reflowing;
 private:
-	void reflow();
+	/**
+	 * Wrap the text again to the window width
+	 * @param minRows	Stop once at least this many rows have been wrapped, -1 to wrap everything
+	 */
+	void reflow(int minRows);
+
+	/**
+	 * Wrap enough of the unwrapped scrollback to provide at least the given number of rows
+	 */
+	void wrapScrollback(int minRows);
+
+	/**
+	 * Lay out text from a given paragraph start, after clearing the window
+	 */
+	void flowText(const FlowText &text, uint start, int inputbyte);
+
+	/**
+	 * Return the start of the oldest paragraph that needs to be wrapped
+	 * to get an estimated number of rows
+	 */
+	uint findFlowStart(const FlowText &text, int rows) const;
 	void touchScroll();
 	bool putPicture(Picture *pic, uint align, uint linkval);
 
@@ -128,6 +204,7 @@ public:
 	gidispatch_rock_t _inArrayRock;
 
 	uint _echoLineInput;
+	bool _lazyReflow;      ///< Only wrap the newest rows when the width changes
 	uint *_lineTerminators;
 
 	// style hints and settings
@@ -149,6 +226,13 @@ public:
 
 	int acceptScroll(uint arg);
 
+	/**
+	 * Alternately shrink and restore the window width count times, first
+	 * wrapping all the scrollback each time, then only the visible part
+	 * @param fill	Number of paragraphs of text to write first
+	 */
+	void benchmarkReflow(int count, int fill, uint32 &fullTime, uint32 &lazyTime);
+
 	uint drawPicture(const Common::String &image, uint align, uint scaled, uint width, uint height);
 
 	/**
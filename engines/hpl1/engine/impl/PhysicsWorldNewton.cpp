@@ -50,6 +50,9 @@
 #include "hpl1/engine/math/Math.h"
 #include "hpl1/engine/system/low_level_system.h"
 
+#include "common/system.h"
+#include "common/task-scheduler.h"
+
 namespace hpl {
 
 //////////////////////////////////////////////////////////////////////////
@@ -64,6 +67,10 @@ cPhysicsWorldNewton::cPhysicsWorldNewton()
 
 	if (mpNewtonWorld == NULL) {
 		Warning("Couldn't create newton world!\n");
+	} else {
+		// Spread the broadphase and the islands over the worker threads,
+		// plus this one which helps while waiting for them
+		NewtonSetThreadsCount(mpNewtonWorld, g_system->getTaskScheduler()->getWorkerCount() + 1);
 	}
 
 	/////////////////////////////////
@@ -23,32 +23,31 @@
 #include "dgTypes.h"
 #include "dgThreads.h"
 
-inline void dgSpinUnlock(dgInt32 *spin) {
-	*spin = 0;
-}
+#include "common/system.h"
 
-dgThreads::dgThreads() {
-	m_numberOfCPUCores = 0;
+class dgThreads::dgJobTask : public Common::Task {
+public:
+	dgJobTask(dgThreads *const manager, dgWorkerThread *const job) :
+		m_manager(manager), m_job(job) {
+	}
 
-	m_numOfThreads = 0;
-	m_exit = false;
+	void run() override {
+		m_manager->DoWork(m_job);
+	}
 
-	m_topIndex = 0;
-	m_bottomIndex = 0;
-	m_workInProgress = 0;
-	m_globalSpinLock = 0;
-	m_workToDoSpinLock = 0;
+private:
+	dgThreads *m_manager;
+	dgWorkerThread *m_job;
+};
 
+dgThreads::dgThreads() {
+	m_numOfThreads = 0;
 	m_getPerformanceCount = NULL;
-	for (dgInt32 i = 0; i < DG_MAXIMUN_THREADS; i++) {
-		m_localData[i].m_ticks = 0;
-		m_localData[i].m_threadIndex = i;
-		m_localData[i].m_manager = this;
-	}
+	ClearTimers();
 }
 
 dgThreads::~dgThreads() {
-
+	DestroydgThreads();
 }
 
 dgInt32 dgThreads::GetThreadCount() const {
@@ -56,7 +55,9 @@ dgInt32 dgThreads::GetThreadCount() const {
 }
 
 void dgThreads::ClearTimers() {
-
+	for (dgInt32 i = 0; i < DG_MAXIMUN_THREADS; i++) {
+		m_ticks[i] = 0;
+	}
 }
 
 void dgThreads::SetPerfomanceCounter(OnGetPerformanceCountCallback callback) {
@@ -65,48 +66,56 @@ void dgThreads::SetPerfomanceCounter(OnGetPerformanceCountCallback callback) {
 
 dgUnsigned32 dgThreads::GetPerfomanceTicks(dgUnsigned32 threadIndex) const {
 
-	if (dgInt32(threadIndex) <= m_numOfThreads) {
-		return dgUnsigned32(m_localData[threadIndex].m_ticks);
+	if (dgInt32(threadIndex) < GetThreadCount()) {
+		return dgUnsigned32(m_ticks[threadIndex]);
 	} else {
 		return 0;
 	}
 }
 
 void dgThreads::CreateThreaded(dgInt32 threads) {
+	DestroydgThreads();
 
+	// The calling thread helps with the jobs while it waits for them, so
+	// one more thread than there are workers can be kept busy
+	const dgInt32 workers = dgInt32(g_system->getTaskScheduler()->getWorkerCount());
+	threads = GetMin(threads, workers + 1, dgInt32(DG_MAXIMUN_THREADS));
+	m_numOfThreads = (threads > 1) ? threads : 0;
 }
 
 void dgThreads::DestroydgThreads() {
-
+	SynchronizationBarrier();
+	m_numOfThreads = 0;
 }
 
 //Queues up another to work
 dgInt32 dgThreads::SubmitJob(dgWorkerThread *const job) {
 	NEWTON_ASSERT(job->m_threadIndex != -1);
-	job->ThreadExecute();
-	return 1;
-}
-
-void *dgThreads::ThreadExecute(void *param) {
-	dgLocadData &data = *(dgLocadData *) param;
-	data.m_manager->DoWork(data.m_threadIndex);
-	return 0;
-}
-
-dgInt32 dgThreads::GetWork(dgWorkerThread **job) {
-	dgWorkerThread *cWorker = m_queue[m_bottomIndex];
-	*job = cWorker;
+	if (m_numOfThreads) {
+		m_jobs.push_back(g_system->getTaskScheduler()->submit(new dgJobTask(this, job)));
+	} else {
+		DoWork(job);
+	}
 	return 1;
 }
 
-void dgThreads::DoWork(dgInt32 mythreadIndex) {
-//	dgWorkerThread *job;
-
-//	job->ThreadExecute();
+void dgThreads::DoWork(dgWorkerThread *const job) {
+	// Every job submitted before a barrier has its own thread index, so
+	// the counters are never updated concurrently
+	if (m_getPerformanceCount) {
+		const dgUnsigned32 ticks = m_getPerformanceCount();
+		job->ThreadExecute();
+		m_ticks[job->m_threadIndex] += dgInt32(m_getPerformanceCount() - ticks);
+	} else {
+		job->ThreadExecute();
+	}
 }
 
 void dgThreads::SynchronizationBarrier() {
-
+	for (uint i = 0; i < m_jobs.size(); i++) {
+		m_jobs[i].wait();
+	}
+	m_jobs.clear();
 }
 
 void dgThreads::CalculateChunkSizes(dgInt32 elements,
@@ -127,24 +136,20 @@ void dgThreads::CalculateChunkSizes(dgInt32 elements,
 }
 
 void dgThreads::dgGetLock() const {
-	NEWTON_ASSERT(sizeof(dgInt32) == sizeof(long));
-
-	//spinLock( &m_globalSpinLock );
-// linux and mac may need to yeald time
-//	while(! __sync_bool_compare_and_swap(&m_globalSpinLock, 0, 1) ) {
-//		ThreadYield();
-//	}
+	m_globalLock.lock();
 }
 
 void dgThreads::dgReleaseLock() const {
-	dgSpinUnlock(&m_globalSpinLock);
+	m_globalLock.unlock();
 }
 
+// The solver may hold the locks of both bodies of a joint at once, in no
+// particular order. A single recursive mutex for all lock variables can
+// not deadlock on that, unlike one lock per variable.
 void dgThreads::dgGetIndirectLock(dgInt32 *lockVar) {
-	NEWTON_ASSERT(sizeof(dgInt32) == sizeof(long));
+	m_indirectLock.lock();
 }
 
 void dgThreads::dgReleaseIndirectLock(dgInt32 *lockVar) {
-	NEWTON_ASSERT(sizeof(dgInt32) == sizeof(long));
-	dgSpinUnlock(lockVar);
+	m_indirectLock.unlock();
 }
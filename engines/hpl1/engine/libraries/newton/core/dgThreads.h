@@ -22,7 +22,9 @@
 #if !defined(AFX_DG_THREADS_42YH_HY78GT_YHJ63Y__INCLUDED_)
 #define AFX_DG_THREADS_42YH_HY78GT_YHJ63Y__INCLUDED_
 
-#define DG_MAXQUEUE     16
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/task-scheduler.h"
 
 
 class dgWorkerThread {
@@ -61,35 +63,20 @@ public:
 	void dgReleaseIndirectLock(dgInt32 *lockVar);
 
 private:
-	struct dgLocadData {
-		dgInt32 m_ticks;
-		dgInt32 m_threadIndex;
-		dgThreads *m_manager;
-	};
+	class dgJobTask;
 
-	void DoWork(dgInt32 threadIndex);
-	dgInt32 GetWork(dgWorkerThread **cWork);
-
-
-	static void *ThreadExecute(void *Param);
+	void DoWork(dgWorkerThread *const job);
 
 	dgInt32 m_numOfThreads;
-	dgInt32 m_numberOfCPUCores;
-	dgInt32 m_topIndex;
-	dgInt32 m_bottomIndex;
-	dgInt32 m_workInProgress;
-	mutable dgInt32 m_globalSpinLock;
-
-	bool m_exit;
-	//dgInt32 m_emptySlot;
-	//dgInt32 m_workToDo;
-	//dgInt32 m_criticalSection;
-	dgInt32 m_workToDoSpinLock;
-	dgWorkerThread *m_queue[DG_MAXQUEUE];
-	//pthread_t m_threadhandles[DG_MAXIMUN_THREADS];
+
+	// The jobs run on the task scheduler of the backend. Both locks are
+	// recursive, which the user callbacks and the solver rely on.
+	Common::Array<Common::TaskFuture> m_jobs;
+	mutable Common::Mutex m_globalLock;
+	Common::Mutex m_indirectLock;
 
 	OnGetPerformanceCountCallback m_getPerformanceCount;
-	dgLocadData m_localData[DG_MAXIMUN_THREADS];
+	dgInt32 m_ticks[DG_MAXIMUN_THREADS];
 };
 
 
@@ -537,9 +537,9 @@ void dgBody::CalcInvInertiaMatrixSimd() {
 
 void dgBody::UpdateMatrix(dgFloat32 timestep, dgInt32 threadIndex) {
 	if (m_matrixUpdate) {
-		//      m_world->dgGetUserLock_();
+		m_world->dgGetUserLock();
 		m_matrixUpdate(reinterpret_cast<const NewtonBody *>(this), &m_matrix.m_front.m_x, threadIndex);
-		//      m_world->dgReleasedUserLock_();
+		m_world->dgReleasedUserLock();
 	}
 	//  UpdateCollisionMatrix (timestep, threadIndex);
 	if (m_world->m_cpu == dgSimdPresent) {
@@ -772,7 +772,9 @@ void dgBroadPhaseApplyExternalForce::ThreadExecute() {
 				NEWTON_ASSERT(
 				    body->m_collision->IsType(dgCollision::dgConvexCollision_RTTI) || body->m_collision->IsType(dgCollision::dgCollisionCompound_RTTI) || body->m_collision->IsType(dgCollision::dgCollisionConvexModifier_RTTI));
 
+				m_world->dgGetUserLock();
 				body->ApplyExtenalForces(m_timeStep, m_threadIndex);
+				m_world->dgReleasedUserLock();
 				if (!body->IsInEquelibrium()) {
 					body->m_sleeping = false;
 					body->m_equilibrium = false;
@@ -791,7 +793,9 @@ void dgBroadPhaseApplyExternalForce::ThreadExecute() {
 				NEWTON_ASSERT(
 				    body->m_collision->IsType(dgCollision::dgConvexCollision_RTTI) || body->m_collision->IsType(dgCollision::dgCollisionCompound_RTTI) || body->m_collision->IsType(dgCollision::dgCollisionConvexModifier_RTTI));
 
+				m_world->dgGetUserLock();
 				body->ApplyExtenalForces(m_timeStep, m_threadIndex);
+				m_world->dgReleasedUserLock();
 				if (!body->IsInEquelibrium()) {
 					body->m_sleeping = false;
 					body->m_equilibrium = false;
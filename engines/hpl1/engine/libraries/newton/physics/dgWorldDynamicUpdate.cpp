@@ -1167,6 +1167,13 @@ dgInt32 dgWorldDynamicUpdate::GetJacobialDerivatives(const dgIsland &island,
 			NEWTON_ASSERT(constraint->m_body0);
 			NEWTON_ASSERT(constraint->m_body1);
 
+			// Joints call the limit callbacks of the application, which may
+			// not be safe to run on several threads
+			const bool userLock = !constraint->m_isUnilateral;
+			if (userLock) {
+				m_world->dgGetUserLock();
+			}
+
 			constraint->m_body0->m_inCallback = true;
 			constraint->m_body1->m_inCallback = true;
 
@@ -1175,6 +1182,10 @@ dgInt32 dgWorldDynamicUpdate::GetJacobialDerivatives(const dgIsland &island,
 			constraint->m_body0->m_inCallback = false;
 			constraint->m_body1->m_inCallback = false;
 
+			if (userLock) {
+				m_world->dgReleasedUserLock();
+			}
+
 			dgInt32 m0 =
 			    (constraint->m_body0->m_invMass.m_w != dgFloat32(0.0f)) ? constraint->m_body0->m_index : 0;
 			dgInt32 m1 =
@@ -6077,6 +6088,13 @@ void dgParallelSolverBuildJacobianMatrix::ThreadExecute() {
 			NEWTON_ASSERT(constraint->m_body0);
 			NEWTON_ASSERT(constraint->m_body1);
 
+			// Joints call the limit callbacks of the application, which may
+			// not be safe to run on several threads
+			const bool userLock = !constraint->m_isUnilateral;
+			if (userLock) {
+				m_world->dgGetUserLock();
+			}
+
 			constraint->m_body0->m_inCallback = true;
 			constraint->m_body1->m_inCallback = true;
 
@@ -6085,6 +6103,10 @@ void dgParallelSolverBuildJacobianMatrix::ThreadExecute() {
 			constraint->m_body0->m_inCallback = false;
 			constraint->m_body1->m_inCallback = false;
 
+			if (userLock) {
+				m_world->dgReleasedUserLock();
+			}
+
 			dgInt32 m0 =
 			    (constraint->m_body0->m_invMass.m_w != dgFloat32(0.0f)) ? constraint->m_body0->m_index : 0;
 			dgInt32 m1 =
@@ -30,6 +30,7 @@
 #include "sci/version.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/savegame.h"
 #include "sci/engine/gc.h"
@@ -126,6 +127,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("restart_game",		WRAP_METHOD(Console, cmdRestartGame));
 	registerCmd("version",			WRAP_METHOD(Console, cmdGetVersion));
 	registerCmd("room",				WRAP_METHOD(Console, cmdRoomNumber));
+	registerCmd("avoidpath_cache",	WRAP_METHOD(Console, cmdAvoidPathCache));
 	registerCmd("quit",				WRAP_METHOD(Console, cmdQuit));
 	registerCmd("list_saves",			WRAP_METHOD(Console, cmdListSaves));
 	// Graphics
@@ -368,6 +370,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" restart_game - Restarts the game\n");
 	debugPrintf(" version - Shows the resource and interpreter versions\n");
 	debugPrintf(" room - Gets or sets the current room number\n");
+	debugPrintf(" avoidpath_cache - Shows, clears, toggles or benchmarks the pathfinding cache\n");
 	debugPrintf(" quit - Quits the game\n");
 	debugPrintf("\n");
 	debugPrintf("Graphics:\n");
@@ -1163,6 +1166,40 @@ bool Console::cmdRoomNumber(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdAvoidPathCache(int argc, const char **argv) {
+	AvoidPathCache *cache = _engine->_gamestate->_avoidPathCache;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "clear")) {
+		cache->clear();
+		cache->resetStats();
+		debugPrintf("Pathfinding cache cleared\n");
+	} else if (argc == 2 && (!scumm_stricmp(argv[1], "on") || !scumm_stricmp(argv[1], "off"))) {
+		cache->setEnabled(!scumm_stricmp(argv[1], "on"));
+		debugPrintf("Pathfinding cache %s\n", cache->isEnabled() ? "enabled" : "disabled");
+	} else if ((argc == 2 || argc == 3) && !scumm_stricmp(argv[1], "bench")) {
+		int count = (argc == 3) ? atoi(argv[2]) : 100;
+		uint32 uncachedTime, cachedTime;
+
+		if (count <= 0 || !cache->benchmark(_engine->_gamestate, count, uncachedTime, cachedTime)) {
+			debugPrintf("No pathfinding query to replay. Walk around the room first\n");
+			return true;
+		}
+
+		debugPrintf("Replayed the last AvoidPath query %d times: %u ms uncached, %u ms cached\n", count, uncachedTime, cachedTime);
+	} else if (argc == 1) {
+		const AvoidPathCache::Stats &stats = cache->getStats();
+		debugPrintf("Pathfinding cache is %s\n", cache->isEnabled() ? "enabled" : "disabled");
+		debugPrintf("Queries: %u, hits: %u, misses: %u, uncached: %u\n", stats.queries, stats.hits, stats.misses, stats.uncached);
+		debugPrintf("Vertex visibility computed: %u, reused: %u\n", stats.rowsComputed, stats.rowsReused);
+	} else {
+		debugPrintf("Shows the statistics of the pathfinding cache\n");
+		debugPrintf("Usage: %s [clear | on | off | bench [count]]\n", argv[0]);
+		debugPrintf("bench replays the last AvoidPath query of the game with and without the cache\n");
+	}
+
+	return true;
+}
+
 bool Console::cmdResourceInfo(int argc, const char **argv) {
 	if (argc != 3) {
 		debugPrintf("Shows information about a resource\n");
@@ -84,6 +84,7 @@ private:
 	bool cmdRestartGame(int argc, const char **argv);
 	bool cmdGetVersion(int argc, const char **argv);
 	bool cmdRoomNumber(int argc, const char **argv);
+	bool cmdAvoidPathCache(int argc, const char **argv);
 	bool cmdQuit(int argc, const char **argv);
 	bool cmdListSaves(int argc, const char **argv);
 	// Screen
@@ -21,6 +21,7 @@
 
 #include "sci/sci.h"
 #include "sci/engine/state.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
 #include "sci/graphics/paint16.h"
@@ -116,10 +117,14 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Position in the vertex index
+	int index;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = nullptr;
+		index = -1;
 	}
 };
 
@@ -262,6 +267,13 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Cached visibility graph of the polygon set, if any. The vertices of
+	// the graph start at _graphOffset in the vertex index, the vertices
+	// before it are the start and end points.
+	AvoidPathCache *_cache;
+	AvoidPathCache::Graph *_graph;
+	int _graphOffset;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = nullptr;
 		vertex_end = nullptr;
@@ -269,6 +281,9 @@ struct PathfindingState {
 		_prependPoint = nullptr;
 		_appendPoint = nullptr;
 		vertices = 0;
+		_cache = nullptr;
+		_graph = nullptr;
+		_graphOffset = 0;
 	}
 
 	~PathfindingState() {
@@ -698,6 +713,58 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether a vertex is visible from another vertex. The result
+ * doesn't depend on the order of the two vertices.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the first vertex
+ * @param vertex		the second vertex
+ * @return true if the line between the vertices doesn't cross a polygon
+ */
+static bool vertex_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Fills a row of the cached visibility graph. Pairs whose other vertex
+ * already has a complete row are taken from that row.
+ * @param s				the pathfinding state
+ * @param row			the graph vertex
+ */
+static void fill_graph_row(PathfindingState *s, uint row) {
+	AvoidPathCache::Graph *graph = s->_graph;
+	Vertex *vertex_cur = s->vertex_index[s->_graphOffset + row];
+
+	for (uint i = 0; i < graph->rowComplete.size(); i++) {
+		if (graph->rowComplete[i] ? graph->isVisible(i, row) : vertex_visible(s, vertex_cur, s->vertex_index[s->_graphOffset + i]))
+			graph->setVisible(row, i);
+	}
+
+	graph->rowComplete[row] = true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -706,34 +773,23 @@ static int inside(const Common::Point &p, Vertex *vertex) {
  */
 static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	VertexList *visVerts = new VertexList();
+	const int row = vertex_cur->index - s->_graphOffset;
+	const bool cached = s->_graph && row >= 0;
+
+	if (cached) {
+		if (s->_graph->rowComplete[row]) {
+			s->_cache->getStats().rowsReused++;
+		} else {
+			fill_graph_row(s, row);
+			s->_cache->getStats().rowsComputed++;
+		}
+	}
 
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
+		const int column = i - s->_graphOffset;
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
-
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
-		}
-
-		if (j == s->vertices)
+		if (cached && column >= 0 ? s->_graph->isVisible(row, column) : vertex_visible(s, vertex_cur, vertex))
 			visVerts->push_front(vertex);
 	}
 
@@ -1326,6 +1382,34 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// Collect the geometry of the polygon set, the key of its cached
+	// visibility graph
+	AvoidPathCache *cache = s->_avoidPathCache;
+	Common::Array<Common::Point> graphPoints;
+	Common::Array<uint16> graphPolygonSizes;
+	uint32 graphHash = 0;
+	uint polygonCount = 0;
+
+	if (cache->isEnabled()) {
+		for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+			polygon = *it;
+			Vertex *vertex;
+			uint16 size = 0;
+
+			CLIST_FOREACH(vertex, &polygon->vertices) {
+				graphPoints.push_back(vertex->v);
+				graphHash = graphHash * 31 + (uint16)vertex->v.x;
+				graphHash = graphHash * 31 + (uint16)vertex->v.y;
+				++size;
+			}
+
+			graphPolygonSizes.push_back(size);
+			graphHash = graphHash * 31 + size;
+		}
+
+		polygonCount = graphPolygonSizes.size();
+	}
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1343,12 +1427,31 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count;
 			pf_s->vertex_index[count++] = vertex;
 		}
 	}
 
 	pf_s->vertices = count;
 
+	if (cache->isEnabled()) {
+		// Points that weren't already vertices are added in front of the
+		// polygon list as single-vertex polygons, which can't block the
+		// view between other vertices. If a point split an edge instead,
+		// the cached graph doesn't apply.
+		const uint addedPolygons = pf_s->polygons.size() - polygonCount;
+
+		cache->getStats().queries++;
+
+		if (count == (int)(graphPoints.size() + addedPolygons)) {
+			pf_s->_cache = cache;
+			pf_s->_graph = cache->lookup(graphHash, graphPoints, graphPolygonSizes);
+			pf_s->_graphOffset = addedPolygons;
+		} else {
+			cache->getStats().uncached++;
+		}
+	}
+
 	return pf_s;
 }
 
@@ -1611,6 +1714,8 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 			}
 		}
 
+		s->_avoidPathCache->recordQuery(poly_list, start, end, width, height, opt);
+
 		PathfindingState *p = convert_polygon_set(s, poly_list, start, end, width, height, opt);
 
 		if (!p) {
@@ -1644,6 +1749,115 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	}
 }
 
+AvoidPathCache::AvoidPathCache() : _useCounter(0), _enabled(true), _hasQuery(false),
+	_queryWidth(0), _queryHeight(0), _queryOpt(0) {
+	resetStats();
+}
+
+AvoidPathCache::~AvoidPathCache() {
+	clear();
+}
+
+AvoidPathCache::Graph *AvoidPathCache::lookup(uint32 hash, const Common::Array<Common::Point> &points, const Common::Array<uint16> &polygonSizes) {
+	if (!_enabled)
+		return nullptr;
+
+	++_useCounter;
+
+	for (uint i = 0; i < _graphs.size(); i++) {
+		Graph *graph = _graphs[i];
+		if (graph->hash == hash && graph->points == points && graph->polygonSizes == polygonSizes) {
+			graph->lastUse = _useCounter;
+			_stats.hits++;
+			return graph;
+		}
+	}
+
+	_stats.misses++;
+	debugC(kDebugLevelAvoidPath, "[avoidpath] New visibility graph for %u vertices in %u polygons", points.size(), polygonSizes.size());
+
+	// Replace the least recently used graph when the cache is full
+	Graph *graph;
+	if (_graphs.size() < kMaxGraphs) {
+		graph = new Graph();
+		_graphs.push_back(graph);
+	} else {
+		graph = _graphs[0];
+		for (uint i = 1; i < _graphs.size(); i++) {
+			if (_graphs[i]->lastUse < graph->lastUse)
+				graph = _graphs[i];
+		}
+	}
+
+	graph->hash = hash;
+	graph->lastUse = _useCounter;
+	graph->points = points;
+	graph->polygonSizes = polygonSizes;
+	graph->rowWords = (points.size() + 31) / 32;
+	graph->visible.clear();
+	graph->visible.resize(points.size() * graph->rowWords, 0);
+	graph->rowComplete.clear();
+	graph->rowComplete.resize(points.size(), false);
+
+	return graph;
+}
+
+void AvoidPathCache::clear() {
+	for (uint i = 0; i < _graphs.size(); i++)
+		delete _graphs[i];
+	_graphs.clear();
+}
+
+void AvoidPathCache::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+void AvoidPathCache::recordQuery(reg_t polyList, const Common::Point &start, const Common::Point &end, int width, int height, int opt) {
+	_hasQuery = true;
+	_queryPolyList = polyList;
+	_queryStart = start;
+	_queryEnd = end;
+	_queryWidth = width;
+	_queryHeight = height;
+	_queryOpt = opt;
+}
+
+bool AvoidPathCache::benchmark(EngineState *s, int count, uint32 &uncachedTime, uint32 &cachedTime) {
+	if (!_hasQuery)
+		return false;
+
+	if (_queryPolyList.getSegment()) {
+		SegmentObj *mobj = s->_segMan->getSegmentObj(_queryPolyList.getSegment());
+		if (!mobj || mobj->getType() != SEG_TYPE_LISTS || !mobj->isValidOffset(_queryPolyList.getOffset()))
+			return false;
+	}
+
+	const bool enabled = _enabled;
+	const Stats stats = _stats;
+
+	for (int pass = 0; pass < 2; pass++) {
+		_enabled = (pass == 1);
+
+		const uint32 startTime = g_system->getMillis();
+		for (int i = 0; i < count; i++) {
+			PathfindingState *p = convert_polygon_set(s, _queryPolyList, _queryStart, _queryEnd, _queryWidth, _queryHeight, _queryOpt);
+			if (p) {
+				AStar(p);
+				delete p;
+			}
+		}
+
+		if (pass == 0)
+			uncachedTime = g_system->getMillis() - startTime;
+		else
+			cachedTime = g_system->getMillis() - startTime;
+	}
+
+	_enabled = enabled;
+	_stats = stats;
+	return true;
+}
+
 static bool PointInRect(const Common::Point &point, int16 rectX1, int16 rectY1, int16 rectX2, int16 rectY2) {
 	int16 top = MIN<int16>(rectY1, rectY2);
 	int16 left = MIN<int16>(rectX1, rectX2);
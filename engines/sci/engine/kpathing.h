@@ -0,0 +1,122 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+#include "sci/engine/vm_types.h"
+
+namespace Sci {
+
+struct EngineState;
+
+/**
+ * Cache of the visibility graphs computed by kAvoidPath.
+ *
+ * Scripts that move actors around obstacles call kAvoidPath every few
+ * cycles with the same polygon set. The visibility between the vertices of
+ * the polygons only depends on their geometry, so it is kept here, keyed by
+ * a hash of the polygon points, and only the start and end points have to be
+ * tested again on repeat queries.
+ */
+class AvoidPathCache {
+public:
+	struct Stats {
+		uint32 queries;      ///< Pathfinding queries
+		uint32 hits;         ///< Queries that found a cached graph
+		uint32 misses;       ///< Queries that created a new graph
+		uint32 uncached;     ///< Queries that split a polygon edge and couldn't use the cache
+		uint32 rowsComputed; ///< Vertices whose visibility was computed
+		uint32 rowsReused;   ///< Vertices whose visibility was taken from the cache
+	};
+
+	/**
+	 * Visibility between the vertices of a polygon set, computed lazily,
+	 * one vertex (row) at a time.
+	 */
+	struct Graph {
+		uint32 hash;
+		uint32 lastUse;
+		Common::Array<Common::Point> points;
+		Common::Array<uint16> polygonSizes;
+
+		uint rowWords;
+		Common::Array<uint32> visible;
+		Common::Array<bool> rowComplete;
+
+		bool isVisible(uint from, uint to) const {
+			return visible[from * rowWords + to / 32] & (1U << (to % 32));
+		}
+
+		void setVisible(uint from, uint to) {
+			visible[from * rowWords + to / 32] |= 1U << (to % 32);
+		}
+	};
+
+	AvoidPathCache();
+	~AvoidPathCache();
+
+	/**
+	 * Returns the graph of a polygon set, creating an empty one if the set
+	 * isn't cached yet. Returns nullptr when the cache is disabled.
+	 */
+	Graph *lookup(uint32 hash, const Common::Array<Common::Point> &points, const Common::Array<uint16> &polygonSizes);
+
+	void clear();
+
+	bool isEnabled() const { return _enabled; }
+	void setEnabled(bool enabled) { _enabled = enabled; }
+
+	Stats &getStats() { return _stats; }
+	void resetStats();
+
+	/** Remembers the input of the last kAvoidPath call, for benchmark() */
+	void recordQuery(reg_t polyList, const Common::Point &start, const Common::Point &end, int width, int height, int opt);
+
+	/**
+	 * Runs the last recorded kAvoidPath query count times without and with
+	 * the cache. Returns false if there is no query to replay or its polygon
+	 * list isn't valid anymore.
+	 */
+	bool benchmark(EngineState *s, int count, uint32 &uncachedTime, uint32 &cachedTime);
+
+private:
+	enum {
+		kMaxGraphs = 8
+	};
+
+	Common::Array<Graph *> _graphs;
+	uint32 _useCounter;
+	bool _enabled;
+	Stats _stats;
+
+	bool _hasQuery;
+	reg_t _queryPolyList;
+	Common::Point _queryStart, _queryEnd;
+	int _queryWidth, _queryHeight, _queryOpt;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
@@ -26,6 +26,7 @@
 #include "sci/engine/file.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
@@ -69,13 +70,15 @@ static const uint16 s_halfWidthSJISMap[256] = {
 EngineState::EngineState(SegManager *segMan) :
 	_segMan(segMan),
 	_msgState(nullptr),
-	_dirseeker() {
+	_dirseeker(),
+	_avoidPathCache(new AvoidPathCache()) {
 
 	reset(false);
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _avoidPathCache;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -46,6 +46,7 @@ class FileHandle;
 class DirSeeker;
 class EventManager;
 class MessageState;
+class AvoidPathCache;
 class SoundCommandParser;
 class VirtualIndexFile;
 
@@ -192,6 +193,8 @@ struct EngineState : public Common::Serializable {
 	MessageState *_msgState;
 	void initMessageState();
 
+	AvoidPathCache *_avoidPathCache; /**< Visibility graphs of kAvoidPath */
+
 	// MemorySegment provides access to a 256-byte block of memory that remains
 	// intact across restarts and restores
 	enum {
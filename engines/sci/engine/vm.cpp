@@ -22,6 +22,7 @@
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/profiler.h"
 
 #include "sci/sci.h"
 #include "sci/console.h"
@@ -322,6 +323,8 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 	if (kernelCallNr >= (int)kernel->_kernelFuncs.size())
 		error("Invalid kernel function 0x%x requested", kernelCallNr);
 
+	PROFILE_COUNT("SCI kernel calls", 1);
+
 	const KernelFunction &kernelCall = kernel->_kernelFuncs[kernelCallNr];
 	reg_t *argv = s->xs->sp + 1;
 
@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/stack.h"
 #include "graphics/primitives.h"
@@ -647,6 +648,8 @@ void GfxAnimate::animateShowPic() {
 }
 
 void GfxAnimate::kernelAnimate(reg_t listReference, bool cycle, int argc, reg_t *argv) {
+	PROFILE_ZONE("SCI animate");
+
 	// If necessary, delay this kAnimate for a running PalVary.
 	// See delayForPalVaryWorkaround() for details.
 	if (_screen->_picNotValid)
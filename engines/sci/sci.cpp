@@ -22,6 +22,7 @@
 #include "common/system.h"
 #include "common/config-manager.h"
 #include "common/debug-channels.h"
+#include "common/profiler.h"
 #include "common/translation.h"
 
 #include "engines/advancedDetector.h"
@@ -975,6 +976,8 @@ void SciEngine::sleep(uint32 msecs) {
 		return;
 	}
 
+	PROFILE_ZONE("SCI sleep");
+
 	const uint32 wakeUpTime = _system->getMillis() + msecs;
 
 	for (;;) {
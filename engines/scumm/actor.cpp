@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/profiler.h"
 #include "common/system.h"	// for setFocusRectangle/clearFocusRectangle
 #include "common/scummsys.h"
 #include "scumm/scumm.h"
@@ -2312,6 +2313,8 @@ Actor *ScummEngine::derefActorSafe(int id, const char *errmsg) const {
 
 
 void ScummEngine::processActors() {
+	PROFILE_ZONE("SCUMM actors");
+
 	int numactors = 0;
 
 #ifdef ENABLE_HE
@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/profiler.h"
 #include "common/system.h"
 #include "scumm/actor.h"
 #include "scumm/charset.h"
@@ -527,6 +528,8 @@ void ScummEngine::markRectAsDirty(VirtScreenNumber virt, int left, int right, in
  * code in the backend is controlled from here.
  */
 void ScummEngine::drawDirtyScreenParts() {
+	PROFILE_ZONE("SCUMM draw");
+
 	// Update verbs
 	updateDirtyScreen(kVerbVirtScreen);
 
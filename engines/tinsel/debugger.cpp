@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/coroutines.h"
 #include "tinsel/tinsel.h"
 #include "tinsel/debugger.h"
 #include "tinsel/dialogs.h"
@@ -73,6 +74,7 @@ Console::Console() : GUI::Debugger() {
 	registerCmd("music",		WRAP_METHOD(Console, cmd_music));
 	registerCmd("sound",		WRAP_METHOD(Console, cmd_sound));
 	registerCmd("string",		WRAP_METHOD(Console, cmd_string));
+	registerCmd("processes",	WRAP_METHOD(Console, cmd_processes));
 }
 
 Console::~Console() {
@@ -167,6 +169,17 @@ bool Console::cmd_string(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmd_processes(int argc, const char **argv) {
+	if (argc != 1) {
+		debugPrintf("%s\n", argv[0]);
+		debugPrintf("Lists the active processes, in the order they are run\n");
+		return true;
+	}
+
+	debugPrintf("%s", CoroScheduler.listProcesses().c_str());
+	return true;
+}
+
 // Noir:
 bool Console::cmd_add_clue(int argc, const char **argv) {
 	if (argc < 2) {
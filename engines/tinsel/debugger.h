@@ -43,6 +43,7 @@ private:
 	bool cmd_music(int argc, const char **argv);
 	bool cmd_sound(int argc, const char **argv);
 	bool cmd_string(int argc, const char **argv);
+	bool cmd_processes(int argc, const char **argv);
 };
 
 } // End of namespace Tinsel
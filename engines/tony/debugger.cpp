@@ -30,6 +30,7 @@ Debugger::Debugger() : GUI::Debugger() {
 	registerCmd("continue",		WRAP_METHOD(Debugger, cmdExit));
 	registerCmd("scene",			WRAP_METHOD(Debugger, Cmd_Scene));
 	registerCmd("dirty_rects",	WRAP_METHOD(Debugger, Cmd_DirtyRects));
+	registerCmd("processes",		WRAP_METHOD(Debugger, Cmd_Processes));
 }
 
 static int strToInt(const char *s) {
@@ -125,4 +126,9 @@ bool Debugger::Cmd_DirtyRects(int argc, const char **argv) {
 	}
 }
 
+bool Debugger::Cmd_Processes(int argc, const char **argv) {
+	debugPrintf("%s", CoroScheduler.listProcesses().c_str());
+	return true;
+}
+
 } // End of namespace Tony
@@ -19,54 +19,78 @@
  *
  */
 
+#include "common/algorithm.h"
+#include "common/hashmap.h"
+#include "common/rect.h"
 #include "twp/graph.h"
 
 namespace Twp {
 
-IndexedPriorityQueue::IndexedPriorityQueue(Common::Array<float> &keys)
+IndexedPriorityQueue::IndexedPriorityQueue(const Common::Array<float> &keys)
 	: _keys(keys) {
 }
 
+void IndexedPriorityQueue::clear(uint size) {
+	_data.clear();
+	_positions.resize(size);
+	for (uint i = 0; i < size; i++)
+		_positions[i] = -1;
+}
+
 void IndexedPriorityQueue::insert(int index) {
 	_data.push_back(index);
-	reorderUp();
+	siftUp(_data.size() - 1);
 }
 
 int IndexedPriorityQueue::pop() {
 	int r = _data[0];
-	_data[0] = _data[_data.size() - 1];
+	_positions[r] = -1;
+	int last = _data.back();
 	_data.pop_back();
-	reorderDown();
+	if (!_data.empty()) {
+		place(0, last);
+		siftDown(0);
+	}
 	return r;
 }
 
-void IndexedPriorityQueue::reorderUp() {
-	if (_data.empty())
-		return;
-	size_t a = _data.size() - 1;
-	while (a > 0) {
-		if (_keys[_data[a]] >= _keys[_data[a - 1]])
-			return;
-		int tmp = _data[a];
-		_data[a] = _data[a - 1];
-		_data[a - 1] = tmp;
-		a--;
+void IndexedPriorityQueue::decreaseKey(int index) {
+	siftUp(_positions[index]);
+}
+
+void IndexedPriorityQueue::place(uint pos, int index) {
+	_data[pos] = index;
+	_positions[index] = pos;
+}
+
+void IndexedPriorityQueue::siftUp(uint pos) {
+	const int index = _data[pos];
+	while (pos > 0) {
+		const uint parent = (pos - 1) / 2;
+		if (_keys[_data[parent]] <= _keys[index])
+			break;
+		place(pos, _data[parent]);
+		pos = parent;
 	}
+	place(pos, index);
 }
 
-void IndexedPriorityQueue::reorderDown() {
-	if (_data.empty())
-		return;
-	for (int a = 0; a < static_cast<int>(_data.size() - 1); a++) {
-		if (_keys[_data[a]] <= _keys[_data[a + 1]])
-			return;
-		int tmp = _data[a];
-		_data[a] = _data[a + 1];
-		_data[a + 1] = tmp;
+void IndexedPriorityQueue::siftDown(uint pos) {
+	const int index = _data[pos];
+	const uint size = _data.size();
+	while (2 * pos + 1 < size) {
+		uint child = 2 * pos + 1;
+		if ((child + 1 < size) && (_keys[_data[child + 1]] < _keys[_data[child]]))
+			child++;
+		if (_keys[index] <= _keys[_data[child]])
+			break;
+		place(pos, _data[child]);
+		pos = child;
 	}
+	place(pos, index);
 }
 
-bool IndexedPriorityQueue::isEmpty() {
+bool IndexedPriorityQueue::isEmpty() const {
 	return _data.empty();
 }
 
@@ -81,33 +105,47 @@ void Graph::addNode(const Math::Vector2d &node) {
 	_edges.push_back(Common::Array<GraphEdge>());
 }
 
-AStar::AStar(Graph *graph)
-	: _fCost(graph->_nodes.size()), _gCost(graph->_nodes.size()), _spt(graph->_nodes.size()), _sf(graph->_nodes.size()) {
-	_graph = graph;
+AStar::AStar() : _pq(_fCost) {
 }
 
-void AStar::search(int source, int target) {
-	IndexedPriorityQueue pq(_fCost);
-	pq.insert(source);
-	while (!pq.isEmpty()) {
-		int NCN = pq.pop();
+void AStar::search(const Graph &graph, int source, int target) {
+	const uint size = graph._nodes.size();
+	_spt.resize(size);
+	_sf.resize(size);
+	_gCost.resize(size);
+	_fCost.resize(size);
+	for (uint i = 0; i < size; i++) {
+		_spt[i] = nullptr;
+		_sf[i] = nullptr;
+	}
+	_pq.clear(size);
+
+	_gCost[source] = 0.f;
+	_fCost[source] = 0.f;
+	_pq.insert(source);
+	while (!_pq.isEmpty()) {
+		int NCN = _pq.pop();
 		_spt[NCN] = _sf[NCN];
-		if (NCN != target) {
-			for (size_t i = 0; i < _graph->_edges[NCN].size(); i++) {
-				GraphEdge &edge = _graph->_edges[NCN][i];
-				float Hcost = length(_graph->_nodes[edge.to] - _graph->_nodes[target]);
-				float Gcost = _gCost[NCN] + edge.cost;
-				if (!_sf[edge.to]) {
-					_fCost[edge.to] = Gcost + Hcost;
-					_gCost[edge.to] = Gcost;
-					pq.insert(edge.to);
-					_sf[edge.to] = &edge;
-				} else if (Gcost < _gCost[edge.to] && !_spt[edge.to]) {
-					_fCost[edge.to] = Gcost + Hcost;
-					_gCost[edge.to] = Gcost;
-					pq.reorderUp();
-					_sf[edge.to] = &edge;
-				}
+		// the distance to the target never overestimates the cost,
+		// so the first time the target is reached its path is the shortest
+		if (NCN == target)
+			break;
+		for (size_t i = 0; i < graph._edges[NCN].size(); i++) {
+			const GraphEdge &edge = graph._edges[NCN][i];
+			if ((edge.to == source) || _spt[edge.to])
+				continue;
+			float Hcost = length(graph._nodes[edge.to] - graph._nodes[target]);
+			float Gcost = _gCost[NCN] + edge.cost;
+			if (!_sf[edge.to]) {
+				_fCost[edge.to] = Gcost + Hcost;
+				_gCost[edge.to] = Gcost;
+				_pq.insert(edge.to);
+				_sf[edge.to] = &edge;
+			} else if (Gcost < _gCost[edge.to]) {
+				_fCost[edge.to] = Gcost + Hcost;
+				_gCost[edge.to] = Gcost;
+				_pq.decreaseKey(edge.to);
+				_sf[edge.to] = &edge;
 			}
 		}
 	}
@@ -123,6 +161,20 @@ void Graph::addEdge(const GraphEdge &e) {
 	}
 }
 
+void Graph::truncate(uint size) {
+	_nodes.resize(size);
+	_edges.resize(size);
+	for (uint i = 0; i < size; i++) {
+		Common::Array<GraphEdge> &edges = _edges[i];
+		for (uint j = 0; j < edges.size();) {
+			if (edges[j].to >= static_cast<int>(size))
+				edges.remove_at(j);
+			else
+				j++;
+		}
+	}
+}
+
 GraphEdge *Graph::edge(int start, int to) {
 	Common::Array<GraphEdge> &edges = _edges[start];
 	for (size_t i = 0; i < edges.size(); i++) {
@@ -133,11 +185,20 @@ GraphEdge *Graph::edge(int start, int to) {
 	return nullptr;
 }
 
-Common::Array<int> Graph::getPath(int source, int target) {
+const GraphEdge *Graph::edge(int start, int to) const {
+	const Common::Array<GraphEdge> &edges = _edges[start];
+	for (size_t i = 0; i < edges.size(); i++) {
+		const GraphEdge *e = &edges[i];
+		if (e->to == to)
+			return e;
+	}
+	return nullptr;
+}
+
+Common::Array<int> Graph::getPath(int source, int target, AStar &astar) const {
 	Common::Array<int> result;
-	AStar astar(this);
 	if (target >= 0) {
-		astar.search(source, target);
+		astar.search(*this, source, target);
 		int nd = target;
 		result.push_back(nd);
 		while ((nd != source) && (astar._spt[nd] != nullptr)) {
@@ -151,7 +212,7 @@ Common::Array<int> Graph::getPath(int source, int target) {
 
 void PathFinder::setWalkboxes(const Common::Array<Walkbox> &walkboxes) {
 	_walkboxes = walkboxes;
-	_graph = nullptr;
+	_graphValid = false;
 }
 
 Math::Vector2d Walkbox::getClosestPointOnEdge(const Math::Vector2d &p) const {
@@ -230,8 +291,30 @@ bool PathFinder::inLineOfSight(const Math::Vector2d &start, const Math::Vector2d
 	return true;
 }
 
-Common::SharedPtr<Graph> PathFinder::createGraph() {
-	Common::SharedPtr<Graph> result(new Graph());
+static Common::Rect boundingRect(const Common::Array<Vector2i> &points) {
+	Common::Rect rect;
+	for (uint i = 0; i < points.size(); i++) {
+		const Common::Rect pointRect(points[i].x, points[i].y, points[i].x + 1, points[i].y + 1);
+		if (i == 0)
+			rect = pointRect;
+		else
+			rect.extend(pointRect);
+	}
+	return rect;
+}
+
+static Common::Rect segmentRect(const Math::Vector2d &p1, const Math::Vector2d &p2) {
+	const Vector2i v1(p1), v2(p2);
+	return Common::Rect(MIN(v1.x, v2.x), MIN(v1.y, v2.y), MAX(v1.x, v2.x) + 1, MAX(v1.y, v2.y) + 1);
+}
+
+static uint32 pointKey(const Math::Vector2d &p) {
+	const Vector2i v(p);
+	return ((uint32)(v.x & 0xFFFF) << 16) | (uint32)(v.y & 0xFFFF);
+}
+
+void PathFinder::updateGraph() {
+	Graph graph;
 	for (uint i = 0; i < _walkboxes.size(); i++) {
 		const Walkbox &walkbox = _walkboxes[i];
 		if (walkbox.getPoints().size() > 2) {
@@ -241,24 +324,69 @@ Common::SharedPtr<Graph> PathFinder::createGraph() {
 			for (uint j = 0; j < walkbox.getPoints().size(); j++) {
 				if (walkbox.concave(j) == firstWalkbox) {
 					Math::Vector2d vertex = (Math::Vector2d)walkbox.getPoints()[j];
-					result->_concaveVertices.push_back(vertex);
-					result->addNode(vertex);
+					graph._concaveVertices.push_back(vertex);
+					graph.addNode(vertex);
 				}
 			}
 		}
 	}
 
-	for (uint i = 0; i < result->_concaveVertices.size(); i++) {
-		for (uint j = 0; j < result->_concaveVertices.size(); j++) {
-			const Math::Vector2d c1(result->_concaveVertices[i]);
-			const Math::Vector2d c2(result->_concaveVertices[j]);
-			if (inLineOfSight(c1, c2)) {
+	// When the walkbox of the actor is the same as in the previous graph,
+	// e.g. when another walkbox has been hidden, the line of sight between
+	// two vertices can only change near the walkboxes which have been added
+	// or removed. These edges are taken from the previous graph.
+	bool reuse = !_graphWalkboxes.empty() && (_graphWalkboxes[0] == _walkboxes[0]);
+	Common::Rect changedRect;
+	bool changed = false;
+	if (reuse) {
+		for (uint k = 0; k < 2; k++) {
+			const Common::Array<Walkbox> &walkboxes = (k == 0) ? _walkboxes : _graphWalkboxes;
+			const Common::Array<Walkbox> &others = (k == 0) ? _graphWalkboxes : _walkboxes;
+			for (uint i = 0; i < walkboxes.size(); i++) {
+				if (Common::find(others.begin(), others.end(), walkboxes[i]) != others.end())
+					continue;
+				const Common::Rect rect = boundingRect(walkboxes[i].getPoints());
+				if (changed)
+					changedRect.extend(rect);
+				else
+					changedRect = rect;
+				changed = true;
+			}
+		}
+		// keep a margin for the tolerance of the line of sight checks
+		changedRect.grow(2);
+	}
+
+	Common::Array<int> previousNodes(graph._concaveVertices.size());
+	if (reuse) {
+		Common::HashMap<uint32, int> nodes;
+		for (uint i = 0; i < _graph._concaveVertices.size(); i++)
+			nodes.setVal(pointKey(_graph._concaveVertices[i]), i);
+		for (uint i = 0; i < graph._concaveVertices.size(); i++)
+			previousNodes[i] = nodes.getValOrDefault(pointKey(graph._concaveVertices[i]), -1);
+	}
+
+	for (uint i = 0; i < graph._concaveVertices.size(); i++) {
+		for (uint j = 0; j < graph._concaveVertices.size(); j++) {
+			const Math::Vector2d c1(graph._concaveVertices[i]);
+			const Math::Vector2d c2(graph._concaveVertices[j]);
+			bool visible;
+			if (reuse && (previousNodes[i] >= 0) && (previousNodes[j] >= 0) &&
+				(!changed || !changedRect.intersects(segmentRect(c1, c2)))) {
+				visible = _graph.edge(previousNodes[i], previousNodes[j]) != nullptr;
+			} else {
+				visible = inLineOfSight(c1, c2);
+			}
+			if (visible) {
 				const float d = distance(c1, c2);
-				result->addEdge(GraphEdge(i, j, d));
+				graph.addEdge(GraphEdge(i, j, d));
 			}
 		}
 	}
-	return result;
+
+	_graph = graph;
+	_graphWalkboxes = _walkboxes;
+	_graphValid = true;
 }
 
 Common::Array<Math::Vector2d> PathFinder::calculatePath(const Math::Vector2d &s, const Math::Vector2d &t) {
@@ -266,11 +394,14 @@ Common::Array<Math::Vector2d> PathFinder::calculatePath(const Math::Vector2d &s,
 	Math::Vector2d to(t);
 	Common::Array<Math::Vector2d> result;
 	if (!_walkboxes.empty()) {
+		// remove the start and end nodes of the previous path
+		_graph.truncate(_graph._concaveVertices.size());
+
 		// find the walkbox where the actor is and put it first
 		for (uint i = 0; i < _walkboxes.size(); i++) {
 			const Walkbox &wb = _walkboxes[i];
 			if (wb.contains(start) && (i != 0)) {
-				_graph.reset();
+				_graphValid = false;
 				SWAP(_walkboxes[0], _walkboxes[i]);
 				break;
 			}
@@ -286,17 +417,16 @@ Common::Array<Math::Vector2d> PathFinder::calculatePath(const Math::Vector2d &s,
 
 			const size_t index = minIndex(dists);
 			if (index != 0) {
-				_graph.reset();
+				_graphValid = false;
 				SWAP(_walkboxes[0], _walkboxes[index]);
 			}
 		}
 
-		if (!_graph)
-			_graph = createGraph();
+		if (!_graphValid)
+			updateGraph();
 
 		// create new node on start position
-		_walkgraph = *_graph;
-		const uint startNodeIndex = _walkgraph._nodes.size();
+		const uint startNodeIndex = _graph._nodes.size();
 
 		// if destination is not inside current walkable area, then get the closest point
 		const Walkbox &wb = _walkboxes[0];
@@ -315,31 +445,31 @@ Common::Array<Math::Vector2d> PathFinder::calculatePath(const Math::Vector2d &s,
 			}
 		}
 
-		_walkgraph.addNode(start);
+		_graph.addNode(start);
 
-		for (uint i = 0; i < _walkgraph._concaveVertices.size(); i++) {
-			const Math::Vector2d c = _walkgraph._concaveVertices[i];
+		for (uint i = 0; i < _graph._concaveVertices.size(); i++) {
+			const Math::Vector2d c = _graph._concaveVertices[i];
 			if (inLineOfSight(start, c))
-				_walkgraph.addEdge(GraphEdge(startNodeIndex, i, distance(start, c)));
+				_graph.addEdge(GraphEdge(startNodeIndex, i, distance(start, c)));
 		}
 
 		// create new node on end position
-		const uint endNodeIndex = _walkgraph._nodes.size();
-		_walkgraph.addNode(to);
+		const uint endNodeIndex = _graph._nodes.size();
+		_graph.addNode(to);
 
-		for (uint i = 0; i < _walkgraph._concaveVertices.size(); i++) {
-			const Math::Vector2d c = _walkgraph._concaveVertices[i];
+		for (uint i = 0; i < _graph._concaveVertices.size(); i++) {
+			const Math::Vector2d c = _graph._concaveVertices[i];
 			if (inLineOfSight(to, c))
-				_walkgraph.addEdge(GraphEdge(i, endNodeIndex, distance(to, c)));
+				_graph.addEdge(GraphEdge(i, endNodeIndex, distance(to, c)));
 		}
 
 		if (inLineOfSight(start, to))
-			_walkgraph.addEdge(GraphEdge(startNodeIndex, endNodeIndex, distance(start, to)));
+			_graph.addEdge(GraphEdge(startNodeIndex, endNodeIndex, distance(start, to)));
 
-		const Common::Array<int> indices = _walkgraph.getPath(startNodeIndex, endNodeIndex);
+		const Common::Array<int> indices = _graph.getPath(startNodeIndex, endNodeIndex, _astar);
 		for (uint i = 0; i < indices.size(); i++) {
 			const int index = indices[i];
-			result.push_back(_walkgraph._nodes[index]);
+			result.push_back(_graph._nodes[index]);
 		}
 	}
 	return result;
@@ -28,21 +28,30 @@
 
 namespace Twp {
 
+// A binary min-heap of node indices, ordered by the keys of the nodes.
 class IndexedPriorityQueue {
 public:
-	explicit IndexedPriorityQueue(Common::Array<float> &keys);
+	explicit IndexedPriorityQueue(const Common::Array<float> &keys);
 
+	// Empties the queue, for nodes in [0, size).
+	void clear(uint size);
 	void insert(int index);
 	int pop();
+	// Restores the order after the key of a queued node has decreased.
+	void decreaseKey(int index);
+	bool contains(int index) const { return _positions[index] >= 0; }
 
-	void reorderUp();
-	void reorderDown();
+	bool isEmpty() const;
 
-	bool isEmpty();
+private:
+	void siftUp(uint pos);
+	void siftDown(uint pos);
+	void place(uint pos, int index);
 
 private:
-	Common::Array<float> &_keys;
+	const Common::Array<float> &_keys;
 	Common::Array<int> _data;
+	Common::Array<int> _positions; // Position of each node in _data, or -1
 };
 
 // An edge is a part of a walkable area, it is used by a Graph.
@@ -60,30 +69,41 @@ struct GraphEdge {
 // A graph helps to find a path between two points.
 // This class has been ported from http://www.groebelsloot.com/2016/03/13/pathfinding-part-2/
 // and modified
+class AStar;
+
 class Graph {
 public:
 	Graph();
 	void addNode(const Math::Vector2d &node);
 	void addEdge(const GraphEdge &edge);
+	// Removes the nodes from 'size' on, and their edges.
+	void truncate(uint size);
 	// Gets the edge from 'from' index to 'to' index.
 	GraphEdge *edge(int start, int to);
-	Common::Array<int> getPath(int source, int target);
+	const GraphEdge *edge(int start, int to) const;
+	Common::Array<int> getPath(int source, int target, AStar &astar) const;
 
 	Common::Array<Math::Vector2d> _nodes;
 	Common::Array<Common::Array<GraphEdge> > _edges;
 	Common::Array<Math::Vector2d> _concaveVertices;
 };
 
+// A* search. The arrays are kept between searches to avoid reallocating them.
 class AStar {
 public:
-	AStar(Graph *graph);
-	void search(int source, int target);
-
-	Graph *_graph = nullptr;
-	Common::Array<GraphEdge *> _spt; // The Shortest Path Tree
-	Common::Array<float> _gCost;     // This array will store the G cost of each node
-	Common::Array<float> _fCost;     // This array will store the F cost of each node
-	Common::Array<GraphEdge *> _sf;  // The Search Frontier
+	AStar();
+	// The arrays are only scratch space, they are not copied.
+	AStar(const AStar &) : _pq(_fCost) {}
+	AStar &operator=(const AStar &) { return *this; }
+	void search(const Graph &graph, int source, int target);
+
+	Common::Array<const GraphEdge *> _spt; // The Shortest Path Tree
+	Common::Array<float> _gCost;           // This array will store the G cost of each node
+	Common::Array<float> _fCost;           // This array will store the F cost of each node
+	Common::Array<const GraphEdge *> _sf;  // The Search Frontier
+
+private:
+	IndexedPriorityQueue _pq;
 };
 
 // Represents an area where an actor can or cannot walk
@@ -98,6 +118,7 @@ public:
 	bool isVisible() const { return _visible; }
 	const Common::Array<Vector2i> &getPoints() const { return _polygon; }
 	Math::Vector2d getClosestPointOnEdge(const Math::Vector2d &p) const;
+	bool operator==(const Walkbox &other) const { return _visible == other._visible && _polygon == other._polygon; }
 
 public:
 	Common::String _name;
@@ -115,16 +136,21 @@ public:
 	Common::Array<Math::Vector2d> calculatePath(const Math::Vector2d &start, const Math::Vector2d &to);
 	void setDirty(bool dirty) { _isDirty = dirty; }
 	bool isDirty() const { return _isDirty; }
-	const Graph &getGraph() const { return _walkgraph; }
+	const Graph &getGraph() const { return _graph; }
 
 private:
-	Common::SharedPtr<Graph> createGraph();
+	void updateGraph();
 	bool inLineOfSight(const Math::Vector2d &start, const Math::Vector2d &to);
 
 private:
 	Common::Array<Walkbox> _walkboxes;
-	Common::SharedPtr<Graph> _graph;
-	Graph _walkgraph;
+	// The concave vertices of the walkboxes, followed by the start and end
+	// nodes of the last path
+	Graph _graph;
+	bool _graphValid = false;
+	// The walkboxes _graph has been created from
+	Common::Array<Walkbox> _graphWalkboxes;
+	AStar _astar;
 	bool _isDirty = true;
 };
 
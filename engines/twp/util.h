@@ -57,6 +57,14 @@ struct Vector2i {
 		return Math::Vector2d(x, y);
 	}
 
+	bool operator==(const Vector2i &v) const {
+		return x == v.x && y == v.y;
+	}
+
+	bool operator!=(const Vector2i &v) const {
+		return !(*this == v);
+	}
+
 	Vector2i operator-(const Vector2i &v) const {
 		return Vector2i(x - v.x, y - v.y);
 	}
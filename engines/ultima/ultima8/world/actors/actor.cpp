@@ -2080,6 +2080,13 @@ bool Actor::loadData(Common::ReadStream *rs, uint32 version) {
 	_actorFlags = rs->readUint32LE();
 	_unkByte = rs->readByte();
 
+	// Item::loadData filed us in the CurrentMap before the kneeling flag
+	// that changes our bounding box was known
+	if (_actorFlags & ACT_KNEELING) {
+		_cachedShapeInfo = nullptr;
+		updateMapEntry();
+	}
+
 	if (GAME_IS_CRUSADER) {
 		_defaultActivity[0] = rs->readUint16LE();
 		_defaultActivity[1] = rs->readUint16LE();
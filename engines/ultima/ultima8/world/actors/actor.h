@@ -137,13 +137,17 @@ public:
 	}
 	void setActorFlag(uint32 mask) {
 		_actorFlags |= mask;
-		if (mask & ACT_KNEELING)
+		if (mask & ACT_KNEELING) {
 			_cachedShapeInfo = nullptr;
+			updateMapEntry();
+		}
 	}
 	void clearActorFlag(uint32 mask) {
 		_actorFlags &= ~mask;
-		if (mask & ACT_KNEELING)
+		if (mask & ACT_KNEELING) {
 			_cachedShapeInfo = nullptr;
+			updateMapEntry();
+		}
 	}
 
 	void setCombatTactic(int no) {
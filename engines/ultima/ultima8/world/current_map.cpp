@@ -46,11 +46,41 @@
 namespace Ultima {
 namespace Ultima8 {
 
-typedef Std::list<Item *> item_list;
-
 const int INT_MAX_VALUE = 0x7fffffff;
 const int INT_MIN_VALUE = -INT_MAX_VALUE - 1;
 
+void ChunkItemIndex::insert(uint idx, const Item *item) {
+	_objIds.insert_at(idx, item->getObjId());
+	_boxes.insert_at(idx, item->getWorldBox());
+	_shapes.insert_at(idx, item->getShape());
+	_shapeFlags.insert_at(idx, item->getShapeInfo()->_flags);
+	_extFlags.insert_at(idx, item->getExtFlags());
+}
+
+void ChunkItemIndex::update(uint idx, const Item *item) {
+	_objIds[idx] = item->getObjId();
+	_boxes[idx] = item->getWorldBox();
+	_shapes[idx] = item->getShape();
+	_shapeFlags[idx] = item->getShapeInfo()->_flags;
+	_extFlags[idx] = item->getExtFlags();
+}
+
+void ChunkItemIndex::remove(uint idx) {
+	_objIds.remove_at(idx);
+	_boxes.remove_at(idx);
+	_shapes.remove_at(idx);
+	_shapeFlags.remove_at(idx);
+	_extFlags.remove_at(idx);
+}
+
+void ChunkItemIndex::clear() {
+	_objIds.clear();
+	_boxes.clear();
+	_shapes.clear();
+	_shapeFlags.clear();
+	_extFlags.clear();
+}
+
 CurrentMap::CurrentMap() : _currentMap(0), _eggHatcher(0),
 	  _fastXMin(-1), _fastYMin(-1), _fastXMax(-1), _fastYMax(-1) {
 	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; i++) {
@@ -81,6 +111,7 @@ void CurrentMap::clear() {
 			for (auto *item : _items[i][j])
 				delete item;
 			_items[i][j].clear();
+			_index[i][j].clear();
 		}
 		memset(_fast[i], false, sizeof(uint32)*MAP_NUM_CHUNKS / 32);
 	}
@@ -146,6 +177,7 @@ void CurrentMap::writeback() {
 				}
 			}
 			_items[i][j].clear();
+			_index[i][j].clear();
 		}
 	}
 
@@ -247,7 +279,8 @@ void CurrentMap::addItem(Item *item) {
 	}
 #endif
 
-	_items[cx][cy].push_front(item);
+	_items[cx][cy].insert_at(0, item);
+	_index[cx][cy].insert(0, item);
 	item->setExtFlag(Item::EXT_INCURMAP);
 
 	Egg *egg = dynamic_cast<Egg *>(item);
@@ -283,6 +316,7 @@ void CurrentMap::addItemToEnd(Item *item) {
 #endif
 
 	_items[cx][cy].push_back(item);
+	_index[cx][cy].insert(_items[cx][cy].size() - 1, item);
 	item->setExtFlag(Item::EXT_INCURMAP);
 
 	Egg *egg = dynamic_cast<Egg *>(item);
@@ -380,9 +414,8 @@ Item *CurrentMap::findBestTargetItem(int32 x, int32 y, int32 z, Direction dir, D
 
 
 void CurrentMap::removeItemFromList(Item *item, int32 oldx, int32 oldy) {
-	//! This might a bit too inefficient
-	// if it's really a problem we could change the item lists into sets
-	// or something, but let's see how it turns out
+	// Chunks hold at most a few hundred items, so a linear scan over the
+	// contiguous pointer array is cheaper than any node based structure.
 
 	if (oldx < 0 || oldx >= _mapChunkSize * MAP_NUM_CHUNKS ||
 	        oldy < 0 || oldy >= _mapChunkSize * MAP_NUM_CHUNKS) {
@@ -393,10 +426,34 @@ void CurrentMap::removeItemFromList(Item *item, int32 oldx, int32 oldy) {
 	int32 cx = oldx / _mapChunkSize;
 	int32 cy = oldy / _mapChunkSize;
 
-	_items[cx][cy].remove(item);
+	ChunkItemList &items = _items[cx][cy];
+	for (uint i = 0; i < items.size(); ++i) {
+		if (items[i] == item) {
+			items.remove_at(i);
+			_index[cx][cy].remove(i);
+			break;
+		}
+	}
 	item->clearExtFlag(Item::EXT_INCURMAP);
 }
 
+void CurrentMap::updateItem(const Item *item, int32 oldx, int32 oldy) {
+	if (oldx < 0 || oldx >= _mapChunkSize * MAP_NUM_CHUNKS ||
+	        oldy < 0 || oldy >= _mapChunkSize * MAP_NUM_CHUNKS)
+		return;
+
+	int32 cx = oldx / _mapChunkSize;
+	int32 cy = oldy / _mapChunkSize;
+
+	const ChunkItemList &items = _items[cx][cy];
+	for (uint i = 0; i < items.size(); ++i) {
+		if (items[i] == item) {
+			_index[cx][cy].update(i, item);
+			break;
+		}
+	}
+}
+
 // Check to see if the chunk is on the screen
 static inline bool ChunkOnScreen(int32 cx, int32 cy, int32 sleft, int32 stop, int32 sright, int32 sbot, int mapChunkSize) {
 	int32 scx = (cx * mapChunkSize - cy * mapChunkSize) / 4;
@@ -506,18 +563,29 @@ void CurrentMap::updateFastArea(const Point3 &from, const Point3 &to) {
 void CurrentMap::setChunkFast(int32 cx, int32 cy) {
 	_fast[cy][cx / 32] |= 1 << (cx & 31);
 
-	for (auto *item : _items[cx][cy]) {
-		item->enterFastArea();
+	// Usecode triggered here may add or remove items in the chunk, so work
+	// on a snapshot of the ids and skip the items destroyed meanwhile
+	const ChunkItemList &items = _items[cx][cy];
+	Std::vector<ObjId> objIds;
+	objIds.reserve(items.size());
+	for (const auto *item : items) {
+		objIds.push_back(item->getObjId());
+	}
+
+	for (ObjId objId : objIds) {
+		Item *item = getItem(objId);
+		if (item)
+			item->enterFastArea();
 	}
 }
 
 void CurrentMap::unsetChunkFast(int32 cx, int32 cy) {
 	_fast[cy][cx / 32] &= ~(1 << (cx & 31));
 
-	item_list::iterator iter = _items[cx][cy].begin();
-	while (iter != _items[cx][cy].end()) {
-		Item *item = *iter;
-		++iter;
+	const ChunkItemList &items = _items[cx][cy];
+	uint i = 0;
+	while (i < items.size()) {
+		Item *item = items[i];
 #ifdef VALIDATE_CHUNKS
 		int32 x, y, z;
 		item->getLocation(x, y, z);
@@ -527,6 +595,11 @@ void CurrentMap::unsetChunkFast(int32 cx, int32 cy) {
 		}
 #endif
 		item->leaveFastArea();  // Can destroy the item
+
+		// Only advance if the item is still in place, otherwise the next
+		// item has been shifted down into this slot.
+		if (i < items.size() && items[i] == item)
+			++i;
 	}
 }
 
@@ -579,13 +652,15 @@ void CurrentMap::areaSearch(UCList *itemlist, const uint8 *loopscript,
 	//
 	for (int cy = miny; cy <= maxy; cy++) {
 		for (int cx = minx; cx <= maxx; cx++) {
-			for (const auto *item : _items[cx][cy]) {
-				if (item->hasExtFlags(Item::EXT_SPRITE))
+			const ChunkItemIndex &index = _index[cx][cy];
+			for (uint i = 0; i < index._objIds.size(); ++i) {
+				if (index._extFlags[i] & Item::EXT_SPRITE)
 					continue;
 
 				// check if item is in range
-				Point3 pt = item->getLocation();
-				if (searchrange.containsXY(pt.x, pt.y)) {
+				if (searchrange.containsXY(index._boxes[i]._x, index._boxes[i]._y)) {
+					const Item *item = _items[cx][cy][i];
+
 					// check item against loopscript
 					if (item->checkLoopScript(loopscript, scriptsize)) {
 						assert(itemlist->getElementSize() == 2);
@@ -621,15 +696,17 @@ void CurrentMap::surfaceSearch(UCList *itemlist, const uint8 *loopscript,
 
 	for (int cy = miny; cy <= maxy; cy++) {
 		for (int cx = minx; cx <= maxx; cx++) {
-			for (const auto *item : _items[cx][cy]) {
-				if (item->getObjId() == check->getObjId())
+			const ChunkItemIndex &index = _index[cx][cy];
+			for (uint i = 0; i < index._objIds.size(); ++i) {
+				if (index._objIds[i] == check->getObjId())
 					continue;
-				if (item->hasExtFlags(Item::EXT_SPRITE))
+				if (index._extFlags[i] & Item::EXT_SPRITE)
 					continue;
 
 				// check if item is in range?
-				const Box ib = item->getWorldBox();
+				const Box &ib = index._boxes[i];
 				if (searchrange.overlapsXY(ib)) {
+					const Item *item = _items[cx][cy][i];
 					bool ok = false;
 
 					if (above && ib._z == (searchrange._z + searchrange._zd)) {
@@ -674,7 +751,7 @@ TeleportEgg *CurrentMap::findDestination(uint16 id) {
 	return nullptr;
 }
 
-const Std::list<Item *> *CurrentMap::getItemList(int32 gx, int32 gy) const {
+const ChunkItemList *CurrentMap::getItemList(int32 gx, int32 gy) const {
 	if (gx < 0 || gy < 0 || gx >= MAP_NUM_CHUNKS || gy >= MAP_NUM_CHUNKS)
 		return nullptr;
 	return &_items[gx][gy];
@@ -713,20 +790,22 @@ PositionInfo CurrentMap::getPositionInfo(const Box &target, const Box &start, ui
 
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			for (const auto *item : _items[cx][cy]) {
-				if (item->getObjId() == id)
+			const ChunkItemIndex &index = _index[cx][cy];
+			for (uint i = 0; i < index._objIds.size(); ++i) {
+				if (index._objIds[i] == id)
 					continue;
-				if (item->hasExtFlags(Item::EXT_SPRITE))
+				if (index._extFlags[i] & Item::EXT_SPRITE)
 					continue;
 
-				const ShapeInfo *si = item->getShapeInfo();
-				if (!(si->_flags & flagmask))
+				const uint32 siflags = index._shapeFlags[i];
+				if (!(siflags & flagmask))
 					continue; // not an interesting item
 
-				Box ib = item->getWorldBox();
+				const Box &ib = index._boxes[i];
+				const Item *item = _items[cx][cy][i];
 
 				// check overlap
-				if ((si->_flags & shapeflags & blockmask) &&
+				if ((siflags & shapeflags & blockmask) &&
 					target.overlaps(ib) && !start.overlaps(ib)) {
 					// overlapping an item. Invalid position
 #if 0
@@ -739,12 +818,12 @@ PositionInfo CurrentMap::getPositionInfo(const Box &target, const Box &start, ui
 
 				if (target.overlapsXY(ib)) {
 					// check support
-					if (si->_flags & supportmask && ib._z + ib._zd > supportz && ib._z + ib._zd <= target._z) {
+					if (siflags & supportmask && ib._z + ib._zd > supportz && ib._z + ib._zd <= target._z) {
 						supportz = ib._z + ib._zd;
 					}
 
 					// check roof
-					if (si->is_roof() && ib._z < roofz && ib._z >= target._z + target._zd) {
+					if ((siflags & ShapeInfo::SI_ROOF) && ib._z < roofz && ib._z >= target._z + target._zd) {
 						info.roof = item;
 						roofz = ib._z;
 					}
@@ -753,7 +832,7 @@ PositionInfo CurrentMap::getPositionInfo(const Box &target, const Box &start, ui
 				// check bottom center
 				if (ib.isBelow(midx, midy, target._z)) {
 					// check land
-					if (si->_flags & landmask && ib._z + ib._zd > landz) {
+					if (siflags & landmask && ib._z + ib._zd > landz) {
 						info.land = item;
 						landz = ib._z + ib._zd;
 					}
@@ -824,20 +903,23 @@ bool CurrentMap::scanForValidPosition(int32 x, int32 y, int32 z, const Item *ite
 
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			for (const auto *citem : _items[cx][cy]) {
-				if (citem->getObjId() == item->getObjId())
+			const ChunkItemIndex &index = _index[cx][cy];
+			for (uint k = 0; k < index._objIds.size(); ++k) {
+				if (index._objIds[k] == item->getObjId())
 					continue;
-				if (citem->hasExtFlags(Item::EXT_SPRITE))
+				if (index._extFlags[k] & Item::EXT_SPRITE)
 					continue;
 
-				const ShapeInfo *si = citem->getShapeInfo();
+				const uint32 siflags = index._shapeFlags[k];
 				//!! need to check is_sea() and is_land() maybe?
-				if (!(si->_flags & blockflagmask))
+				if (!(siflags & blockflagmask))
 					continue; // not an interesting item
 
-				int32 ixd, iyd, izd;
-				Point3 pt = citem->getLocation();
-				citem->getFootpadWorld(ixd, iyd, izd);
+				const Box &ib = index._boxes[k];
+				const Point3 pt(ib._x, ib._y, ib._z);
+				const int32 ixd = ib._xd;
+				const int32 iyd = ib._yd;
+				const int32 izd = ib._zd;
 
 				int minv = pt.z - z - zd + 1;
 				int maxv = pt.z + izd - z - 1;
@@ -876,7 +958,7 @@ bool CurrentMap::scanForValidPosition(int32 x, int32 y, int32 z, const Item *ite
 					for (int i = minh; i <= maxh; ++i)
 						validmask[j + scansize] &= ~(1 << (i + scansize));
 
-				if (wantsupport && si->is_solid() &&
+				if (wantsupport && (siflags & ShapeInfo::SI_SOLID) &&
 				        pt.z + izd >= z - scansize && pt.z + izd <= z + scansize) {
 					for (int i = minh; i <= maxh; ++i)
 						supportmask[pt.z + izd - z + scansize] |= (1 << (i + scansize));
@@ -1006,13 +1088,14 @@ bool CurrentMap::sweepTest(const Point3 &start, const Point3 &end,
 
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			for (const auto *other_item : _items[cx][cy]) {
-				if (other_item->getObjId() == item)
+			const ChunkItemIndex &index = _index[cx][cy];
+			for (uint k = 0; k < index._objIds.size(); ++k) {
+				if (index._objIds[k] == item)
 					continue;
-				if (other_item->hasExtFlags(Item::EXT_SPRITE))
+				if (index._extFlags[k] & Item::EXT_SPRITE)
 					continue;
 
-				uint32 othershapeflags = other_item->getShapeInfo()->_flags;
+				uint32 othershapeflags = index._shapeFlags[k];
 				bool blocking = (othershapeflags & shapeflags &
 				                 blockflagmask) != 0;
 
@@ -1022,11 +1105,13 @@ bool CurrentMap::sweepTest(const Point3 &start, const Point3 &end,
 					continue;
 
 				int32 other[3], oext[3];
-				Point3 opt = other_item->getLocation();
-				other[0] = opt.x;
-				other[1] = opt.y;
-				other[2] = opt.z;
-				other_item->getFootpadWorld(oext[0], oext[1], oext[2]);
+				const Box &ob = index._boxes[k];
+				other[0] = ob._x;
+				other[1] = ob._y;
+				other[2] = ob._z;
+				oext[0] = ob._xd;
+				oext[1] = ob._yd;
+				oext[2] = ob._zd;
 
 				// If the objects overlapped at the start, ignore collision.
 				// The -1 and +1 portions are to still consider collisions
@@ -1167,10 +1252,10 @@ bool CurrentMap::sweepTest(const Point3 &start, const Point3 &end,
 					}
 
 					// Now add it
-					hit->insert(sw_it, SweepItem(other_item->getObjId(), first, last, touch, touch_floor, blocking, dirs));
+					hit->insert(sw_it, SweepItem(index._objIds[k], first, last, touch, touch_floor, blocking, dirs));
 
 					//debugC(kDebugCollision, "Hit item %u (%d, %d, %d) at first: %d, last: %d",
-					//	   other_item->getObjId(), other[0], other[1], other[2], first, last);
+					//	   index._objIds[k], other[0], other[1], other[2], first, last);
 					//debugC(kDebugCollision, "hit item time (%d-%d) (%d-%d) (%d-%d)",
 					//	u_0[0], u_1[0], u_0[1], u_1[1], u_0[2], u_1[2]);
 					//debugC(kDebugCollision, "touch: %d, floor: %d, block: %d", touch, touch_floor, blocking);
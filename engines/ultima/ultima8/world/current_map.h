@@ -25,13 +25,13 @@
 #include "ultima/shared/std/containers.h"
 #include "ultima/ultima8/usecode/intrinsics.h"
 #include "ultima/ultima8/world/position_info.h"
+#include "ultima/ultima8/misc/box.h"
 #include "ultima/ultima8/misc/direction.h"
 #include "ultima/ultima8/misc/point3.h"
 
 namespace Ultima {
 namespace Ultima8 {
 
-struct Box;
 class Map;
 class Item;
 class UCList;
@@ -41,6 +41,26 @@ class EggHatcherProcess;
 #define MAP_NUM_CHUNKS  64
 #define MAP_NUM_TARGET_ITEMS 200
 
+//! The items of a single map chunk. Kept in one contiguous block so the
+//! collision and search loops walk memory linearly instead of list nodes.
+typedef Std::vector<Item *> ChunkItemList;
+
+//! Packed copy of what the area and collision searches test for each item
+//! of a chunk. Entry i describes the item at index i of the ChunkItemList,
+//! so the searches only dereference the items that pass the tests.
+struct ChunkItemIndex {
+	Std::vector<ObjId> _objIds;
+	Std::vector<Box> _boxes;        //!< world bounding boxes
+	Std::vector<uint32> _shapes;
+	Std::vector<uint32> _shapeFlags; //!< ShapeInfo flags of the shapes
+	Std::vector<uint32> _extFlags;   //!< Item extended flags, for the EXT_SPRITE test
+
+	void insert(uint idx, const Item *item);
+	void update(uint idx, const Item *item);
+	void remove(uint idx);
+	void clear();
+};
+
 class CurrentMap {
 	friend class World;
 public:
@@ -73,6 +93,10 @@ public:
 	void removeItemFromList(Item *item, int32 oldx, int32 oldy);
 	void removeItem(Item *item);
 
+	//! Refresh the search index entry of an item after its location, shape
+	//! or flags changed. oldx/oldy are the coordinates it was filed under.
+	void updateItem(const Item *item, int32 oldx, int32 oldy);
+
 	//! Add an item to the list of possible targets (in Crusader)
 	void addTargetItem(const Item *item);
 	//! Remove an item from the list of possible targets (in Crusader)
@@ -172,7 +196,7 @@ public:
 	TeleportEgg *findDestination(uint16 id);
 
 	// Not allowed to modify the list. Remember to use const_iterator
-	const Std::list<Item *> *getItemList(int32 gx, int32 gy) const;
+	const ChunkItemList *getItemList(int32 gx, int32 gy) const;
 
 	bool isChunkFast(int32 cx, int32 cy) const {
 		// CONSTANTS!
@@ -203,7 +227,8 @@ private:
 
 	// item lists. Lots of them :-)
 	// items[x][y]
-	Std::list<Item *> _items[MAP_NUM_CHUNKS][MAP_NUM_CHUNKS];
+	ChunkItemList _items[MAP_NUM_CHUNKS][MAP_NUM_CHUNKS];
+	ChunkItemIndex _index[MAP_NUM_CHUNKS][MAP_NUM_CHUNKS];
 
 	ProcId _eggHatcher;
 
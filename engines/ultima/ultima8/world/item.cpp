@@ -147,15 +147,16 @@ const Item *Item::getTopItem() const {
 }
 
 void Item::setLocation(int32 X, int32 Y, int32 Z) {
+	int32 oldx = _x;
+	int32 oldy = _y;
 	_x = X;
 	_y = Y;
 	_z = Z;
+	updateMapEntry(oldx, oldy);
 }
 
 void Item::setLocation(const Point3 &pt) {
-	_x = pt.x;
-	_y = pt.y;
-	_z = pt.z;
+	setLocation(pt.x, pt.y, pt.z);
 }
 
 void Item::move(const Point3 &pt) {
@@ -224,6 +225,8 @@ void Item::move(int32 X, int32 Y, int32 Z) {
 			map->addItemToEnd(this);
 		else
 			map->addItem(this);
+	} else {
+		map->updateItem(this, X, Y);
 	}
 
 	// Call just moved
@@ -503,6 +506,13 @@ void Item::setShape(uint32 shape) {
 		_shape = shape;
 		_cachedShapeInfo = nullptr;
 	}
+
+	updateMapEntry();
+}
+
+void Item::updateMapEntry(int32 oldx, int32 oldy) const {
+	if (_extendedFlags & EXT_INCURMAP)
+		World::get_instance()->getCurrentMap()->updateItem(this, oldx, oldy);
 }
 
 bool Item::overlaps(const Item &item2) const {
@@ -3022,6 +3032,8 @@ uint32 Item::I_andStatus(const uint8 *args, unsigned int argsize) {
 	if (!item) return 0;
 
 	item->_flags &= mask;
+	if (!(mask & FLG_FLIPPED))
+		item->updateMapEntry();
 	return 0;
 }
 
@@ -153,6 +153,8 @@ public:
 	//! Set the flags set in the given mask.
 	void setFlag(uint32 mask) {
 		_flags |= mask;
+		if (mask & FLG_FLIPPED)
+			updateMapEntry();
 	}
 
 	virtual void setFlagRecursively(uint32 mask) {
@@ -162,6 +164,8 @@ public:
 	//! Clear the flags set in the given mask.
 	void clearFlag(uint32 mask) {
 		_flags &= ~mask;
+		if (mask & FLG_FLIPPED)
+			updateMapEntry();
 	}
 
 	//! Set _extendedFlags
@@ -182,11 +186,15 @@ public:
 	//! Set the _extendedFlags set in the given mask.
 	void setExtFlag(uint32 mask) {
 		_extendedFlags |= mask;
+		if (mask & EXT_SPRITE)
+			updateMapEntry();
 	}
 
 	//! Clear the _extendedFlags set in the given mask.
 	void clearExtFlag(uint32 mask) {
 		_extendedFlags &= ~mask;
+		if (mask & EXT_SPRITE)
+			updateMapEntry();
 	}
 
 	//! Get this Item's shape number
@@ -656,6 +664,13 @@ protected:
 	//! and the type of object this is.
 	int scaleReceivedDamageCru(int damage, uint16 type) const;
 
+	//! Refresh the CurrentMap search index entry of this item, if it is in
+	//! the map. oldx/oldy are the coordinates it is filed under.
+	void updateMapEntry(int32 oldx, int32 oldy) const;
+	void updateMapEntry() const {
+		updateMapEntry(_x, _y);
+	}
+
 private:
 
 	//! Call a Usecode Event. Use the separate functions instead!
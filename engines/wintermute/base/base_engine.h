@@ -34,6 +34,7 @@
 #include "common/language.h"
 
 #include "engines/wintermute/detection.h"
+#include "engines/wintermute/base/scriptables/script_atom_table.h"
 
 namespace Wintermute {
 
@@ -56,6 +57,7 @@ class BaseEngine : public Common::Singleton<Wintermute::BaseEngine> {
 	Common::Language _language;
 	WMETargetExecutable _targetExecutable;
 	uint32 _flags;
+	ScAtomTable _atomTable;
 public:
 	BaseEngine();
 	~BaseEngine() override;
@@ -67,6 +69,7 @@ public:
 	uint32 randInt(int from, int to);
 
 	SystemClassRegistry *getClassRegistry() { return _classReg; }
+	ScAtomTable &getAtomTable() { return _atomTable; }
 	BaseGame *getGameRef() { return _gameRef; }
 	BaseFileManager *getFileManager() { return _fileManager; }
 	BaseSoundMgr *getSoundMgr();
@@ -39,7 +39,7 @@
 #include "common/queue.h"
 #include "common/config-manager.h"
 
-#define DIRTY_RECT_LIMIT 800
+#define DIRTY_RECT_LIMIT 16
 
 namespace Wintermute {
 
@@ -56,7 +56,6 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -74,8 +73,6 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 		delete ticket;
 	}
 
-	delete _dirtyRect;
-
 	_renderSurface->free();
 	delete _renderSurface;
 }
@@ -148,8 +145,7 @@ bool BaseRenderOSystem::forcedFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.clear();
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -188,8 +184,7 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen(_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.clear();
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
@@ -350,12 +345,36 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 }
 
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
+	Common::Rect dirty(rect);
+	dirty.clip(_renderRect);
+	if (dirty.isEmpty()) {
+		return;
+	}
+
+	// Swallow every region the new one overlaps. The grown rect may now
+	// overlap regions that were already checked, so start over after a merge.
+	uint i = 0;
+	while (i < _dirtyRects.size()) {
+		if (_dirtyRects[i].intersects(dirty)) {
+			dirty.extend(_dirtyRects[i]);
+			_dirtyRects.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+	_dirtyRects.push_back(dirty);
+
+	// Too many small regions cost more in ticket traversal than they save
+	// in fill and blit, so fall back to a single bounding box.
+	if (_dirtyRects.size() > DIRTY_RECT_LIMIT) {
+		Common::Rect bounds(_dirtyRects[0]);
+		for (i = 1; i < _dirtyRects.size(); i++) {
+			bounds.extend(_dirtyRects[i]);
+		}
+		_dirtyRects.clear();
+		_dirtyRects.push_back(bounds);
 	}
-	_dirtyRect->clip(_renderRect);
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -374,7 +393,7 @@ void BaseRenderOSystem::drawTickets() {
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
+	if (_dirtyRects.empty()) {
 		it = _renderQueue.begin();
 		while (it != _renderQueue.end()) {
 			RenderTicket *ticket = *it;
@@ -389,38 +408,45 @@ void BaseRenderOSystem::drawTickets() {
 	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
 	// the background color. Typical use-case: Fullscreen FMVs.
 	// Caveat: The FPS-counter will invalidate this.
+	RenderTicket *opaqueTicket = nullptr;
 	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
+		opaqueTicket = *it;
+	}
+
+	for (uint i = 0; i < _dirtyRects.size(); i++) {
+		const Common::Rect &dirtyRect = _dirtyRects[i];
+
 		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
+		if (!opaqueTicket || !opaqueTicket->_dstRect.contains(dirtyRect)) {
 			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+			_renderSurface->fillRect(dirtyRect, _clearColor);
 		}
-		// Otherwise Do NOT fill.
-	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
-	}
-	for (; it != _renderQueue.end(); ++it) {
-		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
+
+		for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+			RenderTicket *ticket = *it;
+			if (ticket->_dstRect.intersects(dirtyRect)) {
+				// dstClip is the area we want redrawn.
+				Common::Rect dstClip(ticket->_dstRect);
+				// reduce it to the dirty rect
+				dstClip.clip(dirtyRect);
+				// we need to keep track of the position to redraw the dirty rect
+				Common::Rect pos(dstClip);
+				int16 offsetX = ticket->_dstRect.left;
+				int16 offsetY = ticket->_dstRect.top;
+				// convert from screen-coords to surface-coords.
+				dstClip.translate(-offsetX, -offsetY);
+
+				drawFromSurface(ticket, &pos, &dstClip);
+				_needsFlip = true;
+			}
 		}
-		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldn't become clear-color)
-		ticket->_wantsDraw = false;
+		g_system->copyRectToScreen(_renderSurface->getBasePtr(dirtyRect.left, dirtyRect.top), _renderSurface->pitch, dirtyRect.left, dirtyRect.top, dirtyRect.width(), dirtyRect.height());
+	}
+
+	// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldn't become clear-color)
+	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		(*it)->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen(_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
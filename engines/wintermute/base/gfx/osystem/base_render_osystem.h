@@ -30,6 +30,7 @@
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 #include "common/list.h"
 
@@ -116,18 +117,20 @@ public:
 private:
 	/**
 	 * Mark a specified rect of the screen as dirty.
+	 * The rect is merged with any dirty region it overlaps, so that
+	 * the dirty regions always stay disjoint.
 	 * @param rect the region to be marked as dirty
 	 */
 	void addDirtyRect(const Common::Rect &rect);
 	/**
-	 * Traverse the tickets that are dirty, and draw them
+	 * Traverse the dirty regions, and redraw the tickets intersecting each of them
 	 */
 	void drawTickets();
 	// Non-dirty-rects:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+	Common::Array<Common::Rect> _dirtyRects;
 	Common::List<RenderTicket *> _renderQueue;
 
 	bool _needsFlip;
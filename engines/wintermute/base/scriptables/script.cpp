@@ -56,6 +56,8 @@ ScScript::ScScript(BaseGame *inGame, ScEngine *engine) : BaseClass(inGame) {
 	_currentLine = 0;
 
 	_symbols = nullptr;
+	_symbolAtoms = nullptr;
+	_globalSlots = nullptr;
 	_numSymbols = 0;
 
 	_engine = engine;
@@ -183,9 +185,13 @@ bool ScScript::initTables() {
 
 	_numSymbols = getDWORD();
 	_symbols = new char*[_numSymbols];
+	_symbolAtoms = new ScAtom[_numSymbols];
+	_globalSlots = new TGlobalSlot[_numSymbols];
 	for (uint32 i = 0; i < _numSymbols; i++) {
 		uint32 index = getDWORD();
 		_symbols[index] = getString();
+		_symbolAtoms[index] = BaseEngine::instance().getAtomTable().intern(_symbols[index]);
+		_globalSlots[index].value = nullptr;
 	}
 
 	// load functions table
@@ -395,6 +401,10 @@ void ScScript::cleanup() {
 		delete[] _symbols;
 	}
 	_symbols = nullptr;
+	delete[] _symbolAtoms;
+	_symbolAtoms = nullptr;
+	delete[] _globalSlots;
+	_globalSlots = nullptr;
 	_numSymbols = 0;
 
 	if (_globals && !_thread) {
@@ -559,9 +569,9 @@ bool ScScript::executeInstruction() {
 		_operand->setNULL();
 		dw = getDWORD();
 		if (_scopeStack->_sP < 0) {
-			_globals->setProp(_symbols[dw], _operand);
+			_globals->setProp(_symbolAtoms[dw], _operand);
 		} else {
-			_scopeStack->getTop()->setProp(_symbols[dw], _operand);
+			_scopeStack->getTop()->setProp(_symbolAtoms[dw], _operand);
 		}
 
 		break;
@@ -573,7 +583,7 @@ bool ScScript::executeInstruction() {
 		// only create global var if it doesn't exist
 		if (!_engine->_globals->propExists(_symbols[dw])) {
 			_operand->setNULL();
-			_engine->_globals->setProp(_symbols[dw], _operand, false, inst == II_DEF_CONST_VAR);
+			_engine->_globals->setProp(_symbolAtoms[dw], _operand, false, inst == II_DEF_CONST_VAR);
 		}
 		break;
 	}
@@ -730,7 +740,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_VAR: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = getSymbolVar(getDWORD());
 		// Disabled in original code
 		/*if (false && var->_type==VAL_OBJECT || var->_type == VAL_NATIVE) {
 			_operand->setReference(var);
@@ -742,15 +752,14 @@ bool ScScript::executeInstruction() {
 	}
 
 	case II_PUSH_VAR_REF: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = getSymbolVar(getDWORD());
 		_operand->setReference(var);
 		_stack->push(_operand);
 		break;
 	}
 
 	case II_POP_VAR: {
-		char *varName = _symbols[getDWORD()];
-		ScValue *var = getVar(varName);
+		ScValue *var = getSymbolVar(getDWORD());
 		if (var) {
 			ScValue *val = _stack->pop();
 			if (!val) {
@@ -801,7 +810,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_THIS:
-		_operand->setReference(getVar(_symbols[getDWORD()]));
+		_operand->setReference(getSymbolVar(getDWORD()));
 		_thisStack->push(_operand);
 		break;
 
@@ -1161,42 +1170,57 @@ uint32 ScScript::getMethodPos(const Common::String &name) const {
 
 //////////////////////////////////////////////////////////////////////////
 ScValue *ScScript::getVar(char *name) {
+	return findVar(BaseEngine::instance().getAtomTable().intern(name), nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScScript::getSymbolVar(uint32 symbol) {
+	return findVar(_symbolAtoms[symbol], &_globalSlots[symbol]);
+}
+
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScScript::findVar(ScAtom atom, TGlobalSlot *slot) {
 	ScValue *ret = nullptr;
 
 	// scope locals
 	if (_scopeStack->_sP >= 0) {
-		if (_scopeStack->getTop()->propExists(name)) {
-			ret = _scopeStack->getTop()->getProp(name);
+		ret = _scopeStack->getTop()->findProp(atom);
+		if (ret) {
+			return ret;
 		}
 	}
 
-	// script globals
-	if (ret == nullptr) {
-		if (_globals->propExists(name)) {
-			ret = _globals->getProp(name);
-		}
+	if (slot && slot->value && slot->globalsGeneration == _globals->_propsGeneration &&
+	        slot->engineGlobalsGeneration == _engine->_globals->_propsGeneration) {
+		return slot->value;
 	}
 
+	// script globals
+	ret = _globals->findProp(atom);
+
 	// engine globals
 	if (ret == nullptr) {
-		if (_engine->_globals->propExists(name)) {
-			ret = _engine->_globals->getProp(name);
-		}
+		ret = _engine->_globals->findProp(atom);
 	}
 
 	if (ret == nullptr) {
+		const char *name = BaseEngine::instance().getAtomTable().getName(atom).c_str();
 		//RuntimeError("Variable '%s' is inaccessible in the current block. Consider changing the script.", name);
 		_gameRef->LOG(0, "Warning: variable '%s' is inaccessible in the current block. Consider changing the script (script:%s, line:%d)", name, _filename, _currentLine);
 		ScValue *val = new ScValue(_gameRef);
 		ScValue *scope = _scopeStack->getTop();
 		if (scope) {
-			scope->setProp(name, val);
-			ret = _scopeStack->getTop()->getProp(name);
+			scope->setProp(atom, val);
+			ret = scope->findProp(atom);
 		} else {
-			_globals->setProp(name, val);
-			ret = _globals->getProp(name);
+			_globals->setProp(atom, val);
+			ret = _globals->findProp(atom);
 		}
 		delete val;
+	} else if (slot) {
+		slot->value = ret;
+		slot->globalsGeneration = _globals->_propsGeneration;
+		slot->engineGlobalsGeneration = _engine->_globals->_propsGeneration;
 	}
 
 	return ret;
@@ -31,6 +31,7 @@
 
 #include "engines/wintermute/base/base.h"
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
+#include "engines/wintermute/base/scriptables/script_atom_table.h"
 #include "engines/wintermute/coll_templ.h"
 #include "engines/wintermute/persistent.h"
 
@@ -151,7 +152,18 @@ public:
 	bool externalCall(ScStack *stack, ScStack *thisStack, ScScript::TExternalFunction *function);
 private:
 	char **_symbols;
+	ScAtom *_symbolAtoms;
+	// Where a symbol was last found among the script and engine globals,
+	// valid while neither of them gained or lost a property
+	typedef struct {
+		ScValue *value;
+		uint32 globalsGeneration;
+		uint32 engineGlobalsGeneration;
+	} TGlobalSlot;
+	TGlobalSlot *_globalSlots;
 	uint32 _numSymbols;
+	ScValue *getSymbolVar(uint32 symbol);
+	ScValue *findVar(ScAtom atom, TGlobalSlot *slot);
 	TFunctionPos *_functions;
 	TMethodPos *_methods;
 	TEventPos *_events;
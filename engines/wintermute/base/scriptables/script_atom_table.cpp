@@ -0,0 +1,48 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engines/wintermute/base/scriptables/script_atom_table.h"
+
+namespace Wintermute {
+
+//////////////////////////////////////////////////////////////////////////
+ScAtom ScAtomTable::intern(const char *name) {
+	Common::HashMap<Common::String, ScAtom>::const_iterator it = _atoms.find(name);
+	if (it != _atoms.end()) {
+		return it->_value;
+	}
+
+	ScAtom atom = _names.size();
+	_names.push_back(name);
+	_atoms[_names.back()] = atom;
+	return atom;
+}
+
+//////////////////////////////////////////////////////////////////////////
+ScAtom ScAtomTable::find(const char *name) const {
+	Common::HashMap<Common::String, ScAtom>::const_iterator it = _atoms.find(name);
+	if (it != _atoms.end()) {
+		return it->_value;
+	}
+	return kNoAtom;
+}
+
+} // End of namespace Wintermute
@@ -0,0 +1,60 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef WINTERMUTE_SCATOMTABLE_H
+#define WINTERMUTE_SCATOMTABLE_H
+
+#include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+
+namespace Wintermute {
+
+/**
+ * ID of an interned property or variable name. Atoms are only valid for the
+ * running game, save games store the names.
+ */
+typedef uint32 ScAtom;
+
+static const ScAtom kNoAtom = 0xFFFFFFFF;
+
+class ScAtomTable {
+public:
+	/**
+	 * Returns the atom of a name, adding it to the table if needed.
+	 */
+	ScAtom intern(const char *name);
+	/**
+	 * Returns the atom of a name, or kNoAtom if it was never interned,
+	 * in which case no property can have it.
+	 */
+	ScAtom find(const char *name) const;
+	const Common::String &getName(ScAtom atom) const { return _names[atom]; }
+
+private:
+	Common::HashMap<Common::String, ScAtom> _atoms;
+	Common::Array<Common::String> _names;
+};
+
+} // End of namespace Wintermute
+
+#endif
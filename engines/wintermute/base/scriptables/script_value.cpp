@@ -27,6 +27,7 @@
 
 #include "engines/wintermute/platform_osystem.h"
 #include "engines/wintermute/base/base_dynamic_buffer.h"
+#include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/scriptables/script_value.h"
 #include "engines/wintermute/base/scriptables/script.h"
@@ -53,6 +54,7 @@ ScValue::ScValue(BaseGame *inGame) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propsGeneration = 0;
 }
 
 
@@ -68,6 +70,7 @@ ScValue::ScValue(BaseGame *inGame, bool val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propsGeneration = 0;
 }
 
 
@@ -83,6 +86,7 @@ ScValue::ScValue(BaseGame *inGame, int32 val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propsGeneration = 0;
 }
 
 
@@ -98,6 +102,7 @@ ScValue::ScValue(BaseGame *inGame, double val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propsGeneration = 0;
 }
 
 
@@ -114,6 +119,7 @@ ScValue::ScValue(BaseGame *inGame, const char *val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propsGeneration = 0;
 }
 
 
@@ -182,24 +188,38 @@ ScValue *ScValue::getProp(const char *name) {
 	}
 
 	if (ret == nullptr) {
-		_valIter = _valObject.find(name);
-		if (_valIter != _valObject.end()) {
-			ret = _valIter->_value;
+		ScAtom atom = BaseEngine::instance().getAtomTable().find(name);
+		if (atom != kNoAtom) {
+			ret = findProp(atom);
 		}
 	}
 	return ret;
 }
 
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScValue::findProp(ScAtom atom) {
+	if (_type == VAL_VARIABLE_REF) {
+		return _valRef->findProp(atom);
+	}
+
+	_valIter = _valObject.find(atom);
+	if (_valIter != _valObject.end()) {
+		return _valIter->_value;
+	}
+	return nullptr;
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool ScValue::deleteProp(const char *name) {
 	if (_type == VAL_VARIABLE_REF) {
 		return _valRef->deleteProp(name);
 	}
 
-	_valIter = _valObject.find(name);
+	_valIter = _valObject.find(BaseEngine::instance().getAtomTable().find(name));
 	if (_valIter != _valObject.end()) {
 		delete _valIter->_value;
 		_valIter->_value = nullptr;
+		_propsGeneration++;
 	}
 
 	return STATUS_OK;
@@ -219,51 +239,63 @@ bool ScValue::setProp(const char *name, ScValue *val, bool copyWhole, bool setAs
 	}
 
 	if (DID_FAIL(ret)) {
-		ScValue *newVal = nullptr;
+		setObjectProp(BaseEngine::instance().getAtomTable().intern(name), val, copyWhole, setAsConst);
+	}
 
-		_valIter = _valObject.find(name);
-		if (_valIter != _valObject.end()) {
-			newVal = _valIter->_value;
-		}
-		if (!newVal) {
-			newVal = new ScValue(_gameRef);
-		} else {
-			newVal->cleanup();
-		}
+	return STATUS_OK;
+}
 
-		newVal->copy(val, copyWhole);
-		newVal->_isConstVar = setAsConst;
-		_valObject[name] = newVal;
 
-		if (_type != VAL_NATIVE) {
-			_type = VAL_OBJECT;
-		}
+//////////////////////////////////////////////////////////////////////////
+bool ScValue::setProp(ScAtom atom, ScValue *val, bool copyWhole, bool setAsConst) {
+	if (_type == VAL_VARIABLE_REF) {
+		return _valRef->setProp(atom, val);
+	}
 
-		/*
-		_valIter = _valObject.find(Name);
-		if (_valIter != _valObject.end()) {
-		    delete _valIter->_value;
-		    _valIter->_value = nullptr;
-		}
-		ScValue* val = new ScValue(_gameRef);
-		val->Copy(Val, CopyWhole);
-		val->_isConstVar = SetAsConst;
-		_valObject[Name] = val;
+	bool ret = STATUS_FAILED;
+	if (_type == VAL_NATIVE && _valNative) {
+		ret = _valNative->scSetProperty(BaseEngine::instance().getAtomTable().getName(atom).c_str(), val);
+	}
 
-		if (_type!=VAL_NATIVE) _type = VAL_OBJECT;
-		*/
+	if (DID_FAIL(ret)) {
+		setObjectProp(atom, val, copyWhole, setAsConst);
 	}
 
 	return STATUS_OK;
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+void ScValue::setObjectProp(ScAtom atom, ScValue *val, bool copyWhole, bool setAsConst) {
+	ScValue *newVal = nullptr;
+
+	_valIter = _valObject.find(atom);
+	if (_valIter != _valObject.end()) {
+		newVal = _valIter->_value;
+	}
+	if (!newVal) {
+		newVal = new ScValue(_gameRef);
+		_propsGeneration++;
+	} else {
+		newVal->cleanup();
+	}
+
+	newVal->copy(val, copyWhole);
+	newVal->_isConstVar = setAsConst;
+	_valObject[atom] = newVal;
+
+	if (_type != VAL_NATIVE) {
+		_type = VAL_OBJECT;
+	}
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 bool ScValue::propExists(const char *name) {
 	if (_type == VAL_VARIABLE_REF) {
 		return _valRef->propExists(name);
 	}
-	_valIter = _valObject.find(name);
+	_valIter = _valObject.find(BaseEngine::instance().getAtomTable().find(name));
 
 	return (_valIter != _valObject.end());
 }
@@ -277,6 +309,7 @@ void ScValue::deleteProps() {
 		_valIter++;
 	}
 	_valObject.clear();
+	_propsGeneration++;
 }
 
 
@@ -745,6 +778,7 @@ void ScValue::copy(ScValue *orig, bool copyWhole) {
 	} else {
 		_valObject.clear();
 	}
+	_propsGeneration++;
 }
 
 
@@ -801,7 +835,7 @@ bool ScValue::persist(BasePersistenceManager *persistMgr) {
 		persistMgr->transferSint32("", &size);
 		_valIter = _valObject.begin();
 		while (_valIter != _valObject.end()) {
-			str = _valIter->_key.c_str();
+			str = BaseEngine::instance().getAtomTable().getName(_valIter->_key).c_str();
 			persistMgr->transferConstChar("", &str);
 			persistMgr->transferPtr("", &_valIter->_value);
 
@@ -814,9 +848,10 @@ bool ScValue::persist(BasePersistenceManager *persistMgr) {
 			persistMgr->transferConstChar("", &str);
 			persistMgr->transferPtr("", &val);
 
-			_valObject[str] = val;
+			_valObject[BaseEngine::instance().getAtomTable().intern(str)] = val;
 			delete[] str;
 		}
+		_propsGeneration++;
 	}
 
 	persistMgr->transferPtr(TMEMBER_PTR(_valRef));
@@ -882,7 +917,7 @@ bool ScValue::saveAsText(BaseDynamicBuffer *buffer, int indent) {
 	_valIter = _valObject.begin();
 	while (_valIter != _valObject.end()) {
 		buffer->putTextIndent(indent, "PROPERTY {\n");
-		buffer->putTextIndent(indent + 2, "NAME=\"%s\"\n", _valIter->_key.c_str());
+		buffer->putTextIndent(indent + 2, "NAME=\"%s\"\n", BaseEngine::instance().getAtomTable().getName(_valIter->_key).c_str());
 		buffer->putTextIndent(indent + 2, "VALUE=\"%s\"\n", _valIter->_value->getString());
 		buffer->putTextIndent(indent, "}\n\n");
 
@@ -32,6 +32,7 @@
 #include "engines/wintermute/base/base.h"
 #include "engines/wintermute/persistent.h"
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
+#include "engines/wintermute/base/scriptables/script_atom_table.h"
 #include "common/str.h"
 
 namespace Wintermute {
@@ -81,7 +82,14 @@ public:
 	bool isInt();
 	bool isObject();
 	bool setProp(const char *name, ScValue *val, bool copyWhole = false, bool setAsConst = false);
+	bool setProp(ScAtom atom, ScValue *val, bool copyWhole = false, bool setAsConst = false);
 	ScValue *getProp(const char *name);
+	/**
+	 * Look up a property stored in this object, skipping the native and
+	 * string pseudo-properties that getProp() resolves.
+	 * @return the property, or nullptr if it doesn't exist
+	 */
+	ScValue *findProp(ScAtom atom);
 	BaseScriptable *_valNative;
 	ScValue *_valRef;
 private:
@@ -97,8 +105,14 @@ public:
 	ScValue(BaseGame *inGame, double Val);
 	ScValue(BaseGame *inGame, const char *Val);
 	~ScValue() override;
-	Common::HashMap<Common::String, ScValue *> _valObject;
-	Common::HashMap<Common::String, ScValue *>::iterator _valIter;
+	Common::HashMap<ScAtom, ScValue *> _valObject;
+	Common::HashMap<ScAtom, ScValue *>::iterator _valIter;
+	// Changes whenever a property is added, deleted or replaced by another value,
+	// so that pointers to the properties can be cached
+	uint32 _propsGeneration;
+private:
+	void setObjectProp(ScAtom atom, ScValue *val, bool copyWhole, bool setAsConst);
+public:
 
 	bool setProperty(const char *propName, int32 value);
 	bool setProperty(const char *propName, const char *value);
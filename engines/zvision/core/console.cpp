@@ -44,6 +44,7 @@ Console::Console(ZVision *engine) : GUI::Debugger(), _engine(engine) {
 	registerCmd("generaterendertable", WRAP_METHOD(Console, cmdGenerateRenderTable));
 	registerCmd("setpanoramafov", WRAP_METHOD(Console, cmdSetPanoramaFoV));
 	registerCmd("setpanoramascale", WRAP_METHOD(Console, cmdSetPanoramaScale));
+	registerCmd("benchpanorama", WRAP_METHOD(Console, cmdBenchPanorama));
 	registerCmd("location", WRAP_METHOD(Console, cmdLocation));
 	registerCmd("dumpfile", WRAP_METHOD(Console, cmdDumpFile));
 	registerCmd("dumpfiles", WRAP_METHOD(Console, cmdDumpFiles));
@@ -195,6 +196,26 @@ bool Console::cmdSetPanoramaScale(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdBenchPanorama(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Use %s [steps] to time warping a full turn around the current panorama\n", argv[0]);
+		return true;
+	}
+
+	RenderManager *renderManager = _engine->getRenderManager();
+	if (renderManager->getRenderTable()->getRenderState() != RenderTable::PANORAMA) {
+		debugPrintf("The current location isn't a panorama\n");
+		return true;
+	}
+
+	const uint steps = argc == 2 ? MAX(atoi(argv[1]), 1) : 360;
+	const uint32 lowTime = renderManager->benchmarkPanorama(false, steps);
+	const uint32 highTime = renderManager->benchmarkPanorama(true, steps);
+	debugPrintf("Panorama warp, %u steps: low quality %u ms, high quality %u ms\n", steps, lowTime, highTime);
+
+	return true;
+}
+
 bool Console::cmdLocation(int argc, const char **argv) {
 	Location curLocation = _engine->getScriptManager()->getCurrentLocation();
 	Common::String scrFile = Common::String::format("%c%c%c%c.scr", curLocation.world, curLocation.room, curLocation.node, curLocation.view);
@@ -423,6 +423,23 @@ RenderTable *RenderManager::getRenderTable() {
 	return &_renderTable;
 }
 
+uint32 RenderManager::benchmarkPanorama(bool highQuality, uint steps) {
+	const int startOffset = _backgroundOffset;
+	// Warp once beforehand, so that regenerating the render table for this quality isn't timed
+	_renderTable.mutateImage(&_warpedSceneSurface, &_backgroundSurface, highQuality);
+	uint32 warpTime = 0;
+	for (uint step = 0; step < steps; step++) {
+		setBackgroundPosition(step * _backgroundWidth / steps);
+		prepareBackground();
+		const uint32 startTime = _system->getMillis();
+		_renderTable.mutateImage(&_warpedSceneSurface, &_backgroundSurface, highQuality);
+		warpTime += _system->getMillis() - startTime;
+	}
+	setBackgroundPosition(startOffset);
+	prepareBackground();
+	return warpTime;
+}
+
 void RenderManager::setBackgroundImage(const Common::Path &fileName) {
 	readImageToSurface(fileName, _currentBackgroundImage);
 	_backgroundWidth = _currentBackgroundImage.w;
@@ -242,6 +242,14 @@ public:
 	// Return current background offset
 	uint32 getCurrentBackgroundOffset();
 
+	/**
+	 * Pans a full turn around the current panorama in the given number of steps,
+	 * warping the background at each of them, then returns to the original position.
+	 *
+	 * @return The total time spent warping, in milliseconds
+	 */
+	uint32 benchmarkPanorama(bool highQuality, uint steps);
+
 	/**
 	 * Creates a copy of surface and transposes the data.
 	 *
@@ -22,6 +22,7 @@
 #include "common/rect.h"
 #include "common/scummsys.h"
 #include "common/system.h"
+#include "common/task-scheduler.h"
 #include "math/utils.h"
 #include "zvision/graphics/render_table.h"
 #include "zvision/scripting/script_manager.h"
@@ -34,9 +35,15 @@ RenderTable::RenderTable(ZVision *engine, uint16 numColumns, uint16 numRows, con
 	  _numRows(numRows),
 	  _numColumns(numColumns),
 	  _renderState(FLAT),
-	  _pixelFormat(pixelFormat) {
+	  _pixelFormat(pixelFormat),
+	  _warpBilinear(warpBilinearGeneric) {
 	assert(numRows != 0 && numColumns != 0);
 
+#ifdef SCUMMVM_SSE2
+	if (_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_warpBilinear = warpBilinearSSE2;
+#endif
+
 	_internalBuffer = new FilterPixel[numRows * numColumns];
 
 	memset(&_panoramaOptions, 0, sizeof(_panoramaOptions));
@@ -130,57 +137,56 @@ void RenderTable::mutateImage(uint16 *sourceBuffer, uint16 *destBuffer, uint32 d
 // */
 
 void RenderTable::mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf, bool highQuality) {
-	uint32 destOffset = 0;
-	uint32 sourceOffset = 0;
-	uint16 *sourceBuffer = (uint16 *)srcBuf->getPixels();
-	uint16 *destBuffer = (uint16 *)dstBuf->getPixels();
-	if (highQuality != _highQuality) {
+	const uint16 *sourceBuffer = (const uint16 *)srcBuf->getPixels();
+	const bool tableReady = highQuality ? !_bilinear.index.empty() : !_nearestIndex.empty();
+	if (highQuality != _highQuality || !tableReady) {
 		_highQuality = highQuality;
 		generateRenderTable();
 	}
 	uint32 mutationTime = _system->getMillis();
-	if (_highQuality) {
-		// Apply bilinear interpolation
-		for (int16 y = 0; y < srcBuf->h; ++y) {
-			sourceOffset = y * _numColumns;
-			for (int16 x = 0; x < srcBuf->w; ++x) {
-				const FilterPixel &curP = _internalBuffer[sourceOffset + x];
-				const uint32 srcIndexYT = y + curP._src.top;
-				const uint32 srcIndexYB = y + curP._src.bottom;
-				const uint32 srcIndexXL = x + curP._src.left;
-				const uint32 srcIndexXR = x + curP._src.right;
-				uint32 rTL, rTR, rBL, rBR;
-				uint32 gTL, gTR, gBL, gBR;
-				uint32 bTL, bTR, bBL, bBR;
-				splitColor(sourceBuffer[srcIndexYT * _numColumns + srcIndexXL], rTL, gTL, bTL);
-				splitColor(sourceBuffer[srcIndexYT * _numColumns + srcIndexXR], rTR, gTR, bTR);
-				splitColor(sourceBuffer[srcIndexYB * _numColumns + srcIndexXL], rBL, gBL, bBL);
-				splitColor(sourceBuffer[srcIndexYB * _numColumns + srcIndexXR], rBR, gBR, bBR);
-				const uint32 rF = curP._fTL * rTL + curP._fTR * rTR + curP._fBL * rBL + curP._fBR * rBR;
-				const uint32 gF = curP._fTL * gTL + curP._fTR * gTR + curP._fBL * gBL + curP._fBR * gBR;
-				const uint32 bF = curP._fTL * bTL + curP._fTR * bTR + curP._fBL * bBL + curP._fBR * bBR;
-				destBuffer[destOffset] = mergeColor(rF, gF, bF);
-				destOffset++;
-			}
-		}
-	} else {
-		// Apply nearest-neighbour interpolation
-		for (int16 y = 0; y < srcBuf->h; ++y) {
-			sourceOffset = y * _numColumns;
-			for (int16 x = 0; x < srcBuf->w; ++x) {
-				const uint32 index = sourceOffset + x;
-				// RenderTable only stores offsets from the original coordinates
-				const uint32 srcIndexX = x + (_internalBuffer[index]._xDir ? _internalBuffer[index]._src.right : _internalBuffer[index]._src.left);
-				const uint32 srcIndexY = y + (_internalBuffer[index]._yDir ? _internalBuffer[index]._src.bottom : _internalBuffer[index]._src.top);
-				destBuffer[destOffset] = sourceBuffer[srcIndexY * _numColumns + srcIndexX];
-				destOffset++;
+	// Rows are independent, so warp them in bands spread over the worker threads
+	_system->getTaskScheduler()->parallelFor(0, srcBuf->h, 16, [&](uint first, uint last) {
+		for (uint y = first; y < last; ++y) {
+			uint16 *destBuffer = (uint16 *)dstBuf->getBasePtr(0, y);
+			const uint32 sourceOffset = y * _numColumns;
+			if (_highQuality) {
+				// Apply bilinear interpolation
+				_warpBilinear(destBuffer, sourceBuffer, _bilinear, sourceOffset, srcBuf->w);
+			} else {
+				// Apply nearest-neighbour interpolation
+				const uint32 *index = &_nearestIndex[sourceOffset];
+				for (int16 x = 0; x < srcBuf->w; ++x)
+					destBuffer[x] = sourceBuffer[index[x]];
 			}
 		}
-	}
+	});
 	mutationTime = _system->getMillis() - mutationTime;
 	debugC(5, kDebugGraphics, "\tPanorama mutation time %dms, %s quality", mutationTime, _highQuality ? "high" : "low");
 }
 
+void RenderTable::warpBilinearGeneric(uint16 *dst, const uint16 *src, const BilinearTable &table, uint32 first, uint32 count) {
+	const uint32 *index = table.index.data() + first;
+	const int16 *right = table.right.data() + first;
+	const int16 *down = table.down.data() + first;
+	const uint16 *weightTL = table.weight[0].data() + first;
+	const uint16 *weightTR = table.weight[1].data() + first;
+	const uint16 *weightBL = table.weight[2].data() + first;
+	const uint16 *weightBR = table.weight[3].data() + first;
+
+	for (uint32 i = 0; i < count; ++i) {
+		const uint16 *srcTL = src + index[i];
+		const uint16 pixels[4] = { srcTL[0], srcTL[right[i]], srcTL[down[i]], srcTL[down[i] + right[i]] };
+		const uint16 weights[4] = { weightTL[i], weightTR[i], weightBL[i], weightBR[i] };
+		uint32 r = 0, g = 0, b = 0;
+		for (int j = 0; j < 4; ++j) {
+			r += (pixels[j] & 0x1f) * weights[j];
+			g += ((pixels[j] >> 5) & 0x1f) * weights[j];
+			b += ((pixels[j] >> 10) & 0x1f) * weights[j];
+		}
+		dst[i] = (r >> 8) | ((g >> 8) << 5) | ((b >> 8) << 10);
+	}
+}
+
 void RenderTable::generateRenderTable() {
 	switch (_renderState) {
 	case RenderTable::PANORAMA: {
@@ -267,11 +273,55 @@ void RenderTable::generateLookupTable(bool tilt) {
 			}
 		}
 	}
+	generateWarpTables();
 	generationTime = _system->getMillis() - generationTime;
 	debugC(1, kDebugGraphics, "Render table generated, %s quality", _highQuality ? "high" : "low");
 	debugC(1, kDebugGraphics, "\tRender table generation time %dms", generationTime);
 }
 
+void RenderTable::generateWarpTables() {
+	const uint32 size = _numRows * _numColumns;
+	if (_highQuality) {
+		_nearestIndex.clear();
+		_bilinear.index.resize(size);
+		_bilinear.right.resize(size);
+		_bilinear.down.resize(size);
+		for (int i = 0; i < 4; ++i)
+			_bilinear.weight[i].resize(size);
+	} else {
+		_nearestIndex.resize(size);
+		_bilinear.index.clear();
+		_bilinear.right.clear();
+		_bilinear.down.clear();
+		for (int i = 0; i < 4; ++i)
+			_bilinear.weight[i].clear();
+	}
+
+	uint32 index = 0;
+	for (uint y = 0; y < _numRows; ++y) {
+		for (uint x = 0; x < _numColumns; ++x, ++index) {
+			const FilterPixel &curP = _internalBuffer[index];
+			if (_highQuality) {
+				// Round the fractions to 1/16th, so that the products of the weights fit in 16 bits
+				const uint32 fX = CLIP<int>((int)(curP._fX * 16.0f + 0.5f), 0, 16);
+				const uint32 fY = CLIP<int>((int)(curP._fY * 16.0f + 0.5f), 0, 16);
+				_bilinear.index[index] = (y + curP._src.top) * _numColumns + (x + curP._src.left);
+				_bilinear.right[index] = curP._src.right - curP._src.left;
+				_bilinear.down[index] = (curP._src.bottom - curP._src.top) * _numColumns;
+				_bilinear.weight[0][index] = (16 - fX) * (16 - fY);
+				_bilinear.weight[1][index] = fX * (16 - fY);
+				_bilinear.weight[2][index] = (16 - fX) * fY;
+				_bilinear.weight[3][index] = fX * fY;
+			} else {
+				// RenderTable only stores offsets from the original coordinates
+				const uint32 srcIndexX = x + (curP._xDir ? curP._src.right : curP._src.left);
+				const uint32 srcIndexY = y + (curP._yDir ? curP._src.bottom : curP._src.top);
+				_nearestIndex[index] = srcIndexY * _numColumns + srcIndexX;
+			}
+		}
+	}
+}
+
 void RenderTable::setPanoramaFoV(float fov) {
 	assert(fov > 0.0f);
 
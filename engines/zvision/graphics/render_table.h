@@ -22,6 +22,7 @@
 #ifndef ZVISION_RENDER_TABLE_H
 #define ZVISION_RENDER_TABLE_H
 
+#include "common/array.h"
 #include "common/rect.h"
 #include "graphics/surface.h"
 #include "zvision/zvision.h"
@@ -91,17 +92,24 @@ private:
 	bool _highQuality = false;
 	const Graphics::PixelFormat _pixelFormat;
 
-	inline void splitColor(uint16 &color, uint32 &r, uint32 &g, uint32 &b) const {
-		// NB Left & right shifting unnecessary for interpolating & recombining, so not bothering in order to save cycles
-		r = color & 0x001f;
-		g = color & 0x03e0;
-		b = color & 0x7c00;
-	}
-	inline uint16 mergeColor(const uint32 &r, const uint32 &g, const uint32 &b) const {
-		// NB Red uses the lowest bits in RGB555 and so doesn't need its fractional bits masked away after averaging
-		return r | (g & 0x03e0) | (b & 0x7c00);
-	}
+	// Warp tables built from _internalBuffer by generateWarpTables(), holding absolute source pixel indices
+	Common::Array<uint32> _nearestIndex;
+
+	// Bilinear filter of each working window pixel; kept as separate arrays so the SSE2 warp can load eight pixels at once
+	struct BilinearTable {
+		Common::Array<uint32> index;  // Top left source pixel
+		Common::Array<int16> right;   // Offset from the top left to the top right source pixel
+		Common::Array<int16> down;    // Offset from the top left to the bottom left source pixel
+		Common::Array<uint16> weight[4]; // Weights of the TL, TR, BL & BR source pixels, 4-bit fixed point in each axis, adding up to 256
+	} _bilinear;
 
+	typedef void (*BilinearWarpFunc)(uint16 *dst, const uint16 *src, const BilinearTable &table, uint32 first, uint32 count);
+	BilinearWarpFunc _warpBilinear;
+
+	static void warpBilinearGeneric(uint16 *dst, const uint16 *src, const BilinearTable &table, uint32 first, uint32 count);
+#ifdef SCUMMVM_SSE2
+	static void warpBilinearSSE2(uint16 *dst, const uint16 *src, const BilinearTable &table, uint32 first, uint32 count);
+#endif
 
 	struct {
 		float verticalFOV;  // Radians
@@ -160,6 +168,7 @@ public:
 
 private:
 	void generateLookupTable(bool tilt = false);
+	void generateWarpTables();
 	void generatePanoramaLookupTable();
 	void generateTiltLookupTable();
 };
@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "zvision/graphics/render_table.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace ZVision {
+
+static inline void weighPixels(__m128i pixels, __m128i weights, __m128i &r, __m128i &g, __m128i &b) {
+	// Each channel is at most 31 and the weights add up to 256, so the sums fit in 16 bits
+	const __m128i mask = _mm_set1_epi16(0x1f);
+	r = _mm_add_epi16(r, _mm_mullo_epi16(_mm_and_si128(pixels, mask), weights));
+	g = _mm_add_epi16(g, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(pixels, 5), mask), weights));
+	b = _mm_add_epi16(b, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(pixels, 10), mask), weights));
+}
+
+void RenderTable::warpBilinearSSE2(uint16 *dst, const uint16 *src, const BilinearTable &table, uint32 first, uint32 count) {
+	const uint32 *index = table.index.data() + first;
+	const int16 *right = table.right.data() + first;
+	const int16 *down = table.down.data() + first;
+	const uint16 *weightTL = table.weight[0].data() + first;
+	const uint16 *weightTR = table.weight[1].data() + first;
+	const uint16 *weightBL = table.weight[2].data() + first;
+	const uint16 *weightBR = table.weight[3].data() + first;
+
+	uint32 i = 0;
+	for (; i + 8 <= count; i += 8) {
+		// There is no 16-bit gather, so fetch the source pixels one by one
+		uint16 pixels[4][8];
+		for (int j = 0; j < 8; ++j) {
+			const uint16 *srcTL = src + index[i + j];
+			const uint16 *srcBL = srcTL + down[i + j];
+			pixels[0][j] = srcTL[0];
+			pixels[1][j] = srcTL[right[i + j]];
+			pixels[2][j] = srcBL[0];
+			pixels[3][j] = srcBL[right[i + j]];
+		}
+
+		__m128i r = _mm_setzero_si128();
+		__m128i g = _mm_setzero_si128();
+		__m128i b = _mm_setzero_si128();
+		weighPixels(_mm_loadu_si128((const __m128i *)pixels[0]), _mm_loadu_si128((const __m128i *)(weightTL + i)), r, g, b);
+		weighPixels(_mm_loadu_si128((const __m128i *)pixels[1]), _mm_loadu_si128((const __m128i *)(weightTR + i)), r, g, b);
+		weighPixels(_mm_loadu_si128((const __m128i *)pixels[2]), _mm_loadu_si128((const __m128i *)(weightBL + i)), r, g, b);
+		weighPixels(_mm_loadu_si128((const __m128i *)pixels[3]), _mm_loadu_si128((const __m128i *)(weightBR + i)), r, g, b);
+
+		const __m128i result = _mm_or_si128(_mm_srli_epi16(r, 8),
+		                                    _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(g, 8), 5), _mm_slli_epi16(_mm_srli_epi16(b, 8), 10)));
+		_mm_storeu_si128((__m128i *)(dst + i), result);
+	}
+
+	if (i < count)
+		warpBilinearGeneric(dst + i, src, table, first + i, count - i);
+}
+
+} // End of namespace ZVision
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
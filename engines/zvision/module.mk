@@ -52,6 +52,11 @@ MODULE_OBJS := \
 	video/zork_avi_decoder.o \
 	zvision.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	graphics/render_table_sse2.o
+endif
+
 MODULE_DIRS += \
 	engines/zvision
 
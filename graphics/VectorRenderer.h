@@ -117,6 +117,7 @@ struct DrawStep {
 };
 
 VectorRenderer *createRenderer(int mode);
+VectorRenderer *createRenderer(int mode, const PixelFormat &format);
 
 /**
  * VectorRenderer: The core Vector Renderer Class
@@ -139,7 +140,7 @@ VectorRenderer *createRenderer(int mode);
 class VectorRenderer {
 public:
 	VectorRenderer() : _activeSurface(NULL), _fillMode(kFillDisabled), _shadowOffset(0), _shadowFillMode(kShadowExponential),
-		_disableShadows(false), _strokeWidth(1), _gradientFactor(1), _bevel(0), _dynamicData(0) {
+		_disableShadows(false), _overlayAlpha(false), _strokeWidth(1), _gradientFactor(1), _bevel(0), _dynamicData(0) {
 
 	}
 
@@ -542,6 +543,12 @@ public:
 	virtual void disableShadows() { _disableShadows = true; }
 	virtual void enableShadows() { _disableShadows = false; }
 
+	/**
+	 * Sets whether the alpha channel of the drawing surface is preserved
+	 * when it is displayed, which changes how shadows and bevels are darkened.
+	 */
+	void setOverlayAlpha(bool overlayAlpha) { _overlayAlpha = overlayAlpha; }
+
 	/**
 	 * Applies a whole-screen shading effect, used before opening a new dialog.
 	 * Currently supports screen dimmings and luminance (b&w).
@@ -557,6 +564,7 @@ protected:
 	int _shadowOffset; /**< offset for drawn shadows */
 	int _bevel; /**< amount of fake bevel */
 	bool _disableShadows; /**< Disables temporarily shadow drawing for overlayed images. */
+	bool _overlayAlpha; /**< The alpha channel of the drawing surface is displayed */
 	int _strokeWidth; /**< Width of the stroke of all drawn shapes */
 	uint32 _dynamicData; /**< Dynamic data from the GUI Theme that modifies the drawing of the current shape */
 
@@ -0,0 +1,301 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/VectorRendererCache.h"
+#include "graphics/VectorRenderer.h"
+
+namespace Graphics {
+
+/** Extra space around the extent of the steps in the scratch surfaces */
+static const int kScratchMargin = 8;
+
+bool DrawStepCache::Key_EqualTo::operator()(const Key &x, const Key &y) const {
+	return x.id == y.id && x.extra == y.extra &&
+	       x.width == y.width && x.height == y.height &&
+	       x.left == y.left && x.top == y.top && x.right == y.right && x.bottom == y.bottom &&
+	       x.oddX == y.oddX;
+}
+
+uint DrawStepCache::Key_Hash::operator()(const Key &x) const {
+	uint hash = x.id;
+	hash = hash * 31 + x.extra;
+	hash = hash * 31 + (uint16)x.width;
+	hash = hash * 31 + (uint16)x.height;
+	hash = hash * 31 + x.oddX;
+	hash = hash * 31 + ((uint8)x.left | ((uint8)x.top << 8) | ((uint8)x.right << 16) | ((uint)(uint8)x.bottom << 24));
+	return hash;
+}
+
+DrawStepCache::DrawStepCache() : _size(0), _maxSize(8 * 1024 * 1024), _useCounter(0) {
+}
+
+DrawStepCache::~DrawStepCache() {
+	clear();
+}
+
+void DrawStepCache::setMaxSize(uint32 maxSize) {
+	_maxSize = maxSize;
+	while (_size > _maxSize)
+		evictOldest();
+}
+
+void DrawStepCache::clear() {
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i)
+		delete i->_value;
+	_entries.clear();
+	_size = 0;
+
+	_scratch[0].free();
+	_scratch[1].free();
+}
+
+bool DrawStepCache::isCacheable(const Common::List<DrawStep> &steps) {
+	if (steps.empty())
+		return false;
+
+	for (Common::List<DrawStep>::const_iterator step = steps.begin(); step != steps.end(); ++step) {
+		if (step->drawingCall == &VectorRenderer::drawCallback_FILLSURFACE)
+			return false;
+		if (step->clip != Common::Rect())
+			return false;
+	}
+
+	return true;
+}
+
+bool DrawStepCache::drawSteps(VectorRenderer *renderer, uint32 id, const Common::List<DrawStep> &steps,
+                              const Common::Rect &area, const Common::Rect &extent, const Common::Rect &clip, uint32 extra) {
+	ManagedSurface *target = renderer->getActiveSurface();
+	if (!target || target->format.bytesPerPixel != 4)
+		return false;
+
+	if (area.isEmpty() || !extent.contains(area))
+		return false;
+
+	if ((uint32)extent.width() * extent.height() * 4 > _maxSize / 2)
+		return false;
+
+	Key key;
+	key.id = id;
+	key.extra = extra;
+	key.width = area.width();
+	key.height = area.height();
+	key.left = area.left - extent.left;
+	key.top = area.top - extent.top;
+	key.right = extent.right - area.right;
+	key.bottom = extent.bottom - area.bottom;
+	key.oddX = area.left & 1;
+
+	Entry *entry;
+	EntryMap::iterator i = _entries.find(key);
+	if (i != _entries.end()) {
+		entry = i->_value;
+	} else {
+		entry = buildEntry(renderer, steps, area, extent, extra);
+		renderer->setSurface(target);
+		insert(key, entry);
+	}
+
+	entry->lastUse = ++_useCounter;
+
+	if (!entry->valid)
+		return false;
+
+	blitEntry(*entry, *target, extent, clip);
+	renderer->setClippingRect(clip);
+	return true;
+}
+
+void DrawStepCache::renderScratch(VectorRenderer *renderer, ManagedSurface &surface, uint32 background,
+                                  const Common::List<DrawStep> &steps, const Common::Rect &area, uint32 extra) {
+	const Common::Rect bounds(surface.w, surface.h);
+	surface.fillRect(bounds, background);
+
+	renderer->setSurface(&surface);
+	for (Common::List<DrawStep>::const_iterator step = steps.begin(); step != steps.end(); ++step)
+		renderer->drawStep(area, bounds, *step, extra);
+}
+
+DrawStepCache::Entry *DrawStepCache::buildEntry(VectorRenderer *renderer, const Common::List<DrawStep> &steps,
+                                                const Common::Rect &area, const Common::Rect &extent, uint32 extra) {
+	const int w = extent.width();
+	const int h = extent.height();
+	const PixelFormat &format = renderer->getActiveSurface()->format;
+
+	// Some shapes are skipped when they get too close to the surface border,
+	// so leave some room around the extent. Gradients are dithered by the
+	// parity of their x position, so the extent is shifted by one more pixel
+	// when that is needed to keep it.
+	const int originX = kScratchMargin + (extent.left & 1);
+	const int scratchW = w + 2 * kScratchMargin + 1;
+	const int scratchH = h + 2 * kScratchMargin;
+	for (int i = 0; i < 2; i++) {
+		if (_scratch[i].w != scratchW || _scratch[i].h != scratchH || _scratch[i].format != format)
+			_scratch[i].create(scratchW, scratchH, format);
+	}
+
+	Common::Rect localArea = area;
+	localArea.translate(originX - extent.left, kScratchMargin - extent.top);
+
+	renderScratch(renderer, _scratch[0], 0x00000000, steps, localArea, extra);
+	renderScratch(renderer, _scratch[1], 0xFFFFFFFF, steps, localArea, extra);
+
+	Entry *entry = new Entry();
+	entry->valid = true;
+	entry->lastUse = 0;
+	entry->rowStart.resize(h + 1);
+
+	for (int y = 0; y < h && entry->valid; y++) {
+		const uint32 *overBlack = (const uint32 *)_scratch[0].getBasePtr(originX, kScratchMargin + y);
+		const uint32 *overWhite = (const uint32 *)_scratch[1].getBasePtr(originX, kScratchMargin + y);
+
+		entry->rowStart[y] = entry->spans.size();
+
+		int x = 0;
+		while (x < w) {
+			if (overBlack[x] == 0x00000000 && overWhite[x] == 0xFFFFFFFF) {
+				x++;
+				continue;
+			}
+
+			const bool opaque = (overBlack[x] == overWhite[x]);
+
+			Span span;
+			span.x = x;
+			span.offset = entry->pixels.size();
+			span.blendOffset = opaque ? -1 : (int32)entry->transmit.size();
+
+			for (; x < w; x++) {
+				const uint32 black = overBlack[x];
+				const uint32 white = overWhite[x];
+
+				if (black == 0x00000000 && white == 0xFFFFFFFF)
+					break;
+				if ((black == white) != opaque)
+					break;
+
+				if (!opaque) {
+					// The steps only blend towards their colors, so every channel
+					// drawn over white must be at least as bright as over black.
+					uint32 transmit = 0;
+					for (int shift = 0; shift < 32; shift += 8) {
+						const int b = (black >> shift) & 0xFF;
+						const int t = ((white >> shift) & 0xFF) - b;
+						if (t < 0)
+							entry->valid = false;
+						transmit |= (uint32)(t & 0xFF) << shift;
+					}
+					entry->transmit.push_back(transmit);
+				}
+
+				entry->pixels.push_back(black);
+			}
+
+			span.length = x - span.x;
+			entry->spans.push_back(span);
+		}
+	}
+	entry->rowStart[h] = entry->spans.size();
+
+	if (!entry->valid) {
+		entry->rowStart.clear();
+		entry->spans.clear();
+		entry->pixels.clear();
+		entry->transmit.clear();
+	}
+
+	entry->size = sizeof(Entry) + entry->rowStart.size() * sizeof(uint32) + entry->spans.size() * sizeof(Span) +
+	              entry->pixels.size() * sizeof(uint32) + entry->transmit.size() * sizeof(uint32);
+	return entry;
+}
+
+static inline uint32 blendCachedPixel(uint32 dst, uint32 color, uint32 transmit) {
+	uint32 result = 0;
+	for (int shift = 0; shift < 32; shift += 8) {
+		const uint32 d = (dst >> shift) & 0xFF;
+		const uint32 t = (transmit >> shift) & 0xFF;
+		result |= (((color >> shift) & 0xFF) + (d * t + 127) / 255) << shift;
+	}
+	return result;
+}
+
+void DrawStepCache::blitEntry(const Entry &entry, ManagedSurface &target, const Common::Rect &extent, const Common::Rect &clip) const {
+	Common::Rect dest = extent;
+	dest.clip(clip);
+	dest.clip(Common::Rect(target.w, target.h));
+	if (dest.isEmpty())
+		return;
+
+	for (int y = dest.top; y < dest.bottom; y++) {
+		const int row = y - extent.top;
+		uint32 *dst = (uint32 *)target.getBasePtr(0, y);
+
+		for (uint32 i = entry.rowStart[row]; i < entry.rowStart[row + 1]; i++) {
+			const Span &span = entry.spans[i];
+
+			int x0 = extent.left + span.x;
+			int x1 = x0 + span.length;
+			int skip = 0;
+			if (x0 < dest.left) {
+				skip = dest.left - x0;
+				x0 = dest.left;
+			}
+			if (x1 > dest.right)
+				x1 = dest.right;
+			if (x0 >= x1)
+				continue;
+
+			const uint32 *src = &entry.pixels[span.offset + skip];
+			if (span.blendOffset < 0) {
+				memcpy(dst + x0, src, (x1 - x0) * sizeof(uint32));
+			} else {
+				const uint32 *transmit = &entry.transmit[span.blendOffset + skip];
+				for (int x = x0; x < x1; x++)
+					dst[x] = blendCachedPixel(dst[x], *src++, *transmit++);
+			}
+		}
+	}
+}
+
+void DrawStepCache::insert(const Key &key, Entry *entry) {
+	while (!_entries.empty() && _size + entry->size > _maxSize)
+		evictOldest();
+
+	_entries[key] = entry;
+	_size += entry->size;
+}
+
+void DrawStepCache::evictOldest() {
+	EntryMap::iterator oldest = _entries.end();
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (oldest == _entries.end() || i->_value->lastUse < oldest->_value->lastUse)
+			oldest = i;
+	}
+
+	if (oldest == _entries.end())
+		return;
+
+	_size -= oldest->_value->size;
+	delete oldest->_value;
+	_entries.erase(oldest);
+}
+
+} // End of namespace Graphics
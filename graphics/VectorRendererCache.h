@@ -0,0 +1,168 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VECTOR_RENDERER_CACHE_H
+#define VECTOR_RENDERER_CACHE_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/rect.h"
+#include "common/scummsys.h"
+
+#include "graphics/managed_surface.h"
+
+namespace Graphics {
+class VectorRenderer;
+struct DrawStep;
+
+/**
+ * @defgroup graphics_vector_renderer_cache Vector renderer cache
+ * @ingroup graphics
+ *
+ * @brief Cache of rasterized DrawStep lists.
+ *
+ * @{
+ */
+
+/**
+ * Keeps the rasterized result of DrawStep lists, so widgets which are
+ * redrawn with the same size do not have to replay their gradients,
+ * bevels and rounded corners every time.
+ *
+ * On a miss the steps are rendered twice into scratch surfaces, once over
+ * transparent black and once over opaque white. Pixels which come out the
+ * same on both are stored as opaque, pixels which were not touched are
+ * skipped, and for the remaining blended pixels (anti-aliased edges,
+ * shadows) the per-channel coverage is recovered from the difference so
+ * they can be blended onto whatever is below them later.
+ *
+ * Only 32bpp surfaces are supported. For other formats drawSteps() returns
+ * false and the caller has to draw the steps itself.
+ */
+class DrawStepCache {
+public:
+	DrawStepCache();
+	~DrawStepCache();
+
+	/**
+	 * Set the maximum amount of memory used for cached rasters, in bytes.
+	 * Rasters which would take more than half of it are never cached.
+	 */
+	void setMaxSize(uint32 maxSize);
+	uint32 getMaxSize() const { return _maxSize; }
+
+	/** Return the amount of memory currently used for cached rasters. */
+	uint32 getSize() const { return _size; }
+
+	/** Drop all cached rasters. */
+	void clear();
+
+	/**
+	 * Return whether a step list can be cached at all. Steps that fill the
+	 * whole surface or use their own clipping rectangle depend on more than
+	 * the area they are drawn for, and are always drawn directly.
+	 */
+	static bool isCacheable(const Common::List<DrawStep> &steps);
+
+	/**
+	 * Draw a step list onto the active surface of the renderer, using the
+	 * cached raster if there is one.
+	 *
+	 * @param renderer  The renderer to draw with. Its active surface is the target.
+	 * @param id        Identifier of the step list, e.g. its DrawData id.
+	 * @param steps     The steps to draw.
+	 * @param area      The area the steps are drawn for.
+	 * @param extent    The area the steps may touch. Must contain @p area.
+	 * @param clip      Clipping rectangle for the final blit.
+	 * @param extra     Dynamic data passed on to the steps.
+	 * @return false if the steps could not be drawn from the cache, in which
+	 *         case nothing has been drawn.
+	 */
+	bool drawSteps(VectorRenderer *renderer, uint32 id, const Common::List<DrawStep> &steps,
+	               const Common::Rect &area, const Common::Rect &extent, const Common::Rect &clip, uint32 extra);
+
+private:
+	struct Key {
+		uint32 id;
+		uint32 extra;
+		int16 width, height;
+		int16 left, top, right, bottom;
+		/** Parity of area.left, which selects the phase of dithered gradients. */
+		uint8 oddX;
+	};
+
+	struct Key_EqualTo {
+		bool operator()(const Key &x, const Key &y) const;
+	};
+
+	struct Key_Hash {
+		uint operator()(const Key &x) const;
+	};
+
+	/** A run of touched pixels inside one row of a cached raster. */
+	struct Span {
+		uint16 x;
+		uint16 length;
+		/** Index of the first pixel in Entry::_pixels. */
+		uint32 offset;
+		/** Index of the first coverage value in Entry::_transmit, or -1 if the run is opaque. */
+		int32 blendOffset;
+	};
+
+	struct Entry {
+		/** False if the steps could not be cached for this key. */
+		bool valid;
+		uint32 lastUse;
+		uint32 size;
+
+		/** Span range for row y is [rowStart[y], rowStart[y + 1]). */
+		Common::Array<uint32> rowStart;
+		Common::Array<Span> spans;
+		Common::Array<uint32> pixels;
+		/** Per channel fraction of the background which shows through. */
+		Common::Array<uint32> transmit;
+	};
+
+	typedef Common::HashMap<Key, Entry *, Key_Hash, Key_EqualTo> EntryMap;
+
+	Entry *buildEntry(VectorRenderer *renderer, const Common::List<DrawStep> &steps,
+	                  const Common::Rect &area, const Common::Rect &extent, uint32 extra);
+	void renderScratch(VectorRenderer *renderer, ManagedSurface &surface, uint32 background,
+	                   const Common::List<DrawStep> &steps, const Common::Rect &area, uint32 extra);
+	void blitEntry(const Entry &entry, ManagedSurface &target, const Common::Rect &extent, const Common::Rect &clip) const;
+
+	void insert(const Key &key, Entry *entry);
+	void evictOldest();
+
+	EntryMap _entries;
+	uint32 _size;
+	uint32 _maxSize;
+	uint32 _useCounter;
+
+	ManagedSurface _scratch[2];
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
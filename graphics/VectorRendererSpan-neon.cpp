@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/VectorRendererSpan.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Graphics {
+
+void VectorRendererSpan::blendFillNEON(uint32 *first, uint32 *last, uint32 color, uint8 alpha, uint32 resultMask) {
+	// d + ((s - d) * a >> 8) == (d * (255 - a) + d + s * a) >> 8
+	const uint16x8_t srcAlpha = vmull_u8(vreinterpret_u8_u32(vdup_n_u32(color)), vdup_n_u8(alpha));
+	const uint8x8_t invAlpha = vdup_n_u8(255 - alpha);
+	const uint32x4_t mask = vdupq_n_u32(resultMask);
+
+	while (last - first >= 4) {
+		const uint8x16_t dst = vreinterpretq_u8_u32(vld1q_u32(first));
+		const uint8x8_t dstLo = vget_low_u8(dst);
+		const uint8x8_t dstHi = vget_high_u8(dst);
+		const uint16x8_t lo = vaddw_u8(vmlal_u8(srcAlpha, dstLo, invAlpha), dstLo);
+		const uint16x8_t hi = vaddw_u8(vmlal_u8(srcAlpha, dstHi, invAlpha), dstHi);
+		const uint8x16_t result = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+		vst1q_u32(first, vandq_u32(vreinterpretq_u32_u8(result), mask));
+		first += 4;
+	}
+
+	blendFillGeneric(first, last, color, alpha, resultMask);
+}
+
+void VectorRendererSpan::darkenFillNEON(uint32 *first, uint32 *last, uint32 keepMask, uint32 add) {
+	const uint32x4_t keep = vdupq_n_u32(keepMask);
+	const uint32x4_t offset = vdupq_n_u32(add);
+
+	while (last - first >= 4) {
+		const uint32x4_t dst = vld1q_u32(first);
+		vst1q_u32(first, vaddq_u32(vshrq_n_u32(vandq_u32(dst, keep), 2), offset));
+		first += 4;
+	}
+
+	darkenFillGeneric(first, last, keepMask, add);
+}
+
+void VectorRendererSpan::patternFillNEON(uint32 *first, uint32 *last, uint32 even, uint32 odd) {
+	const uint32 values[4] = { even, odd, even, odd };
+	const uint32x4_t pattern = vld1q_u32(values);
+
+	while (last - first >= 4) {
+		vst1q_u32(first, pattern);
+		first += 4;
+	}
+
+	patternFillGeneric(first, last, even, odd);
+}
+
+} // End of namespace Graphics
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/VectorRendererSpan.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Graphics {
+
+void VectorRendererSpan::blendFillSSE2(uint32 *first, uint32 *last, uint32 color, uint8 alpha, uint32 resultMask) {
+	// d + ((s - d) * a >> 8) == (d * (256 - a) + s * a) >> 8, and both
+	// products fit in an unsigned 16-bit lane
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i srcAlpha = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(color), zero), _mm_set1_epi16(alpha));
+	const __m128i invAlpha = _mm_set1_epi16(256 - alpha);
+	const __m128i mask = _mm_set1_epi32(resultMask);
+
+	while (last - first >= 4) {
+		const __m128i dst = _mm_loadu_si128((const __m128i *)first);
+		__m128i lo = _mm_unpacklo_epi8(dst, zero);
+		__m128i hi = _mm_unpackhi_epi8(dst, zero);
+		lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, invAlpha), srcAlpha), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, invAlpha), srcAlpha), 8);
+		_mm_storeu_si128((__m128i *)first, _mm_and_si128(_mm_packus_epi16(lo, hi), mask));
+		first += 4;
+	}
+
+	blendFillGeneric(first, last, color, alpha, resultMask);
+}
+
+void VectorRendererSpan::darkenFillSSE2(uint32 *first, uint32 *last, uint32 keepMask, uint32 add) {
+	const __m128i keep = _mm_set1_epi32(keepMask);
+	const __m128i offset = _mm_set1_epi32(add);
+
+	while (last - first >= 4) {
+		const __m128i dst = _mm_loadu_si128((const __m128i *)first);
+		_mm_storeu_si128((__m128i *)first, _mm_add_epi32(_mm_srli_epi32(_mm_and_si128(dst, keep), 2), offset));
+		first += 4;
+	}
+
+	darkenFillGeneric(first, last, keepMask, add);
+}
+
+void VectorRendererSpan::patternFillSSE2(uint32 *first, uint32 *last, uint32 even, uint32 odd) {
+	const __m128i pattern = _mm_set_epi32(odd, even, odd, even);
+
+	while (last - first >= 4) {
+		_mm_storeu_si128((__m128i *)first, pattern);
+		first += 4;
+	}
+
+	patternFillGeneric(first, last, even, odd);
+}
+
+} // End of namespace Graphics
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
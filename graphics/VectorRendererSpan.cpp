@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/VectorRendererSpan.h"
+
+namespace Graphics {
+
+VectorRendererSpan::BlendFillFunc VectorRendererSpan::_blendFillFunc = nullptr;
+VectorRendererSpan::DarkenFillFunc VectorRendererSpan::_darkenFillFunc = nullptr;
+VectorRendererSpan::PatternFillFunc VectorRendererSpan::_patternFillFunc = nullptr;
+
+void VectorRendererSpan::selectFuncs() {
+	_blendFillFunc = blendFillGeneric;
+	_darkenFillFunc = darkenFillGeneric;
+	_patternFillFunc = patternFillGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		_blendFillFunc = blendFillNEON;
+		_darkenFillFunc = darkenFillNEON;
+		_patternFillFunc = patternFillNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		_blendFillFunc = blendFillSSE2;
+		_darkenFillFunc = darkenFillSSE2;
+		_patternFillFunc = patternFillSSE2;
+	}
+#endif
+}
+
+void VectorRendererSpan::blendFillGeneric(uint32 *first, uint32 *last, uint32 color, uint8 alpha, uint32 resultMask) {
+	while (first < last) {
+		const uint32 dst = *first;
+		uint32 result = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			const int s = (color >> shift) & 0xFF;
+			const int d = (dst >> shift) & 0xFF;
+			result |= (uint32)((d + (((s - d) * alpha) >> 8)) & 0xFF) << shift;
+		}
+		*first++ = result & resultMask;
+	}
+}
+
+void VectorRendererSpan::darkenFillGeneric(uint32 *first, uint32 *last, uint32 keepMask, uint32 add) {
+	while (first < last) {
+		*first = ((*first & keepMask) >> 2) + add;
+		++first;
+	}
+}
+
+void VectorRendererSpan::patternFillGeneric(uint32 *first, uint32 *last, uint32 even, uint32 odd) {
+	while (last - first >= 2) {
+		*first++ = even;
+		*first++ = odd;
+	}
+	if (first < last)
+		*first = even;
+}
+
+} // End of namespace Graphics
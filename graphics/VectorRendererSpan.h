@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VECTOR_RENDERER_SPAN_H
+#define VECTOR_RENDERER_SPAN_H
+
+#include "common/scummsys.h"
+
+class VectorRendererCacheTestSuite;
+class VectorRendererSpanTestSuite;
+
+namespace Graphics {
+
+/**
+ * Span fillers used by VectorRendererSpec for 32bpp surfaces.
+ *
+ * All functions work on the half-open range [first, last). The SIMD
+ * variants are selected at runtime on first use, like BlendBlit.
+ */
+class VectorRendererSpan {
+public:
+	/**
+	 * Blend a color into every pixel of the span. Each byte of the pixel is
+	 * moved towards the matching byte of the color by (color - pixel) * alpha / 256,
+	 * rounding down, the same way as VectorRendererSpec::blendPixelPtr().
+	 *
+	 * @param color       Color to blend towards, with the alpha byte set to 0xFF.
+	 * @param alpha       Intensity of the color (0-255).
+	 * @param resultMask  Mask applied to every resulting pixel.
+	 */
+	static void blendFill(uint32 *first, uint32 *last, uint32 color, uint8 alpha, uint32 resultMask) {
+		if (!_blendFillFunc)
+			selectFuncs();
+		_blendFillFunc(first, last, color, alpha, resultMask);
+	}
+
+	/** Replace every pixel p of the span with ((p & keepMask) >> 2) + add. */
+	static void darkenFill(uint32 *first, uint32 *last, uint32 keepMask, uint32 add) {
+		if (!_darkenFillFunc)
+			selectFuncs();
+		_darkenFillFunc(first, last, keepMask, add);
+	}
+
+	/** Fill the span alternating between two colors, starting with even. */
+	static void patternFill(uint32 *first, uint32 *last, uint32 even, uint32 odd) {
+		if (!_patternFillFunc)
+			selectFuncs();
+		_patternFillFunc(first, last, even, odd);
+	}
+
+private:
+	typedef void (*BlendFillFunc)(uint32 *first, uint32 *last, uint32 color, uint8 alpha, uint32 resultMask);
+	typedef void (*DarkenFillFunc)(uint32 *first, uint32 *last, uint32 keepMask, uint32 add);
+	typedef void (*PatternFillFunc)(uint32 *first, uint32 *last, uint32 even, uint32 odd);
+
+	static void selectFuncs();
+
+	static void blendFillGeneric(uint32 *first, uint32 *last, uint32 color, uint8 alpha, uint32 resultMask);
+	static void darkenFillGeneric(uint32 *first, uint32 *last, uint32 keepMask, uint32 add);
+	static void patternFillGeneric(uint32 *first, uint32 *last, uint32 even, uint32 odd);
+#ifdef SCUMMVM_NEON
+	static void blendFillNEON(uint32 *first, uint32 *last, uint32 color, uint8 alpha, uint32 resultMask);
+	static void darkenFillNEON(uint32 *first, uint32 *last, uint32 keepMask, uint32 add);
+	static void patternFillNEON(uint32 *first, uint32 *last, uint32 even, uint32 odd);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void blendFillSSE2(uint32 *first, uint32 *last, uint32 color, uint8 alpha, uint32 resultMask);
+	static void darkenFillSSE2(uint32 *first, uint32 *last, uint32 keepMask, uint32 add);
+	static void patternFillSSE2(uint32 *first, uint32 *last, uint32 even, uint32 odd);
+#endif
+
+	static BlendFillFunc _blendFillFunc;
+	static DarkenFillFunc _darkenFillFunc;
+	static PatternFillFunc _patternFillFunc;
+
+	friend class ::VectorRendererCacheTestSuite;
+	friend class ::VectorRendererSpanTestSuite;
+};
+
+} // End of namespace Graphics
+
+#endif
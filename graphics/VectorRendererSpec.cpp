@@ -29,6 +29,7 @@
 #include "gui/ThemeEngine.h"
 #include "graphics/VectorRenderer.h"
 #include "graphics/VectorRendererSpec.h"
+#include "graphics/VectorRendererSpan.h"
 
 #define VECTOR_RENDERER_FAST_TRIANGLES
 
@@ -525,28 +526,34 @@ void colorVFillClip(PixelType *first, PixelType *last, int pitch, PixelType colo
 
 
 VectorRenderer *createRenderer(int mode) {
+	VectorRenderer *renderer = createRenderer(mode, g_system->getOverlayFormat());
+	if (renderer)
+		renderer->setOverlayAlpha(g_system->hasFeature(OSystem::kFeatureOverlaySupportsAlpha));
+	return renderer;
+}
+
+VectorRenderer *createRenderer(int mode, const PixelFormat &format) {
 #ifdef DISABLE_FANCY_THEMES
 	assert(mode == GUI::ThemeEngine::kGfxStandard);
 #endif
 
-	PixelFormat format = g_system->getOverlayFormat();
 	switch (mode) {
 	case GUI::ThemeEngine::kGfxStandard:
-		if (g_system->getOverlayFormat().bytesPerPixel == 4)
+		if (format.bytesPerPixel == 4)
 			return new VectorRendererSpec<uint32>(format);
-		else if (g_system->getOverlayFormat().bytesPerPixel == 2)
+		else if (format.bytesPerPixel == 2)
 			return new VectorRendererSpec<uint16>(format);
-		else if (g_system->getOverlayFormat().bytesPerPixel == 1)
+		else if (format.bytesPerPixel == 1)
 			return new VectorRendererSpec<uint8>(format);
 		break;
 #ifndef DISABLE_FANCY_THEMES
 	case GUI::ThemeEngine::kGfxAntialias:
-		if (g_system->getOverlayFormat().bytesPerPixel == 4)
+		if (format.bytesPerPixel == 4)
 			return new VectorRendererAA<uint32>(format);
-		else if (g_system->getOverlayFormat().bytesPerPixel == 2)
+		else if (format.bytesPerPixel == 2)
 			return new VectorRendererAA<uint16>(format);
 		// No AA with 8-bit
-		else if (g_system->getOverlayFormat().bytesPerPixel == 1)
+		else if (format.bytesPerPixel == 1)
 			return new VectorRendererSpec<uint8>(format);
 		break;
 #endif
@@ -564,7 +571,10 @@ VectorRendererSpec(PixelFormat format) :
 	_redMask((0xFF >> format.rLoss) << format.rShift),
 	_greenMask((0xFF >> format.gLoss) << format.gShift),
 	_blueMask((0xFF >> format.bLoss) << format.bShift),
-	_alphaMask((0xFF >> format.aLoss) << format.aShift) {
+	_alphaMask((0xFF >> format.aLoss) << format.aShift),
+	_byteChannels(format.bytesPerPixel == 4 && format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0 &&
+	              (format.aLoss == 0 || format.aLoss == 8) &&
+	              (format.rShift % 8) == 0 && (format.gShift % 8) == 0 && (format.bShift % 8) == 0 && (format.aShift % 8) == 0) {
 
 	_clippingArea = Common::Rect(0, 0, 32767, 32767);
 
@@ -659,16 +669,9 @@ gradientFill(PixelType *ptr, int width, int x, int y) {
 	} else if (grad == 3 && ox) {
 		colorFill<PixelType>(ptr, ptr + width, _gradCache[curGrad + 1]);
 	} else {
-		for (int j = x; j < x + width; j++, ptr++) {
-			bool oy = ((j & 1) == 1);
-
-			if ((ox && oy) ||
-				((grad == 2 || grad == 3) && ox && !oy) ||
-				(grad == 3 && oy))
-				*ptr = _gradCache[curGrad + 1];
-			else
-				*ptr = _gradCache[curGrad];
-		}
+		const PixelType even = ((grad == 2 || grad == 3) && ox) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		const PixelType odd = (ox || grad == 3) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		patternFill(ptr, ptr + width, x, even, odd);
 	}
 }
 
@@ -701,20 +704,64 @@ gradientFillClip(PixelType *ptr, int width, int x, int y, int realX, int realY)
 	} else if (grad == 3 && ox) {
 		colorFillClip<PixelType>(ptr, ptr + width, _gradCache[curGrad + 1], realX, realY, _clippingArea);
 	} else {
-		for (int j = x; j < x + width; j++, ptr++) {
-			if (realX + j - x < _clippingArea.left || realX + j - x >= _clippingArea.right) continue;
-			bool oy = ((j & 1) == 1);
-
-			if ((ox && oy) ||
-				((grad == 2 || grad == 3) && ox && !oy) ||
-				(grad == 3 && oy))
-				*ptr = _gradCache[curGrad + 1];
-			else
-				*ptr = _gradCache[curGrad];
-		}
+		const PixelType even = ((grad == 2 || grad == 3) && ox) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		const PixelType odd = (ox || grad == 3) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+
+		int skip = MAX(_clippingArea.left - realX, 0);
+		int end = MIN(_clippingArea.right - realX, width);
+		if (skip < end)
+			patternFill(ptr + skip, ptr + end, x + skip, even, odd);
+	}
+}
+
+template<typename PixelType>
+void VectorRendererSpec<PixelType>::
+patternFill(PixelType *first, PixelType *last, int x, PixelType even, PixelType odd) {
+	if (x & 1)
+		SWAP(even, odd);
+
+	if (sizeof(PixelType) == 4) {
+		VectorRendererSpan::patternFill((uint32 *)first, (uint32 *)last, even, odd);
+		return;
+	}
+
+	while (last - first >= 2) {
+		*first++ = even;
+		*first++ = odd;
+	}
+	if (first < last)
+		*first = even;
+}
+
+template<typename PixelType>
+void VectorRendererSpec<PixelType>::
+blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha) {
+	if (alpha == 0xff) {
+		colorFill<PixelType>(first, last, color | _alphaMask);
+	} else if (_byteChannels) {
+		// Only reached for 32bpp surfaces, the casts are no-ops then
+		VectorRendererSpan::blendFill((uint32 *)first, (uint32 *)last,
+		                              (color & (_redMask | _greenMask | _blueMask)) | _alphaMask, alpha,
+		                              _redMask | _greenMask | _blueMask | _alphaMask);
+	} else {
+		while (first < last)
+			blendPixelPtr(first++, color, alpha);
 	}
 }
 
+template<typename PixelType>
+void VectorRendererSpec<PixelType>::
+blendFillClip(PixelType *first, PixelType *last, PixelType color, uint8 alpha, int realX, int realY) {
+	if (realY < _clippingArea.top || realY >= _clippingArea.bottom)
+		return;
+
+	const int count = last - first;
+	const int skip = MAX(_clippingArea.left - realX, 0);
+	const int end = MIN(_clippingArea.right - realX, count);
+	if (skip < end)
+		blendFill(first + skip, first + end, color, alpha);
+}
+
 template<typename PixelType>
 void VectorRendererSpec<PixelType>::
 fillSurface() {
@@ -919,11 +966,18 @@ inline void VectorRendererSpec<PixelType>::
 darkenFill(PixelType *ptr, PixelType *end) {
 	PixelType mask = (PixelType)((3 << _format.rShift) | (3 << _format.gShift) | (3 << _format.bShift));
 
-	if (!g_system->hasFeature(OSystem::kFeatureOverlaySupportsAlpha)) {
+	if (!Base::_overlayAlpha) {
 		// !kFeatureOverlaySupportsAlpha (but might have alpha bits)
 
 		mask |= _alphaMask;
 
+		if (_byteChannels) {
+			// The darkened channels never reach the alpha bits, so adding
+			// the alpha mask is the same as or-ing it
+			VectorRendererSpan::darkenFill((uint32 *)ptr, (uint32 *)end, (PixelType)~mask, _alphaMask);
+			return;
+		}
+
 		while (ptr != end) {
 			*ptr = ((*ptr & ~mask) >> 2) | _alphaMask;
 			++ptr;
@@ -935,6 +989,11 @@ darkenFill(PixelType *ptr, PixelType *end) {
 		mask |= 3 << _format.aShift;
 		PixelType addA = (PixelType)(3 << (_format.aShift + 6 - _format.aLoss));
 
+		if (_byteChannels) {
+			VectorRendererSpan::darkenFill((uint32 *)ptr, (uint32 *)end, (PixelType)~mask, addA);
+			return;
+		}
+
 		while (ptr != end) {
 			// Darken the color, and increase the alpha
 			// (0% -> 75%, 100% -> 100%)
@@ -947,9 +1006,21 @@ darkenFill(PixelType *ptr, PixelType *end) {
 template<typename PixelType>
 inline void VectorRendererSpec<PixelType>::
 darkenFillClip(PixelType *ptr, PixelType *end, int x, int y) {
+	if (_byteChannels) {
+		if (y < _clippingArea.top || y >= _clippingArea.bottom)
+			return;
+
+		const int count = end - ptr;
+		const int skip = MAX(_clippingArea.left - x, 0);
+		const int last = MIN(_clippingArea.right - x, count);
+		if (skip < last)
+			darkenFill(ptr + skip, ptr + last);
+		return;
+	}
+
 	PixelType mask = (PixelType)((3 << _format.rShift) | (3 << _format.gShift) | (3 << _format.bShift));
 
-	if (!g_system->hasFeature(OSystem::kFeatureOverlaySupportsAlpha)) {
+	if (!Base::_overlayAlpha) {
 		// !kFeatureOverlaySupportsAlpha (but might have alpha bits)
 
 		mask |= _alphaMask;
@@ -4329,7 +4400,7 @@ drawInteriorRoundedSquareAlg(int x1, int y1, int r, int w, int h, PixelType colo
 			// and the overlay supports alpha, we have to do AA by
 			// setting the dest alpha channel, instead of blending with
 			// dest color channels.
-			if (!g_system->hasFeature(OSystem::kFeatureOverlaySupportsAlpha))
+			if (!Base::_overlayAlpha)
 				WU_DRAWCIRCLE_XCOLOR(ptr_tr, ptr_tl, ptr_bl, ptr_br, x, y, px, py, a1, blendPixelPtr);
 			else
 				WU_DRAWCIRCLE_XCOLOR(ptr_tr, ptr_tl, ptr_bl, ptr_br, x, y, px, py, a1, blendPixelDestAlphaPtr);
@@ -286,28 +286,25 @@ protected:
 	 * @param color Color of the pixel
 	 * @param alpha Alpha intensity of the pixel (0-255)
 	 */
-	inline void blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha) {
-		while (first < last)
-			blendPixelPtr(first++, color, alpha);
-	}
-
-	inline void blendFillClip(PixelType *first, PixelType *last, PixelType color, uint8 alpha, int realX, int realY) {
-		if (_clippingArea.top <= realY && realY < _clippingArea.bottom) {
-			while (first < last) {
-				if (_clippingArea.left <= realX && realX < _clippingArea.right)
-					blendPixelPtr(first++, color, alpha);
-				else
-					++first;
-				++realX;
-			}
-		}
-	}
+	void blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha);
+	void blendFillClip(PixelType *first, PixelType *last, PixelType color, uint8 alpha, int realX, int realY);
 
 	void darkenFill(PixelType *first, PixelType *last);
 	void darkenFillClip(PixelType *first, PixelType *last, int x, int y);
 
+	/**
+	 * Fills several pixels in a row alternating between two colors, as used
+	 * by the gradient dithering.
+	 *
+	 * @param x Column of the first pixel, which selects the starting color.
+	 * @param even Color of the pixels in even columns.
+	 * @param odd Color of the pixels in odd columns.
+	 */
+	void patternFill(PixelType *first, PixelType *last, int x, PixelType even, PixelType odd);
+
 	const PixelFormat _format;
 	const PixelType _redMask, _greenMask, _blueMask, _alphaMask;
+	const bool _byteChannels; /**< 32bpp format with one byte per channel, which can use VectorRendererSpan */
 
 	PixelType _fgColor; /**< Foreground color currently being used to draw on the renderer */
 	PixelType _bgColor; /**< Background color currently being used to draw on the renderer */
@@ -194,6 +194,7 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
+		/** The glyph image, pointing into one of the atlas pages */
 		Surface image;
 		int xOffset, yOffset;
 		int advance;
@@ -205,6 +206,35 @@ private:
 	mutable GlyphCache _glyphs;
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
+	const Glyph *findGlyph(uint32 chr) const;
+
+	/** Direct lookup for characters 0-255, which are all cached by load() */
+	const Glyph *_latin1Glyphs[256];
+
+	/**
+	 * A page of the glyph atlas. Glyph images are packed left to right on
+	 * shelves, and a new shelf is started when the current one is full.
+	 */
+	struct AtlasPage {
+		Surface surface;
+		int cursorX;
+		int shelfY, shelfHeight;
+	};
+
+	void allocateGlyphImage(Surface &image, int w, int h) const;
+	mutable Common::Array<AtlasPage *> _atlasPages;
+
+	/** Kerning offsets, keyed by the glyph slots of both characters */
+	typedef Common::HashMap<uint32, int> KerningCache;
+	mutable KerningCache _kerning;
+
+	struct Stats {
+		uint32 glyphHits;
+		uint32 glyphMisses;
+		uint32 kerningHits;
+		uint32 freeTypeCalls;
+	};
+	mutable Stats _stats;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
@@ -226,7 +256,8 @@ TTFFont::TTFFont()
 	: _initialized(false), _stream(), _face(), _ttfFile(0), _width(0), _height(0), _ascent(0),
 	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
 	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false),
-	  _disposeAfterUse(DisposeAfterUse::NO) {
+	  _disposeAfterUse(DisposeAfterUse::NO), _stats() {
+	memset(_latin1Glyphs, 0, sizeof(_latin1Glyphs));
 }
 
 TTFFont::~TTFFont() {
@@ -237,11 +268,16 @@ TTFFont::~TTFFont() {
 			delete _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
+		debug(5, "TTFFont: %u glyph hits, %u glyph misses, %u kerning hits, %u FreeType calls, %u atlas pages",
+		      _stats.glyphHits, _stats.glyphMisses, _stats.kerningHits, _stats.freeTypeCalls, _atlasPages.size());
 
 		_initialized = false;
 	}
+
+	for (uint i = 0; i < _atlasPages.size(); i++) {
+		_atlasPages[i]->surface.free();
+		delete _atlasPages[i];
+	}
 }
 
 
@@ -403,6 +439,13 @@ bool TTFFont::load(Common::SeekableReadStream *ttfFile, DisposeAfterUse::Flag di
 
 		return false;
 	} else {
+		// Glyphs are never removed from the cache from here on, so the
+		// pointers stay valid
+		for (uint i = 0; i < ARRAYSIZE(_latin1Glyphs); ++i) {
+			GlyphCache::const_iterator glyphEntry = _glyphs.find(i);
+			_latin1Glyphs[i] = (glyphEntry != _glyphs.end()) ? &glyphEntry->_value : nullptr;
+		}
+
 		_initialized = true;
 		// At this point we get ownership of _ttfFile
 		return true;
@@ -548,55 +591,56 @@ int TTFFont::getMaxCharWidth() const {
 }
 
 int TTFFont::getCharWidth(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyph = findGlyph(chr);
+	if (!glyph)
 		return 0;
 	else
-		return glyphEntry->_value.advance;
+		return glyph->advance;
 }
 
 int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
-
-	FT_UInt leftGlyph, rightGlyph;
-	GlyphCache::const_iterator glyphEntry;
-
-	glyphEntry = _glyphs.find(left);
-	if (glyphEntry != _glyphs.end()) {
-		leftGlyph = glyphEntry->_value.slot;
-	} else {
+	const Glyph *leftEntry = findGlyph(left);
+	if (!leftEntry)
 		return 0;
-	}
 
-	glyphEntry = _glyphs.find(right);
-	if (glyphEntry != _glyphs.end()) {
-		rightGlyph = glyphEntry->_value.slot;
-	} else {
+	const Glyph *rightEntry = findGlyph(right);
+	if (!rightEntry)
 		return 0;
-	}
+
+	FT_UInt leftGlyph = leftEntry->slot;
+	FT_UInt rightGlyph = rightEntry->slot;
 
 	if (!leftGlyph || !rightGlyph)
 		return 0;
 
+	// Glyph indices are 16-bit in both TrueType and CFF fonts
+	const uint32 key = (leftGlyph << 16) | (rightGlyph & 0xFFFF);
+	KerningCache::const_iterator kerningEntry = _kerning.find(key);
+	if (kerningEntry != _kerning.end()) {
+		_stats.kerningHits++;
+		return kerningEntry->_value;
+	}
+
 	FT_Vector kerningVector;
 	FT_Get_Kerning(_face, leftGlyph, rightGlyph, FT_KERNING_DEFAULT, &kerningVector);
-	return (kerningVector.x / 64);
+	_stats.freeTypeCalls++;
+
+	const int offset = kerningVector.x / 64;
+	_kerning[key] = offset;
+	return offset;
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end()) {
+	const Glyph *glyph = findGlyph(chr);
+	if (!glyph) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
+		const int xOffset = glyph->xOffset;
+		const int yOffset = glyph->yOffset;
+		const Graphics::Surface &image = glyph->image;
 		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
 	}
 }
@@ -703,12 +747,11 @@ void TTFFont::drawAlphaChar(ManagedSurface *dst, uint32 chr, int x, int y, uint3
 
 void TTFFont::drawCharIntern(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		const uint32 *transparentColor, bool alpha) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyphEntry = findGlyph(chr);
+	if (!glyphEntry)
 		return;
 
-	const Glyph &glyph = glyphEntry->_value;
+	const Glyph &glyph = *glyphEntry;
 
 	x += glyph.xOffset;
 	y += glyph.yOffset;
@@ -788,6 +831,9 @@ void TTFFont::drawCharIntern(Surface * dst, uint32 chr, int x, int y, uint32 col
 }
 
 bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
+	_stats.glyphMisses++;
+	_stats.freeTypeCalls++;
+
 	FT_UInt slot = FT_Get_Char_Index(_face, chr);
 	if (!slot)
 		return false;
@@ -797,6 +843,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	// We use the light target and render mode to improve the looks of the
 	// glyphs. It is most noticeable in FreeSansBold.ttf, where otherwise the
 	// 't' glyph looks like it is cut off on the right side.
+	_stats.freeTypeCalls += 2;
 	if (FT_Load_Glyph(_face, slot, _loadFlags))
 		return false;
 
@@ -851,8 +898,12 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		bitmap = &_face->glyph->bitmap;
 	}
 
+	if (bitmap->pixel_mode != FT_PIXEL_MODE_MONO && bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
+		return false;
+	}
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	allocateGlyphImage(glyph.image, bitmap->width, bitmap->rows);
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -867,6 +918,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	case FT_PIXEL_MODE_MONO:
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			const uint8 *curSrc = src;
+			uint8 *curDst = dst;
 			uint8 mask = 0;
 
 			for (int x = 0; x < (int)bitmap->width; ++x) {
@@ -874,12 +926,13 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 					mask = *curSrc++;
 
 				if (mask & 0x80)
-					*dst = 255;
+					*curDst = 255;
 
 				mask <<= 1;
-				++dst;
+				++curDst;
 			}
 
+			dst += glyph.image.pitch;
 			src += srcPitch;
 		}
 		break;
@@ -893,9 +946,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		break;
 
 	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
-		return false;
+		break;
 	}
 
 #if FAKE_BOLD == 1
@@ -907,6 +958,52 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	return true;
 }
 
+void TTFFont::allocateGlyphImage(Surface &image, int w, int h) const {
+	static const int kAtlasPageSize = 256;
+
+	if (w == 0 || h == 0) {
+		image.init(w, h, 0, nullptr, PixelFormat::createFormatCLUT8());
+		return;
+	}
+
+	AtlasPage *page = _atlasPages.empty() ? nullptr : _atlasPages.back();
+	if (page && page->cursorX + w > page->surface.w) {
+		// Start a new shelf
+		page->shelfY += page->shelfHeight;
+		page->shelfHeight = 0;
+		page->cursorX = 0;
+	}
+
+	if (!page || page->cursorX + w > page->surface.w || page->shelfY + h > page->surface.h) {
+		page = new AtlasPage();
+		// Oversized glyphs get a page of their own
+		page->surface.create(MAX(w, kAtlasPageSize), MAX(h, kAtlasPageSize), PixelFormat::createFormatCLUT8());
+		page->cursorX = 0;
+		page->shelfY = 0;
+		page->shelfHeight = 0;
+		_atlasPages.push_back(page);
+	}
+
+	image = page->surface.getSubArea(Common::Rect(page->cursorX, page->shelfY, page->cursorX + w, page->shelfY + h));
+	page->cursorX += w;
+	page->shelfHeight = MAX(page->shelfHeight, h);
+}
+
+const TTFFont::Glyph *TTFFont::findGlyph(uint32 chr) const {
+	if (chr < ARRAYSIZE(_latin1Glyphs) && _initialized) {
+		_stats.glyphHits++;
+		return _latin1Glyphs[chr];
+	}
+
+	assureCached(chr);
+	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
+	if (glyphEntry == _glyphs.end())
+		return nullptr;
+
+	_stats.glyphHits++;
+	return &glyphEntry->_value;
+}
+
 void TTFFont::assureCached(uint32 chr) const {
 	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
 		return;
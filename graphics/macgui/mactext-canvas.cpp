@@ -995,6 +995,86 @@ void MacTextCanvas::recalcDims() {
 	_textMaxHeight = y;
 }
 
+static void moveSurfaceRows(ManagedSurface *surface, int fromY, int toY, int height) {
+	if (!surface || height <= 0 || fromY == toY)
+		return;
+
+	height = MIN(height, surface->h - MAX(fromY, toY));
+	if (height <= 0)
+		return;
+
+	memmove(surface->getBasePtr(0, toY), surface->getBasePtr(0, fromY), height * surface->pitch);
+	surface->markAllDirty();
+}
+
+bool MacTextCanvas::relayoutLines(int from, int to) {
+	if (_text.empty())
+		return true;
+
+	from = CLIP<int>(from, 0, _text.size() - 1);
+	to = CLIP<int>(to, from, _text.size() - 1);
+
+	int oldClipWidth = MIN(_maxWidth, _textMaxWidth);
+	int oldHeight = _textMaxHeight;
+	int oldTailY = (to + 1 < (int)_text.size()) ? _text[to + 1].y : oldHeight;
+
+	// Lay out the edited lines. Everything above keeps its position
+	int y = from ? _text[from - 1].y + MAX(getLineHeight(from - 1), _interLinear) : 0;
+
+	for (int i = from; i <= to; i++) {
+		_text[i].y = y;
+		getLineWidth(i, true);
+		y += MAX(getLineHeight(i), _interLinear);
+	}
+
+	// Shift the lines below without measuring them again
+	int shift = y - oldTailY;
+
+	if (shift) {
+		for (uint i = to + 1; i < _text.size(); i++)
+			_text[i].y += shift;
+	}
+
+	_textMaxHeight = oldHeight + shift;
+
+	_textMaxWidth = 0;
+	for (uint i = 0; i < _text.size(); i++)
+		_textMaxWidth = MAX(_textMaxWidth, getLineWidth(i));
+
+	bool hadSurface = _surface != nullptr;
+
+	reallocSurface();
+
+	if (!hadSurface || MIN(_maxWidth, _textMaxWidth) != oldClipWidth)
+		return false;
+
+	int tailHeight = oldHeight - oldTailY;
+	int editedBottom = _text[to].y + MAX(getLineHeight(to), _interLinear);
+
+	moveSurfaceRows(_surface, oldTailY, oldTailY + shift, tailHeight);
+	moveSurfaceRows(_shadowSurface, oldTailY, oldTailY + shift, tailHeight);
+
+	// Clear the edited lines and whatever the text no longer covers
+	Common::Rect dirty(0, _text[from].y, _surface->w, editedBottom);
+	_surface->fillRect(dirty, _tbgcolor);
+	if (_textShadow)
+		_shadowSurface->fillRect(dirty, _tbgcolor);
+
+	if (shift < 0) {
+		Common::Rect vacated(0, _textMaxHeight, _surface->w, MIN<int>(oldHeight, _surface->h));
+		_surface->fillRect(vacated, _tbgcolor);
+		if (_textShadow)
+			_shadowSurface->fillRect(vacated, _tbgcolor);
+	}
+
+	if (_textShadow)
+		render(from, to, _textShadow);
+
+	render(from, to, 0);
+
+	return true;
+}
+
 int MacTextCanvas::getAlignOffset(int row) {
 	int alignOffset = 0;
 	if (_textAlignment == kTextAlignRight)
@@ -1142,7 +1222,7 @@ Common::U32String MacTextCanvas::getTextChunk(int startRow, int startCol, int en
 	return res;
 }
 
-void MacTextCanvas::reshuffleParagraph(int *row, int *col, MacFontRun &defaultFormatting) {
+void MacTextCanvas::reshuffleParagraph(int *row, int *col, MacFontRun &defaultFormatting, int *firstLine, int *lastLine) {
 	_defaultFormatting = defaultFormatting;
 
 	// First, we looking for the paragraph start and end
@@ -1237,6 +1317,11 @@ void MacTextCanvas::reshuffleParagraph(int *row, int *col, MacFontRun &defaultFo
 	// Restore the paragraph marker
 	_text[curLine].paragraphEnd = paragraphEnd;
 
+	if (firstLine)
+		*firstLine = start;
+	if (lastLine)
+		*lastLine = curLine;
+
 	// Find new pos within paragraph after reshuffling
 	*row = start;
 
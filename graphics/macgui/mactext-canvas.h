@@ -129,6 +129,17 @@ public:
 	~MacTextCanvas();
 
 	void recalcDims();
+
+	/**
+	 * Lays out lines [from, to] again after they were edited or rewrapped,
+	 * and updates the surface. Lines above @p from must be untouched, and
+	 * lines below @p to must still have their y from before the edit: they
+	 * keep their cached metrics and their pixels are only moved.
+	 *
+	 * @return false if the rest of the surface has to be rendered again,
+	 *         e.g. because the clipping width changed
+	 */
+	bool relayoutLines(int from, int to);
 	void reallocSurface();
 	void render(int from, int to);
 	void render(int from, int to, int shadow);
@@ -157,9 +168,11 @@ public:
 	/**
 	 * Rewraps paragraph containing given text row.
 	 * When text is modified, we redo whole thing again without touching
-	 * other paragraphs. Also, cursor position is returned in the arguments
+	 * other paragraphs. Also, cursor position is returned in the arguments.
+	 * If requested, the range of the rewrapped lines is returned
+	 * in @p firstLine and @p lastLine
 	 */
-	void reshuffleParagraph(int *row, int *col, MacFontRun &defaultFormatting);
+	void reshuffleParagraph(int *row, int *col, MacFontRun &defaultFormatting, int *firstLine = nullptr, int *lastLine = nullptr);
 	void setMaxWidth(int maxWidth, MacFontRun &defaultFormatting);
 
 	void debugPrint(const char *prefix = nullptr);
@@ -665,7 +665,10 @@ void MacText::setInterLinear(int interLinear) {
 
 void MacText::recalcDims() {
 	_canvas.recalcDims();
+	fitDimsToText();
+}
 
+void MacText::fitDimsToText() {
 	if (!_fixedDims) {
 		int newBottom = _dims.top + _canvas._textMaxHeight + (2 * _border) + _gutter + _shadow;
 		if (newBottom > _dims.bottom) {
@@ -683,6 +686,14 @@ void MacText::recalcDims() {
 	}
 }
 
+void MacText::relayoutLines(int from, int to) {
+	if (!_canvas.relayoutLines(from, to))
+		_fullRefresh = true;
+
+	fitDimsToText();
+	render();
+}
+
 void MacText::setAlignOffset(TextAlign align) {
 	if (_canvas._textAlignment == align)
 		return;
@@ -817,10 +828,10 @@ void MacText::appendText(const Common::U32String &str, const Font *font, uint16
 void MacText::appendText_(const Common::U32String &strWithFont, uint oldLen) {
 	clearChunkInput();
 
-	_canvas.splitString(strWithFont, -1, _defaultFormatting);
-	recalcDims();
+	int from = MIN<int>(oldLen, _canvas._text.size()) - 1;
 
-	_canvas.render(oldLen - 1, _canvas._text.size());
+	_canvas.splitString(strWithFont, -1, _defaultFormatting);
+	relayoutLines(from, _canvas._text.size() - 1);
 
 	_contentIsDirty = true;
 
@@ -844,9 +855,7 @@ void MacText::appendTextDefault(const Common::U32String &str, bool skipAdd) {
 		_str += strWithFont;
 	}
 	_canvas.splitString(strWithFont, -1, _defaultFormatting);
-	recalcDims();
-
-	_canvas.render(oldLen - 1, _canvas._text.size());
+	relayoutLines(oldLen - 1, _canvas._text.size() - 1);
 }
 
 void MacText::appendTextDefault(const Common::String &str, bool skipAdd) {
@@ -1945,13 +1954,11 @@ void MacText::insertChar(byte c, int *row, int *col) {
 	(*col)++;
 
 	if (_canvas.getLineWidth(*row) - oldw + chunkw > _canvas._maxWidth) { // Needs reshuffle
-		_canvas.reshuffleParagraph(row, col, _defaultFormatting);
-		_fullRefresh = true;
-		recalcDims();
-		render();
+		int first, last;
+		_canvas.reshuffleParagraph(row, col, _defaultFormatting, &first, &last);
+		relayoutLines(first, last);
 	} else {
-		recalcDims();
-		_canvas.render(*row, *row);
+		relayoutLines(*row, *row);
 	}
 	for (int i = 0; i < (int)_canvas._text.size(); i++) {
 		D(9, "**insertChar line %d isEnd %d", i, _canvas._text[i].paragraphEnd);
@@ -1985,11 +1992,9 @@ void MacText::deleteSelection() {
 		deletePreviousCharInternal(&row, &col);
 	}
 
-	_canvas.reshuffleParagraph(&row, &col, _defaultFormatting);
-
-	_fullRefresh = true;
-	recalcDims();
-	render();
+	int first, last;
+	_canvas.reshuffleParagraph(&row, &col, _defaultFormatting, &first, &last);
+	relayoutLines(MIN(row, first), last);
 
 	// update cursor position
 	_cursorRow = row;
@@ -2052,11 +2057,9 @@ void MacText::deletePreviousChar(int *row, int *col) {
 	}
 	D(9, "**deleteChar cursor row %d col %d", _cursorRow, _cursorCol);
 
-	_canvas.reshuffleParagraph(row, col, _defaultFormatting);
-
-	_fullRefresh = true;
-	recalcDims();
-	render();
+	int first, last;
+	_canvas.reshuffleParagraph(row, col, _defaultFormatting, &first, &last);
+	relayoutLines(first, last);
 }
 
 void MacText::addNewLine(int *row, int *col) {
@@ -2102,10 +2105,13 @@ void MacText::addNewLine(int *row, int *col) {
 
 	_canvas._text.insert_at(*row + 1, newline);
 
+	int editedRow = *row;
+
 	(*row)++;
 	*col = 0;
 
-	_canvas.reshuffleParagraph(row, col, _defaultFormatting);
+	int first, last;
+	_canvas.reshuffleParagraph(row, col, _defaultFormatting, &first, &last);
 
 	for (int i = 0; i < (int)_canvas._text.size(); i++) {
 		D(9, "** addNewLine line %d", i);
@@ -2115,9 +2121,7 @@ void MacText::addNewLine(int *row, int *col) {
 	}
 	D(9, "** addNewLine cursor row %d col %d", _cursorRow, _cursorCol);
 
-	_fullRefresh = true;
-	recalcDims();
-	render();
+	relayoutLines(MIN(editedRow, first), last);
 }
 
 //////////////////
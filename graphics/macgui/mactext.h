@@ -194,6 +194,13 @@ private:
 	bool isCutAllowed();
 
 	void recalcDims();
+	void fitDimsToText();
+
+	/**
+	 * Lays out and redraws only lines [from, to] after an edit,
+	 * see MacTextCanvas::relayoutLines()
+	 */
+	void relayoutLines(int from, int to);
 
 	void drawSelection(int xoff, int yoff);
 	void updateCursorPos();
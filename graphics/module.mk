@@ -62,6 +62,8 @@ MODULE_OBJS := \
 	transform_tools.o \
 	thumbnail.o \
 	VectorRenderer.o \
+	VectorRendererCache.o \
+	VectorRendererSpan.o \
 	VectorRendererSpec.o \
 	wincursor.o \
 	yuv_to_rgb.o
@@ -146,11 +148,14 @@ endif
 
 ifdef SCUMMVM_NEON
 MODULE_OBJS += \
-	blit/blit-neon.o
+	blit/blit-neon.o \
+	VectorRendererSpan-neon.o
 endif
 ifdef SCUMMVM_SSE2
 MODULE_OBJS += \
-	blit/blit-sse2.o
+	blit/blit-sse2.o \
+	palette-sse2.o \
+	VectorRendererSpan-sse2.o
 endif
 ifdef SCUMMVM_AVX2
 MODULE_OBJS += \
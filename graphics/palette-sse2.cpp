@@ -0,0 +1,179 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/palette.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Graphics {
+
+namespace {
+
+/**
+ * Compute the distances between the color and 8 palette entries, with the
+ * same integer math as Palette::findBestColor(). All channel values are
+ * 16-bit lanes; the distances of entries 0-3 and 4-7 are returned as 32-bit
+ * lanes in lo and hi.
+ */
+template<ColorDistanceMethod method>
+FORCEINLINE void colorDistances(__m128i pr, __m128i pg, __m128i pb, __m128i cr, __m128i cg, __m128i cb, __m128i &lo, __m128i &hi) {
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i dr = _mm_sub_epi16(pr, cr);
+	__m128i dg = _mm_sub_epi16(pg, cg);
+	__m128i db = _mm_sub_epi16(pb, cb);
+
+	// The squares are at most 255 * 255, so they fit in an unsigned 16-bit lane
+	__m128i sr = _mm_mullo_epi16(dr, dr);
+	__m128i sg = _mm_mullo_epi16(dg, dg);
+	__m128i sb = _mm_mullo_epi16(db, db);
+
+	__m128i gLo = _mm_unpacklo_epi16(sg, zero);
+	__m128i gHi = _mm_unpackhi_epi16(sg, zero);
+
+	if (method == kColorDistanceRedmean) {
+		__m128i rmean = _mm_srli_epi16(_mm_add_epi16(pr, cr), 1);
+		__m128i wr = _mm_add_epi16(rmean, _mm_set1_epi16(512));
+		__m128i wb = _mm_sub_epi16(_mm_set1_epi16(767), rmean);
+
+		__m128i prLo16 = _mm_mullo_epi16(wr, sr);
+		__m128i prHi16 = _mm_mulhi_epu16(wr, sr);
+		__m128i pbLo16 = _mm_mullo_epi16(wb, sb);
+		__m128i pbHi16 = _mm_mulhi_epu16(wb, sb);
+
+		__m128i rLo = _mm_srli_epi32(_mm_unpacklo_epi16(prLo16, prHi16), 8);
+		__m128i rHi = _mm_srli_epi32(_mm_unpackhi_epi16(prLo16, prHi16), 8);
+		__m128i bLo = _mm_srli_epi32(_mm_unpacklo_epi16(pbLo16, pbHi16), 8);
+		__m128i bHi = _mm_srli_epi32(_mm_unpackhi_epi16(pbLo16, pbHi16), 8);
+
+		lo = _mm_add_epi32(_mm_add_epi32(rLo, _mm_slli_epi32(gLo, 2)), bLo);
+		hi = _mm_add_epi32(_mm_add_epi32(rHi, _mm_slli_epi32(gHi, 2)), bHi);
+		return;
+	}
+
+	__m128i rLo = _mm_unpacklo_epi16(sr, zero);
+	__m128i rHi = _mm_unpackhi_epi16(sr, zero);
+	__m128i bLo = _mm_unpacklo_epi16(sb, zero);
+	__m128i bHi = _mm_unpackhi_epi16(sb, zero);
+
+	if (method == kColorDistanceNaive) {
+		// 3 * r + 5 * g + 2 * b
+		rLo = _mm_add_epi32(rLo, _mm_slli_epi32(rLo, 1));
+		rHi = _mm_add_epi32(rHi, _mm_slli_epi32(rHi, 1));
+		gLo = _mm_add_epi32(gLo, _mm_slli_epi32(gLo, 2));
+		gHi = _mm_add_epi32(gHi, _mm_slli_epi32(gHi, 2));
+		bLo = _mm_slli_epi32(bLo, 1);
+		bHi = _mm_slli_epi32(bHi, 1);
+	}
+
+	lo = _mm_add_epi32(_mm_add_epi32(rLo, gLo), bLo);
+	hi = _mm_add_epi32(_mm_add_epi32(rHi, gHi), bHi);
+}
+
+FORCEINLINE void keepMinimum(__m128i dist, __m128i index, __m128i &minDist, __m128i &minIndex) {
+	// Only replace on a strictly smaller distance, so that each lane keeps
+	// the lowest index among equal distances, like the scalar search
+	__m128i mask = _mm_cmplt_epi32(dist, minDist);
+	minDist = _mm_or_si128(_mm_and_si128(mask, dist), _mm_andnot_si128(mask, minDist));
+	minIndex = _mm_or_si128(_mm_and_si128(mask, index), _mm_andnot_si128(mask, minIndex));
+}
+
+template<ColorDistanceMethod method>
+byte searchPalette(const byte *paletteR, const byte *paletteG, const byte *paletteB, byte r, byte g, byte b) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i cr = _mm_set1_epi16(r);
+	const __m128i cg = _mm_set1_epi16(g);
+	const __m128i cb = _mm_set1_epi16(b);
+	const __m128i four = _mm_set1_epi32(4);
+	const __m128i eight = _mm_set1_epi32(8);
+
+	__m128i minDist = _mm_set1_epi32(0x7FFFFFFF);
+	__m128i minIndex = zero;
+	__m128i index = _mm_setr_epi32(0, 1, 2, 3);
+
+	for (int i = 0; i < PALETTE_COUNT; i += 8) {
+		__m128i pr = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(paletteR + i)), zero);
+		__m128i pg = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(paletteG + i)), zero);
+		__m128i pb = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(paletteB + i)), zero);
+
+		__m128i distLo, distHi;
+		colorDistances<method>(pr, pg, pb, cr, cg, cb, distLo, distHi);
+
+		keepMinimum(distLo, index, minDist, minIndex);
+		keepMinimum(distHi, _mm_add_epi32(index, four), minDist, minIndex);
+		index = _mm_add_epi32(index, eight);
+	}
+
+	int32 dists[4], indices[4];
+	_mm_storeu_si128((__m128i *)dists, minDist);
+	_mm_storeu_si128((__m128i *)indices, minIndex);
+
+	int best = 0;
+	for (int i = 1; i < 4; i++) {
+		if (dists[i] < dists[best] || (dists[i] == dists[best] && indices[i] < indices[best]))
+			best = i;
+	}
+	return indices[best];
+}
+
+} // End of anonymous namespace
+
+byte PaletteLookup::findBestColorSSE2(const PaletteLookup &lookup, byte r, byte g, byte b, ColorDistanceMethod method) {
+	const byte *paletteR = lookup._paletteR;
+	const byte *paletteG = lookup._paletteG;
+	const byte *paletteB = lookup._paletteB;
+
+	switch (method) {
+	case kColorDistanceEuclidean:
+		return searchPalette<kColorDistanceEuclidean>(paletteR, paletteG, paletteB, r, g, b);
+	case kColorDistanceNaive:
+		return searchPalette<kColorDistanceNaive>(paletteR, paletteG, paletteB, r, g, b);
+	case kColorDistanceRedmean:
+		return searchPalette<kColorDistanceRedmean>(paletteR, paletteG, paletteB, r, g, b);
+	default:
+		return 0;
+	}
+}
+
+} // End of namespace Graphics
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
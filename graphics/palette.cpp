@@ -18,6 +18,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "common/system.h"
 #include "graphics/palette.h"
 
 namespace Graphics {
@@ -188,14 +189,18 @@ void Palette::grab(Palette &p, uint start, uint num) const {
 	memcpy(p._data, _data + 3 * start, 3 * num);
 }
 
-PaletteLookup::PaletteLookup(): _palette(256) {
+PaletteLookup::FindBestColorFunc PaletteLookup::_findBestColorFunc = nullptr;
+
+PaletteLookup::PaletteLookup(): _palette(256), _precision(kPrecisionExact) {
 	_paletteSize = 0;
+	updateChannels();
 }
 
-PaletteLookup::PaletteLookup(const byte *palette, uint len) : _palette(256) {
+PaletteLookup::PaletteLookup(const byte *palette, uint len) : _palette(256), _precision(kPrecisionExact) {
 	_paletteSize = len;
 
 	_palette.set(palette, 0, len);
+	updateChannels();
 }
 
 bool PaletteLookup::setPalette(const byte *palette, uint len)  {
@@ -207,21 +212,72 @@ bool PaletteLookup::setPalette(const byte *palette, uint len)  {
 	_palette.set(palette, 0, len);
 	_colorHash.clear();
 
+	for (int i = 0; i < kMethodCount; i++)
+		_inverseMaps[i].clear();
+	updateChannels();
+
 	return true;
 }
 
+void PaletteLookup::updateChannels() {
+	const byte *data = _palette.data();
+	for (uint i = 0; i < PALETTE_COUNT; i++) {
+		_paletteR[i] = data[i * 3 + 0];
+		_paletteG[i] = data[i * 3 + 1];
+		_paletteB[i] = data[i * 3 + 2];
+	}
+}
+
+byte PaletteLookup::findBestColorGeneric(const PaletteLookup &lookup, byte cr, byte cg, byte cb, ColorDistanceMethod method) {
+	return lookup._palette.findBestColor(cr, cg, cb, method);
+}
+
+byte PaletteLookup::findBestColorExact(byte cr, byte cg, byte cb, ColorDistanceMethod method) const {
+	// If no function has been selected yet, detect and select
+	if (!_findBestColorFunc) {
+		_findBestColorFunc = findBestColorGeneric;
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			_findBestColorFunc = findBestColorSSE2;
+#endif
+	}
+
+	return _findBestColorFunc(*this, cr, cg, cb, method);
+}
+
+const byte *PaletteLookup::getInverseMap(ColorDistanceMethod method) {
+	Common::Array<byte> &map = _inverseMaps[method];
+	if (!map.empty())
+		return map.data();
+
+	// Each cell holds the closest entry to the center of the colors it covers
+	map.resize(32 * 32 * 32);
+	byte *dst = map.data();
+	for (uint r = 0; r < 32; r++) {
+		for (uint g = 0; g < 32; g++) {
+			for (uint b = 0; b < 32; b++)
+				*dst++ = findBestColorExact((r << 3) | 4, (g << 3) | 4, (b << 3) | 4, method);
+		}
+	}
+
+	return map.data();
+}
+
 byte PaletteLookup::findBestColor(byte cr, byte cg, byte cb, ColorDistanceMethod method) {
 	if (_paletteSize == 0) {
 		warning("PaletteLookup::findBestColor(): Palette was not set");
 		return 0;
 	}
 
-	uint32 color = cr << 16 | cg << 8 | cb;
+	if (_precision == kPrecisionFast && (uint)method < kMethodCount)
+		return getInverseMap(method)[((cr & 0xF8) << 7) | ((cg & 0xF8) << 2) | (cb >> 3)];
+
+	uint32 color = method << 24 | cr << 16 | cg << 8 | cb;
 
 	if (_colorHash.contains(color))
 		return _colorHash[color];
 
-	uint bestColor = _palette.findBestColor(cr, cg, cb, method);
+	uint bestColor = findBestColorExact(cr, cg, cb, method);
 	_colorHash[color] = bestColor;
 
 	return bestColor;
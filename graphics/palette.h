@@ -22,9 +22,12 @@
 #ifndef GRAPHICS_PALETTE_H
 #define GRAPHICS_PALETTE_H
 
+#include "common/array.h"
 #include "common/hashmap.h"
 #include "common/types.h"
 
+class PaletteLookupTestSuite;
+
 namespace Graphics {
 
 enum ColorDistanceMethod {
@@ -185,6 +188,18 @@ public:
 
 class PaletteLookup {
 public:
+	/** How closely findBestColor() should match. */
+	enum Precision {
+		/** Always return the closest palette entry. */
+		kPrecisionExact,
+		/**
+		 * Look colors up in a 15-bit inverse color map, built once per
+		 * palette and distance method. Colors which only differ in the
+		 * lower 3 bits of each component map to the same entry.
+		 */
+		kPrecisionFast
+	};
+
 	PaletteLookup();
 	/**
 	 * @brief Construct a new Palette Lookup object
@@ -205,6 +220,12 @@ public:
 	 */
 	bool setPalette(const byte *palette, uint len);
 
+	/**
+	 * @brief Select how closely findBestColor() should match. The default
+	 *        is kPrecisionExact.
+	 */
+	void setPrecision(Precision precision) { _precision = precision; }
+
 	/**
 	 * @brief This method returns closest color from the palette
 	 *        and it uses cache for faster lookups
@@ -228,9 +249,35 @@ public:
 	uint32 *createMap(const byte *srcPalette, uint len, ColorDistanceMethod method = kColorDistanceRedmean);
 
 private:
+	static const int kMethodCount = kColorDistanceRedmean + 1;
+
+	typedef byte (*FindBestColorFunc)(const PaletteLookup &lookup, byte r, byte g, byte b, ColorDistanceMethod method);
+
+	void updateChannels();
+	byte findBestColorExact(byte r, byte g, byte b, ColorDistanceMethod method) const;
+	const byte *getInverseMap(ColorDistanceMethod method);
+
+	static byte findBestColorGeneric(const PaletteLookup &lookup, byte r, byte g, byte b, ColorDistanceMethod method);
+#ifdef SCUMMVM_SSE2
+	static byte findBestColorSSE2(const PaletteLookup &lookup, byte r, byte g, byte b, ColorDistanceMethod method);
+#endif
+
+	/** The search used for exact lookups, selected on first use */
+	static FindBestColorFunc _findBestColorFunc;
+
+	friend class ::PaletteLookupTestSuite;
+
 	Palette _palette;
 	uint _paletteSize;
 	Common::HashMap<int, byte> _colorHash;
+
+	Precision _precision;
+	/** The palette split into separate channels, for the SIMD searches */
+	byte _paletteR[PALETTE_COUNT];
+	byte _paletteG[PALETTE_COUNT];
+	byte _paletteB[PALETTE_COUNT];
+	/** 15-bit inverse color maps, one per distance method */
+	Common::Array<byte> _inverseMaps[kMethodCount];
 };
 
 } //  // end of namespace Graphics
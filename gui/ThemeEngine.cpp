@@ -85,6 +85,9 @@ struct WidgetDrawData {
 
 	DrawLayer _layer;
 
+	/** Whether the steps can be drawn from the DrawStepCache */
+	bool _cacheable;
+
 
 	/**
 	 * Calculates the background threshold offset of a given DrawData item.
@@ -186,7 +189,7 @@ static const DrawDataInfo kDrawDataDefaults[] = {
  * ThemeEngine class
  *********************************************************/
 ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
-	_system(nullptr), _vectorRenderer(nullptr),
+	_system(nullptr), _vectorRenderer(nullptr), _useDrawStepCache(false),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
 	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
 	_cursor(nullptr), _scaleFactor(1.0f) {
@@ -464,6 +467,17 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
 
+	// Leave room for about two screens worth of widgets
+	uint32 cacheSize = 2 * _screen.pitch * _screen.h;
+	if (cacheSize < kMinDrawStepCacheSize)
+		cacheSize = kMinDrawStepCacheSize;
+	_drawStepCache.clear();
+	_drawStepCache.setMaxSize(cacheSize);
+
+	// On overlays with alpha, dialog backgrounds blend with the destination
+	// alpha channel, which the cached rasters cannot reproduce
+	_useDrawStepCache = !_system->hasFeature(OSystem::kFeatureOverlaySupportsAlpha);
+
 	// Since we reinitialized our screen surfaces we know nothing has been
 	// drawn so far. Sometimes we still end up with dirty screen bits in the
 	// list. Clearing it avoids invalid overlay writes when the backend
@@ -749,6 +763,7 @@ bool ThemeEngine::addDrawData(const Common::String &data, bool cached) {
 	_widgets[id] = new WidgetDrawData;
 	_widgets[id]->_layer = kDrawDataDefaults[id].layer;
 	_widgets[id]->_textDataId = kTextDataNone;
+	_widgets[id]->_cacheable = false;
 
 	return true;
 }
@@ -779,6 +794,7 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 			warning("Missing data asset: '%s' in theme '%s", kDrawDataDefaults[i].name, themeId.c_str());
 		} else {
 			_widgets[i]->calcBackgroundOffset();
+			_widgets[i]->_cacheable = Graphics::DrawStepCache::isCacheable(_widgets[i]->_steps);
 		}
 	}
 
@@ -789,6 +805,8 @@ void ThemeEngine::unloadTheme() {
 	if (!_themeOk)
 		return;
 
+	_drawStepCache.clear();
+
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = nullptr;
@@ -928,13 +946,14 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 	Common::Rect area = r;
 	area.clip(_screen.w, _screen.h);
 
-	Common::Rect extendedRect = area;
-	extendedRect.grow(kDirtyRectangleThreshold + drawData->_backgroundOffset);
+	Common::Rect extent = area;
+	extent.grow(kDirtyRectangleThreshold + drawData->_backgroundOffset);
 	if (drawData->_shadowOffset > drawData->_backgroundOffset) {
-		extendedRect.right += drawData->_shadowOffset - drawData->_backgroundOffset;
-		extendedRect.bottom += drawData->_shadowOffset - drawData->_backgroundOffset;
+		extent.right += drawData->_shadowOffset - drawData->_backgroundOffset;
+		extent.bottom += drawData->_shadowOffset - drawData->_backgroundOffset;
 	}
 
+	Common::Rect extendedRect = extent;
 	if (!_clip.isEmpty()) {
 		extendedRect.clip(_clip);
 	}
@@ -948,9 +967,16 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		restoreBackground(extendedRect);
 
 	if (drawData->_layer == _layerToDraw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
-			_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+		// Clipped widgets take different code paths in the renderer, so
+		// only widgets which are fully visible are drawn from the cache
+		bool cached = _useDrawStepCache && drawData->_cacheable && area == r && _clip.contains(extent) &&
+		              _drawStepCache.drawSteps(_vectorRenderer, type, drawData->_steps, area, extent, _clip, dynamic);
+
+		if (!cached) {
+			Common::List<Graphics::DrawStep>::const_iterator step;
+			for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+				_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+			}
 		}
 
 		addDirtyRect(extendedRect);
@@ -34,6 +34,7 @@
 #include "graphics/managed_surface.h"
 #include "graphics/font.h"
 #include "graphics/pixelformat.h"
+#include "graphics/VectorRendererCache.h"
 
 
 #define SCUMMVM_THEME_VERSION_STR "SCUMMVM_STX0.9.20"
@@ -340,6 +341,9 @@ public:
 	/** Constant value to expand dirty rectangles, to make sure they are fully copied */
 	static const int kDirtyRectangleThreshold = 1;
 
+	/** Minimum memory budget of the DrawStep cache, in bytes */
+	static const uint32 kMinDrawStepCacheSize = 4 * 1024 * 1024;
+
 	struct Renderer {
 		const char *name;
 		const char *shortname;
@@ -750,6 +754,10 @@ protected:
 	/** Vector Renderer object, does the actual drawing on screen */
 	Graphics::VectorRenderer *_vectorRenderer;
 
+	/** Rasterized DrawData sets, blitted instead of replaying their steps */
+	Graphics::DrawStepCache _drawStepCache;
+	bool _useDrawStepCache;
+
 	/** XML Parser, does the Theme parsing instead of the default parser */
 	GUI::ThemeParser *_parser;
 
@@ -420,6 +420,8 @@ void Dialog::removeWidget(Widget *del) {
 		_focusedWidget = nullptr;
 	if (del == _dragWidget || del->containsWidget(_dragWidget))
 		_dragWidget = nullptr;
+	if (del == _tickleWidget || del->containsWidget(_tickleWidget))
+		_tickleWidget = nullptr;
 
 	GuiObject::removeWidget(del);
 }
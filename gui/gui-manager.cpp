@@ -19,7 +19,10 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/events.h"
+#include "common/file.h"
+#include "common/fs.h"
 #include "common/translation.h"
 #include "common/zip-set.h"
 #include "gui/EventRecorder.h"
@@ -117,6 +120,33 @@ void GuiManager::initIconsSet() {
 #else
 	_iconsSetChanged = Common::generateZipSet(_iconsSet, "gui-icons.dat", "gui-icons*.dat");
 #endif
+
+	// Identify the packs by name and size. That is enough to notice
+	// a downloaded update without reading the archives.
+	Common::String packs;
+	Common::ArchiveMemberList packFiles;
+
+	if (!ConfMan.getPath("iconspath").empty()) {
+		Common::FSDirectory iconDir(ConfMan.getPath("iconspath"));
+		iconDir.listMatchingMembers(packFiles, "gui-icons*.dat");
+	}
+
+	for (auto &pack : packFiles) {
+		Common::SeekableReadStream *stream = pack->createReadStream();
+		packs += Common::String::format("%s:%d;", pack->getName().c_str(), stream ? (int)stream->size() : 0);
+		delete stream;
+	}
+
+	Common::File defaultPack;
+	if (defaultPack.open("gui-icons.dat"))
+		packs += Common::String::format("gui-icons.dat:%d", (int)defaultPack.size());
+
+	_iconsSetVersion = Common::String::format("%08x", Common::hashit(packs.c_str()));
+}
+
+Common::String GuiManager::getIconsSetVersion() {
+	Common::StackLock lock(_iconsMutex);
+	return _iconsSetVersion;
 }
 
 void GuiManager::computeScaleFactor() {
@@ -111,6 +111,12 @@ public:
 	void lockIconsSet() { _iconsMutex.lock(); }
 	void unlockIconsSet()  { _iconsMutex.unlock(); }
 	Common::SearchSet &getIconsSet() { return _iconsSet; }
+	/**
+	 * Return a string identifying the loaded icon packs. It changes
+	 * whenever a pack is added, removed or replaced, so it can be used
+	 * to key caches of data derived from the icons.
+	 */
+	Common::String getIconsSetVersion();
 
 	int16 getGUIWidth() const { return _baseWidth; }
 	int16 getGUIHeight() const { return _baseHeight; }
@@ -185,6 +191,7 @@ protected:
 
 	Common::Mutex _iconsMutex;
 	Common::SearchSet _iconsSet;
+	Common::String _iconsSetVersion;
 	bool _iconsSetChanged;
 
 	Graphics::MacWindowManager *_wm = nullptr;
@@ -1633,6 +1633,8 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	// The grid picks up thumbnails loaded in the background on tickles
+	setTickleWidget(_grid);
 	// Populate the list
 	updateListing();
 
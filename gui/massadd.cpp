@@ -189,6 +189,10 @@ void MassAddDialog::handleTickle() {
 
 	uint32 t = g_system->getMillis();
 
+	// Detection may store plugin file names in the config. Write them
+	// once per tickle rather than once per plugin.
+	ConfMan.beginFlushBatch();
+
 	// Perform a breadth-first scan of the filesystem.
 	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
 		Common::FSNode dir = _scanStack.pop();
@@ -272,6 +276,7 @@ void MassAddDialog::handleTickle() {
 #endif
 	}
 
+	ConfMan.endFlushBatch();
 
 	// Update the dialog
 	Common::U32String buf;
@@ -20,6 +20,7 @@
  */
 
 #include "common/system.h"
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/language.h"
 #include "common/platform.h"
@@ -47,13 +48,7 @@ void GridItemWidget::setActiveEntry(GridItemInfo &entry) {
 }
 
 void GridItemWidget::updateThumb() {
-	const Graphics::ManagedSurface *gfx = _grid->filenameToSurface(_activeEntry->thumbPath);
-	_thumbGfx.free();
-	if (gfx) {
-		// TODO: Use a reference instead of copying the surface
-		_thumbGfx.copyFrom(*gfx);
-		_thumbAlpha = _thumbGfx.detectAlpha();
-	}
+	_thumbGfx = _grid->filenameToSurface(_activeEntry->thumbPath, _thumbAlpha);
 }
 
 void GridItemWidget::update() {
@@ -109,7 +104,7 @@ void GridItemWidget::drawWidget() {
 										ThemeEngine::kThumbnailBackground);
 
 	// Draw Thumbnail
-	if (_thumbGfx.empty()) {
+	if (!_thumbGfx) {
 		// Draw Title when thumbnail is missing
 		int linesInThumb = MIN(thumbHeight / kLineHeight, (int)titleLines.size());
 		Common::Rect r(_x, _y + (thumbHeight - linesInThumb * kLineHeight) / 2,
@@ -122,7 +117,7 @@ void GridItemWidget::drawWidget() {
 			r.translate(0, kLineHeight);
 		}
 	} else {
-		g_gui.theme()->drawManagedSurface(Common::Point(_x + _grid->_thumbnailMargin, _y + _grid->_thumbnailMargin), _thumbGfx, _thumbAlpha);
+		g_gui.theme()->drawManagedSurface(Common::Point(_x + _grid->_thumbnailMargin, _y + _grid->_thumbnailMargin), *_thumbGfx, _thumbAlpha);
 	}
 
 	Graphics::AlphaType alphaType;
@@ -351,6 +346,23 @@ void GridItemTray::handleMouseMoved(int x, int y, int button) {
 
 #pragma mark -
 
+// Only hold the lock while reading the file, so that several icons can be
+// decoded at the same time
+static Common::SeekableReadStream *readIconsSetFile(const Common::Path &path) {
+	Common::SeekableReadStream *stream = nullptr;
+
+	g_gui.lockIconsSet();
+	if (g_gui.getIconsSet().hasFile(path)) {
+		Common::SeekableReadStream *member = g_gui.getIconsSet().createReadStreamForMember(path);
+		if (member)
+			stream = member->readStream(member->size());
+		delete member;
+	}
+	g_gui.unlockIconsSet();
+
+	return stream;
+}
+
 // Load an image file by String name, provide additional render dimensions for SVG images.
 // TODO: Add BMP support, and add scaling of non-vector images.
 Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int renderWidth = 0, int renderHeight = 0) {
@@ -360,49 +372,209 @@ Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int re
 #ifdef USE_PNG
 		const Graphics::Surface *srcSurface = nullptr;
 		Image::PNGDecoder decoder;
-		g_gui.lockIconsSet();
-		if (g_gui.getIconsSet().hasFile(path)) {
-			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(path);
-			if (!decoder.loadStream(*stream)) {
-				g_gui.unlockIconsSet();
-				warning("Error decoding PNG");
-				return surf;
-			}
+		Common::SeekableReadStream *stream = readIconsSetFile(path);
+		if (!stream) {
+			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+			return surf;
+		}
 
-			srcSurface = decoder.getSurface();
+		if (!decoder.loadStream(*stream)) {
 			delete stream;
-			if (!srcSurface) {
-				warning("Failed to load surface : %s", name.c_str());
-			} else if (srcSurface->format.bytesPerPixel != 1) {
-				surf = new Graphics::ManagedSurface();
-				surf->copyFrom(*srcSurface);
-			}
-		} else {
-			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+			warning("Error decoding PNG");
+			return surf;
+		}
+
+		srcSurface = decoder.getSurface();
+		delete stream;
+		if (!srcSurface) {
+			warning("Failed to load surface : %s", name.c_str());
+		} else if (srcSurface->format.bytesPerPixel != 1) {
+			surf = new Graphics::ManagedSurface();
+			surf->copyFrom(*srcSurface);
 		}
-		g_gui.unlockIconsSet();
 #else
 		error("No PNG support compiled");
 #endif
 	} else if (name.hasSuffix(".svg")) {
-		g_gui.lockIconsSet();
-		if (g_gui.getIconsSet().hasFile(path)) {
-			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(path);
+		Common::SeekableReadStream *stream = readIconsSetFile(path);
+		if (stream) {
 			surf = new Graphics::SVGBitmap(stream, renderWidth, renderHeight);
 			delete stream;
 		} else {
 			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
 		}
-		g_gui.unlockIconsSet();
 	}
 	return surf;
 }
 
 #pragma mark -
 
+enum {
+	kThumbnailCacheVersion = 2
+};
+
+// Pre-scaled thumbnails are stored on disk as a small header followed by
+// the raw pixels, so loading them needs neither PNG decoding nor scaling.
+// The header names the icon packs and size the file was made for, and a
+// file made for others is simply written again.
+static Graphics::ManagedSurface *readCachedThumbnail(const Common::FSNode &node, const Common::String &key, Graphics::AlphaType &alphaType) {
+	if (!node.exists())
+		return nullptr;
+
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream)
+		return nullptr;
+
+	Graphics::ManagedSurface *surf = nullptr;
+
+	if (stream->readUint32BE() == MKTAG('G', 'T', 'H', 'B') && stream->readUint16LE() == kThumbnailCacheVersion &&
+			stream->readString(0, stream->readUint16LE()) == key) {
+		uint16 w = stream->readUint16LE();
+		uint16 h = stream->readUint16LE();
+		byte format[9];
+		stream->read(format, sizeof(format));
+		alphaType = (Graphics::AlphaType)stream->readByte();
+
+		const Graphics::PixelFormat pf(format[0], format[1], format[2], format[3], format[4],
+			format[5], format[6], format[7], format[8]);
+		const int lineSize = w * pf.bytesPerPixel;
+
+		// Drop truncated files and anything we would not have written
+		if ((pf.bytesPerPixel == 2 || pf.bytesPerPixel == 4) &&
+				stream->size() - stream->pos() == (int64)lineSize * h) {
+			surf = new Graphics::ManagedSurface(w, h, pf);
+			for (int y = 0; y < h; y++)
+				stream->read(surf->getBasePtr(0, y), lineSize);
+
+			if (stream->err()) {
+				delete surf;
+				surf = nullptr;
+			}
+		}
+	}
+
+	delete stream;
+	return surf;
+}
+
+static void writeCachedThumbnail(const Common::FSNode &node, const Common::String &key, const Graphics::ManagedSurface &surf, Graphics::AlphaType alphaType) {
+	if (surf.format.bytesPerPixel != 2 && surf.format.bytesPerPixel != 4)
+		return;
+
+	Common::SeekableWriteStream *stream = node.createWriteStream();
+	if (!stream)
+		return;
+
+	const Graphics::PixelFormat &pf = surf.format;
+
+	stream->writeUint32BE(MKTAG('G', 'T', 'H', 'B'));
+	stream->writeUint16LE(kThumbnailCacheVersion);
+	stream->writeUint16LE(key.size());
+	stream->writeString(key);
+	stream->writeUint16LE(surf.w);
+	stream->writeUint16LE(surf.h);
+	stream->writeByte(pf.bytesPerPixel);
+	stream->writeByte(pf.rBits());
+	stream->writeByte(pf.gBits());
+	stream->writeByte(pf.bBits());
+	stream->writeByte(pf.aBits());
+	stream->writeByte(pf.rShift);
+	stream->writeByte(pf.gShift);
+	stream->writeByte(pf.bShift);
+	stream->writeByte(pf.aShift);
+	stream->writeByte(alphaType);
+
+	for (int y = 0; y < surf.h; y++)
+		stream->write(surf.getBasePtr(0, y), surf.w * pf.bytesPerPixel);
+
+	stream->finalize();
+	delete stream;
+}
+
+/**
+ * Loads and scales one thumbnail, possibly on a worker thread. Everything
+ * the task needs is copied in, and results are only picked up by the
+ * GridWidget once the task is done.
+ */
+class GridThumbnailTask : public Common::Task {
+public:
+	GridThumbnailTask(const Common::String &path, const Common::String &fallbackPath, bool fallbackLoaded,
+			int width, int height, const Common::FSNode &cacheDir, const Common::String &cacheKey) :
+		_path(path), _fallbackPath(fallbackPath), _fallbackLoaded(fallbackLoaded), _width(width), _height(height),
+		_alphaType(Graphics::ALPHA_OPAQUE), _usedFallback(false), _cacheDir(cacheDir), _cacheKey(cacheKey), _surface(nullptr) {}
+
+	~GridThumbnailTask() {
+		delete _surface;
+	}
+
+	void run() override {
+		if (load(_path) || _fallbackPath.empty() || _fallbackPath == _path)
+			return;
+
+		// The fallback is shared with other games, so it is not decoded
+		// again when it was already loaded
+		_usedFallback = true;
+		if (!_fallbackLoaded)
+			load(_fallbackPath);
+	}
+
+	/** Take ownership of the loaded surface. */
+	const Graphics::ManagedSurface *releaseSurface() {
+		const Graphics::ManagedSurface *surf = _surface;
+		_surface = nullptr;
+		return surf;
+	}
+
+	const Common::String _path, _fallbackPath;
+	const bool _fallbackLoaded;
+	const int _width, _height;
+
+	Graphics::AlphaType _alphaType;
+	bool _usedFallback;
+
+private:
+	bool load(const Common::String &path) {
+		Common::FSNode cacheFile;
+		if (!_cacheKey.empty()) {
+			Common::String name = path;
+			if (name.contains('/'))
+				name = Common::lastPathComponent(name, '/');
+			cacheFile = _cacheDir.getChild(name + ".thumb");
+
+			_surface = readCachedThumbnail(cacheFile, _cacheKey, _alphaType);
+			if (_surface)
+				return true;
+		}
+
+		Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
+		if (!surf)
+			return false;
+
+		_surface = scaleGfx(surf, _width, _height, true);
+		if (surf != _surface) {
+			surf->free();
+			delete surf;
+		}
+		_alphaType = _surface->detectAlpha();
+
+		if (!_cacheKey.empty())
+			writeCachedThumbnail(cacheFile, _cacheKey, *_surface, _alphaType);
+
+		return true;
+	}
+
+	const Common::FSNode _cacheDir;
+	const Common::String _cacheKey;
+	const Graphics::ManagedSurface *_surface;
+};
+
+#pragma mark -
+
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	: ContainerWidget(boss, name), CommandSender(boss) {
 
+	setFlags(WIDGET_WANT_TICKLE);
+
 	_thumbnailHeight = 0;
 	_thumbnailWidth = 0;
 	_flagIconHeight = 0;
@@ -448,10 +620,12 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 }
 
 GridWidget::~GridWidget() {
+	discardThumbnails();
 	unloadSurfaces(_platformIcons);
 	unloadSurfaces(_languageIcons);
 	unloadSurfaces(_extraIcons);
-	unloadSurfaces(_loadedSurfaces);
+	_loadedSurfaces.clear();
+	_loadedSurfacesAlpha.clear();
 	delete _disabledIconOverlay;
 	_gridItems.clear();
 	_dataEntryList.clear();
@@ -471,9 +645,10 @@ void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurfac
 	surfaces.clear();
 }
 
-const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
-	if (name.empty())
-		return nullptr;
+Common::SharedPtr<const Graphics::ManagedSurface> GridWidget::filenameToSurface(const Common::String &name, Graphics::AlphaType &alphaType) {
+	if (name.empty() || !_loadedSurfaces.contains(name))
+		return Common::SharedPtr<const Graphics::ManagedSurface>();
+	alphaType = _loadedSurfacesAlpha[name];
 	return _loadedSurfaces[name];
 }
 
@@ -700,45 +875,105 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 void GridWidget::reloadThumbnails() {
 	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
 	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+	Common::TaskScheduler *scheduler = g_system->getTaskScheduler();
+
 	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
 		GridItemInfo *entry = *iter;
 		if (entry->thumbPath.empty())
 			continue;
 
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
-			_loadedSurfaces[entry->thumbPath] = nullptr;
-			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
-				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
-					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					// TODO: Use SharedPtr instead of duplicating the surface
-					Graphics::ManagedSurface *thSurf = new Graphics::ManagedSurface();
-					thSurf->copyFrom(*scSurf);
-					_loadedSurfaces[entry->thumbPath] = thSurf;
-				}
-			}
+		if (_loadedSurfaces.contains(entry->thumbPath) || _pendingThumbnails.contains(entry->thumbPath))
+			continue;
 
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+		// Decoding and scaling happens in the task scheduler, so scrolling
+		// does not stall on it. Without worker threads, the task has
+		// already run when submit() returns.
+		Common::String fallbackPath = Common::String::format("icons/%s.png", entry->engineid.c_str());
 
-				if (path != entry->thumbPath) {
-					// TODO: Use SharedPtr instead of duplicating the surface
-					Graphics::ManagedSurface *thSurf = new Graphics::ManagedSurface();
-					thSurf->copyFrom(*scSurf);
-					_loadedSurfaces[path] = thSurf;
-				}
+		PendingThumbnail pending;
+		pending.task = new GridThumbnailTask(entry->thumbPath, fallbackPath, _loadedSurfaces.contains(fallbackPath),
+			thumbnailWidth, thumbnailHeight, _thumbnailCacheDir, _thumbnailCacheKey);
+		pending.future = scheduler->submit(pending.task, DisposeAfterUse::NO);
+		_pendingThumbnails[entry->thumbPath] = pending;
+	}
 
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
+	collectThumbnails();
+}
+
+bool GridWidget::collectThumbnails() {
+	Common::Array<Common::String> done;
+
+	for (Common::HashMap<Common::String, PendingThumbnail>::iterator i = _pendingThumbnails.begin(); i != _pendingThumbnails.end(); ++i) {
+		if (i->_value.future.isDone())
+			done.push_back(i->_key);
+	}
+
+	for (uint i = 0; i < done.size(); i++) {
+		GridThumbnailTask *task = _pendingThumbnails[done[i]].task;
+		_pendingThumbnails.erase(done[i]);
+
+		Common::SharedPtr<const Graphics::ManagedSurface> surf(task->releaseSurface());
+		Graphics::AlphaType alphaType = task->_alphaType;
+
+		if (task->_usedFallback) {
+			if (task->_fallbackLoaded && _loadedSurfaces.contains(task->_fallbackPath)) {
+				surf = _loadedSurfaces[task->_fallbackPath];
+				alphaType = _loadedSurfacesAlpha[task->_fallbackPath];
+			} else if (!_loadedSurfaces.contains(task->_fallbackPath)) {
+				_loadedSurfaces[task->_fallbackPath] = surf;
+				_loadedSurfacesAlpha[task->_fallbackPath] = alphaType;
 			}
 		}
+
+		_loadedSurfaces[task->_path] = surf;
+		_loadedSurfacesAlpha[task->_path] = alphaType;
+
+		delete task;
+	}
+
+	return !done.empty();
+}
+
+void GridWidget::discardThumbnails() {
+	for (Common::HashMap<Common::String, PendingThumbnail>::iterator i = _pendingThumbnails.begin(); i != _pendingThumbnails.end(); ++i) {
+		i->_value.future.wait();
+		delete i->_value.task;
+	}
+	_pendingThumbnails.clear();
+}
+
+void GridWidget::initThumbnailCache() {
+	_thumbnailCacheDir = Common::FSNode();
+	_thumbnailCacheKey.clear();
+
+	Common::Path iconsPath = ConfMan.getPath("iconspath");
+	if (iconsPath.empty())
+		return;
+
+	Common::FSNode dir = Common::FSNode(iconsPath).getChild("thumbnails");
+	if (!dir.exists() && !dir.createDirectory())
+		return;
+
+	if (!dir.isDirectory() || !dir.isWritable())
+		return;
+
+	// There is one file per icon, made for the current icon packs and size.
+	// Updating the packs or resizing the grid never shows stale icons, and
+	// the files are replaced as the icons are shown again.
+	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+
+	_thumbnailCacheDir = dir;
+	_thumbnailCacheKey = Common::String::format("%s-%dx%d", g_gui.getIconsSetVersion().c_str(), thumbnailWidth, thumbnailHeight);
+}
+
+void GridWidget::handleTickle() {
+	if (_pendingThumbnails.empty() || !collectThumbnails())
+		return;
+
+	for (uint k = 0; k < _gridItems.size(); ++k) {
+		if (_gridItems[k]->isVisible())
+			_gridItems[k]->update();
 	}
 }
 
@@ -1072,11 +1307,14 @@ void GridWidget::reflowLayout() {
 		unloadSurfaces(_extraIcons);
 		unloadSurfaces(_platformIcons);
 		unloadSurfaces(_languageIcons);
-		unloadSurfaces(_loadedSurfaces);
+		discardThumbnails();
+		_loadedSurfaces.clear();
+		_loadedSurfacesAlpha.clear();
 		_platformIconsAlpha.clear();
 		_languageIconsAlpha.clear();
 		_extraIconsAlpha.clear();
 		delete _disabledIconOverlay;
+		initThumbnailCache();
 		reloadThumbnails();
 		loadFlagIcons();
 		loadPlatformIcons();
@@ -24,7 +24,10 @@
 
 #include "gui/dialog.h"
 #include "gui/widgets/scrollbar.h"
+#include "common/fs.h"
+#include "common/ptr.h"
 #include "common/str.h"
+#include "common/task-scheduler.h"
 
 #include "image/bmp.h"
 #include "image/png.h"
@@ -35,6 +38,7 @@ namespace GUI {
 class ScrollBarWidget;
 class GridItemWidget;
 class GridWidget;
+class GridThumbnailTask;
 
 enum {
 	kPlayButtonCmd = 'PLAY',
@@ -106,8 +110,21 @@ protected:
 	Common::HashMap<int, Graphics::AlphaType> _languageIconsAlpha;
 	Common::HashMap<int, Graphics::AlphaType> _extraIconsAlpha;
 	Graphics::ManagedSurface *_disabledIconOverlay;
-	// Images are mapped by filename -> surface.
-	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
+	// Images are mapped by filename -> surface. Games without an icon of
+	// their own share the surface of their engine icon.
+	Common::HashMap<Common::String, Common::SharedPtr<const Graphics::ManagedSurface> > _loadedSurfaces;
+	Common::HashMap<Common::String, Graphics::AlphaType> _loadedSurfacesAlpha;
+
+	// Thumbnails being loaded by the task scheduler, mapped by filename
+	struct PendingThumbnail {
+		GridThumbnailTask *task;
+		Common::TaskFuture future;
+	};
+	Common::HashMap<Common::String, PendingThumbnail> _pendingThumbnails;
+
+	// Scaled thumbnails are also kept on disk, for the current icon packs and size
+	Common::FSNode _thumbnailCacheDir;
+	Common::String _thumbnailCacheKey;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
@@ -175,7 +192,7 @@ public:
 	template<typename T>
 	void unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurface *> &surfaces);
 
-	const Graphics::ManagedSurface *filenameToSurface(const Common::String &name);
+	Common::SharedPtr<const Graphics::ManagedSurface> filenameToSurface(const Common::String &name, Graphics::AlphaType &alphaType);
 	const Graphics::ManagedSurface *languageToSurface(Common::Language languageCode, Graphics::AlphaType &alphaType);
 	const Graphics::ManagedSurface *platformToSurface(Common::Platform platformCode, Graphics::AlphaType &alphaType);
 	const Graphics::ManagedSurface *demoToSurface(const Common::String &extraString, Graphics::AlphaType &alphaType);
@@ -198,6 +215,11 @@ public:
 	void saveClosedGroups(const Common::U32String &groupName);
 
 	void reloadThumbnails();
+	/// Install thumbnails that finished loading, returns true if there were any.
+	bool collectThumbnails();
+	/// Wait for all pending thumbnails and drop them.
+	void discardThumbnails();
+	void initThumbnailCache();
 	void loadFlagIcons();
 	void loadPlatformIcons();
 	void loadExtraIcons();
@@ -219,6 +241,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -233,7 +256,7 @@ public:
 /* GridItemWidget */
 class GridItemWidget : public ContainerWidget, public CommandSender {
 protected:
-	Graphics::ManagedSurface _thumbGfx;
+	Common::SharedPtr<const Graphics::ManagedSurface> _thumbGfx;
 	Graphics::AlphaType _thumbAlpha;
 
 	GridItemInfo	*_activeEntry;
@@ -22,19 +22,91 @@
 #include "image/codecs/dither.h"
 
 #include "common/list.h"
+#include "common/singleton.h"
+
+namespace Image {
+
+/**
+ * Cache of the most recently built QuickTime dither tables.
+ *
+ * Many games play lots of short videos dithered to the same palette, so
+ * building the table only once saves noticeable time when opening them.
+ * Like the other singletons, this is only meant to be used from the main
+ * thread.
+ */
+class QuickTimeDitherTableCache : public Common::Singleton<QuickTimeDitherTableCache> {
+public:
+	~QuickTimeDitherTableCache();
+
+	/**
+	 * Return the table for the given palette, or nullptr if it is not
+	 * in the cache.
+	 */
+	const byte *find(const byte *palette, uint colorCount);
+
+	/**
+	 * Add a table to the cache, evicting the least recently used one if
+	 * the cache is full. Returns the cached copy.
+	 */
+	const byte *add(const byte *palette, uint colorCount, const byte *table);
+
+private:
+	/** Maximum number of cached tables; each one takes 64KB. */
+	static const uint kMaxEntries = 4;
+
+	struct Entry {
+		uint32 hash;
+		uint colorCount;
+		byte palette[256 * 3];
+		byte table[0x10000];
+	};
+
+	static uint32 hashPalette(const byte *palette, uint colorCount);
+
+	/** Entries, most recently used first. */
+	Common::List<Entry *> _entries;
+};
+
+} // End of namespace Image
+
+namespace Common {
+DECLARE_SINGLETON(Image::QuickTimeDitherTableCache);
+}
 
 namespace Image {
 
 namespace {
 
+/**
+ * Queue of colors to check when building a QuickTime dither table.
+ *
+ * Every one of the 0x4000 RGB554 colors is queued at most once, and black
+ * and white may additionally be pushed to the front before the search
+ * starts, so a fixed buffer is enough.
+ */
+struct DitherCheckQueue {
+	static const uint kFrontSlots = 2;
+
+	uint16 colors[kFrontSlots + 0x4000];
+	uint head;
+	uint tail;
+
+	DitherCheckQueue() : head(kFrontSlots), tail(kFrontSlots) {}
+
+	bool empty() const { return head == tail; }
+	void pushBack(uint16 color) { assert(tail < ARRAYSIZE(colors)); colors[tail++] = color; }
+	void pushFront(uint16 color) { assert(head > 0); colors[--head] = color; }
+	uint16 popFront() { return colors[head++]; }
+};
+
 /**
  * Add a color to the QuickTime dither table check queue if it hasn't already been found.
  */
-inline void addColorToQueue(uint16 color, uint16 index, byte *checkBuffer, Common::List<uint16> &checkQueue) {
+inline void addColorToQueue(uint16 color, uint16 index, byte *checkBuffer, DitherCheckQueue &checkQueue) {
 	if ((READ_UINT16(checkBuffer + color * 2) & 0xFF) == 0) {
 		// Previously unfound color
 		WRITE_UINT16(checkBuffer + color * 2, index);
-		checkQueue.push_back(color);
+		checkQueue.pushBack(color);
 	}
 }
 
@@ -97,13 +169,25 @@ void ditherQuickTimeFrame(const Graphics::Surface &src, Graphics::Surface &dst,
 	for (int y = 0; y < dst.h; y++) {
 		const PixelInt *srcPtr = (const PixelInt *)src.getBasePtr(0, y);
 		byte *dstPtr = (byte *)dst.getBasePtr(0, y);
-		uint16 colorTableOffset = colorTableOffsets[y & 3];
 
-		for (int x = 0; x < dst.w; x++) {
-			uint16 color = fn(*srcPtr++, src.format, palette);
-			*dstPtr++ = ditherTable[colorTableOffset + color];
-			colorTableOffset += 0x4000;
+		// The sub-table advances by 0x4000 for every pixel, so it repeats
+		// every four pixels. Resolve the four of them once per line.
+		const byte *tables[4];
+		for (int i = 0; i < 4; i++)
+			tables[i] = ditherTable + ((colorTableOffsets[y & 3] + i * 0x4000) & 0xFFFF);
+
+		int x = 0;
+		for (; x + 4 <= dst.w; x += 4) {
+			dstPtr[0] = tables[0][fn(srcPtr[0], src.format, palette)];
+			dstPtr[1] = tables[1][fn(srcPtr[1], src.format, palette)];
+			dstPtr[2] = tables[2][fn(srcPtr[2], src.format, palette)];
+			dstPtr[3] = tables[3][fn(srcPtr[3], src.format, palette)];
+			srcPtr += 4;
+			dstPtr += 4;
 		}
+
+		for (int i = 0; x < dst.w; x++, i++)
+			*dstPtr++ = tables[i][fn(*srcPtr++, src.format, palette)];
 	}
 }
 
@@ -206,10 +290,62 @@ void DitherCodec::setCodecAccuracy(CodecAccuracy accuracy) {
 	return _codec->setCodecAccuracy(accuracy);
 }
 
-byte *DitherCodec::createQuickTimeDitherTable(const byte *palette, uint colorCount) {
-	byte *buf = new byte[0x10000]();
+QuickTimeDitherTableCache::~QuickTimeDitherTableCache() {
+	for (Common::List<Entry *>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+		delete *it;
+}
+
+uint32 QuickTimeDitherTableCache::hashPalette(const byte *palette, uint colorCount) {
+	// FNV-1a
+	uint32 hash = 2166136261u;
+	for (uint i = 0; i < colorCount * 3; i++)
+		hash = (hash ^ palette[i]) * 16777619u;
+	return hash;
+}
+
+const byte *QuickTimeDitherTableCache::find(const byte *palette, uint colorCount) {
+	uint32 hash = hashPalette(palette, colorCount);
 
-	Common::List<uint16> checkQueue;
+	for (Common::List<Entry *>::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		Entry *entry = *it;
+		if (entry->hash != hash || entry->colorCount != colorCount)
+			continue;
+		if (memcmp(entry->palette, palette, colorCount * 3) != 0)
+			continue;
+
+		if (it != _entries.begin()) {
+			_entries.erase(it);
+			_entries.push_front(entry);
+		}
+		return entry->table;
+	}
+
+	return nullptr;
+}
+
+const byte *QuickTimeDitherTableCache::add(const byte *palette, uint colorCount, const byte *table) {
+	Entry *entry;
+	if (_entries.size() >= kMaxEntries) {
+		entry = _entries.back();
+		_entries.pop_back();
+	} else {
+		entry = new Entry();
+	}
+
+	entry->hash = hashPalette(palette, colorCount);
+	entry->colorCount = colorCount;
+	memcpy(entry->palette, palette, colorCount * 3);
+	memcpy(entry->table, table, sizeof(entry->table));
+	_entries.push_front(entry);
+	return entry->table;
+}
+
+namespace {
+
+void generateQuickTimeDitherTable(byte *buf, const byte *palette, uint colorCount) {
+	memset(buf, 0, 0x10000);
+
+	DitherCheckQueue checkQueue;
 
 	bool foundBlack = false;
 	bool foundWhite = false;
@@ -244,17 +380,16 @@ byte *DitherCodec::createQuickTimeDitherTable(const byte *palette, uint colorCou
 
 	// More special handling for white
 	if (foundWhite)
-		checkQueue.push_front(0x3FFF);
+		checkQueue.pushFront(0x3FFF);
 
 	// More special handling for black
 	if (foundBlack)
-		checkQueue.push_front(0);
+		checkQueue.pushFront(0);
 
 	// Go through the list of colors we have and match up similar colors
 	// to fill in the table as best as we can.
 	while (!checkQueue.empty()) {
-		uint16 col = checkQueue.front();
-		checkQueue.pop_front();
+		uint16 col = checkQueue.popFront();
 		uint16 index = READ_UINT16(buf + col * 2);
 
 		uint32 x = col << 4;
@@ -324,9 +459,24 @@ byte *DitherCodec::createQuickTimeDitherTable(const byte *palette, uint colorCou
 			}
 		}
 	}
+}
 
+} // End of anonymous namespace
+
+byte *DitherCodec::createQuickTimeDitherTable(const byte *palette, uint colorCount) {
+	assert(colorCount <= 256);
+
+	byte *buf = new byte[0x10000];
+
+	const byte *cached = QuickTimeDitherTableCache::instance().find(palette, colorCount);
+	if (cached) {
+		memcpy(buf, cached, 0x10000);
+		return buf;
+	}
+
+	generateQuickTimeDitherTable(buf, palette, colorCount);
+	QuickTimeDitherTableCache::instance().add(palette, colorCount, buf);
 	return buf;
 }
 
 } // End of namespace Image
-
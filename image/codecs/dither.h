@@ -52,6 +52,10 @@ public:
 
 	/**
 	 * Create a dither table, as used by QuickTime codecs.
+	 *
+	 * The most recently used tables are cached, so creating the table for
+	 * the same palette again is cheap. The caller owns the returned table
+	 * and must free it with delete[].
 	 */
 	static byte *createQuickTimeDitherTable(const byte *palette, uint colorCount);
 
@@ -0,0 +1,185 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class ConfigManagerTestSuite : public CxxTest::TestSuite {
+	bool load(Common::ConfigManager &conf, const Common::String &text) {
+		Common::MemoryReadStream stream((const byte *)text.c_str(), text.size());
+		return conf.loadFromStream(stream);
+	}
+
+	Common::String write(Common::ConfigManager &conf) {
+		Common::String out;
+		conf.writeConfig(out);
+		return out;
+	}
+
+public:
+	void test_load() {
+		Common::ConfigManager conf;
+
+		TS_ASSERT(load(conf,
+			"\xEF\xBB\xBF[scummvm]\r\n"
+			"  gfx_mode = opengl  \r\n"
+			"\r\n"
+			"# Monkey Island\r"
+			"[monkey]\n"
+			"gameid=monkey\n"
+			"# The path\n"
+			"path=/games/monkey\n"
+			"   \n"
+			"language=en"));
+
+		TS_ASSERT_EQUALS(conf.get("gfx_mode", "scummvm"), "opengl");
+		TS_ASSERT(conf.hasGameDomain("monkey"));
+		TS_ASSERT_EQUALS(conf.get("path", "monkey"), "/games/monkey");
+		TS_ASSERT_EQUALS(conf.get("language", "monkey"), "en");
+
+		const Common::ConfigManager::Domain *domain = conf.getDomain("monkey");
+		TS_ASSERT_EQUALS(domain->getDomainComment(), "# Monkey Island\n");
+		TS_ASSERT_EQUALS(domain->getKVComment("path"), "# The path\n");
+		TS_ASSERT(!domain->hasKVComment("gameid"));
+
+		TS_ASSERT(!load(conf, "[scummvm]\nno delimiter\n"));
+		TS_ASSERT(!load(conf, "key=outside\n"));
+		TS_ASSERT(!load(conf, "[bad name]\n"));
+	}
+
+	void test_write() {
+		Common::ConfigManager conf;
+
+		TS_ASSERT(load(conf,
+			"[scummvm]\n"
+			"versioninfo=2.9.0\n"
+			"\n"
+			"# Monkey Island\n"
+			"[monkey]\n"
+			"gameid=monkey\n"
+			"\n"
+			"[atlantis]\n"
+			"gameid=atlantis\n"
+			"\n"));
+
+		const Common::String expected =
+			"[scummvm]\n"
+			"versioninfo=2.9.0\n"
+			"\n"
+			"# Monkey Island\n"
+			"[monkey]\n"
+			"gameid=monkey\n"
+			"\n"
+			"[atlantis]\n"
+			"gameid=atlantis\n"
+			"\n";
+
+		TS_ASSERT_EQUALS(write(conf), expected);
+		// Writing again reuses the serialized domains
+		TS_ASSERT_EQUALS(write(conf), expected);
+
+		// Changes to a domain must not be hidden by the cache
+		conf.set("gameid", "atlantis-demo", "atlantis");
+		conf.getDomain("scummvm")->erase("versioninfo");
+		TS_ASSERT_EQUALS(write(conf),
+			"# Monkey Island\n"
+			"[monkey]\n"
+			"gameid=monkey\n"
+			"\n"
+			"[atlantis]\n"
+			"gameid=atlantis-demo\n"
+			"\n");
+
+		conf.removeGameDomain("monkey");
+		conf.addGameDomain("zak");
+		conf.set("gameid", "zak", "zak");
+		TS_ASSERT_EQUALS(write(conf),
+			"[atlantis]\n"
+			"gameid=atlantis-demo\n"
+			"\n"
+			"[zak]\n"
+			"gameid=zak\n"
+			"\n");
+	}
+
+	void test_loaded_text() {
+		Common::ConfigManager conf;
+
+		// A file written by ScummVM does not need to be written again
+		// until a setting changes
+		const Common::String text =
+			"[scummvm]\n"
+			"versioninfo=2.9.0\n"
+			"\n"
+			"[monkey]\n"
+			"gameid=monkey\n"
+			"\n";
+		TS_ASSERT(load(conf, text));
+		TS_ASSERT(conf._hasFlushed);
+		TS_ASSERT_EQUALS(conf._lastFlushed, text);
+		TS_ASSERT_EQUALS(write(conf), text);
+
+		TS_ASSERT(!load(conf, "[bad name]\n"));
+		TS_ASSERT(!conf._hasFlushed);
+	}
+
+	void test_large_config_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 20;
+#else
+		const int iters = 1;
+#endif
+		const int domains = 5000;
+
+		Common::String text("[scummvm]\nversioninfo=2.9.0\n\n");
+		for (int i = 0; i < domains; i++) {
+			text += Common::String::format("[game%d]\n", i);
+			text += Common::String::format("description=Game number %d (DOS/English)\n", i);
+			text += "engineid=scumm\n";
+			text += Common::String::format("gameid=game%d\n", i);
+			text += Common::String::format("path=/home/user/games/game%d\n", i);
+			text += "language=en\nplatform=pc\nguioptions=sndNoSpeech gameOption2 lang_English\n\n";
+		}
+
+		Common::ConfigManager conf;
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < iters; i++)
+			TS_ASSERT(load(conf, text));
+		uint32 loadTime = g_system->getMillis() - start;
+		TS_ASSERT_EQUALS((int)conf.getGameDomains().size(), domains);
+
+		start = g_system->getMillis();
+		Common::String out;
+		for (int i = 0; i < iters; i++) {
+			conf._domainCache.clear();
+			out = write(conf);
+		}
+		uint32 fullWriteTime = g_system->getMillis() - start;
+
+		// A typical flush after changing a single setting
+		start = g_system->getMillis();
+		for (int i = 0; i < iters; i++) {
+			conf.set("lastselectedgame", Common::String::format("game%d", i), "scummvm");
+			out = write(conf);
+		}
+		uint32 cachedWriteTime = g_system->getMillis() - start;
+
+		debug("ConfigManager with %d domains: load %u ms, write %u ms, write after one change %u ms (%d iterations)\n",
+			domains, loadTime, fullWriteTime, cachedWriteTime, iters);
+#endif
+	}
+};
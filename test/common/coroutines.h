@@ -0,0 +1,235 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/coroutines.h"
+#include "common/debug.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+
+namespace {
+
+/** Log of the processes run, one letter per run and a '|' per cycle */
+Common::String s_log;
+
+struct SleeperParam {
+	char name;
+	int delay;
+	int runs;
+};
+
+void sleeperProcess(CORO_PARAM, const void *param) {
+	const SleeperParam *p = (const SleeperParam *)param;
+
+	CORO_BEGIN_CONTEXT;
+		int i;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	for (_ctx->i = 0; _ctx->i < p->runs; _ctx->i++) {
+		s_log += p->name;
+		CORO_SLEEP(p->delay);
+	}
+
+	CORO_END_CODE;
+}
+
+void giveWayProcess(CORO_PARAM, const void *param) {
+	const SleeperParam *p = (const SleeperParam *)param;
+
+	CORO_BEGIN_CONTEXT;
+		int i;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	for (_ctx->i = 0; _ctx->i < p->runs; _ctx->i++) {
+		s_log += p->name;
+		CORO_GIVE_WAY;
+	}
+
+	CORO_END_CODE;
+}
+
+void spawnerProcess(CORO_PARAM, const void *param) {
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	s_log += 'S';
+	{
+		SleeperParam child = { 'c', 1, 2 };
+		CoroScheduler.createProcess(sleeperProcess, &child, sizeof(child));
+	}
+	CORO_SLEEP(1);
+	s_log += 'S';
+
+	CORO_END_CODE;
+}
+
+void nestedProcess(CORO_PARAM, const void *param);
+
+void nestedCall(CORO_PARAM, int depth) {
+	CORO_BEGIN_CONTEXT;
+		int values[8];
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	_ctx->values[0] = depth;
+	if (depth > 0)
+		CORO_INVOKE_1(nestedCall, depth - 1);
+	else
+		CORO_SLEEP(1);
+	s_log += (char)('0' + _ctx->values[0]);
+
+	CORO_END_CODE;
+}
+
+void nestedProcess(CORO_PARAM, const void *param) {
+	CORO_BEGIN_CONTEXT;
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	CORO_INVOKE_1(nestedCall, 3);
+
+	CORO_END_CODE;
+}
+
+} // End of anonymous namespace
+
+#endif
+
+class CoroutinesTestSuite : public CxxTest::TestSuite {
+#if NULL_OSYSTEM_IS_AVAILABLE
+	void runCycles(int count) {
+		for (int i = 0; i < count; i++) {
+			CoroScheduler.schedule();
+			s_log += '|';
+		}
+	}
+
+	uint32 createSleeper(char name, int delay, int runs) {
+		SleeperParam p = { name, delay, runs };
+		return CoroScheduler.createProcess(sleeperProcess, &p, sizeof(p));
+	}
+
+public:
+	void setUp() {
+		Common::install_null_g_system();
+		CoroScheduler.reset();
+		s_log.clear();
+	}
+
+	void test_sleep() {
+		// New processes are added to the start of the list
+		createSleeper('a', 1, 4);
+		createSleeper('b', 2, 3);
+		createSleeper('c', 3, 2);
+		runCycles(6);
+		TS_ASSERT_EQUALS(s_log, "cba|a|ba|ca|b||");
+	}
+
+	void test_long_sleep() {
+		// Cross all levels of the timer wheel
+		const int delays[] = { 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 262145, 300000 };
+		for (int i = 0; i < ARRAYSIZE(delays); i++) {
+			createSleeper('x', delays[i], 1);
+
+			CoroScheduler.schedule();
+			TS_ASSERT_EQUALS(CoroScheduler.getSleepTime(CoroScheduler.getNextProcess()), (uint32)delays[i]);
+
+			for (int cycle = 1; cycle < delays[i]; cycle++)
+				CoroScheduler.schedule();
+			TS_ASSERT_EQUALS(CoroScheduler.getSleepTime(CoroScheduler.getNextProcess()), 1U);
+			TS_ASSERT_EQUALS(CoroScheduler.getNextProcess()->runCount, 1U);
+
+			CoroScheduler.schedule();
+			TS_ASSERT(CoroScheduler.getNextProcess() == nullptr);
+		}
+	}
+
+	void test_list_processes() {
+		const uint32 pidA = createSleeper('a', 5, 2);
+		const uint32 pidB = createSleeper('b', 2, 2);
+		runCycles(1);
+
+		// One line per process, in the order they are run
+		const Common::String list = CoroScheduler.listProcesses();
+		TS_ASSERT(list.hasPrefix("  PID      Sleep     Runs  Time (ms)\n"));
+		TS_ASSERT(list.contains(Common::String::format("%5u          2        1  ", pidB)));
+		TS_ASSERT(list.contains(Common::String::format("%5u          5        1  ", pidA)));
+		TS_ASSERT(list.find(Common::String::format("%5u  ", pidB)) < list.find(Common::String::format("%5u  ", pidA)));
+
+		uint lines = 0;
+		for (uint i = 0; i < list.size(); i++)
+			if (list[i] == '\n')
+				lines++;
+		TS_ASSERT_EQUALS(lines, 3U);
+	}
+
+	void test_create_in_cycle() {
+		// Processes created by another process run in the same cycle, right after it
+		createSleeper('a', 1, 3);
+		CoroScheduler.createProcess(spawnerProcess, nullptr, 0);
+		createSleeper('b', 1, 3);
+		runCycles(3);
+		TS_ASSERT_EQUALS(s_log, "bSca|bSca|ba|");
+	}
+
+	void test_give_way() {
+		// A process giving way runs again at the end of the same cycle
+		createSleeper('a', 1, 2);
+		SleeperParam p = { 'g', 1, 2 };
+		CoroScheduler.createProcess(giveWayProcess, &p, sizeof(p));
+		createSleeper('b', 1, 2);
+		runCycles(3);
+		TS_ASSERT_EQUALS(s_log, "bgag|ba||");
+	}
+
+	void test_kill() {
+		createSleeper('a', 1, 5);
+		uint32 pid = createSleeper('b', 5, 5);
+		createSleeper('c', 2, 5);
+		runCycles(2);
+		TS_ASSERT_EQUALS(CoroScheduler.killMatchingProcess(pid), 1);
+		runCycles(2);
+		TS_ASSERT_EQUALS(s_log, "cba|a|ca|a|");
+	}
+
+	void test_nested_contexts() {
+		CoroScheduler.createProcess(nestedProcess, nullptr, 0);
+		CoroScheduler.createProcess(nestedProcess, nullptr, 0);
+		runCycles(3);
+		TS_ASSERT_EQUALS(s_log, "|01230123||");
+	}
+
+	void test_schedule_speed() {
+#ifdef SLOW_TESTS
+		const int cycles = 100000;
+#else
+		const int cycles = 5000;
+#endif
+
+		// Mostly sleeping processes, as in Tinsel scenes
+		for (int i = 0; i < CORO_NUM_PROCESS - 10; i++)
+			createSleeper('s', 50 + i, 1000000);
+		for (int i = 0; i < 10; i++)
+			createSleeper('a', 1, 1000000);
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < cycles; i++) {
+			CoroScheduler.schedule();
+			s_log.clear();
+		}
+		debug("Coroutine scheduler: %d cycles in %u ms\n", cycles, g_system->getMillis() - start);
+
+		CoroScheduler.reset();
+	}
+#endif
+};
@@ -0,0 +1,360 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/pathfinding.h"
+#include "common/rect.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+namespace {
+
+struct TestGrid {
+	int width, height;
+	Common::Array<byte> cells;
+
+	TestGrid(int w, int h, byte fill) : width(w), height(h) {
+		cells.resize(w * h, fill);
+	}
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	bool isWalkable(int x, int y) const { return cells[y * width + x] != 0; }
+	void set(int x, int y, byte value) { cells[y * width + x] = value; }
+};
+
+/** Points joined by straight lines, like the walkbox graphs of point and click games */
+struct TestGraph {
+	struct Edge {
+		uint32 to;
+		float cost;
+	};
+
+	Common::Array<Common::Point> points;
+	Common::Array<Common::Array<Edge> > edges;
+	bool useEstimate;
+
+	uint32 size() const { return points.size(); }
+
+	float estimate(uint32 from, uint32 to) const {
+		return useEstimate ? sqrtf((float)points[from].sqrDist(points[to])) : 0.0f;
+	}
+
+	template<class Visitor>
+	void visitNeighbors(uint32 node, Visitor &visit) const {
+		for (uint i = 0; i < edges[node].size(); i++)
+			visit(edges[node][i].to, edges[node][i].cost);
+	}
+};
+
+} // End of anonymous namespace
+
+class PathfindingTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	/** Simple LCG, RandomSource needs a backend */
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % (max + 1);
+	}
+
+	TestGrid noiseMap(int width, int height, int wallPercent) {
+		TestGrid grid(width, height, 1);
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				if ((int)nextRandom(99) < wallPercent)
+					grid.set(x, y, 0);
+			}
+		}
+		return grid;
+	}
+
+	/** A walkable area mask with furniture-like obstacles, as used for rooms by AGS */
+	TestGrid roomMap(int width, int height, int obstacles) {
+		TestGrid grid(width, height, 1);
+		for (int i = 0; i < obstacles; i++) {
+			const int w = 4 + nextRandom(width / 8);
+			const int h = 2 + nextRandom(height / 8);
+			const int left = nextRandom(width - w);
+			const int top = nextRandom(height - h);
+			const bool ellipse = nextRandom(1);
+			for (int y = 0; y < h; y++) {
+				for (int x = 0; x < w; x++) {
+					const int ex = 2 * x + 1 - w, ey = 2 * y + 1 - h;
+					if (!ellipse || ex * ex * h * h + ey * ey * w * w <= w * w * h * h)
+						grid.set(left + x, top + y, 0);
+				}
+			}
+		}
+		return grid;
+	}
+
+	/** A maze of one cell wide corridors with some loops, like dungeon tile maps */
+	TestGrid mazeMap(int cellsX, int cellsY) {
+		TestGrid grid(cellsX * 2 + 1, cellsY * 2 + 1, 0);
+		Common::Array<Common::Point> stack;
+		grid.set(1, 1, 1);
+		stack.push_back(Common::Point(0, 0));
+
+		while (!stack.empty()) {
+			const Common::Point cell = stack.back();
+			static const int kDirs[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+			int options[4], count = 0;
+			for (int d = 0; d < 4; d++) {
+				const int x = cell.x + kDirs[d][0], y = cell.y + kDirs[d][1];
+				if (x >= 0 && y >= 0 && x < cellsX && y < cellsY && !grid.isWalkable(x * 2 + 1, y * 2 + 1))
+					options[count++] = d;
+			}
+			if (count == 0) {
+				stack.pop_back();
+				continue;
+			}
+
+			const int d = options[nextRandom(count - 1)];
+			const int x = cell.x + kDirs[d][0], y = cell.y + kDirs[d][1];
+			grid.set(cell.x * 2 + 1 + kDirs[d][0], cell.y * 2 + 1 + kDirs[d][1], 1);
+			grid.set(x * 2 + 1, y * 2 + 1, 1);
+			stack.push_back(Common::Point(x, y));
+		}
+
+		// Open some walls, so there is more than one way
+		for (int i = 0; i < cellsX * cellsY / 10; i++) {
+			const int x = 1 + nextRandom(grid.width - 3), y = 1 + nextRandom(grid.height - 3);
+			grid.set(x, y, 1);
+		}
+		return grid;
+	}
+
+	Common::Point randomOpenCell(const TestGrid &grid) {
+		for (;;) {
+			const Common::Point p(nextRandom(grid.width - 1), nextRandom(grid.height - 1));
+			if (grid.isWalkable(p.x, p.y))
+				return p;
+		}
+	}
+
+	/** Dijkstra's with a linear search of the open set, to check the results against */
+	static float referenceCost(const TestGrid &grid, const Common::Point &start, const Common::Point &goal) {
+		const int size = grid.width * grid.height;
+		Common::Array<float> cost;
+		Common::Array<bool> done;
+		cost.resize(size, -1.0f);
+		done.resize(size, false);
+		cost[start.y * grid.width + start.x] = 0.0f;
+
+		for (;;) {
+			int best = -1;
+			for (int i = 0; i < size; i++) {
+				if (!done[i] && cost[i] >= 0.0f && (best < 0 || cost[i] < cost[best]))
+					best = i;
+			}
+			if (best < 0)
+				return -1.0f;
+			if (best == goal.y * grid.width + goal.x)
+				return cost[best];
+			done[best] = true;
+
+			const int x = best % grid.width, y = best / grid.width;
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					const int nx = x + dx, ny = y + dy;
+					if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= grid.width || ny >= grid.height || !grid.isWalkable(nx, ny))
+						continue;
+					if (dx != 0 && dy != 0 && (!grid.isWalkable(nx, y) || !grid.isWalkable(x, ny)))
+						continue;
+					const float c = cost[best] + ((dx != 0 && dy != 0) ? 1.41421356f : 1.0f);
+					const int n = ny * grid.width + nx;
+					if (cost[n] < 0.0f || c < cost[n])
+						cost[n] = c;
+				}
+			}
+		}
+	}
+
+	/** Checks that every step of a path is walkable and returns its cost */
+	static float checkPath(const TestGrid &grid, const Common::Array<Common::Point> &path) {
+		float total = 0.0f;
+		for (uint i = 1; i < path.size(); i++) {
+			const int dx = path[i].x - path[i - 1].x, dy = path[i].y - path[i - 1].y;
+			TS_ASSERT(dx == 0 || dy == 0 || ABS(dx) == ABS(dy));
+			const int stepX = (dx > 0) - (dx < 0), stepY = (dy > 0) - (dy < 0);
+			const int steps = MAX(ABS(dx), ABS(dy));
+			int x = path[i - 1].x, y = path[i - 1].y;
+			for (int s = 0; s < steps; s++) {
+				if (stepX != 0 && stepY != 0) {
+					TS_ASSERT(grid.isWalkable(x + stepX, y));
+					TS_ASSERT(grid.isWalkable(x, y + stepY));
+				}
+				x += stepX;
+				y += stepY;
+				TS_ASSERT(grid.isWalkable(x, y));
+			}
+			total += Common::GridPathFinder::octileDistance(path[i - 1].x, path[i - 1].y, path[i].x, path[i].y);
+		}
+		return total;
+	}
+
+	void checkGrid(Common::GridPathFinder &finder, const TestGrid &grid, int queries) {
+		Common::Array<Common::Point> path;
+		for (int i = 0; i < queries; i++) {
+			const Common::Point start = randomOpenCell(grid);
+			const Common::Point goal = randomOpenCell(grid);
+			const float expected = referenceCost(grid, start, goal);
+
+			for (int method = 0; method < 2; method++) {
+				const bool found = finder.findPath(grid, start, goal, path, (Common::GridPathFinder::Method)method);
+				TS_ASSERT_EQUALS(found, expected >= 0.0f);
+				if (!found) {
+					TS_ASSERT(path.empty());
+					continue;
+				}
+
+				TS_ASSERT_EQUALS(path.front(), start);
+				TS_ASSERT_EQUALS(path.back(), goal);
+				TS_ASSERT_DELTA(finder.getPathCost(), expected, 0.001f);
+				TS_ASSERT_DELTA(checkPath(grid, path), expected, 0.001f);
+			}
+		}
+	}
+
+	TestGraph walkboxGraph(int nodes, int range, bool useEstimate) {
+		TestGraph graph;
+		graph.useEstimate = useEstimate;
+		for (int i = 0; i < nodes; i++)
+			graph.points.push_back(Common::Point(nextRandom(639), nextRandom(479)));
+		graph.edges.resize(nodes);
+		for (int i = 0; i < nodes; i++) {
+			for (int j = 0; j < nodes; j++) {
+				if (i != j && graph.points[i].sqrDist(graph.points[j]) < (uint)(range * range)) {
+					TestGraph::Edge edge = { (uint32)j, sqrtf((float)graph.points[i].sqrDist(graph.points[j])) };
+					graph.edges[i].push_back(edge);
+				}
+			}
+		}
+		return graph;
+	}
+
+public:
+	PathfindingTestSuite() : _seed(1) {}
+
+	void test_grid_small() {
+		Common::GridPathFinder finder;
+		for (int i = 0; i < 20; i++)
+			checkGrid(finder, noiseMap(24 + nextRandom(16), 16 + nextRandom(16), 15 + nextRandom(25)), 10);
+	}
+
+	void test_grid_room_and_maze() {
+		// Reusing the same finder on maps of different sizes
+		Common::GridPathFinder finder;
+		checkGrid(finder, roomMap(64, 40, 12), 20);
+		checkGrid(finder, mazeMap(12, 10), 20);
+		checkGrid(finder, noiseMap(8, 8, 0), 5);
+	}
+
+	void test_grid_edge_cases() {
+		Common::GridPathFinder finder;
+		TestGrid grid(10, 10, 1);
+		for (int y = 0; y < 10; y++)
+			grid.set(5, y, 0);
+
+		Common::Array<Common::Point> path;
+		TS_ASSERT(!finder.findPath(grid, Common::Point(1, 1), Common::Point(8, 8), path));
+		TS_ASSERT(!finder.findPath(grid, Common::Point(1, 1), Common::Point(5, 5), path));
+		TS_ASSERT(!finder.findPath(grid, Common::Point(-1, 1), Common::Point(2, 2), path));
+
+		TS_ASSERT(finder.findPath(grid, Common::Point(2, 3), Common::Point(2, 3), path));
+		TS_ASSERT_EQUALS(path.size(), 1U);
+		TS_ASSERT_EQUALS(finder.getPathCost(), 0.0f);
+
+		// Squeezing between two diagonal walls isn't allowed
+		grid.set(5, 4, 1);
+		grid.set(6, 5, 0);
+		grid.set(4, 3, 0);
+		TS_ASSERT(finder.findPath(grid, Common::Point(4, 4), Common::Point(6, 4), path));
+		TS_ASSERT_DELTA(finder.getPathCost(), 2.0f, 0.001f);
+	}
+
+	void test_graph() {
+		Common::PathFinder<float> finder;
+		Common::Array<uint32> path;
+		for (int i = 0; i < 10; i++) {
+			TestGraph graph = walkboxGraph(60, 120, true);
+			TestGraph dijkstra = graph;
+			dijkstra.useEstimate = false;
+
+			const uint32 start = nextRandom(59), goal = nextRandom(59);
+			const bool found = finder.findPath(dijkstra, start, goal, path);
+			const float expected = finder.getPathCost();
+
+			TS_ASSERT_EQUALS(finder.findPath(graph, start, goal, path), found);
+			if (!found)
+				continue;
+			TS_ASSERT_DELTA(finder.getPathCost(), expected, 0.01f);
+			TS_ASSERT_EQUALS(path.front(), start);
+			TS_ASSERT_EQUALS(path.back(), goal);
+
+			float total = 0.0f;
+			for (uint j = 1; j < path.size(); j++)
+				total += sqrtf((float)graph.points[path[j - 1]].sqrDist(graph.points[path[j]]));
+			TS_ASSERT_DELTA(total, expected, 0.01f);
+		}
+	}
+
+	void test_grid_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int queries = 2000;
+#else
+		const int queries = 50;
+#endif
+
+		const char *const names[] = { "room 640x400", "maze 255x255", "open 1024x1024" };
+		const TestGrid maps[] = { roomMap(640, 400, 60), mazeMap(127, 127), noiseMap(1024, 1024, 10) };
+
+		for (int m = 0; m < ARRAYSIZE(maps); m++) {
+			const TestGrid &grid = maps[m];
+			Common::Array<Common::Point> starts, goals, path;
+			for (int i = 0; i < queries; i++) {
+				starts.push_back(randomOpenCell(grid));
+				goals.push_back(randomOpenCell(grid));
+			}
+
+			// A new finder per query, as the engines do now
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < queries; i++) {
+				Common::GridPathFinder finder;
+				finder.findPath(grid, starts[i], goals[i], path, Common::GridPathFinder::kAStar);
+			}
+			const uint32 freshTime = g_system->getMillis() - start;
+
+			Common::GridPathFinder finder;
+			uint32 expandedAStar = 0, expandedJPS = 0;
+			start = g_system->getMillis();
+			for (int i = 0; i < queries; i++) {
+				finder.findPath(grid, starts[i], goals[i], path, Common::GridPathFinder::kAStar);
+				expandedAStar += finder.getExpanded();
+			}
+			const uint32 aStarTime = g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int i = 0; i < queries; i++) {
+				finder.findPath(grid, starts[i], goals[i], path, Common::GridPathFinder::kJumpPointSearch);
+				expandedJPS += finder.getExpanded();
+			}
+			const uint32 jpsTime = g_system->getMillis() - start;
+
+			debug("Path finding on %s: %d queries, A* new finder %u ms, A* %u ms (%u nodes), JPS %u ms (%u nodes)\n",
+			      names[m], queries, freshTime, aStarTime, expandedAStar, jpsTime, expandedJPS);
+		}
+#endif
+	}
+};
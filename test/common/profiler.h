@@ -0,0 +1,121 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/profiler.h"
+#include "common/str.h"
+
+#include "../null_osystem.h"
+
+class ProfilerTestSuite : public CxxTest::TestSuite {
+#if NULL_OSYSTEM_IS_AVAILABLE
+	static void nested() {
+		PROFILE_ZONE("Outer");
+		{
+			PROFILE_ZONE("Inner");
+			PROFILE_COUNT("Calls", 1);
+		}
+		{
+			PROFILE_ZONE("Inner");
+			PROFILE_COUNT("Calls", 2);
+		}
+	}
+
+	static Common::Profiler &profiler() {
+		return Common::Profiler::instance();
+	}
+
+public:
+	void setUp() {
+		Common::install_null_g_system();
+	}
+
+	void tearDown() {
+		profiler().setEnabled(false);
+	}
+
+	void test_disabled() {
+		profiler().setEnabled(true);
+		profiler().setEnabled(false);
+		nested();
+		profiler().endFrame();
+		TS_ASSERT_EQUALS(profiler().getFrameCount(), 0U);
+	}
+
+	void test_zones() {
+		profiler().setEnabled(true);
+		nested();
+		profiler().endFrame();
+		TS_ASSERT_EQUALS(profiler().getFrameCount(), 1U);
+
+		const Common::Profiler::Frame &frame = profiler().getFrame(0);
+		TS_ASSERT_EQUALS(frame.zones.size(), 3U);
+		// Zones are added when they end, so nested zones come first
+		TS_ASSERT_EQUALS(Common::String(frame.zones[0].name), "Inner");
+		TS_ASSERT_EQUALS(frame.zones[0].depth, 1);
+		TS_ASSERT_EQUALS(Common::String(frame.zones[1].name), "Inner");
+		TS_ASSERT_EQUALS(frame.zones[1].depth, 1);
+		TS_ASSERT_EQUALS(Common::String(frame.zones[2].name), "Outer");
+		TS_ASSERT_EQUALS(frame.zones[2].depth, 0);
+		TS_ASSERT(frame.zones[2].start <= frame.zones[0].start);
+		TS_ASSERT(frame.zones[2].duration >= frame.zones[0].duration + frame.zones[1].duration);
+		TS_ASSERT(frame.start <= frame.zones[2].start);
+
+		TS_ASSERT_EQUALS(frame.counters.size(), 1U);
+		TS_ASSERT_EQUALS(frame.counters[0].value, 3);
+	}
+
+	void test_tracks() {
+		profiler().setEnabled(true);
+		{
+			PROFILE_ZONE("Engine");
+			PROFILE_ZONE_ON("Mixer", Common::Profiler::kTrackAudio);
+		}
+		profiler().endFrame();
+
+		const Common::Profiler::Frame &frame = profiler().getFrame(0);
+		TS_ASSERT_EQUALS(frame.zones.size(), 2U);
+		TS_ASSERT_EQUALS(frame.zones[0].track, Common::Profiler::kTrackAudio);
+		TS_ASSERT_EQUALS(frame.zones[0].depth, 0);
+		TS_ASSERT_EQUALS(frame.zones[1].track, Common::Profiler::kTrackMain);
+		TS_ASSERT_EQUALS(frame.zones[1].depth, 0);
+	}
+
+	void test_ring() {
+		profiler().setEnabled(true);
+		for (int i = 0; i < Common::Profiler::kFrameCount + 10; i++) {
+			PROFILE_COUNT("Frame", i);
+			profiler().endFrame();
+		}
+
+		TS_ASSERT_EQUALS(profiler().getFrameCount(), (uint)Common::Profiler::kFrameCount);
+		TS_ASSERT_EQUALS(profiler().getFrame(0).counters[0].value, Common::Profiler::kFrameCount + 9);
+		TS_ASSERT_EQUALS(profiler().getFrame(Common::Profiler::kFrameCount - 1).counters[0].value, 10);
+		TS_ASSERT_EQUALS(profiler().getFrame(0).number, profiler().getFrame(1).number + 1);
+
+		// Starting again drops the old frames
+		profiler().setEnabled(false);
+		profiler().setEnabled(true);
+		TS_ASSERT_EQUALS(profiler().getFrameCount(), 0U);
+	}
+
+	void test_chrome_trace() {
+		profiler().setEnabled(true);
+		{
+			PROFILE_ZONE("Say \"hi\"");
+			PROFILE_COUNT("Calls", 7);
+		}
+		profiler().endFrame();
+
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		TS_ASSERT(profiler().writeChromeTrace(stream));
+		const Common::String trace((const char *)stream.getData(), stream.size());
+
+		TS_ASSERT(trace.hasPrefix("{\"traceEvents\":["));
+		TS_ASSERT(trace.hasSuffix("\"displayTimeUnit\":\"ms\"}\n"));
+		TS_ASSERT(trace.contains("{\"name\":\"Say \\\"hi\\\"\",\"ph\":\"X\","));
+		TS_ASSERT(trace.contains("\"tid\":1}"));
+		TS_ASSERT(trace.contains("{\"name\":\"Calls\",\"ph\":\"C\",\"ts\":0,\"pid\":1,\"args\":{\"value\":7}}"));
+		TS_ASSERT(trace.contains("\"thread_name\""));
+	}
+#endif
+};
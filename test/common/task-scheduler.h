@@ -0,0 +1,215 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/task-scheduler.h"
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#ifdef HAS_PTHREADS
+#include "backends/tasks/pthread/pthread-task-scheduler.h"
+#endif
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+namespace {
+
+class CountTask : public Common::Task {
+public:
+	CountTask(int *counter, int *destroyed = nullptr) : _counter(counter), _destroyed(destroyed) {}
+	~CountTask() override {
+		if (_destroyed)
+			(*_destroyed)++;
+	}
+
+	void run() override {
+		(*_counter)++;
+	}
+
+private:
+	int *_counter;
+	int *_destroyed;
+};
+
+class SumTask : public Common::Task {
+public:
+	SumTask(const Common::Array<uint> *values, uint first, uint last) : _values(values), _first(first), _last(last), _sum(0) {}
+
+	void run() override {
+		for (uint i = _first; i < _last; i++)
+			_sum += (*_values)[i];
+	}
+
+	uint64 getSum() const { return _sum; }
+
+private:
+	const Common::Array<uint> *_values;
+	uint _first, _last;
+	uint64 _sum;
+};
+
+/** Scramble every value a number of times, to give each index some work. */
+struct HashRange {
+	Common::Array<uint32> *values;
+
+	void operator()(uint first, uint last) const {
+		for (uint i = first; i < last; i++) {
+			uint32 x = (*values)[i];
+			for (int round = 0; round < 64; round++) {
+				x ^= x << 13;
+				x ^= x >> 17;
+				x ^= x << 5;
+			}
+			(*values)[i] = x;
+		}
+	}
+};
+
+struct MarkRange {
+	Common::Array<uint> *marks;
+
+	void operator()(uint first, uint last) const {
+		for (uint i = first; i < last; i++)
+			(*marks)[i]++;
+	}
+};
+
+} // End of anonymous namespace
+
+class TaskSchedulerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_synchronous() {
+		Common::TaskScheduler scheduler;
+		TS_ASSERT_EQUALS(scheduler.getWorkerCount(), 0u);
+
+		int counter = 0, destroyed = 0;
+		Common::TaskFuture future = scheduler.submit(new CountTask(&counter, &destroyed));
+		TS_ASSERT(future.isValid());
+		TS_ASSERT(future.isDone());
+		TS_ASSERT_EQUALS(counter, 1);
+		TS_ASSERT_EQUALS(destroyed, 1);
+
+		CountTask task(&counter, &destroyed);
+		Common::TaskFuture copy = scheduler.submit(&task, DisposeAfterUse::NO);
+		copy.wait();
+		TS_ASSERT_EQUALS(counter, 2);
+		TS_ASSERT_EQUALS(destroyed, 1);
+
+		Common::TaskFuture empty;
+		TS_ASSERT(!empty.isValid());
+		TS_ASSERT(empty.isDone());
+		empty = copy;
+		TS_ASSERT(empty.isValid());
+	}
+
+	void test_parallel_for_synchronous() {
+		Common::TaskScheduler scheduler;
+		checkParallelFor(scheduler);
+	}
+
+#ifdef HAS_PTHREADS
+	void test_threaded() {
+		Common::TaskScheduler *scheduler = createPthreadTaskScheduler(3);
+		TS_ASSERT_EQUALS(scheduler->getWorkerCount(), 3u);
+
+		Common::Array<uint> values;
+		uint64 expected = 0;
+		for (uint i = 0; i < 100000; i++) {
+			values.push_back(i * 7 + 1);
+			expected += i * 7 + 1;
+		}
+
+		Common::Array<SumTask *> tasks;
+		Common::Array<Common::TaskFuture> futures;
+		for (uint i = 0; i < 100; i++) {
+			tasks.push_back(new SumTask(&values, i * 1000, (i + 1) * 1000));
+			futures.push_back(scheduler->submit(tasks.back(), DisposeAfterUse::NO));
+		}
+
+		uint64 sum = 0;
+		for (uint i = 0; i < tasks.size(); i++) {
+			futures[i].wait();
+			TS_ASSERT(futures[i].isDone());
+			sum += tasks[i]->getSum();
+			delete tasks[i];
+		}
+		TS_ASSERT_EQUALS(sum, expected);
+		futures.clear();
+
+		checkParallelFor(*scheduler);
+
+		// Tasks still queued when the scheduler goes away are run by it
+		Common::Array<int> counters;
+		counters.resize(50);
+		for (uint i = 0; i < counters.size(); i++)
+			scheduler->submit(new CountTask(&counters[i]));
+		delete scheduler;
+		for (uint i = 0; i < counters.size(); i++)
+			TS_ASSERT_EQUALS(counters[i], 1);
+	}
+#endif
+
+	void test_parallel_for_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const uint count = 1 << 22;
+#else
+		const uint count = 1 << 18;
+#endif
+
+		Common::Array<uint32> serial, threaded;
+		serial.resize(count);
+		for (uint i = 0; i < count; i++)
+			serial[i] = i + 1;
+		threaded = serial;
+
+		HashRange func;
+
+		Common::TaskScheduler synchronous;
+		func.values = &serial;
+		uint32 start = g_system->getMillis();
+		synchronous.parallelFor(0, count, 1024, func);
+		const uint32 serialTime = g_system->getMillis() - start;
+
+#ifdef HAS_PTHREADS
+		Common::TaskScheduler *scheduler = createPthreadTaskScheduler();
+#else
+		Common::TaskScheduler *scheduler = new Common::TaskScheduler();
+#endif
+		func.values = &threaded;
+		start = g_system->getMillis();
+		scheduler->parallelFor(0, count, 1024, func);
+		const uint32 threadedTime = g_system->getMillis() - start;
+		const uint workers = scheduler->getWorkerCount();
+		delete scheduler;
+
+		TS_ASSERT(serial == threaded);
+
+		debug("parallelFor over %u indices: %u ms synchronously, %u ms with %u workers\n",
+			count, serialTime, threadedTime, workers);
+#endif
+	}
+
+private:
+	void checkParallelFor(Common::TaskScheduler &scheduler) {
+		Common::Array<uint> marks;
+		marks.resize(1003);
+
+		MarkRange func;
+		func.marks = &marks;
+
+		scheduler.parallelFor(0, 1003, 10, func);
+		scheduler.parallelFor(500, 1003, 1, func);
+		scheduler.parallelFor(7, 7, 1, func);
+
+		for (uint i = 0; i < marks.size(); i++)
+			TS_ASSERT_EQUALS(marks[i], i < 500 ? 1u : 2u);
+	}
+};
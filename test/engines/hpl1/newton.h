@@ -0,0 +1,150 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/task-scheduler.h"
+
+#include "engines/hpl1/engine/libraries/newton/Newton.h"
+
+#include "../../null_osystem.h"
+
+#ifdef HAS_PTHREADS
+#include "backends/tasks/pthread/pthread-task-scheduler.h"
+#endif
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class NewtonTestSuite : public CxxTest::TestSuite {
+	static const int kPiles = 16;
+	static const int kPileHeight = 12;
+
+	static void applyGravity(NewtonBody *const body, float, int32) {
+		float mass, ixx, iyy, izz;
+		NewtonBodyGetMassMatrix(body, &mass, &ixx, &iyy, &izz);
+		const float force[3] = { 0.0f, -9.81f * mass, 0.0f };
+		NewtonBodyAddForce(body, force);
+	}
+
+	static void setPosition(float *matrix, float x, float y, float z) {
+		for (int i = 0; i < 16; i++)
+			matrix[i] = (i % 5) ? 0.0f : 1.0f;
+		matrix[12] = x;
+		matrix[13] = y;
+		matrix[14] = z;
+	}
+
+	/**
+	 * A floor with piles of boxes far enough apart to end up in separate
+	 * islands, so both the broadphase and the solver have work to spread.
+	 */
+	static NewtonWorld *createScene() {
+		NewtonWorld *world = NewtonCreate();
+		const float minPoint[3] = { -100.0f, -10.0f, -100.0f };
+		const float maxPoint[3] = { 100.0f, 100.0f, 100.0f };
+		NewtonSetWorldSize(world, minPoint, maxPoint);
+
+		float matrix[16];
+		NewtonCollision *floor = NewtonCreateBox(world, 200.0f, 1.0f, 200.0f, 0, nullptr);
+		setPosition(matrix, 0.0f, -0.5f, 0.0f);
+		NewtonCreateBody(world, floor, matrix);
+		NewtonReleaseCollision(world, floor);
+
+		NewtonCollision *box = NewtonCreateBox(world, 1.0f, 1.0f, 1.0f, 0, nullptr);
+		for (int pile = 0; pile < kPiles; pile++) {
+			for (int i = 0; i < kPileHeight; i++) {
+				setPosition(matrix, (pile % 4) * 10.0f - 15.0f, 0.5f + i * 1.01f, (pile / 4) * 10.0f - 15.0f);
+				NewtonBody *body = NewtonCreateBody(world, box, matrix);
+				NewtonBodySetMassMatrix(body, 1.0f, 1.0f / 6, 1.0f / 6, 1.0f / 6);
+				NewtonBodySetForceAndTorqueCallback(body, applyGravity);
+				NewtonBodySetAutoSleep(body, 0);
+			}
+		}
+		NewtonReleaseCollision(world, box);
+
+		return world;
+	}
+
+	/** Step the scene and return the time taken in milliseconds. */
+	static uint32 simulate(NewtonWorld *world, int steps) {
+		const uint32 start = g_system->getMillis();
+		for (int i = 0; i < steps; i++)
+			NewtonUpdate(world, 1.0f / 60.0f);
+		return g_system->getMillis() - start;
+	}
+
+public:
+	void setUp() {
+		NewtonInitGlobals();
+	}
+
+	void tearDown() {
+		NewtonDestroyGlobals();
+	}
+
+	void test_thread_count() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system(new Common::TaskScheduler());
+
+		NewtonWorld *world = NewtonCreate();
+		NewtonSetThreadsCount(world, 4);
+		TS_ASSERT_EQUALS(NewtonGetThreadsCount(world), 1);
+		NewtonDestroy(world);
+
+#ifdef HAS_PTHREADS
+		Common::install_null_g_system(createPthreadTaskScheduler(2));
+
+		world = NewtonCreate();
+		NewtonSetThreadsCount(world, 8);
+		TS_ASSERT_EQUALS(NewtonGetThreadsCount(world), 3);
+		NewtonSetThreadsCount(world, 2);
+		TS_ASSERT_EQUALS(NewtonGetThreadsCount(world), 2);
+		NewtonDestroy(world);
+#endif
+#endif
+	}
+
+	void test_piles_speed() {
+#if BENCHMARK_TIME
+#ifdef HAS_PTHREADS
+		Common::install_null_g_system(createPthreadTaskScheduler());
+#else
+		Common::install_null_g_system();
+#endif
+
+#ifdef SLOW_TESTS
+		const int steps = 600;
+#else
+		const int steps = 60;
+#endif
+		const int workers = g_system->getTaskScheduler()->getWorkerCount();
+
+		NewtonWorld *world = createScene();
+		NewtonSetThreadsCount(world, 1);
+		const uint32 serialTime = simulate(world, steps);
+		NewtonDestroy(world);
+
+		world = createScene();
+		NewtonSetThreadsCount(world, workers + 1);
+		const int threads = NewtonGetThreadsCount(world);
+		const uint32 threadedTime = simulate(world, steps);
+
+		// No box may have fallen through the floor, whichever thread solved it
+		float matrix[16];
+		int resting = 0;
+		for (NewtonBody *body = NewtonWorldGetFirstBody(world); body; body = NewtonWorldGetNextBody(world, body)) {
+			NewtonBodyGetMatrix(body, matrix);
+			if (matrix[13] > -1.0f)
+				resting++;
+		}
+		TS_ASSERT_EQUALS(resting, kPiles * kPileHeight + 1);
+		NewtonDestroy(world);
+
+		debug("Newton with %d boxes: %u ms on 1 thread, %u ms on %d threads (%d steps)\n",
+			kPiles * kPileHeight, serialTime, threadedTime, threads, steps);
+#endif
+	}
+};
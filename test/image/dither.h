@@ -0,0 +1,37 @@
+#include <cxxtest/TestSuite.h>
+
+#include "image/codecs/dither.h"
+
+class DitherTestSuite : public CxxTest::TestSuite {
+public:
+	void test_quicktime_dither_table_cache() {
+		// More palettes than the cache holds, so the first ones get evicted
+		const int numPalettes = 6;
+		byte palettes[numPalettes][256 * 3];
+		byte *tables[numPalettes];
+
+		uint32 seed = 1;
+		for (int i = 0; i < numPalettes; i++) {
+			for (int j = 0; j < 256 * 3; j++) {
+				seed = seed * 1103515245 + 12345;
+				palettes[i][j] = seed >> 16;
+			}
+			tables[i] = Image::DitherCodec::createQuickTimeDitherTable(palettes[i], 256);
+		}
+
+		for (int i = 0; i < numPalettes; i++) {
+			byte *table = Image::DitherCodec::createQuickTimeDitherTable(palettes[i], 256);
+			TS_ASSERT_SAME_DATA(table, tables[i], 0x10000);
+			delete[] table;
+		}
+
+		// A palette differing in a single entry must not hit the cache
+		palettes[0][255 * 3] ^= 0xF8;
+		byte *table = Image::DitherCodec::createQuickTimeDitherTable(palettes[0], 256);
+		TS_ASSERT_DIFFERS(memcmp(table, tables[0], 0x10000), 0);
+		delete[] table;
+
+		for (int i = 0; i < numPalettes; i++)
+			delete[] tables[i];
+	}
+};
@@ -0,0 +1,79 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "graphics/palette.h"
+
+class PaletteLookupTestSuite : public CxxTest::TestSuite {
+public:
+	void test_exact_lookup() {
+		selectSearch();
+
+		static const Graphics::ColorDistanceMethod methods[] = {
+			Graphics::kColorDistanceEuclidean,
+			Graphics::kColorDistanceNaive,
+			Graphics::kColorDistanceRedmean
+		};
+
+		byte palette[256 * 3];
+		uint32 seed = 1;
+		for (int i = 0; i < 256 * 3; i++)
+			palette[i] = nextRandom(seed);
+		// Duplicate entries, to check that ties resolve to the lowest index
+		memcpy(palette + 200 * 3, palette + 10 * 3, 3);
+
+		Graphics::Palette reference(palette, 256);
+		Graphics::PaletteLookup lookup(palette, 256);
+
+		for (int n = 0; n < 2000; n++) {
+			byte r = nextRandom(seed), g = nextRandom(seed), b = nextRandom(seed);
+			if (n % 100 == 0) {
+				r = palette[10 * 3 + 0];
+				g = palette[10 * 3 + 1];
+				b = palette[10 * 3 + 2];
+			}
+
+			for (int m = 0; m < ARRAYSIZE(methods); m++)
+				TS_ASSERT_EQUALS(lookup.findBestColor(r, g, b, methods[m]), reference.findBestColor(r, g, b, methods[m]));
+		}
+	}
+
+	void test_fast_lookup() {
+		selectSearch();
+
+		byte palette[256 * 3];
+		uint32 seed = 2;
+		for (int i = 0; i < 256 * 3; i++)
+			palette[i] = nextRandom(seed);
+
+		Graphics::Palette reference(palette, 256);
+		Graphics::PaletteLookup lookup(palette, 256);
+		lookup.setPrecision(Graphics::PaletteLookup::kPrecisionFast);
+
+		for (int n = 0; n < 2000; n++) {
+			byte r = nextRandom(seed), g = nextRandom(seed), b = nextRandom(seed);
+
+			// Colors in the same cell share the answer for the cell center
+			byte expected = reference.findBestColor((r & 0xF8) | 4, (g & 0xF8) | 4, (b & 0xF8) | 4, Graphics::kColorDistanceEuclidean);
+			TS_ASSERT_EQUALS(lookup.findBestColor(r, g, b, Graphics::kColorDistanceEuclidean), expected);
+		}
+	}
+
+private:
+	static void selectSearch() {
+		Graphics::PaletteLookup::_findBestColorFunc = Graphics::PaletteLookup::findBestColorGeneric;
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			Graphics::PaletteLookup::_findBestColorFunc = Graphics::PaletteLookup::findBestColorSSE2;
+#endif
+	}
+
+	static byte nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 16;
+	}
+};
@@ -0,0 +1,290 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/list.h"
+#include "common/random.h"
+#include "common/rect.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "graphics/managed_surface.h"
+#include "graphics/VectorRenderer.h"
+#include "graphics/VectorRendererCache.h"
+#include "graphics/VectorRendererSpan.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class VectorRendererCacheTestSuite : public CxxTest::TestSuite {
+	Graphics::PixelFormat _format;
+
+	static Graphics::DrawStep makeStep(Graphics::DrawingFunctionCallback call, int fillMode) {
+		Graphics::DrawStep step;
+		step.drawingCall = call;
+		step.autoWidth = step.autoHeight = true;
+		step.factor = 1;
+		step.scale = 1 << 16;
+		step.stroke = 1;
+		step.fillMode = fillMode;
+		return step;
+	}
+
+	/** A gradient button with an inner frame and an underline */
+	static Common::List<Graphics::DrawStep> buttonSteps() {
+		Common::List<Graphics::DrawStep> steps;
+
+		Graphics::DrawStep step = makeStep(&Graphics::VectorRenderer::drawCallback_ROUNDSQ, Graphics::VectorRenderer::kFillGradient);
+		step.radius = 6;
+		step.fgColor.r = 20; step.fgColor.g = 30; step.fgColor.b = 40; step.fgColor.set = true;
+		step.gradColor1.r = 250; step.gradColor1.g = 200; step.gradColor1.b = 120; step.gradColor1.set = true;
+		step.gradColor2.r = 180; step.gradColor2.g = 90; step.gradColor2.b = 10; step.gradColor2.set = true;
+		steps.push_back(step);
+
+		step = makeStep(&Graphics::VectorRenderer::drawCallback_SQUARE, Graphics::VectorRenderer::kFillDisabled);
+		step.padding = Common::Rect(6, 6, 6, 6);
+		step.fgColor.r = 255; step.fgColor.g = 255; step.fgColor.b = 255; step.fgColor.set = true;
+		steps.push_back(step);
+
+		step = makeStep(&Graphics::VectorRenderer::drawCallback_LINE, Graphics::VectorRenderer::kFillForeground);
+		step.autoHeight = false;
+		step.yAlign = Graphics::DrawStep::kVectorAlignBottom;
+		step.h = 0;
+		step.padding = Common::Rect(8, 0, 8, 10);
+		step.fgColor.r = 90; step.fgColor.g = 60; step.fgColor.b = 30; step.fgColor.set = true;
+		steps.push_back(step);
+
+		return steps;
+	}
+
+	/** A tall rounded panel with a gradient slow enough to be dithered */
+	static Common::List<Graphics::DrawStep> panelSteps() {
+		Common::List<Graphics::DrawStep> steps;
+
+		Graphics::DrawStep step = makeStep(&Graphics::VectorRenderer::drawCallback_ROUNDSQ, Graphics::VectorRenderer::kFillGradient);
+		step.radius = 8;
+		step.fgColor.r = 20; step.fgColor.g = 30; step.fgColor.b = 40; step.fgColor.set = true;
+		step.gradColor1.r = 100; step.gradColor1.g = 100; step.gradColor1.b = 100; step.gradColor1.set = true;
+		step.gradColor2.r = 110; step.gradColor2.g = 106; step.gradColor2.b = 100; step.gradColor2.set = true;
+		steps.push_back(step);
+
+		return steps;
+	}
+
+	/** An anti-aliased rounded frame, which leaves blended pixels at the corners */
+	static Common::List<Graphics::DrawStep> frameSteps() {
+		Common::List<Graphics::DrawStep> steps;
+
+		Graphics::DrawStep step = makeStep(&Graphics::VectorRenderer::drawCallback_ROUNDSQ, Graphics::VectorRenderer::kFillForeground);
+		step.radius = 12;
+		step.stroke = 2;
+		step.fgColor.r = 200; step.fgColor.g = 220; step.fgColor.b = 240; step.fgColor.set = true;
+		steps.push_back(step);
+
+		return steps;
+	}
+
+	void fillNoise(Graphics::ManagedSurface &surface, uint32 seed) {
+		Common::RandomSource rnd("vector_renderer_cache");
+		rnd.setSeed(seed);
+		for (int y = 0; y < surface.h; y++) {
+			uint32 *row = (uint32 *)surface.getBasePtr(0, y);
+			for (int x = 0; x < surface.w; x++)
+				row[x] = _format.RGBToColor(rnd.getRandomNumber(255), rnd.getRandomNumber(255), rnd.getRandomNumber(255));
+		}
+	}
+
+	/** Return the largest difference of a single channel between the surfaces */
+	int maxDifference(const Graphics::ManagedSurface &a, const Graphics::ManagedSurface &b) {
+		int result = 0;
+		for (int y = 0; y < a.h; y++) {
+			const uint32 *rowA = (const uint32 *)a.getBasePtr(0, y);
+			const uint32 *rowB = (const uint32 *)b.getBasePtr(0, y);
+			for (int x = 0; x < a.w; x++) {
+				for (int shift = 0; shift < 32; shift += 8) {
+					int diff = ABS((int)((rowA[x] >> shift) & 0xFF) - (int)((rowB[x] >> shift) & 0xFF));
+					result = MAX(result, diff);
+				}
+			}
+		}
+		return result;
+	}
+
+	void drawDirect(Graphics::VectorRenderer *renderer, Graphics::ManagedSurface &surface,
+	                const Common::List<Graphics::DrawStep> &steps, const Common::Rect &area, const Common::Rect &clip) {
+		renderer->setSurface(&surface);
+		for (Common::List<Graphics::DrawStep>::const_iterator step = steps.begin(); step != steps.end(); ++step)
+			renderer->drawStep(area, clip, *step);
+	}
+
+	bool drawCached(Graphics::DrawStepCache &cache, uint32 id, Graphics::VectorRenderer *renderer, Graphics::ManagedSurface &surface,
+	                const Common::List<Graphics::DrawStep> &steps, const Common::Rect &area, const Common::Rect &clip) {
+		Common::Rect extent = area;
+		extent.grow(3);
+		renderer->setSurface(&surface);
+		return cache.drawSteps(renderer, id, steps, area, extent, clip, 0);
+	}
+
+	void checkSteps(int mode, const Common::List<Graphics::DrawStep> &steps, const Common::Rect &clip, int tolerance) {
+		Graphics::VectorRenderer *renderer = Graphics::createRenderer(mode, _format);
+		Graphics::DrawStepCache cache;
+
+		Graphics::ManagedSurface direct(200, 100, _format);
+		Graphics::ManagedSurface cached(200, 100, _format);
+
+		// The first draw fills the cache, the others blit from it, onto
+		// different backgrounds and at different positions
+		for (int i = 0; i < 3; i++) {
+			const Common::Rect area(10 + i * 20, 10 + i * 5, 10 + i * 20 + 120, 10 + i * 5 + 40);
+
+			fillNoise(direct, i);
+			fillNoise(cached, i);
+
+			drawDirect(renderer, direct, steps, area, clip);
+			TS_ASSERT(drawCached(cache, 1, renderer, cached, steps, area, clip));
+			TS_ASSERT_LESS_THAN_EQUALS(maxDifference(direct, cached), tolerance);
+		}
+		TS_ASSERT_EQUALS(cache.getSize() > 0, true);
+
+		delete renderer;
+	}
+
+public:
+	VectorRendererCacheTestSuite() : _format(4, 8, 8, 8, 8, 24, 16, 8, 0) {
+		// Selecting the span fillers would query the backend
+		Graphics::VectorRendererSpan::_blendFillFunc = Graphics::VectorRendererSpan::blendFillGeneric;
+		Graphics::VectorRendererSpan::_darkenFillFunc = Graphics::VectorRendererSpan::darkenFillGeneric;
+		Graphics::VectorRendererSpan::_patternFillFunc = Graphics::VectorRendererSpan::patternFillGeneric;
+	}
+
+	void test_opaque_steps() {
+		// The last button is partially clipped
+		checkSteps(GUI::ThemeEngine::kGfxStandard, buttonSteps(), Common::Rect(0, 0, 160, 100), 0);
+	}
+
+	void test_blended_steps() {
+		// Blended pixels are reconstructed from the coverage, which may be
+		// off by the rounding of the renderer
+		checkSteps(GUI::ThemeEngine::kGfxAntialias, frameSteps(), Common::Rect(0, 0, 200, 100), 2);
+	}
+
+	void test_dither_phase() {
+		Graphics::VectorRenderer *renderer = Graphics::createRenderer(GUI::ThemeEngine::kGfxStandard, _format);
+		Graphics::DrawStepCache cache;
+		const Common::List<Graphics::DrawStep> steps = panelSteps();
+		const Common::Rect clip(200, 100);
+
+		Graphics::ManagedSurface direct(200, 100, _format);
+		Graphics::ManagedSurface cached(200, 100, _format);
+
+		// Odd and even positions need different rasters, and both have to
+		// be found again when drawing at another position of the same parity
+		const int lefts[] = { 11, 12, 33, 34 };
+		for (int i = 0; i < ARRAYSIZE(lefts); i++) {
+			const Common::Rect area(lefts[i], 5, lefts[i] + 120, 95);
+
+			fillNoise(direct, i);
+			fillNoise(cached, i);
+
+			drawDirect(renderer, direct, steps, area, clip);
+			TS_ASSERT(drawCached(cache, 1, renderer, cached, steps, area, clip));
+			TS_ASSERT_EQUALS(maxDifference(direct, cached), 0);
+		}
+
+		delete renderer;
+	}
+
+	void test_uncacheable() {
+		Common::List<Graphics::DrawStep> steps = buttonSteps();
+		TS_ASSERT(Graphics::DrawStepCache::isCacheable(steps));
+
+		steps.back().clip = Common::Rect(0, 0, 10, 10);
+		TS_ASSERT(!Graphics::DrawStepCache::isCacheable(steps));
+
+		steps = buttonSteps();
+		steps.push_back(makeStep(&Graphics::VectorRenderer::drawCallback_FILLSURFACE, Graphics::VectorRenderer::kFillForeground));
+		TS_ASSERT(!Graphics::DrawStepCache::isCacheable(steps));
+
+		TS_ASSERT(!Graphics::DrawStepCache::isCacheable(Common::List<Graphics::DrawStep>()));
+
+		Graphics::VectorRenderer *renderer = Graphics::createRenderer(GUI::ThemeEngine::kGfxStandard, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		Graphics::ManagedSurface surface(64, 64, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		Graphics::DrawStepCache cache;
+		TS_ASSERT(!drawCached(cache, 1, renderer, surface, buttonSteps(), Common::Rect(4, 4, 60, 60), Common::Rect(64, 64)));
+		delete renderer;
+	}
+
+	void test_size_limit() {
+		Graphics::VectorRenderer *renderer = Graphics::createRenderer(GUI::ThemeEngine::kGfxStandard, _format);
+		Graphics::ManagedSurface surface(400, 300, _format);
+		const Common::Rect clip(400, 300);
+		const Common::List<Graphics::DrawStep> steps = buttonSteps();
+
+		Graphics::DrawStepCache cache;
+		cache.setMaxSize(64 * 1024);
+
+		// Too large to be cached
+		TS_ASSERT(!drawCached(cache, 1, renderer, surface, steps, Common::Rect(0, 0, 300, 200), clip));
+		TS_ASSERT_EQUALS(cache.getSize(), 0U);
+
+		for (int i = 0; i < 50; i++) {
+			TS_ASSERT(drawCached(cache, 1, renderer, surface, steps, Common::Rect(10, 10, 60 + i, 40), clip));
+			TS_ASSERT_LESS_THAN_EQUALS(cache.getSize(), cache.getMaxSize());
+		}
+
+		cache.setMaxSize(16 * 1024);
+		TS_ASSERT_LESS_THAN_EQUALS(cache.getSize(), 16U * 1024);
+
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.getSize(), 0U);
+
+		delete renderer;
+	}
+
+	void test_redraw_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int frames = 100;
+#else
+		const int frames = 5;
+#endif
+
+		// A 4K dialog with a column of large buttons
+		Graphics::ManagedSurface screen(3840, 2160, _format);
+		const Common::Rect clip(3840, 2160);
+		const Common::List<Graphics::DrawStep> steps = buttonSteps();
+		Graphics::VectorRenderer *renderer = Graphics::createRenderer(GUI::ThemeEngine::kGfxStandard, _format);
+
+		Graphics::DrawStepCache cache;
+		cache.setMaxSize(2 * screen.pitch * screen.h);
+
+		uint32 directTime = 0, cachedTime = 0;
+		for (int pass = 0; pass < 2; pass++) {
+			uint32 start = g_system->getMillis();
+			for (int frame = 0; frame < frames; frame++) {
+				for (int i = 0; i < 20; i++) {
+					const Common::Rect area(400, 100 + i * 96, 3440, 180 + i * 96);
+					if (pass == 0)
+						drawDirect(renderer, screen, steps, area, clip);
+					else
+						drawCached(cache, 1, renderer, screen, steps, area, clip);
+				}
+			}
+			if (pass == 0)
+				directTime = g_system->getMillis() - start;
+			else
+				cachedTime = g_system->getMillis() - start;
+		}
+
+		debug("DrawStep redraw: %d frames direct %u ms, cached %u ms\n", frames, directTime, cachedTime);
+
+		delete renderer;
+#endif
+	}
+};
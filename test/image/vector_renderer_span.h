@@ -0,0 +1,261 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/list.h"
+#include "common/rect.h"
+#include "common/system.h"
+
+#include "graphics/managed_surface.h"
+#include "graphics/VectorRenderer.h"
+#include "graphics/VectorRendererSpan.h"
+
+#include "test/instrset_detect.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class VectorRendererSpanTestSuite : public CxxTest::TestSuite {
+	Graphics::PixelFormat _format;
+	uint32 _seed;
+
+	/** Simple LCG, RandomSource needs a backend */
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % (max + 1);
+	}
+
+	static void selectGeneric() {
+		Graphics::VectorRendererSpan::_blendFillFunc = Graphics::VectorRendererSpan::blendFillGeneric;
+		Graphics::VectorRendererSpan::_darkenFillFunc = Graphics::VectorRendererSpan::darkenFillGeneric;
+		Graphics::VectorRendererSpan::_patternFillFunc = Graphics::VectorRendererSpan::patternFillGeneric;
+	}
+
+	/** Select the fastest implementation, returns false if it is the generic one */
+	static bool selectBest() {
+		selectGeneric();
+#ifdef SCUMMVM_NEON
+		Graphics::VectorRendererSpan::_blendFillFunc = Graphics::VectorRendererSpan::blendFillNEON;
+		Graphics::VectorRendererSpan::_darkenFillFunc = Graphics::VectorRendererSpan::darkenFillNEON;
+		Graphics::VectorRendererSpan::_patternFillFunc = Graphics::VectorRendererSpan::patternFillNEON;
+		return true;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			Graphics::VectorRendererSpan::_blendFillFunc = Graphics::VectorRendererSpan::blendFillSSE2;
+			Graphics::VectorRendererSpan::_darkenFillFunc = Graphics::VectorRendererSpan::darkenFillSSE2;
+			Graphics::VectorRendererSpan::_patternFillFunc = Graphics::VectorRendererSpan::patternFillSSE2;
+			return true;
+		}
+#endif
+		return false;
+	}
+
+	/** Same math as VectorRendererSpec::blendPixelPtr() for 32bpp */
+	static uint32 blendReference(uint32 dst, uint32 color, uint8 alpha) {
+		uint32 result = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			byte d = (dst >> shift) & 0xFF;
+			const byte s = (color >> shift) & 0xFF;
+			d += ((s - d) * alpha) >> 8;
+			result |= (uint32)d << shift;
+		}
+		return result;
+	}
+
+	void fillRandom(uint32 *buffer, int count) {
+		for (int i = 0; i < count; i++)
+			buffer[i] = nextRandom(0xFFFF) | (nextRandom(0xFFFF) << 16);
+	}
+
+	/** Check the spans of every length and offset, and that nothing outside them is touched */
+	void checkBlendFill() {
+		uint32 buffer[48], expected[48];
+		for (int alpha = 0; alpha < 256; alpha += 3) {
+			for (int length = 0; length <= 19; length++) {
+				const int offset = nextRandom(7);
+				const uint32 color = nextRandom(0xFFFFFF) | 0xFF000000;
+
+				fillRandom(buffer, ARRAYSIZE(buffer));
+				memcpy(expected, buffer, sizeof(buffer));
+				for (int i = offset; i < offset + length; i++)
+					expected[i] = blendReference(expected[i], color, alpha) & 0xFF00FFFF;
+
+				Graphics::VectorRendererSpan::blendFill(buffer + offset, buffer + offset + length, color, alpha, 0xFF00FFFF);
+				TS_ASSERT_SAME_DATA(buffer, expected, sizeof(buffer));
+			}
+		}
+	}
+
+	void checkDarkenFill() {
+		uint32 buffer[48], expected[48];
+		for (int length = 0; length <= 19; length++) {
+			const int offset = nextRandom(7);
+
+			fillRandom(buffer, ARRAYSIZE(buffer));
+			memcpy(expected, buffer, sizeof(buffer));
+			for (int i = offset; i < offset + length; i++)
+				expected[i] = ((expected[i] & 0x00FCFCFC) >> 2) | 0xFF000000;
+
+			Graphics::VectorRendererSpan::darkenFill(buffer + offset, buffer + offset + length, 0x00FCFCFC, 0xFF000000);
+			TS_ASSERT_SAME_DATA(buffer, expected, sizeof(buffer));
+		}
+	}
+
+	void checkPatternFill() {
+		uint32 buffer[48], expected[48];
+		for (int length = 0; length <= 19; length++) {
+			const int offset = nextRandom(7);
+
+			fillRandom(buffer, ARRAYSIZE(buffer));
+			memcpy(expected, buffer, sizeof(buffer));
+			for (int i = 0; i < length; i++)
+				expected[offset + i] = (i & 1) ? 0x11223344 : 0x55667788;
+
+			Graphics::VectorRendererSpan::patternFill(buffer + offset, buffer + offset + length, 0x55667788, 0x11223344);
+			TS_ASSERT_SAME_DATA(buffer, expected, sizeof(buffer));
+		}
+	}
+
+	static Graphics::DrawStep makeStep(Graphics::DrawingFunctionCallback call, int fillMode) {
+		Graphics::DrawStep step;
+		step.drawingCall = call;
+		step.autoWidth = step.autoHeight = true;
+		step.factor = 1;
+		step.scale = 1 << 16;
+		step.stroke = 1;
+		step.fillMode = fillMode;
+		return step;
+	}
+
+	/** Steps similar to the ones of the default theme: gradient buttons with shadows, bevels and dialog frames */
+	static Common::List<Graphics::DrawStep> themeSteps() {
+		Common::List<Graphics::DrawStep> steps;
+
+		Graphics::DrawStep step = makeStep(&Graphics::VectorRenderer::drawCallback_ROUNDSQ, Graphics::VectorRenderer::kFillGradient);
+		step.radius = 5;
+		step.shadow = 3;
+		step.factor = 2;
+		step.fgColor.r = 20; step.fgColor.g = 30; step.fgColor.b = 40; step.fgColor.set = true;
+		step.gradColor1.r = 250; step.gradColor1.g = 200; step.gradColor1.b = 120; step.gradColor1.set = true;
+		step.gradColor2.r = 180; step.gradColor2.g = 90; step.gradColor2.b = 10; step.gradColor2.set = true;
+		steps.push_back(step);
+
+		step = makeStep(&Graphics::VectorRenderer::drawCallback_BEVELSQ, Graphics::VectorRenderer::kFillBackground);
+		step.padding = Common::Rect(12, 12, 12, 12);
+		step.bevel = 2;
+		step.bgColor.r = 160; step.bgColor.g = 170; step.bgColor.b = 180; step.bgColor.set = true;
+		step.bevelColor.r = 255; step.bevelColor.g = 255; step.bevelColor.b = 255; step.bevelColor.set = true;
+		steps.push_back(step);
+
+		step = makeStep(&Graphics::VectorRenderer::drawCallback_ROUNDSQ, Graphics::VectorRenderer::kFillBackground);
+		step.padding = Common::Rect(24, 24, 24, 24);
+		step.radius = 8;
+		step.shadow = 4;
+		step.bgColor.r = 240; step.bgColor.g = 230; step.bgColor.b = 200; step.bgColor.set = true;
+		step.fgColor.r = 90; step.fgColor.g = 60; step.fgColor.b = 30; step.fgColor.set = true;
+		steps.push_back(step);
+
+		return steps;
+	}
+
+	void drawSteps(Graphics::VectorRenderer *renderer, Graphics::ManagedSurface &surface,
+	               const Common::List<Graphics::DrawStep> &steps, const Common::Rect &area, const Common::Rect &clip) {
+		renderer->setSurface(&surface);
+		for (Common::List<Graphics::DrawStep>::const_iterator step = steps.begin(); step != steps.end(); ++step)
+			renderer->drawStep(area, clip, *step);
+	}
+
+	void checkRenderer(int mode, bool overlayAlpha, const Common::Rect &clip) {
+		Graphics::VectorRenderer *renderer = Graphics::createRenderer(mode, _format);
+		renderer->setOverlayAlpha(overlayAlpha);
+
+		Graphics::ManagedSurface expected(240, 120, _format);
+		Graphics::ManagedSurface result(240, 120, _format);
+		const Common::List<Graphics::DrawStep> steps = themeSteps();
+		const Common::Rect area(13, 9, 221, 107);
+
+		expected.fillRect(Common::Rect(240, 120), _format.ARGBToColor(0x80, 40, 80, 120));
+		result.fillRect(Common::Rect(240, 120), _format.ARGBToColor(0x80, 40, 80, 120));
+
+		selectGeneric();
+		drawSteps(renderer, expected, steps, area, clip);
+		selectBest();
+		drawSteps(renderer, result, steps, area, clip);
+		selectGeneric();
+
+		TS_ASSERT_SAME_DATA(expected.getPixels(), result.getPixels(), result.pitch * result.h);
+
+		delete renderer;
+	}
+
+public:
+	VectorRendererSpanTestSuite() : _format(4, 8, 8, 8, 8, 24, 16, 8, 0), _seed(1) {}
+
+	void test_generic() {
+		selectGeneric();
+		checkBlendFill();
+		checkDarkenFill();
+		checkPatternFill();
+	}
+
+	void test_simd() {
+		if (!selectBest())
+			return;
+		checkBlendFill();
+		checkDarkenFill();
+		checkPatternFill();
+		selectGeneric();
+	}
+
+	void test_renderer_output() {
+		checkRenderer(GUI::ThemeEngine::kGfxStandard, false, Common::Rect(240, 120));
+		checkRenderer(GUI::ThemeEngine::kGfxStandard, true, Common::Rect(30, 20, 200, 100));
+		checkRenderer(GUI::ThemeEngine::kGfxAntialias, false, Common::Rect(240, 120));
+	}
+
+	void test_draw_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int frames = 100;
+#else
+		const int frames = 5;
+#endif
+
+		// A 1080p dialog filled with large buttons
+		Graphics::ManagedSurface screen(1920, 1080, _format);
+		const Common::Rect clip(1920, 1080);
+		const Common::List<Graphics::DrawStep> steps = themeSteps();
+		Graphics::VectorRenderer *renderer = Graphics::createRenderer(GUI::ThemeEngine::kGfxAntialias, _format);
+
+		uint32 genericTime = 0, simdTime = 0;
+		for (int pass = 0; pass < 2; pass++) {
+			if (pass == 0)
+				selectGeneric();
+			else if (!selectBest())
+				break;
+
+			uint32 start = g_system->getMillis();
+			for (int frame = 0; frame < frames; frame++) {
+				for (int i = 0; i < 10; i++)
+					drawSteps(renderer, screen, steps, Common::Rect(100, 40 + i * 100, 1820, 130 + i * 100), clip);
+			}
+			if (pass == 0)
+				genericTime = g_system->getMillis() - start;
+			else
+				simdTime = g_system->getMillis() - start;
+		}
+		selectGeneric();
+
+		debug("VectorRenderer theme steps: %d frames generic %u ms, SIMD %u ms\n", frames, genericTime, simdTime);
+
+		delete renderer;
+#endif
+	}
+};
@@ -16,6 +16,9 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o
+ifdef HAS_PTHREADS
+TEST_LIBS += backends/tasks/pthread/pthread-task-scheduler.o
+endif
 endif
 
 ifdef WIN32
@@ -30,11 +33,21 @@ endif
 
 TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
+ifdef USE_BINK
+	TESTS += $(srcdir)/test/video/*.h
+	TEST_LIBS += video/libvideo.a
+endif
+
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
 endif
 
+ifeq ($(ENABLE_HPL1), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/hpl1/*.h
+	TEST_LIBS += engines/hpl1/libhpl1.a
+endif
+
 ifeq ($(ENABLE_ULTIMA), STATIC_PLUGIN)
 ifdef ENABLE_ULTIMA1
 	TESTS += $(srcdir)/test/engines/ultima/shared/*/*.h
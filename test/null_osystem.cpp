@@ -7,14 +7,16 @@
 
 //#define DISPLAY_ERROR_MESSAGES
 
-void Common::install_null_g_system() {
+void Common::install_null_g_system(Common::TaskScheduler *taskScheduler) {
 #ifdef DISPLAY_ERROR_MESSAGES
 	const bool silenceLogs = false;
 #else
 	const bool silenceLogs = true;
 #endif
 
-	g_system = OSystem_NULL_create(silenceLogs);
+	OSystem_NULL *system = new OSystem_NULL(silenceLogs);
+	system->setTaskScheduler(taskScheduler);
+	g_system = system;
 }
 
 void OSystem_NULL::quit() {
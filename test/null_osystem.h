@@ -1,8 +1,14 @@
 #ifndef TEST_NULL_OSYSTEM
 #define TEST_NULL_OSYSTEM 1
 namespace Common {
+class TaskScheduler;
+
 #if defined(POSIX) || defined(WIN32)
-void install_null_g_system();
+/**
+ * Install a new null OSystem as g_system. It takes ownership of the
+ * optional task scheduler, otherwise it has none.
+ */
+void install_null_g_system(TaskScheduler *taskScheduler = nullptr);
 #define NULL_OSYSTEM_IS_AVAILABLE 1
 #else
 #define NULL_OSYSTEM_IS_AVAILABLE 0
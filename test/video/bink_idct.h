@@ -0,0 +1,110 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "../null_osystem.h"
+
+#ifdef USE_BINK
+#include "video/bink_idct.h"
+#endif
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class BinkIDCTTestSuite : public CxxTest::TestSuite {
+public:
+	void test_simd_matches_generic() {
+#if defined(USE_BINK) && defined(SCUMMVM_SSE2)
+		if (instrset_detect() < 2)
+			return;
+
+		uint32 seed = 1;
+		for (int n = 0; n < 2000; n++) {
+			int32 block[64];
+			makeBlock(block, seed, n);
+
+			int32 generic[64], simd[64];
+			memcpy(generic, block, sizeof(block));
+			memcpy(simd, block, sizeof(block));
+			Video::BinkIDCT::idctGeneric(generic);
+			Video::BinkIDCT::idctSSE2(simd);
+			TS_ASSERT_SAME_DATA(generic, simd, sizeof(generic));
+
+			// Use a pitch larger than the block, to catch stray writes
+			byte genericPixels[8 * 12], simdPixels[8 * 12];
+			for (int i = 0; i < ARRAYSIZE(genericPixels); i++)
+				genericPixels[i] = simdPixels[i] = (byte)nextRandom(seed);
+
+			Video::BinkIDCT::idctAddGeneric(genericPixels, 12, block);
+			Video::BinkIDCT::idctAddSSE2(simdPixels, 12, block);
+			TS_ASSERT_SAME_DATA(genericPixels, simdPixels, sizeof(genericPixels));
+
+			Video::BinkIDCT::idctPutGeneric(genericPixels, 12, block);
+			Video::BinkIDCT::idctPutSSE2(simdPixels, 12, block);
+			TS_ASSERT_SAME_DATA(genericPixels, simdPixels, sizeof(genericPixels));
+		}
+#endif
+	}
+
+	void test_benchmark() {
+#if defined(USE_BINK) && BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		// The blocks of a 640x480 4:2:0 frame
+		const int blocksPerFrame = (640 / 8) * (480 / 8) * 3 / 2;
+#ifdef SLOW_TESTS
+		const int frames = 500;
+#else
+		const int frames = 5;
+#endif
+
+		int32 blocks[64][64];
+		uint32 seed = 1;
+		for (int i = 0; i < 64; i++)
+			makeBlock(blocks[i], seed, i);
+
+		static byte pixels[8 * 640];
+
+		uint32 start = g_system->getMillis();
+		for (int n = 0; n < frames * blocksPerFrame; n++)
+			Video::BinkIDCT::idctAddGeneric(pixels + (n & 63) * 8, 640, blocks[n & 63]);
+		uint32 genericTime = g_system->getMillis() - start;
+		debug("Bink IDCT (generic): %d frames in %u ms\n", frames, genericTime);
+
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			start = g_system->getMillis();
+			for (int n = 0; n < frames * blocksPerFrame; n++)
+				Video::BinkIDCT::idctAddSSE2(pixels + (n & 63) * 8, 640, blocks[n & 63]);
+			uint32 simdTime = g_system->getMillis() - start;
+			debug("Bink IDCT (SSE2): %d frames in %u ms\n", frames, simdTime);
+		}
+#endif
+#endif
+	}
+
+private:
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 16;
+	}
+
+	// Mix of DC-only, sparse and dense blocks, like the decoder sees
+	static void makeBlock(int32 *block, uint32 &seed, int n) {
+		memset(block, 0, 64 * sizeof(int32));
+		block[0] = (int32)(nextRandom(seed) % 4096) - 2048;
+
+		int coeffs = (n % 3 == 0) ? 0 : (n % 3 == 1) ? 4 : 64;
+		for (int i = 0; i < coeffs; i++)
+			block[nextRandom(seed) & 63] = (int32)(nextRandom(seed) % 2048) - 1024;
+	}
+};
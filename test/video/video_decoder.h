@@ -0,0 +1,175 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "common/task-scheduler.h"
+
+#include "graphics/surface.h"
+
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+namespace {
+
+/**
+ * Claims to have a worker, but only runs tasks while the caller waits on
+ * one, so the test decides when frames are decoded ahead.
+ */
+class DeferredTaskScheduler : public Common::TaskScheduler {
+public:
+	uint getWorkerCount() const override { return 1; }
+
+	/** Run the tasks queued so far, but not the ones they queue. */
+	void runQueued() {
+		submit(new NopTask()).wait();
+	}
+
+private:
+	class NopTask : public Common::Task {
+	public:
+		void run() override {}
+	};
+};
+
+/** A video whose frames are a single pixel holding the frame number. */
+class CountingDecoder : public Video::VideoDecoder {
+public:
+	CountingDecoder() : _track(nullptr) {}
+
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		return false;
+	}
+
+	void load(int frameCount) {
+		close();
+		_track = new CountingTrack(frameCount);
+		addTrack(_track);
+	}
+
+	/** The last frame decoded by the track, which may be ahead of getCurFrame(). */
+	int getDecodedFrame() const { return _track->getCurFrame(); }
+
+private:
+	class CountingTrack : public FixedRateVideoTrack {
+	public:
+		CountingTrack(int frameCount) : _frameCount(frameCount), _curFrame(-1) {
+			_surface.create(1, 1, Graphics::PixelFormat::createFormatCLUT8());
+		}
+
+		~CountingTrack() override {
+			_surface.free();
+		}
+
+		bool isSeekable() const override { return true; }
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = (int)getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		uint16 getWidth() const override { return 1; }
+		uint16 getHeight() const override { return 1; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return _frameCount; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			*(byte *)_surface.getPixels() = _curFrame;
+			return &_surface;
+		}
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+
+	private:
+		int _frameCount;
+		int _curFrame;
+		Graphics::Surface _surface;
+	};
+
+	CountingTrack *_track;
+};
+
+} // End of anonymous namespace
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+#if NULL_OSYSTEM_IS_AVAILABLE
+	static int decodeFrame(CountingDecoder &decoder) {
+		const Graphics::Surface *surface = decoder.decodeNextFrame();
+		TS_ASSERT(surface);
+		return surface ? *(const byte *)surface->getPixels() : -1;
+	}
+
+public:
+	void test_decode_ahead_unsupported() {
+		Common::install_null_g_system(new Common::TaskScheduler());
+
+		CountingDecoder decoder;
+		decoder.load(10);
+		TS_ASSERT(!decoder.setDecodeAhead(4));
+		TS_ASSERT(decoder.setDecodeAhead(0));
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 0);
+	}
+
+	void test_decode_ahead() {
+		DeferredTaskScheduler *scheduler = new DeferredTaskScheduler();
+		Common::install_null_g_system(scheduler);
+
+		CountingDecoder decoder;
+		decoder.load(20);
+		TS_ASSERT(decoder.setDecodeAhead(4));
+
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 0);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 0);
+
+		// Let the worker get ahead; the reported state follows the frame
+		// that was handed out, not the track
+		for (int i = 0; i < 6; i++)
+			scheduler->runQueued();
+		TS_ASSERT_EQUALS(decoder.getDecodedFrame(), 4);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 0);
+		TS_ASSERT(!decoder.endOfVideo());
+
+		for (int i = 1; i < 7; i++) {
+			TS_ASSERT_EQUALS(decodeFrame(decoder), i);
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), i);
+		}
+
+		// Seeking drops the frames decoded ahead
+		scheduler->runQueued();
+		scheduler->runQueued();
+		TS_ASSERT(decoder.getDecodedFrame() > 6);
+		TS_ASSERT(decoder.seek(Audio::Timestamp(1200, 1000)));
+		TS_ASSERT_EQUALS(decoder.getTime(), 1200U);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 11);
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 12);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 12);
+
+		scheduler->runQueued();
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT_EQUALS(decoder.getTime(), 0U);
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 0);
+
+		// Playing keeps the clock going from the seek position
+		decoder.start();
+		TS_ASSERT(decoder.seek(Audio::Timestamp(500, 1000)));
+		const uint32 time = decoder.getTime();
+		TS_ASSERT(time >= 500 && time < 1500);
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 5);
+
+		// The end is only reported once the last frame is handed out
+		TS_ASSERT(decoder.seek(Audio::Timestamp(1700, 1000)));
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 17);
+		for (int i = 0; i < 4; i++)
+			scheduler->runQueued();
+		TS_ASSERT_EQUALS(decoder.getDecodedFrame(), 19);
+		TS_ASSERT(!decoder.endOfVideo());
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 18);
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 19);
+		TS_ASSERT(decoder.endOfVideo());
+
+		decoder.stop();
+		decoder.close();
+	}
+#endif
+};
@@ -36,6 +36,7 @@
 #include "common/bitstream.h"
 #include "common/compression/huffman.h"
 #include "common/system.h"
+#include "common/task-scheduler.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -279,6 +280,17 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32
 		_surfaceWidth++;
 	}
 
+	_idct = BinkIDCT::idctGeneric;
+	_idctPut = BinkIDCT::idctPutGeneric;
+	_idctAdd = BinkIDCT::idctAddGeneric;
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		_idct = BinkIDCT::idctSSE2;
+		_idctPut = BinkIDCT::idctPutSSE2;
+		_idctAdd = BinkIDCT::idctAddSSE2;
+	}
+#endif
+
 	_pixelFormat = g_system->getScreenFormat();
 
 	// Default to a 32bpp format, if in 8bpp mode
@@ -478,18 +490,7 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
-	// Convert the YUV data we have to our format
-	// The width used here is the surface-width, and not the video-width
-	// to allow for odd-sized videos.
-	if (_hasAlpha) {
-		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	} else {
-		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	}
+	convertPlanes();
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
@@ -498,6 +499,42 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	_curFrame++;
 }
 
+void BinkDecoder::BinkVideoTrack::convertPlanes() {
+	// Convert the YUV data we have to our format
+	// The width used here is the surface-width, and not the video-width
+	// to allow for odd-sized videos.
+	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && (!_hasAlpha || _curPlanes[3]));
+
+	const int yPitch = _yBlockWidth * 8;
+	const int uvPitch = _uvBlockWidth * 8;
+
+	// Converts the lines [2 * first, 2 * last) of the surface
+	auto convertLines = [this, yPitch, uvPitch](uint first, uint last) {
+		Graphics::Surface dst;
+		dst.init(_surfaceWidth, (last - first) * 2, _surface->pitch, _surface->getBasePtr(0, first * 2), _surface->format);
+
+		const byte *y = _curPlanes[0] + first * 2 * yPitch;
+		const byte *u = _curPlanes[1] + first * uvPitch;
+		const byte *v = _curPlanes[2] + first * uvPitch;
+
+		if (_hasAlpha)
+			YUVToRGBMan.convert420Alpha(&dst, Graphics::YUVToRGBManager::kScaleITU, y, u, v, _curPlanes[3] + first * 2 * yPitch,
+					dst.w, dst.h, yPitch, uvPitch);
+		else
+			YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, y, u, v,
+					dst.w, dst.h, yPitch, uvPitch);
+	};
+
+	// The planes are complete at this point, so the conversion can be
+	// split into strips. The first strip is converted here, which also
+	// sets up the lookup table shared by the other strips.
+	const uint linePairs = _surfaceHeight / 2;
+	const uint firstStrip = MIN<uint>(linePairs, 16);
+
+	convertLines(0, firstStrip);
+	g_system->getTaskScheduler()->parallelFor(firstStrip, linePairs, 16, convertLines);
+}
+
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
 	uint32 blockWidth  = isChroma ? _uvBlockWidth  : _yBlockWidth;
 	uint32 blockHeight = isChroma ? _uvBlockHeight : _yBlockHeight;
@@ -815,7 +852,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCT(block);
+	_idct(block);
 
 	int32 *src   = block;
 	byte  *dest1 = ctx.dest;
@@ -960,7 +997,7 @@ void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCTPut(ctx, block);
+	_idctPut(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
@@ -981,7 +1018,7 @@ void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, false);
 
-	IDCTAdd(ctx, block);
+	_idctAdd(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
@@ -1410,88 +1447,6 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-	const int a0 = (src)[s0] + (src)[s4]; \
-	const int a1 = (src)[s0] - (src)[s4]; \
-	const int a2 = (src)[s2] + (src)[s6]; \
-	const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-	const int a4 = (src)[s5] + (src)[s3]; \
-	const int a5 = (src)[s5] - (src)[s3]; \
-	const int a6 = (src)[s1] + (src)[s7]; \
-	const int a7 = (src)[s1] - (src)[s7]; \
-	const int b0 = a4 + a6; \
-	const int b1 = (A3*(a5 + a7)) >> 11; \
-	const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-	const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-	const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-	(dest)[d0] = munge(a0+a2   +b0); \
-	(dest)[d1] = munge(a1+a3-a2+b2); \
-	(dest)[d2] = munge(a1-a3+a2+b3); \
-	(dest)[d3] = munge(a0-a2   -b4); \
-	(dest)[d4] = munge(a0-a2   +b4); \
-	(dest)[d5] = munge(a1-a3+a2-b3); \
-	(dest)[d6] = munge(a1+a3-a2-b2); \
-	(dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int32 *dest, const int32 *src) {
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
-	int i;
-	int32 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
-	int i;
-	int32 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
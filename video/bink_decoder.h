@@ -35,6 +35,7 @@
 #include "common/rational.h"
 
 #include "video/video_decoder.h"
+#include "video/bink_idct.h"
 
 #include "graphics/surface.h"
 
@@ -281,6 +282,10 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		BinkIDCT::IDCTFunc _idct;          ///< IDCT in place, best for this CPU
+		BinkIDCT::IDCTPixelsFunc _idctPut; ///< IDCT into pixels, best for this CPU
+		BinkIDCT::IDCTPixelsFunc _idctAdd; ///< IDCT added to pixels, best for this CPU
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -337,10 +342,8 @@ private:
 		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
-		// Bink video IDCT
-		void IDCT(int32 *block);
-		void IDCTPut(DecodeContext &ctx, int32 *block);
-		void IDCTAdd(DecodeContext &ctx, int32 *block);
+		/** Convert the current YUV planes into the surface. */
+		void convertPlanes();
 	};
 
 	class BinkAudioTrack : public AudioTrack {
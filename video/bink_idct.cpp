@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Based quite heavily on the Bink decoder found in FFmpeg
+
+#include "video/bink_idct.h"
+
+namespace Video {
+
+namespace BinkIDCT {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+	const int a0 = (src)[s0] + (src)[s4]; \
+	const int a1 = (src)[s0] - (src)[s4]; \
+	const int a2 = (src)[s2] + (src)[s6]; \
+	const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+	const int a4 = (src)[s5] + (src)[s3]; \
+	const int a5 = (src)[s5] - (src)[s3]; \
+	const int a6 = (src)[s1] + (src)[s7]; \
+	const int a7 = (src)[s1] - (src)[s7]; \
+	const int b0 = a4 + a6; \
+	const int b1 = (A3*(a5 + a7)) >> 11; \
+	const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+	const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+	const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+	(dest)[d0] = munge(a0+a2   +b0); \
+	(dest)[d1] = munge(a1+a3-a2+b2); \
+	(dest)[d2] = munge(a1-a3+a2+b3); \
+	(dest)[d3] = munge(a0-a2   -b4); \
+	(dest)[d4] = munge(a0-a2   +b4); \
+	(dest)[d5] = munge(a1-a3+a2-b3); \
+	(dest)[d6] = munge(a1+a3-a2-b2); \
+	(dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int32 *dest, const int32 *src) {
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+void idctGeneric(int32 *block) {
+	int i;
+	int32 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+void idctPutGeneric(byte *dest, int pitch, const int32 *block) {
+	int i;
+	int32 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+void idctAddGeneric(byte *dest, int pitch, const int32 *block) {
+	int i, j;
+	int32 temp[64];
+
+	memcpy(temp, block, sizeof(temp));
+	idctGeneric(temp);
+
+	const int32 *src = temp;
+	for (i = 0; i < 8; i++, dest += pitch, src += 8)
+		for (j = 0; j < 8; j++)
+			 dest[j] += src[j];
+}
+
+} // End of namespace BinkIDCT
+
+} // End of namespace Video
@@ -0,0 +1,56 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VIDEO_BINK_IDCT_H
+#define VIDEO_BINK_IDCT_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * The 8x8 inverse DCT used by Bink video.
+ *
+ * Blocks are 64 coefficients in row-major order. All implementations
+ * produce bit-identical results.
+ */
+namespace BinkIDCT {
+
+/** Transform a block in place. */
+typedef void (*IDCTFunc)(int32 *block);
+/** Transform a block and store (Put) or add (Add) the result to 8x8 pixels. */
+typedef void (*IDCTPixelsFunc)(byte *dest, int pitch, const int32 *block);
+
+void idctGeneric(int32 *block);
+void idctPutGeneric(byte *dest, int pitch, const int32 *block);
+void idctAddGeneric(byte *dest, int pitch, const int32 *block);
+
+#ifdef SCUMMVM_SSE2
+void idctSSE2(int32 *block);
+void idctPutSSE2(byte *dest, int pitch, const int32 *block);
+void idctAddSSE2(byte *dest, int pitch, const int32 *block);
+#endif
+
+} // End of namespace BinkIDCT
+
+} // End of namespace Video
+
+#endif
@@ -0,0 +1,177 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "video/bink_idct.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Video {
+
+namespace BinkIDCT {
+
+// Low 32 bits of a 32x32 bit multiplication. SSE2 has no pmulld.
+static FORCEINLINE __m128i mulConst(__m128i a, int32 c) {
+	const __m128i b = _mm_set1_epi32(c);
+	__m128i even = _mm_shuffle_epi32(_mm_mul_epu32(a, b), _MM_SHUFFLE(0, 0, 2, 0));
+	__m128i odd = _mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_si128(a, 4), b), _MM_SHUFFLE(0, 0, 2, 0));
+	return _mm_unpacklo_epi32(even, odd);
+}
+
+// The same 1-D transform as the generic IDCT_TRANSFORM, applied to four
+// columns at once. s[i] holds element i of each column.
+static FORCEINLINE void transform(__m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(mulConst(_mm_sub_epi32(s[2], s[6]), 2896), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mulConst(_mm_add_epi32(a5, a7), 3784), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(mulConst(a5, -5352), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mulConst(_mm_sub_epi32(a6, a4), 2896), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mulConst(a7, 2217), 11), b3), b1);
+
+	const __m128i c0 = _mm_add_epi32(a0, a2);
+	const __m128i c1 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i c2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	const __m128i c3 = _mm_sub_epi32(a0, a2);
+
+	s[0] = _mm_add_epi32(c0, b0);
+	s[1] = _mm_add_epi32(c1, b2);
+	s[2] = _mm_add_epi32(c2, b3);
+	s[3] = _mm_sub_epi32(c3, b4);
+	s[4] = _mm_add_epi32(c3, b4);
+	s[5] = _mm_sub_epi32(c2, b3);
+	s[6] = _mm_sub_epi32(c1, b2);
+	s[7] = _mm_sub_epi32(c0, b0);
+}
+
+static FORCEINLINE void transpose4(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t1);
+	r1 = _mm_unpackhi_epi64(t0, t1);
+	r2 = _mm_unpacklo_epi64(t2, t3);
+	r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+// lo[i] holds columns 0-3 of row i, hi[i] columns 4-7
+static FORCEINLINE void transpose8(__m128i *lo, __m128i *hi) {
+	transpose4(lo[0], lo[1], lo[2], lo[3]);
+	transpose4(lo[4], lo[5], lo[6], lo[7]);
+	transpose4(hi[0], hi[1], hi[2], hi[3]);
+	transpose4(hi[4], hi[5], hi[6], hi[7]);
+
+	for (int i = 0; i < 4; i++) {
+		const __m128i t = lo[4 + i];
+		lo[4 + i] = hi[i];
+		hi[i] = t;
+	}
+}
+
+static FORCEINLINE void idct8x8(const int32 *block, __m128i *lo, __m128i *hi) {
+	for (int i = 0; i < 8; i++) {
+		lo[i] = _mm_loadu_si128((const __m128i *)&block[i * 8]);
+		hi[i] = _mm_loadu_si128((const __m128i *)&block[i * 8 + 4]);
+	}
+
+	// Columns
+	transform(lo);
+	transform(hi);
+
+	// Rows, by transforming the columns of the transposed block
+	transpose8(lo, hi);
+	transform(lo);
+	transform(hi);
+
+	const __m128i round = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++) {
+		lo[i] = _mm_srai_epi32(_mm_add_epi32(lo[i], round), 8);
+		hi[i] = _mm_srai_epi32(_mm_add_epi32(hi[i], round), 8);
+	}
+
+	transpose8(lo, hi);
+}
+
+// Pack a row to bytes, wrapping like a store to a byte does
+static FORCEINLINE __m128i packRow(__m128i lo, __m128i hi) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i words = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+	return _mm_packus_epi16(words, words);
+}
+
+void idctSSE2(int32 *block) {
+	__m128i lo[8], hi[8];
+	idct8x8(block, lo, hi);
+
+	for (int i = 0; i < 8; i++) {
+		_mm_storeu_si128((__m128i *)&block[i * 8], lo[i]);
+		_mm_storeu_si128((__m128i *)&block[i * 8 + 4], hi[i]);
+	}
+}
+
+void idctPutSSE2(byte *dest, int pitch, const int32 *block) {
+	__m128i lo[8], hi[8];
+	idct8x8(block, lo, hi);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, packRow(lo[i], hi[i]));
+}
+
+void idctAddSSE2(byte *dest, int pitch, const int32 *block) {
+	__m128i lo[8], hi[8];
+	idct8x8(block, lo, hi);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i pixels = _mm_loadl_epi64((const __m128i *)dest);
+		_mm_storel_epi64((__m128i *)dest, _mm_add_epi8(pixels, packRow(lo[i], hi[i])));
+	}
+}
+
+} // End of namespace BinkIDCT
+
+} // End of namespace Video
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -18,7 +18,13 @@ MODULE_OBJS := \
 
 ifdef USE_BINK
 MODULE_OBJS += \
-	bink_decoder.o
+	bink_decoder.o \
+	bink_idct.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	bink_idct_sse2.o
+endif
 endif
 
 ifdef USE_HNM
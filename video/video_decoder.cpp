@@ -26,14 +26,85 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/mutex.h"
+#include "common/profiler.h"
+#include "common/queue.h"
 #include "common/system.h"
+#include "common/task-scheduler.h"
+
+#include "graphics/surface.h"
 
 namespace Video {
 
+/**
+ * A frame decoded ahead of time, along with the state of the video track
+ * right after it was decoded.
+ */
+struct VideoDecoder::DecodedFrame {
+	DecodedFrame() : hasSurface(false), hasPalette(false), nextVideoTrack(nullptr), curFrame(-1), nextFrameStartTime(0), endOfTrack(false), isReversed(false) {}
+	~DecodedFrame() { surface.free(); }
+
+	Graphics::Surface surface;
+	bool hasSurface;
+	byte palette[256 * 3];
+	bool hasPalette;
+
+	VideoTrack *nextVideoTrack;
+	int curFrame;
+	uint32 nextFrameStartTime;
+	bool endOfTrack;
+	bool isReversed;
+};
+
+class VideoDecoder::DecodeAhead {
+public:
+	DecodeAhead(VideoTrack *track, uint frames) : videoTrack(track), frameCount(frames), stop(false), endReached(false), presented(nullptr), presentedValid(false) {
+		// One surface for each queued frame, plus the one being displayed
+		for (uint i = 0; i <= frames; i++)
+			pool.push_back(new DecodedFrame());
+	}
+
+	~DecodeAhead() {
+		delete presented;
+		while (!queue.empty())
+			delete queue.pop();
+		for (auto &frame : pool)
+			delete frame;
+	}
+
+	VideoTrack *videoTrack;
+	uint frameCount;
+
+	// Shared with the worker, protected by the mutex
+	Common::Mutex mutex;
+	Common::Queue<DecodedFrame *> queue;
+	Common::Array<DecodedFrame *> pool;
+	bool stop;
+	bool endReached;
+
+	Common::TaskFuture task;
+
+	// The frame last returned by decodeNextFrame()
+	DecodedFrame *presented;
+	bool presentedValid;
+};
+
+class VideoDecoder::DecodeAheadTask : public Common::Task {
+public:
+	DecodeAheadTask(VideoDecoder *decoder) : _decoder(decoder) {}
+
+	void run() override {
+		_decoder->runDecodeAhead();
+	}
+
+private:
+	VideoDecoder *_decoder;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
-	_palette = 0;
+	_palette = nullptr;
 	_playbackRate = 0;
 	_audioVolume = Audio::Mixer::kMaxChannelVolume;
 	_audioBalance = 0;
@@ -48,9 +119,16 @@ VideoDecoder::VideoDecoder() {
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
 	_videoCodecAccuracy = Image::CodecAccuracy::Default;
+	_decodeAhead = nullptr;
+}
+
+VideoDecoder::~VideoDecoder() {
+	freeDecodeAhead();
 }
 
 void VideoDecoder::close() {
+	freeDecodeAhead();
+
 	if (isPlaying())
 		stop();
 
@@ -61,7 +139,7 @@ void VideoDecoder::close() {
 	_internalTracks.clear();
 	_externalTracks.clear();
 	_dirtyPalette = false;
-	_palette = 0;
+	_palette = nullptr;
 	_startTime = 0;
 	_audioVolume = Audio::Mixer::kMaxChannelVolume;
 	_audioBalance = 0;
@@ -121,6 +199,9 @@ void VideoDecoder::delayMillis(uint msecs) {
 }
 
 void VideoDecoder::pauseVideo(bool pause) {
+	// The tracks must not be touched while frames are decoded ahead
+	waitForDecodeAhead();
+
 	if (pause) {
 		_pauseLevel++;
 
@@ -208,10 +289,27 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 }
 
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
+	PROFILE_ZONE("Video decode");
+
 	_needsUpdate = false;
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
+	if (_decodeAhead)
+		return decodeNextFrameAhead();
+
+	const byte *palette = nullptr;
+	const Graphics::Surface *frame = decodeFrame(palette);
+
+	if (palette) {
+		_palette = palette;
+		_dirtyPalette = true;
+	}
+
+	return frame;
+}
+
+const Graphics::Surface *VideoDecoder::decodeFrame(const byte *&palette) {
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -221,10 +319,8 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
 
-	if (_nextVideoTrack->hasDirtyPalette()) {
-		_palette = _nextVideoTrack->getPalette();
-		_dirtyPalette = true;
-	}
+	if (_nextVideoTrack->hasDirtyPalette())
+		palette = _nextVideoTrack->getPalette();
 
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
@@ -237,9 +333,14 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	waitForDecodeAhead();
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (auto &track : _tracks) {
 		if (track->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)track)->isReversed() != reverse) {
+			// Frames decoded ahead were going the other way
+			flushDecodeAhead();
+
 			if (!((VideoTrack *)track)->setReverse(reverse))
 				return false;
 
@@ -257,6 +358,10 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	const DecodedFrame *presented = getPresentedFrame();
+	if (presented)
+		return presented->curFrame;
+
 	int32 frame = -1;
 
 	for (const auto &track : _tracks)
@@ -298,13 +403,18 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	// While decoding ahead, _nextVideoTrack belongs to the worker
+	const DecodedFrame *presented = getPresentedFrame();
+	const VideoTrack *nextVideoTrack = presented ? presented->nextVideoTrack : _nextVideoTrack;
+
+	if (endOfVideo() || _needsUpdate || !nextVideoTrack)
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = presented ? presented->nextFrameStartTime : nextVideoTrack->getNextFrameStartTime();
+	bool isReversed = presented ? presented->isReversed : nextVideoTrack->isReversed();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (isReversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -321,8 +431,8 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 
 bool VideoDecoder::endOfVideo() const {
 	for (const auto &track : _tracks) {
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && getTrackNextFrameStartTime((const VideoTrack *)track) >= (uint)_endTime.msecs();
+		bool endReached = isTrackAtEnd(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -345,6 +455,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	flushDecodeAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -379,6 +491,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	flushDecodeAhead();
+
 	// Stop all tracks so they can be seek'ed
 	if (isPlaying())
 		stopAudio();
@@ -445,6 +559,9 @@ void VideoDecoder::stop() {
 	if (!isPlaying())
 		return;
 
+	// The tracks must not be touched while frames are decoded ahead
+	waitForDecodeAhead();
+
 	// Stop audio here so we don't have it affect getTime()
 	stopAudio();
 
@@ -456,7 +573,7 @@ void VideoDecoder::stop() {
 
 	_playbackRate = 0;
 	_startTime = 0;
-	_palette = 0;
+	_palette = nullptr;
 	_dirtyPalette = false;
 	_needsUpdate = false;
 
@@ -806,6 +923,12 @@ bool VideoDecoder::StreamFileAudioTrack::loadFromFile(const Common::Path &baseNa
 }
 
 void VideoDecoder::addTrack(Track *track, bool isExternal) {
+	// Decoding ahead only supports a single video track
+	if (track->getTrackType() == Track::kTrackTypeVideo)
+		freeDecodeAhead();
+	else
+		waitForDecodeAhead();
+
 	_tracks.push_back(track);
 
 	if (isExternal)
@@ -1038,8 +1161,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *videoTrack = (const VideoTrack *)track;
 
-		bool videoEndTimeReached = _endTimeSet && videoTrack->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = videoTrack->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getTrackNextFrameStartTime(videoTrack) >= (uint)_endTime.msecs();
+		bool endReached = isTrackAtEnd(videoTrack) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -1056,6 +1179,11 @@ bool VideoDecoder::hasAudio() const {
 }
 
 void VideoDecoder::eraseTrack(Track *track) {
+	if (_decodeAhead && _decodeAhead->videoTrack == track)
+		freeDecodeAhead();
+	else
+		waitForDecodeAhead();
+
 	for (uint idx = 0; idx < _externalTracks.size(); ++idx) {
 		if (_externalTracks[idx] == track)
 			_externalTracks.remove_at(idx);
@@ -1072,4 +1200,225 @@ void VideoDecoder::eraseTrack(Track *track) {
 	}
 }
 
+bool VideoDecoder::setDecodeAhead(uint frames) {
+	freeDecodeAhead();
+
+	if (frames == 0)
+		return true;
+
+	Common::TaskScheduler *scheduler = g_system->getTaskScheduler();
+	if (!scheduler || scheduler->getWorkerCount() == 0)
+		return false;
+
+	VideoTrack *videoTrack = nullptr;
+
+	for (auto &track : _tracks) {
+		if (track->getTrackType() == Track::kTrackTypeVideo) {
+			// We only allow this when one video track is present
+			if (videoTrack)
+				return false;
+
+			videoTrack = (VideoTrack *)track;
+		}
+	}
+
+	if (!videoTrack)
+		return false;
+
+	_decodeAhead = new DecodeAhead(videoTrack, frames);
+	return true;
+}
+
+const Graphics::Surface *VideoDecoder::decodeNextFrameAhead() {
+	DecodeAhead *ahead = _decodeAhead;
+	DecodedFrame *frame = nullptr;
+	Common::TaskFuture next;
+
+	{
+		Common::StackLock lock(ahead->mutex);
+		if (!ahead->queue.empty())
+			frame = ahead->queue.pop();
+		else
+			next = ahead->task;
+	}
+
+	if (!frame) {
+		// The worker fell behind. Only wait for the frame it is decoding
+		// right now, not for the ones it would decode after that.
+		next.wait();
+
+		Common::StackLock lock(ahead->mutex);
+		if (!ahead->queue.empty())
+			frame = ahead->queue.pop();
+	}
+
+	if (!frame) {
+		// The worker had nothing left to decode, do it ourselves
+		waitForDecodeAhead();
+
+		{
+			Common::StackLock lock(ahead->mutex);
+			frame = ahead->pool.back();
+			ahead->pool.pop_back();
+		}
+
+		decodeFrameAhead(frame);
+	}
+
+	if (ahead->presented) {
+		// Keep a palette that is still in use alive
+		if (!frame->hasPalette && _palette == ahead->presented->palette) {
+			memcpy(frame->palette, ahead->presented->palette, sizeof(frame->palette));
+			_palette = frame->palette;
+		}
+
+		Common::StackLock lock(ahead->mutex);
+		ahead->pool.push_back(ahead->presented);
+	}
+
+	ahead->presented = frame;
+	ahead->presentedValid = true;
+
+	if (frame->hasPalette) {
+		_palette = frame->palette;
+		_dirtyPalette = true;
+	}
+
+	// Keep the queue filled
+	if (!frame->endOfTrack) {
+		Common::StackLock lock(ahead->mutex);
+		if (!ahead->task.isValid() || ahead->task.isDone())
+			ahead->task = g_system->getTaskScheduler()->submit(new DecodeAheadTask(this));
+	}
+
+	return frame->hasSurface ? &frame->surface : nullptr;
+}
+
+void VideoDecoder::decodeFrameAhead(DecodedFrame *frame) {
+	const byte *palette = nullptr;
+	const Graphics::Surface *surface = decodeFrame(palette);
+
+	// Reuse the surface from an earlier frame if possible
+	frame->hasSurface = (surface != nullptr);
+	if (surface) {
+		if (frame->surface.w != surface->w || frame->surface.h != surface->h || frame->surface.format != surface->format) {
+			frame->surface.free();
+			frame->surface.create(surface->w, surface->h, surface->format);
+		}
+
+		frame->surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+	}
+
+	frame->hasPalette = (palette != nullptr);
+	if (palette)
+		memcpy(frame->palette, palette, sizeof(frame->palette));
+
+	VideoTrack *videoTrack = _decodeAhead->videoTrack;
+	frame->nextVideoTrack = _nextVideoTrack;
+	frame->curFrame = videoTrack->getCurFrame();
+	frame->nextFrameStartTime = videoTrack->getNextFrameStartTime();
+	frame->endOfTrack = videoTrack->endOfTrack();
+	frame->isReversed = videoTrack->isReversed();
+}
+
+void VideoDecoder::runDecodeAhead() {
+	DecodeAhead *ahead = _decodeAhead;
+	DecodedFrame *frame;
+
+	{
+		Common::StackLock lock(ahead->mutex);
+		if (ahead->stop || ahead->endReached || (uint)ahead->queue.size() >= ahead->frameCount || ahead->pool.empty())
+			return;
+
+		frame = ahead->pool.back();
+		ahead->pool.pop_back();
+	}
+
+	decodeFrameAhead(frame);
+
+	Common::StackLock lock(ahead->mutex);
+	ahead->queue.push(frame);
+	if (frame->endOfTrack)
+		ahead->endReached = true;
+
+	// Each task decodes a single frame and queues the next one, so
+	// decodeNextFrameAhead() can wait for just the frame it needs
+	if (!ahead->stop && !ahead->endReached && (uint)ahead->queue.size() < ahead->frameCount)
+		ahead->task = g_system->getTaskScheduler()->submit(new DecodeAheadTask(this));
+}
+
+void VideoDecoder::waitForDecodeAhead() {
+	if (!_decodeAhead)
+		return;
+
+	// Keep the running task from queuing another one, then wait for it
+	Common::TaskFuture task;
+
+	{
+		Common::StackLock lock(_decodeAhead->mutex);
+		_decodeAhead->stop = true;
+		task = _decodeAhead->task;
+		_decodeAhead->task = Common::TaskFuture();
+	}
+
+	task.wait();
+
+	Common::StackLock lock(_decodeAhead->mutex);
+	_decodeAhead->stop = false;
+}
+
+void VideoDecoder::flushDecodeAhead() {
+	if (!_decodeAhead)
+		return;
+
+	waitForDecodeAhead();
+
+	// Drop any frames decoded ahead. The tracks are now positioned after
+	// them, so report their state directly until the next frame is decoded.
+	Common::StackLock lock(_decodeAhead->mutex);
+	while (!_decodeAhead->queue.empty())
+		_decodeAhead->pool.push_back(_decodeAhead->queue.pop());
+
+	_decodeAhead->endReached = false;
+	_decodeAhead->presentedValid = false;
+}
+
+void VideoDecoder::freeDecodeAhead() {
+	if (!_decodeAhead)
+		return;
+
+	flushDecodeAhead();
+
+	if (_decodeAhead->presented && _palette == _decodeAhead->presented->palette) {
+		_palette = nullptr;
+		_dirtyPalette = false;
+	}
+
+	delete _decodeAhead;
+	_decodeAhead = nullptr;
+}
+
+const VideoDecoder::DecodedFrame *VideoDecoder::getPresentedFrame() const {
+	if (_decodeAhead && _decodeAhead->presentedValid)
+		return _decodeAhead->presented;
+
+	return nullptr;
+}
+
+bool VideoDecoder::isTrackAtEnd(const Track *track) const {
+	const DecodedFrame *presented = getPresentedFrame();
+	if (presented && track == _decodeAhead->videoTrack)
+		return presented->endOfTrack;
+
+	return track->endOfTrack();
+}
+
+uint32 VideoDecoder::getTrackNextFrameStartTime(const VideoTrack *track) const {
+	const DecodedFrame *presented = getPresentedFrame();
+	if (presented && track == _decodeAhead->videoTrack)
+		return presented->nextFrameStartTime;
+
+	return track->getNextFrameStartTime();
+}
+
 } // End of namespace Video
@@ -53,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -365,6 +365,26 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Decode frames ahead of time on a worker thread.
+	 *
+	 * Once enabled, up to the given number of frames are decoded in the
+	 * background into a pool of surfaces, and decodeNextFrame() only has to
+	 * hand out the next one. Seeking, rewinding and timing keep working as
+	 * usual.
+	 *
+	 * The video's tracks and readNextPacket() are then called from another
+	 * thread, so they must not touch anything besides their own state.
+	 *
+	 * This should be called after loadStream(). The setting remains until
+	 * close() is called.
+	 *
+	 * @param frames The number of frames to decode ahead, or 0 to disable
+	 * @return true on success, false if the video or the backend does not
+	 *         support it
+	 */
+	bool setDecodeAhead(uint frames);
+
 	/**
 	 * Set the video to decode frames in reverse.
 	 *
@@ -1038,6 +1058,24 @@ private:
 	Audio::Mixer::SoundType _soundType;
 
 	AudioTrack *_mainAudioTrack;
+
+	// Decode-ahead support
+	class DecodeAhead;
+	class DecodeAheadTask;
+	struct DecodedFrame;
+
+	DecodeAhead *_decodeAhead;
+
+	const Graphics::Surface *decodeFrame(const byte *&palette);
+	const Graphics::Surface *decodeNextFrameAhead();
+	void decodeFrameAhead(DecodedFrame *frame);
+	void runDecodeAhead();
+	void waitForDecodeAhead();
+	void flushDecodeAhead();
+	void freeDecodeAhead();
+	const DecodedFrame *getPresentedFrame() const;
+	bool isTrackAtEnd(const Track *track) const;
+	uint32 getTrackNextFrameStartTime(const VideoTrack *track) const;
 };
 
 } // End of namespace Video